@@ -17,7 +17,14 @@ static const void *offload_param;
 /* Called by z_arm_svc */
 void z_irq_do_offload(void)
 {
+	/* the SVC exception doesn't go through _isr_wrapper */
+#ifdef CONFIG_CPU_LOAD_ISR
+	z_cpu_load_isr_enter();
+#endif
 	offload_routine(offload_param);
+#ifdef CONFIG_CPU_LOAD_ISR
+	z_cpu_load_isr_exit();
+#endif
 }
 
 void arch_irq_offload(irq_offload_routine_t routine, const void *parameter)
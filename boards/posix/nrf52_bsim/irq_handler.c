@@ -86,6 +86,7 @@ static inline void vector_to_irq(int irq_nbr, int *may_swap)
 			  irqnames[irq_nbr]);
 
 	sys_trace_isr_enter();
+	z_cpu_load_isr_enter();
 
 	if (irq_vector_table[irq_nbr].func == NULL) { /* LCOV_EXCL_BR_LINE */
 		/* LCOV_EXCL_START */
@@ -107,6 +108,7 @@ static inline void vector_to_irq(int irq_nbr, int *may_swap)
 		}
 	}
 
+	z_cpu_load_isr_exit();
 	sys_trace_isr_exit();
 
 	bs_trace_raw_time(7, "Irq %i (%s) ended\n", irq_nbr, irqnames[irq_nbr]);
@@ -118,6 +118,11 @@ void z_clock_isr(void *arg)
 	ARG_UNUSED(arg);
 	uint32_t dticks;
 
+#ifdef CONFIG_CPU_LOAD_ISR
+	/* SysTick is vectored here directly, not through _isr_wrapper */
+	z_cpu_load_isr_enter();
+#endif
+
 	/* Update overflow_cyc and clear COUNTFLAG by invoking elapsed() */
 	elapsed();
 
@@ -146,6 +151,10 @@ void z_clock_isr(void *arg)
 	} else {
 		z_clock_announce(1);
 	}
+
+#ifdef CONFIG_CPU_LOAD_ISR
+	z_cpu_load_isr_exit();
+#endif
 	z_arm_int_exit();
 }
 
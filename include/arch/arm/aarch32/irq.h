@@ -135,15 +135,26 @@ extern void sys_trace_isr_enter(void);
 extern void sys_trace_isr_exit(void);
 #endif
 
+#ifdef CONFIG_CPU_LOAD_ISR
+extern void z_cpu_load_isr_enter(void);
+extern void z_cpu_load_isr_exit(void);
+#endif
+
 static inline void arch_isr_direct_header(void)
 {
 #ifdef CONFIG_TRACING
 	sys_trace_isr_enter();
 #endif
+#ifdef CONFIG_CPU_LOAD_ISR
+	z_cpu_load_isr_enter();
+#endif
 }
 
 static inline void arch_isr_direct_footer(int maybe_swap)
 {
+#ifdef CONFIG_CPU_LOAD_ISR
+	z_cpu_load_isr_exit();
+#endif
 #ifdef CONFIG_TRACING
 	sys_trace_isr_exit();
 #endif
@@ -266,11 +266,19 @@ extern void sys_trace_isr_enter(void);
 extern void sys_trace_isr_exit(void);
 #endif
 
+#if defined(CONFIG_CPU_LOAD_ISR)
+extern void z_cpu_load_isr_enter(void);
+extern void z_cpu_load_isr_exit(void);
+#endif
+
 static inline void arch_isr_direct_header(void)
 {
 #if defined(CONFIG_TRACING)
 	sys_trace_isr_enter();
 #endif
+#if defined(CONFIG_CPU_LOAD_ISR)
+	z_cpu_load_isr_enter();
+#endif
 
 	/* We're not going to unlock IRQs, but we still need to increment this
 	 * so that arch_is_in_isr() works
@@ -288,6 +296,9 @@ extern void arch_isr_direct_footer_swap(unsigned int key);
 static inline void arch_isr_direct_footer(int swap)
 {
 	z_irq_controller_eoi();
+#if defined(CONFIG_CPU_LOAD_ISR)
+	z_cpu_load_isr_exit();
+#endif
 #if defined(CONFIG_TRACING)
 	sys_trace_isr_exit();
 #endif
@@ -7,6 +7,7 @@
 #ifndef __STACK_SIZE_ANALYZER_H
 #define __STACK_SIZE_ANALYZER_H
 #include <stddef.h>
+#include <kernel.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,6 +30,10 @@ struct thread_analyzer_info {
 	size_t stack_size;
 	/** Stack size in used */
 	size_t stack_used;
+#ifdef CONFIG_CPU_LOAD
+	/** Load averages of the thread, see k_thread_load_get() */
+	struct k_load_avg load;
+#endif
 };
 
 /** @brief Thread analyzer stack size callback function
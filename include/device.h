@@ -267,6 +267,62 @@ extern "C" {
  */
 #define DEVICE_DECLARE(name) static const struct device DEVICE_NAME_GET(name)
 
+/**
+ * @def DEVICE_INIT_ASYNC
+ *
+ * @brief Let a device be initialized concurrently with the boot
+ *
+ * @details With CONFIG_DEVICE_INIT_ASYNC, the init function of the
+ * device is not called in sequence when its level and priority are
+ * reached, but handed to a pool of worker threads while the boot goes
+ * on.  This is meant for devices with slow, blocking initialization
+ * such as a PHY autonegotiation or a modem power-up.  Only devices at
+ * the POST_KERNEL and APPLICATION levels are affected, devices at the
+ * earlier levels are still initialized in sequence.
+ *
+ * Until its initialization finished the device is not ready.
+ * device_get_binding() on it runs the initialization in the calling
+ * thread if no worker has picked it up yet, or waits for the worker
+ * to finish.  Consumers that hold a direct pointer to the device must
+ * check device_is_ready() before use.
+ *
+ * Devices named in the optional dependency list are looked up with
+ * device_get_binding() before the init function is called, so an
+ * asynchronously initialized dependency is complete by then.  As for
+ * sequential initialization, dependencies must have a lower level or
+ * priority than the device and must not form a cycle.
+ *
+ * Without CONFIG_DEVICE_INIT_ASYNC the macro expands to nothing and
+ * the device is initialized in sequence.
+ *
+ * @param dev_name The dev_name provided to DEVICE_DEFINE(), or the
+ * node_id provided to DEVICE_DT_DEFINE(), in the same file.
+ *
+ * @param ... Names of the devices this one depends on, as passed to
+ * device_get_binding().
+ */
+#define DEVICE_INIT_ASYNC(dev_name, ...) \
+	Z_DEVICE_INIT_ASYNC(dev_name, false, __VA_ARGS__)
+
+/**
+ * @def DEVICE_INIT_DEFERRED
+ *
+ * @brief Defer the initialization of a device until its first use
+ *
+ * @details Like DEVICE_INIT_ASYNC(), except that no worker picks the
+ * device up: the init function runs in the thread which first looks
+ * the device up with device_get_binding().  A device nobody looks up
+ * is never initialized.
+ *
+ * @param dev_name The dev_name provided to DEVICE_DEFINE(), or the
+ * node_id provided to DEVICE_DT_DEFINE(), in the same file.
+ *
+ * @param ... Names of the devices this one depends on, as passed to
+ * device_get_binding().
+ */
+#define DEVICE_INIT_DEFERRED(dev_name, ...) \
+	Z_DEVICE_INIT_ASYNC(dev_name, true, __VA_ARGS__)
+
 typedef void (*device_pm_cb)(const struct device *dev,
 			     int status, void *context, void *arg);
 
@@ -313,6 +369,36 @@ struct device {
 #endif
 };
 
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+/**
+ * @brief Runtime state of an asynchronously initialized device
+ */
+struct device_init_async_data {
+	/** Init entry of the device, set once its init level is reached */
+	const struct init_entry *entry;
+	/** Initialization state, private to the kernel */
+	atomic_t state;
+};
+
+/**
+ * @brief Asynchronous initialization record of a device
+ *
+ * Created by DEVICE_INIT_ASYNC() and DEVICE_INIT_DEFERRED().
+ */
+struct device_init_async {
+	/** The device */
+	const struct device *dev;
+	/** Names of the devices it depends on */
+	const char * const *deps;
+	/** Runtime state */
+	struct device_init_async_data *data;
+	/** Number of entries in @a deps */
+	uint8_t num_deps;
+	/** Initialize on first use rather than by a worker */
+	bool deferred;
+};
+#endif
+
 /**
  * @brief Retrieve the device structure for a driver by name
  *
@@ -710,6 +796,27 @@ static inline int device_pm_put_sync(const struct device *dev) { return -ENOTSUP
 	Z_INIT_ENTRY_DEFINE(_CONCAT(__device_, dev_name), init_fn,	\
 			    (&_CONCAT(__device_, dev_name)), level, prio)
 
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+#define Z_DEVICE_INIT_ASYNC(dev_name, _deferred, ...)			\
+	static struct device_init_async_data				\
+		_CONCAT(__device_async_data_, dev_name);		\
+	static const char * const					\
+		_CONCAT(__device_async_deps_, dev_name)[] = {		\
+		__VA_ARGS__						\
+	};								\
+	static const Z_STRUCT_SECTION_ITERABLE(device_init_async,	\
+		_CONCAT(__device_async_, dev_name)) = {			\
+		.dev = DEVICE_GET(dev_name),				\
+		.deps = _CONCAT(__device_async_deps_, dev_name),	\
+		.data = &_CONCAT(__device_async_data_, dev_name),	\
+		.num_deps = ARRAY_SIZE(					\
+			_CONCAT(__device_async_deps_, dev_name)),	\
+		.deferred = (_deferred),				\
+	}
+#else
+#define Z_DEVICE_INIT_ASYNC(dev_name, _deferred, ...)
+#endif
+
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
 #define Z_DEVICE_DEFINE_PM(dev_name)					\
 	static struct device_pm _CONCAT(__pm_, dev_name) __used  = {	\
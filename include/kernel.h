@@ -23,6 +23,10 @@
 #include <timing/timing.h>
 #endif
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS_GROUP
+#include <stats/stats.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -149,6 +153,9 @@ struct _thread_base {
 	union {
 		sys_dnode_t qnode_dlist;
 		struct rbnode qnode_rb;
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_DEADLINE)
+		struct pheap_node qnode_pheap;
+#endif
 	};
 
 	/* wait queue on which the thread is pended (needed only for
@@ -202,6 +209,11 @@ struct _thread_base {
 	/* CPU index on which thread was last run */
 	uint8_t cpu;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Global enqueue order, to keep FIFO order between run queues */
+	uint32_t runq_seq;
+#endif
+
 	/* Recursive count of irq_lock() calls */
 	uint8_t global_lock_count;
 
@@ -284,6 +296,20 @@ struct z_poller {
 	uint8_t mode;
 };
 
+#ifdef CONFIG_CPU_LOAD
+/** Windows of the CPU load averages */
+enum k_load_window {
+	/** @option{CONFIG_CPU_LOAD_WINDOW_SHORT}, 1 s by default */
+	K_LOAD_WINDOW_SHORT,
+	/** @option{CONFIG_CPU_LOAD_WINDOW_MEDIUM}, 10 s by default */
+	K_LOAD_WINDOW_MEDIUM,
+	/** @option{CONFIG_CPU_LOAD_WINDOW_LONG}, 60 s by default */
+	K_LOAD_WINDOW_LONG,
+
+	K_LOAD_WINDOWS
+};
+#endif
+
 #ifdef CONFIG_THREAD_RUNTIME_STATS
 struct k_thread_runtime_stats {
 	/* Thread execution cycles */
@@ -305,6 +331,17 @@ struct _thread_runtime_stats {
 #endif
 
 	k_thread_runtime_stats_t stats;
+
+#ifdef CONFIG_CPU_LOAD
+	/* odd while the CPU running the thread updates its statistics */
+	atomic_t seq;
+	/* set while the time in progress is accounted to the thread */
+	bool accounting;
+	/* execution cycles at the last load sample */
+	uint64_t sampled_cycles;
+	/* load averages, in fixed point per mille of a CPU */
+	uint32_t load[K_LOAD_WINDOWS];
+#endif
 };
 #endif
 
@@ -355,6 +392,11 @@ struct k_thread {
 
 	/** next item in list of all threads */
 	struct k_thread *next_thread;
+
+	/** k_thread_foreach_unlocked() calls in progress when the thread
+	 * exited, which k_thread_join() must wait for, or 0 if none
+	 */
+	uint32_t monitor_walks;
 #endif
 
 #if defined(CONFIG_THREAD_NAME)
@@ -461,28 +503,26 @@ extern void k_thread_foreach(k_thread_user_cb_t user_cb, void *user_data);
  * @brief Iterate over all the threads in the system without locking.
  *
  * This routine works exactly the same like @ref k_thread_foreach
- * but unlocks interrupts when user_cb is executed.
+ * but doesn't lock interrupts, nor keep threads from being created and
+ * aborted, while it walks the list of threads and user_cb is executed.
  *
  * @param user_cb Pointer to the user callback function.
  * @param user_data Pointer to user data.
  *
  * @note @option{CONFIG_THREAD_MONITOR} must be set for this function
  * to be effective.
- * @note This API uses @ref k_spin_lock only when accessing the _kernel.threads
- * queue elements. It unlocks it during user callback function processing.
+ * @note This API walks the _kernel.threads list in a read-copy-update
+ * read-side critical section (see @ref rcu_apis), so concurrent calls,
+ * on any CPU, don't contend with each other.
  * If a new task is created when this @c foreach function is in progress,
  * the added new task would not be included in the enumeration.
- * If a task is aborted during this enumeration, there would be a race here
- * and there is a possibility that this aborted task would be included in the
- * enumeration.
- * @note If the task is aborted and the memory occupied by its @c k_thread
- * structure is reused when this @c k_thread_foreach_unlocked is in progress
- * it might even lead to the system behave unstable.
- * This function may never return, as it would follow some @c next task
- * pointers treating given pointer as a pointer to the k_thread structure
- * while it is something different right now.
- * Do not reuse the memory that was occupied by k_thread structure of aborted
- * task if it was aborted after this function was called in any context.
+ * If a task is aborted during this enumeration, there is a possibility that
+ * this aborted task would be included in the enumeration.
+ * @note k_thread_join() waits until the calls of this function in progress
+ * have returned, so the memory occupied by the @c k_thread structure of a
+ * task may be reused or freed once k_thread_join() on it has returned, but
+ * not earlier. user_cb may only call k_thread_join() with K_NO_WAIT: a
+ * waiting call could wait for the very walk it is called from to end.
  */
 extern void k_thread_foreach_unlocked(
 	k_thread_user_cb_t user_cb, void *user_data);
@@ -711,10 +751,17 @@ void k_thread_system_pool_assign(struct k_thread *thread);
  *
  * This API may only be called from ISRs with a K_NO_WAIT timeout.
  *
+ * With @option{CONFIG_THREAD_MONITOR}, if calls of
+ * k_thread_foreach_unlocked() were in progress when the target thread
+ * exited, this API also waits for them to return, after which the target
+ * thread's object may be freed or reused.  With a K_NO_WAIT timeout it
+ * returns -EBUSY instead of waiting for them, until they have returned.
+ *
  * @param thread Thread to wait to exit
  * @param timeout upper bound time to wait for the thread to exit.
  * @retval 0 success, target thread has exited or wasn't running
- * @retval -EBUSY returned without waiting
+ * @retval -EBUSY returned without waiting, target thread is running or
+ *                may still be referenced by k_thread_foreach_unlocked()
  * @retval -EAGAIN waiting period timed out
  * @retval -EDEADLK target thread is joining on the caller, or target thread
  *                  is the caller
@@ -1930,6 +1977,12 @@ struct k_queue {
 	_POLL_EVENT;
 	_OBJECT_TRACING_NEXT_PTR(k_queue)
 	_OBJECT_TRACING_LINKED_FLAG
+#ifdef CONFIG_FIFO_MPSC
+	/* Single consumer mode, see queue.c */
+	sys_sfnode_t mpsc_stub;
+	atomic_t mpsc_waiting;
+	bool mpsc;
+#endif
 };
 
 #define Z_QUEUE_INITIALIZER(obj) \
@@ -1941,6 +1994,20 @@ struct k_queue {
 	_OBJECT_TRACING_INIT \
 	}
 
+#ifdef CONFIG_FIFO_MPSC
+#define Z_QUEUE_MPSC_INITIALIZER(obj) \
+	{ \
+	.data_q = { &obj.mpsc_stub, &obj.mpsc_stub }, \
+	.lock = { }, \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q),	\
+	_POLL_EVENT_OBJ_INIT(obj)		\
+	_OBJECT_TRACING_INIT \
+	.mpsc = true, \
+	}
+
+extern sys_sfnode_t *z_queue_mpsc_peek(struct k_queue *queue, bool head);
+#endif
+
 extern void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free);
 
 /**
@@ -1964,6 +2031,28 @@ extern void *z_queue_node_peek(sys_sfnode_t *node, bool needs_free);
  */
 __syscall void k_queue_init(struct k_queue *queue);
 
+#if defined(CONFIG_FIFO_MPSC) || defined(__DOXYGEN__)
+/**
+ * @brief Initialize a queue with a single consumer.
+ *
+ * This routine initializes a queue object, prior to its first use, for
+ * use by a single consumer thread.  Any number of threads and ISRs can
+ * append data items to it without taking a lock, and the kernel is only
+ * entered to wake the consumer when it waits on an empty queue.
+ *
+ * Only k_queue_get() by the consumer, k_queue_append(),
+ * k_queue_alloc_append(), k_queue_append_list(), k_queue_merge_slist()
+ * and k_queue_cancel_wait() are supported, k_queue_is_empty(),
+ * k_queue_peek_head() and k_queue_peek_tail() only by the consumer.
+ * Such a queue can not be used with k_poll().
+ *
+ * @param queue Address of the queue.
+ *
+ * @return N/A
+ */
+void k_queue_init_mpsc(struct k_queue *queue);
+#endif
+
 /**
  * @brief Cancel waiting on a queue.
  *
@@ -2185,6 +2274,11 @@ __syscall int k_queue_is_empty(struct k_queue *queue);
 
 static inline int z_impl_k_queue_is_empty(struct k_queue *queue)
 {
+#ifdef CONFIG_FIFO_MPSC
+	if (queue->mpsc) {
+		return z_queue_mpsc_peek(queue, true) == NULL;
+	}
+#endif
 	return (int)sys_sflist_is_empty(&queue->data_q);
 }
 
@@ -2201,6 +2295,11 @@ __syscall void *k_queue_peek_head(struct k_queue *queue);
 
 static inline void *z_impl_k_queue_peek_head(struct k_queue *queue)
 {
+#ifdef CONFIG_FIFO_MPSC
+	if (queue->mpsc) {
+		return z_queue_node_peek(z_queue_mpsc_peek(queue, true), false);
+	}
+#endif
 	return z_queue_node_peek(sys_sflist_peek_head(&queue->data_q), false);
 }
 
@@ -2217,6 +2316,12 @@ __syscall void *k_queue_peek_tail(struct k_queue *queue);
 
 static inline void *z_impl_k_queue_peek_tail(struct k_queue *queue)
 {
+#ifdef CONFIG_FIFO_MPSC
+	if (queue->mpsc) {
+		return z_queue_node_peek(z_queue_mpsc_peek(queue, false),
+					 false);
+	}
+#endif
 	return z_queue_node_peek(sys_sflist_peek_tail(&queue->data_q), false);
 }
 
@@ -2325,6 +2430,13 @@ struct k_fifo {
 	._queue = Z_QUEUE_INITIALIZER(obj._queue) \
 	}
 
+#ifdef CONFIG_FIFO_MPSC
+#define Z_FIFO_MPSC_INITIALIZER(obj) \
+	{ \
+	._queue = Z_QUEUE_MPSC_INITIALIZER(obj._queue) \
+	}
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -2347,6 +2459,22 @@ struct k_fifo {
 #define k_fifo_init(fifo) \
 	k_queue_init(&(fifo)->_queue)
 
+/**
+ * @brief Initialize a FIFO queue with a single consumer.
+ *
+ * This routine initializes a FIFO queue, prior to its first use, for
+ * use by a single consumer thread, see k_queue_init_mpsc().  Putting
+ * data items to it and getting them while it is not empty is lock-free.
+ *
+ * This macro is only available with CONFIG_FIFO_MPSC.
+ *
+ * @param fifo Address of the FIFO queue.
+ *
+ * @return N/A
+ */
+#define k_fifo_init_mpsc(fifo) \
+	k_queue_init_mpsc(&(fifo)->_queue)
+
 /**
  * @brief Cancel waiting on a FIFO queue.
  *
@@ -2513,6 +2641,20 @@ struct k_fifo {
 	Z_STRUCT_SECTION_ITERABLE_ALTERNATE(k_queue, k_fifo, name) = \
 		Z_FIFO_INITIALIZER(name)
 
+/**
+ * @brief Statically define and initialize a FIFO queue with a single
+ * consumer.
+ *
+ * Same as K_FIFO_DEFINE(), for a FIFO queue initialized as by
+ * k_fifo_init_mpsc().  This macro is only available with
+ * CONFIG_FIFO_MPSC.
+ *
+ * @param name Name of the FIFO queue.
+ */
+#define K_FIFO_MPSC_DEFINE(name) \
+	Z_STRUCT_SECTION_ITERABLE_ALTERNATE(k_queue, k_fifo, name) = \
+		Z_FIFO_MPSC_INITIALIZER(name)
+
 /** @} */
 
 struct k_lifo {
@@ -2775,6 +2917,75 @@ struct k_work;
  */
 typedef void (*k_work_handler_t)(struct k_work *work);
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+#ifdef CONFIG_WORKQUEUE_POOL
+struct k_work_q_worker {
+	struct k_thread thread;
+	struct k_work_q *work_q;
+	/* work item being handled, or NULL */
+	struct k_work *current;
+	/* resubmissions of the current item, taken by other workers */
+	sys_slist_t deferred;
+	uint32_t handled;
+	uint32_t max_cycles;
+	uint64_t cycles;
+};
+#endif
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+#if defined(CONFIG_WORKQUEUE_RUNTIME_STATS) || defined(__DOXYGEN__)
+/** Number of buckets of the workqueue latency histograms. */
+#define K_WORK_Q_LATENCY_BUCKETS 16
+
+/**
+ * @brief Workqueue runtime statistics
+ */
+struct k_work_q_runtime_stats {
+	/** Work items submitted. */
+	uint32_t submitted;
+	/** Handlers run. */
+	uint32_t handled;
+	/** Work items submitted and not yet taken by a thread. */
+	uint32_t depth;
+	/** High water mark of depth. */
+	uint32_t max_depth;
+	/** Longest time from submission to handler start, in microseconds. */
+	uint32_t max_latency_us;
+	/**
+	 * Histogram of the times from submission to handler start. Bucket 0
+	 * counts the times below 1 us, bucket i those from 2^(i-1) us to
+	 * 2^i us, and the last bucket all the longer ones.
+	 */
+	uint32_t latency_hist[K_WORK_Q_LATENCY_BUCKETS];
+	/** Longest handler run, in cycles. */
+	uint32_t max_handler_cycles;
+	/** Time spent in handlers, in cycles. */
+	uint64_t handler_cycles;
+};
+
+/**
+ * @brief Runtime statistics of a work handler on a workqueue
+ */
+struct k_work_handler_stats {
+	/** Workqueue the handler ran on. */
+	struct k_work_q *work_q;
+	/** Handler. */
+	k_work_handler_t handler;
+	/** Times the handler ran. */
+	uint32_t count;
+	/** Longest run, in cycles. */
+	uint32_t max_cycles;
+	/** Time spent in the handler, in cycles. */
+	uint64_t cycles;
+};
+#endif /* CONFIG_WORKQUEUE_RUNTIME_STATS */
+
 /**
  * @cond INTERNAL_HIDDEN
  */
@@ -2782,6 +2993,18 @@ typedef void (*k_work_handler_t)(struct k_work *work);
 struct k_work_q {
 	struct k_queue queue;
 	struct k_thread thread;
+#ifdef CONFIG_WORKQUEUE_POOL
+	/* NULL unless started with k_work_q_pool_start() */
+	struct k_work_q_worker *workers;
+	int num_workers;
+	struct k_spinlock lock;
+#endif
+#ifdef CONFIG_WORKQUEUE_RUNTIME_STATS
+	/* only kernel mode workqueues are instrumented */
+	bool stats_enabled;
+	sys_snode_t stats_node;
+	struct k_work_q_runtime_stats stats;
+#endif
 };
 
 enum {
@@ -2792,8 +3015,18 @@ struct k_work {
 	void *_reserved;		/* Used by k_queue implementation. */
 	k_work_handler_t handler;
 	atomic_t flags[1];
+#ifdef CONFIG_WORKQUEUE_RUNTIME_STATS
+	uint32_t _submitted_at;	/* Cycle count when last submitted */
+#endif
 };
 
+#ifdef CONFIG_WORKQUEUE_RUNTIME_STATS
+extern void z_work_q_stats_submit(struct k_work_q *work_q,
+				  struct k_work *work);
+#else
+#define z_work_q_stats_submit(work_q, work) do { } while (false)
+#endif
+
 struct k_delayed_work {
 	struct k_work work;
 	struct _timeout timeout;
@@ -2878,6 +3111,7 @@ static inline void k_work_submit_to_queue(struct k_work_q *work_q,
 					  struct k_work *work)
 {
 	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+		z_work_q_stats_submit(work_q, work);
 		k_queue_append(&work_q->queue, work);
 	}
 }
@@ -3004,6 +3238,171 @@ extern void k_work_q_user_start(struct k_work_q *work_q,
 				k_thread_stack_t *stack,
 				size_t stack_size, int prio);
 
+/**
+ * @brief Check whether the caller runs on a workqueue.
+ *
+ * Tells whether the calling thread is the thread of @a work_q, or one of
+ * its workers if it was started with k_work_q_pool_start(). Use this
+ * rather than comparing k_current_get() with the thread member of
+ * @a work_q, which a pool doesn't use.
+ *
+ * @param work_q Address of a started workqueue.
+ *
+ * @return true if the caller is a thread of @a work_q, false otherwise.
+ */
+static inline bool k_work_q_is_current(struct k_work_q *work_q)
+{
+	k_tid_t current = k_current_get();
+
+#ifdef CONFIG_WORKQUEUE_POOL
+	if (work_q->workers != NULL) {
+		for (int i = 0; i < work_q->num_workers; i++) {
+			if (current == &work_q->workers[i].thread) {
+				return true;
+			}
+		}
+		return false;
+	}
+#endif
+
+	return current == &work_q->thread;
+}
+
+#if defined(CONFIG_WORKQUEUE_POOL) || defined(__DOXYGEN__)
+/** Pin the workers of a workqueue pool, one per CPU in turn. */
+#define K_WORK_Q_POOL_PIN BIT(0)
+
+/**
+ * @brief Workqueue pool statistics
+ */
+struct k_work_q_pool_stats {
+	/** Work items submitted and not yet taken by a worker. */
+	uint32_t depth;
+	/** Workers running a handler. */
+	uint32_t busy;
+	/** Handlers run since the pool was started. */
+	uint32_t handled;
+	/** Longest handler run, in cycles. */
+	uint32_t max_handler_cycles;
+	/** Time spent in handlers, in cycles. */
+	uint64_t handler_cycles;
+};
+
+/**
+ * @brief Start a workqueue served by a pool of threads.
+ *
+ * This routine starts workqueue @a work_q like k_work_q_start(), except
+ * that @a num_workers threads take work items from it, so that a slow
+ * handler only holds up one of them. Work items are submitted, delayed
+ * and cancelled as for any other workqueue, and are taken by whichever
+ * worker is idle first.
+ *
+ * Different work items may run concurrently, but a work item never runs
+ * concurrently with itself: if it is resubmitted while its handler runs,
+ * the worker running it runs it again once the handler returns.
+ *
+ * With @ref K_WORK_Q_POOL_PIN and @option{CONFIG_SCHED_CPU_MASK}, worker
+ * @p i only runs on CPU @p i modulo the number of CPUs. The option is
+ * ignored otherwise.
+ *
+ * @note The thread member of @a work_q is not used by a pool.
+ *
+ * @param work_q Address of workqueue.
+ * @param workers Array of @a num_workers worker objects.
+ * @param stacks Array of @a num_workers stacks, as defined by
+ *		K_KERNEL_STACK_ARRAY_DEFINE()
+ * @param stack_size Size of each stack, the same constant passed to
+ *		K_KERNEL_STACK_ARRAY_DEFINE().
+ * @param num_workers Number of threads.
+ * @param prio Priority of the threads.
+ * @param options K_WORK_Q_POOL_* options.
+ *
+ * @return N/A
+ */
+extern void k_work_q_pool_start(struct k_work_q *work_q,
+				struct k_work_q_worker *workers,
+				k_thread_stack_t *stacks, size_t stack_size,
+				int num_workers, int prio, uint32_t options);
+
+/**
+ * @brief Get the statistics of a workqueue pool.
+ *
+ * The queue depth is counted when called, so this routine takes time
+ * proportional to the number of work items queued.
+ *
+ * @param work_q Address of a workqueue started with k_work_q_pool_start().
+ * @param stats Statistics, filled in on return.
+ *
+ * @retval 0 Statistics retrieved.
+ * @retval -EINVAL @a work_q is not a workqueue pool.
+ */
+extern int k_work_q_pool_stats_get(struct k_work_q *work_q,
+				   struct k_work_q_pool_stats *stats);
+#endif /* CONFIG_WORKQUEUE_POOL */
+
+#if defined(CONFIG_WORKQUEUE_RUNTIME_STATS) || defined(__DOXYGEN__)
+/**
+ * @brief Get the runtime statistics of a workqueue.
+ *
+ * Statistics are kept for workqueues started with k_work_q_start() or
+ * k_work_q_pool_start(), but not for those running in user mode.
+ *
+ * @param work_q Address of workqueue.
+ * @param stats Statistics, filled in on return.
+ *
+ * @retval 0 Statistics retrieved.
+ * @retval -EINVAL No statistics are kept for @a work_q.
+ */
+extern int k_work_q_runtime_stats_get(struct k_work_q *work_q,
+				      struct k_work_q_runtime_stats *stats);
+
+/**
+ * @brief Reset the runtime statistics of a workqueue.
+ *
+ * Clears all the statistics of @a work_q, and of the handlers run by it,
+ * except its current depth, which becomes the new high water mark.
+ *
+ * @param work_q Address of workqueue.
+ *
+ * @return N/A
+ */
+extern void k_work_q_runtime_stats_reset(struct k_work_q *work_q);
+
+typedef void (*k_work_q_user_cb_t)(struct k_work_q *work_q,
+				   void *user_data);
+
+/**
+ * @brief Iterate over the workqueues statistics are kept for.
+ *
+ * @a user_cb is called without holding any lock, and may get or reset
+ * the statistics of the workqueue.
+ *
+ * @param user_cb Callback invoked for each workqueue.
+ * @param user_data Passed to @a user_cb.
+ *
+ * @return N/A
+ */
+extern void k_work_q_foreach(k_work_q_user_cb_t user_cb, void *user_data);
+
+typedef void (*k_work_handler_stats_cb_t)(
+	const struct k_work_handler_stats *stats, void *user_data);
+
+/**
+ * @brief Iterate over the runtime statistics of work handlers.
+ *
+ * Statistics are kept for the first
+ * @option{CONFIG_WORKQUEUE_RUNTIME_STATS_HANDLERS} pairs of workqueue
+ * and handler seen, only the workqueue statistics account for the others.
+ *
+ * @param user_cb Callback invoked with a copy of each handler statistics.
+ * @param user_data Passed to @a user_cb.
+ *
+ * @return N/A
+ */
+extern void k_work_handler_stats_foreach(k_work_handler_stats_cb_t user_cb,
+					 void *user_data);
+#endif /* CONFIG_WORKQUEUE_RUNTIME_STATS */
+
 #define Z_DELAYED_WORK_INITIALIZER(work_handler) \
 	{ \
 		.work = Z_WORK_INITIALIZER(work_handler), \
@@ -3463,6 +3862,171 @@ __syscall int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout);
  */
 __syscall int k_mutex_unlock(struct k_mutex *mutex);
 
+/**
+ * @}
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+#if defined(CONFIG_SMP) && (CONFIG_MP_NUM_CPUS > 1)
+#define Z_RWLOCK_READER_SLOTS CONFIG_MP_NUM_CPUS
+#else
+#define Z_RWLOCK_READER_SLOTS 1
+#endif
+
+/* Readers counted on one CPU, padded to a typical cache line on SMP so
+ * that readers on different CPUs don't write to the same line.
+ */
+struct z_rwlock_readers {
+	atomic_t count;
+#if Z_RWLOCK_READER_SLOTS > 1
+	uint8_t pad[64 - sizeof(atomic_t)];
+#endif
+};
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup rwlock_apis Reader-Writer Lock APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * Reader-writer lock structure
+ */
+struct k_rwlock {
+	/** Readers holding the lock, counted per CPU */
+	struct z_rwlock_readers readers[Z_RWLOCK_READER_SLOTS];
+	/** Set while a writer owns the lock or waits for readers to leave */
+	atomic_t writing;
+	/** Writer owning the lock or waiting for readers to leave */
+	struct k_thread *writer;
+	struct k_spinlock lock;
+	/** Readers waiting for writers to finish */
+	_wait_q_t read_q;
+	/** Writers waiting for the owning writer */
+	_wait_q_t write_q;
+	/** Writer waiting for readers to leave */
+	_wait_q_t drain_q;
+};
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+#define Z_RWLOCK_INITIALIZER(obj) \
+	{ \
+	.writing = ATOMIC_INIT(0), \
+	.writer = NULL, \
+	.read_q = Z_WAIT_Q_INIT(&obj.read_q), \
+	.write_q = Z_WAIT_Q_INIT(&obj.write_q), \
+	.drain_q = Z_WAIT_Q_INIT(&obj.drain_q), \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Statically define and initialize a reader-writer lock.
+ *
+ * The lock can be accessed outside the module where it is defined using:
+ *
+ * @code extern struct k_rwlock <name>; @endcode
+ *
+ * @param name Name of the reader-writer lock.
+ */
+#define K_RWLOCK_DEFINE(name) \
+	Z_STRUCT_SECTION_ITERABLE(k_rwlock, name) = \
+		Z_RWLOCK_INITIALIZER(name)
+
+/**
+ * @brief Initialize a reader-writer lock.
+ *
+ * This routine initializes a reader-writer lock, prior to its first use.
+ * The lock is initially not held.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @retval 0 Reader-writer lock initialized.
+ */
+__syscall int k_rwlock_init(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader-writer lock for reading.
+ *
+ * This routine locks @a rwlock for reading. Any number of threads can hold
+ * the lock for reading at a time. If a writer holds the lock, or waits for
+ * it, the calling thread waits until the writers are done or until a
+ * timeout occurs: writers take precedence over new readers.
+ *
+ * Locking for reading doesn't touch data shared with readers on other CPUs
+ * unless a writer is involved, so readers on different CPUs don't contend.
+ *
+ * A thread holding the lock for reading must not lock it for reading again,
+ * as it could wait behind a writer which waits for it to unlock. There is no
+ * priority inheritance. Reader-writer locks may not be used in ISRs.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the reader-writer lock,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Locked for reading.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_rwlock_read_lock(struct k_rwlock *rwlock,
+				 k_timeout_t timeout);
+
+/**
+ * @brief Unlock a reader-writer lock locked for reading.
+ *
+ * The calling thread must hold @a rwlock for reading.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ */
+__syscall void k_rwlock_read_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader-writer lock for writing.
+ *
+ * This routine locks @a rwlock for writing, excluding all other readers
+ * and writers. The calling thread waits until the lock is free or until a
+ * timeout occurs. Once it is next in line, no new readers are let in while
+ * it waits for the current ones to unlock.
+ *
+ * The lock is not recursive, and there is no priority inheritance.
+ * Reader-writer locks may not be used in ISRs.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the reader-writer lock,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Locked for writing.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EDEADLK The calling thread already holds the lock for writing.
+ */
+__syscall int k_rwlock_write_lock(struct k_rwlock *rwlock,
+				  k_timeout_t timeout);
+
+/**
+ * @brief Unlock a reader-writer lock locked for writing.
+ *
+ * The lock is handed over to the next waiting writer, if any, or else to
+ * all waiting readers.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @retval 0 Unlocked.
+ * @retval -EPERM The calling thread does not hold the lock for writing.
+ */
+__syscall int k_rwlock_write_unlock(struct k_rwlock *rwlock);
+
 /**
  * @}
  */
@@ -3616,6 +4180,8 @@ static inline unsigned int z_impl_k_sem_count_get(struct k_sem *sem)
 struct k_msgq {
 	/** Message queue wait queue */
 	_wait_q_t wait_q;
+	/** Threads waiting to claim a slot */
+	_wait_q_t claim_wait_q;
 	/** Lock */
 	struct k_spinlock lock;
 	/** Message size */
@@ -3647,6 +4213,7 @@ struct k_msgq {
 #define Z_MSGQ_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs) \
 	{ \
 	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	.claim_wait_q = Z_WAIT_Q_INIT(&obj.claim_wait_q), \
 	.msg_size = q_msg_size, \
 	.max_msgs = q_max_msgs, \
 	.buffer_start = q_buffer, \
@@ -3663,6 +4230,8 @@ struct k_msgq {
 
 
 #define K_MSGQ_FLAG_ALLOC	BIT(0)
+#define K_MSGQ_FLAG_PUT_CLAIMED	BIT(1)
+#define K_MSGQ_FLAG_GET_CLAIMED	BIT(2)
 
 /**
  * @brief Message Queue Attributes
@@ -3782,29 +4351,173 @@ int k_msgq_cleanup(struct k_msgq *msgq);
 __syscall int k_msgq_put(struct k_msgq *msgq, const void *data, k_timeout_t timeout);
 
 /**
- * @brief Receive a message from a message queue.
+ * @brief Send several messages to a message queue.
  *
- * This routine receives a message from message queue @a q in a "first in,
- * first out" manner.
+ * This routine sends up to @a num_msgs consecutive messages from @a data
+ * to message queue @a msgq, taking the queue lock once and rescheduling
+ * at most once for the whole batch.  Messages are handed to waiting
+ * receivers first, the rest go into the ring buffer until it is full.
+ *
+ * If no message at all can be sent immediately, the routine waits as
+ * k_msgq_put() does for the first message and then returns.
  *
  * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
  *
  * @param msgq Address of the message queue.
- * @param data Address of area to hold the received message.
- * @param timeout Waiting period to receive the message,
+ * @param data Pointer to an array of @a num_msgs messages.
+ * @param num_msgs Number of messages to send.
+ * @param timeout Waiting period to send the first message,
  *                or one of the special values K_NO_WAIT and
  *                K_FOREVER.
  *
- * @retval 0 Message received.
- * @retval -ENOMSG Returned without waiting.
+ * @return Number of messages sent if at least one was sent.
+ * @retval -ENOMSG Returned without waiting or queue purged.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A slot claimed by k_msgq_put_claim() is not committed.
  */
-__syscall int k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout);
+__syscall int k_msgq_put_batch(struct k_msgq *msgq, const void *data,
+			       uint32_t num_msgs, k_timeout_t timeout);
 
 /**
- * @brief Peek/read a message from a message queue.
+ * @brief Receive a message from a message queue.
  *
- * This routine reads a message from message queue @a q in a "first in,
+ * This routine receives a message from message queue @a q in a "first in,
+ * first out" manner.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param msgq Address of the message queue.
+ * @param data Address of area to hold the received message.
+ * @param timeout Waiting period to receive the message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Message received.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout);
+
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * This routine receives up to @a num_msgs messages from message queue
+ * @a msgq into consecutive slots of @a data, taking the queue lock once
+ * and rescheduling at most once for the whole batch.  Each slot freed
+ * in the ring buffer takes the message of a waiting sender, if any.
+ *
+ * If the queue is empty, the routine waits as k_msgq_get() does for a
+ * single message and then returns.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param msgq Address of the message queue.
+ * @param data Address of an area to hold @a num_msgs messages.
+ * @param num_msgs Maximum number of messages to receive.
+ * @param timeout Waiting period to receive the first message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @return Number of messages received if at least one was received.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A message claimed by k_msgq_get_claim() is not committed.
+ */
+__syscall int k_msgq_get_batch(struct k_msgq *msgq, void *data,
+			       uint32_t num_msgs, k_timeout_t timeout);
+
+/**
+ * @brief Claim a free slot of a message queue to write a message in place.
+ *
+ * This routine hands out a pointer to the next free slot of the ring
+ * buffer of @a msgq, so that the caller can build the message there
+ * rather than in a buffer of its own.  The message is sent by
+ * k_msgq_put_commit().
+ *
+ * Only one slot can be claimed for sending at a time.  Until it is
+ * committed, the other routines sending to the queue fail with -EBUSY,
+ * so this is meant for queues with a single sender.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ * @note Not available to user mode threads, since the slot lives in
+ * kernel memory.
+ *
+ * @param msgq Address of the message queue.
+ * @param slot Set to the address of the claimed slot.
+ * @param timeout Waiting period for a free slot,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Slot claimed.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another slot is already claimed for sending.
+ */
+int k_msgq_put_claim(struct k_msgq *msgq, void **slot, k_timeout_t timeout);
+
+/**
+ * @brief Send the message written in a claimed slot.
+ *
+ * This routine sends the message built in the slot obtained from
+ * k_msgq_put_claim().  If a receiver is waiting, the message is copied
+ * to it, otherwise it stays in the ring buffer in place.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param msgq Address of the message queue.
+ *
+ * @retval 0 Message sent.
+ * @retval -EINVAL No slot is claimed for sending.
+ */
+int k_msgq_put_commit(struct k_msgq *msgq);
+
+/**
+ * @brief Claim the next message of a message queue to read it in place.
+ *
+ * This routine hands out a pointer to the oldest message in the ring
+ * buffer of @a msgq, which the caller can read without copying it out.
+ * The message stays in the queue until released by k_msgq_get_commit().
+ *
+ * Only one message can be claimed for receiving at a time.  Until it is
+ * committed, the other routines receiving from the queue fail with
+ * -EBUSY, so this is meant for queues with a single receiver.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ * @note Not available to user mode threads, since the slot lives in
+ * kernel memory.
+ *
+ * @param msgq Address of the message queue.
+ * @param slot Set to the address of the claimed message.
+ * @param timeout Waiting period for a message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Message claimed.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another message is already claimed for receiving.
+ */
+int k_msgq_get_claim(struct k_msgq *msgq, void **slot, k_timeout_t timeout);
+
+/**
+ * @brief Release a message claimed for receiving.
+ *
+ * This routine removes the message obtained from k_msgq_get_claim()
+ * from the queue, making its slot available to senders again.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param msgq Address of the message queue.
+ *
+ * @retval 0 Message released.
+ * @retval -EINVAL No message is claimed for receiving.
+ */
+int k_msgq_get_commit(struct k_msgq *msgq);
+
+/**
+ * @brief Peek/read a message from a message queue.
+ *
+ * This routine reads a message from message queue @a q in a "first in,
  * first out" manner and leaves the message in the queue.
  *
  * @note Can be called by ISRs.
@@ -3822,7 +4535,8 @@ __syscall int k_msgq_peek(struct k_msgq *msgq, void *data);
  *
  * This routine discards all unreceived messages in a message queue's ring
  * buffer. Any threads that are blocked waiting to send a message to the
- * message queue are unblocked and see an -ENOMSG error code.
+ * message queue are unblocked and see an -ENOMSG error code.  A message
+ * claimed with k_msgq_get_claim() is discarded as well.
  *
  * @param msgq Address of the message queue.
  *
@@ -4095,9 +4809,13 @@ struct k_pipe {
 	size_t         write_index;     /**< Where in buffer to write */
 	struct k_spinlock lock;		/**< Synchronization lock */
 
+	size_t         put_claimed;     /**< # bytes claimed for writing */
+	size_t         get_claimed;     /**< # bytes claimed for reading */
+
 	struct {
 		_wait_q_t      readers; /**< Reader wait queue */
 		_wait_q_t      writers; /**< Writer wait queue */
+		_wait_q_t      claims;  /**< Claiming threads wait queue */
 	} wait_q;			/** Wait queue */
 
 	_OBJECT_TRACING_NEXT_PTR(k_pipe)
@@ -4105,6 +4823,12 @@ struct k_pipe {
 	uint8_t	       flags;		/**< Flags */
 };
 
+/** Segment of data for k_pipe_writev() and k_pipe_readv() */
+struct k_pipe_iovec {
+	void  *iov_base;	/**< Address of the segment */
+	size_t iov_len;		/**< Size of the segment (in bytes) */
+};
+
 /**
  * @cond INTERNAL_HIDDEN
  */
@@ -4118,9 +4842,12 @@ struct k_pipe {
 	.read_index = 0,                                            \
 	.write_index = 0,                                           \
 	.lock = {},                                                 \
+	.put_claimed = 0,                                           \
+	.get_claimed = 0,                                           \
 	.wait_q = {                                                 \
 		.readers = Z_WAIT_Q_INIT(&obj.wait_q.readers),       \
-		.writers = Z_WAIT_Q_INIT(&obj.wait_q.writers)        \
+		.writers = Z_WAIT_Q_INIT(&obj.wait_q.writers),       \
+		.claims = Z_WAIT_Q_INIT(&obj.wait_q.claims)          \
 	},                                                          \
 	_OBJECT_TRACING_INIT                                        \
 	.flags = 0                                                  \
@@ -4211,6 +4938,7 @@ __syscall int k_pipe_alloc_init(struct k_pipe *pipe, size_t size);
  * @retval -EIO Returned without waiting; zero data bytes were written.
  * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
  *                 minus one data bytes were written.
+ * @retval -EBUSY A region claimed by k_pipe_put_claim() is not committed.
  */
 __syscall int k_pipe_put(struct k_pipe *pipe, void *data,
 			 size_t bytes_to_write, size_t *bytes_written,
@@ -4234,11 +4962,71 @@ __syscall int k_pipe_put(struct k_pipe *pipe, void *data,
  * @retval -EIO Returned without waiting; zero data bytes were read.
  * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
  *                 minus one data bytes were read.
+ * @retval -EBUSY A region claimed by k_pipe_get_claim() is not released.
  */
 __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 			 size_t bytes_to_read, size_t *bytes_read,
 			 size_t min_xfer, k_timeout_t timeout);
 
+/**
+ * @brief Write data gathered from several segments to a pipe.
+ *
+ * This routine works like k_pipe_put() on the data of the @a iovcnt
+ * segments of @a iov, one after the other, e.g. a header, a payload and a
+ * trailer.  The data is transferred in a single call: no other writer
+ * can interleave data between the segments, and each waiting reader is
+ * woken up once.
+ *
+ * @param pipe Address of the pipe.
+ * @param iov Array of the segments to write.
+ * @param iovcnt Number of segments.
+ * @param bytes_written Address of area to hold the number of bytes written.
+ * @param min_xfer Minimum number of bytes to write.
+ * @param timeout Waiting period to wait for the data to be written,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 At least @a min_xfer bytes of data were written.
+ * @retval -EINVAL invalid parameters supplied
+ * @retval -ENOMEM no memory to copy the segments of a user mode thread
+ * @retval -EIO Returned without waiting; zero data bytes were written.
+ * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
+ *                 minus one data bytes were written.
+ * @retval -EBUSY A region claimed by k_pipe_put_claim() is not committed.
+ */
+__syscall int k_pipe_writev(struct k_pipe *pipe,
+			    const struct k_pipe_iovec *iov, size_t iovcnt,
+			    size_t *bytes_written, size_t min_xfer,
+			    k_timeout_t timeout);
+
+/**
+ * @brief Read data from a pipe, scattering it to several segments.
+ *
+ * This routine works like k_pipe_get(), filling the @a iovcnt segments of
+ * @a iov one after the other, e.g. a header and a payload.  The data is
+ * transferred in a single call: no other reader can take data between
+ * the segments, and each waiting writer is woken up once.
+ *
+ * @param pipe Address of the pipe.
+ * @param iov Array of the segments to fill.
+ * @param iovcnt Number of segments.
+ * @param bytes_read Address of area to hold the number of bytes read.
+ * @param min_xfer Minimum number of data bytes to read.
+ * @param timeout Waiting period to wait for the data to be read,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 At least @a min_xfer bytes of data were read.
+ * @retval -EINVAL invalid parameters supplied
+ * @retval -ENOMEM no memory to copy the segments of a user mode thread
+ * @retval -EIO Returned without waiting; zero data bytes were read.
+ * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
+ *                 minus one data bytes were read.
+ * @retval -EBUSY A region claimed by k_pipe_get_claim() is not released.
+ */
+__syscall int k_pipe_readv(struct k_pipe *pipe,
+			   const struct k_pipe_iovec *iov, size_t iovcnt,
+			   size_t *bytes_read, size_t min_xfer,
+			   k_timeout_t timeout);
+
 /**
  * @brief Write memory block to a pipe.
  *
@@ -4246,6 +5034,10 @@ __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
  * Once all of the data in the block has been written to the pipe, it will
  * free the memory block @a block and give the semaphore @a sem (if specified).
  *
+ * If a region of @a pipe is claimed with k_pipe_put_claim(), none of the
+ * data is written: the memory block is freed and @a sem given at once.
+ * This is a usage error that is also caught by an assertion.
+ *
  * @param pipe Address of the pipe.
  * @param block Memory block containing data to send
  * @param size Number of data bytes in memory block to send
@@ -4256,6 +5048,102 @@ __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 			     size_t size, struct k_sem *sem);
 
+/**
+ * @brief Claim free space of a pipe to write data in place.
+ *
+ * This routine hands out the contiguous free region of the ring buffer
+ * of @a pipe that follows the data already in it, so that the caller can
+ * produce data there rather than in a buffer of its own.  The data is
+ * sent by k_pipe_put_commit().  The region ends at the end of the ring
+ * buffer, so it may be smaller than the free space of the pipe.
+ *
+ * Only one region can be claimed for writing at a time.  Until it is
+ * committed, k_pipe_put() fails with -EBUSY, so this is meant for pipes
+ * with a single writer.  A pipe with a pending claim must not be given
+ * to k_pipe_block_put().
+ *
+ * @note Not available to user mode threads, since the region lives in
+ * kernel memory.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Set to the address of the claimed region.
+ * @param size On entry, the maximum number of bytes to claim.  On return,
+ *             the number of bytes claimed, at least one.
+ * @param timeout Waiting period for free space,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Region claimed.
+ * @retval -EINVAL @a pipe has no ring buffer or @a size is zero.
+ * @retval -EIO Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another region is already claimed for writing.
+ */
+int k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     k_timeout_t timeout);
+
+/**
+ * @brief Send data written in a claimed region of a pipe.
+ *
+ * This routine sends the first @a bytes bytes of the region obtained from
+ * k_pipe_put_claim() and releases the rest of the claim.  If readers are
+ * waiting, the data is copied to them, otherwise it stays in the ring
+ * buffer in place.
+ *
+ * @param pipe Address of the pipe.
+ * @param bytes Number of bytes written, at most the size of the claim.
+ *
+ * @retval 0 Data sent.
+ * @retval -EINVAL No region is claimed for writing, or @a bytes exceeds it.
+ */
+int k_pipe_put_commit(struct k_pipe *pipe, size_t bytes);
+
+/**
+ * @brief Claim data of a pipe to read it in place.
+ *
+ * This routine hands out the contiguous region of the ring buffer of
+ * @a pipe that holds the oldest data, which the caller can consume without
+ * copying it out.  The data stays in the pipe until released by
+ * k_pipe_get_release().  The region ends at the end of the ring buffer,
+ * so it may hold less than the data in the pipe.
+ *
+ * Only one region can be claimed for reading at a time.  Until it is
+ * released, k_pipe_get() fails with -EBUSY, so this is meant for pipes
+ * with a single reader.
+ *
+ * @note Not available to user mode threads, since the region lives in
+ * kernel memory.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Set to the address of the claimed region.
+ * @param size On entry, the maximum number of bytes to claim.  On return,
+ *             the number of bytes claimed, at least one.
+ * @param timeout Waiting period for data,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Region claimed.
+ * @retval -EINVAL @a pipe has no ring buffer or @a size is zero.
+ * @retval -EIO Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY Another region is already claimed for reading.
+ */
+int k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     k_timeout_t timeout);
+
+/**
+ * @brief Release data read in a claimed region of a pipe.
+ *
+ * This routine removes the first @a bytes bytes of the region obtained
+ * from k_pipe_get_claim() from the pipe, and leaves the rest of the claim
+ * for the next read.  Waiting writers are given the space freed.
+ *
+ * @param pipe Address of the pipe.
+ * @param bytes Number of bytes consumed, at most the size of the claim.
+ *
+ * @retval 0 Data released.
+ * @retval -EINVAL No region is claimed for reading, or @a bytes exceeds it.
+ */
+int k_pipe_get_release(struct k_pipe *pipe, size_t bytes);
+
 /**
  * @brief Query the number of bytes that may be read from @a pipe.
  *
@@ -4287,16 +5175,34 @@ struct k_mem_slab {
 	uint32_t num_blocks;
 	size_t block_size;
 	char *buffer;
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	/* Tagged index of the first free block, see mem_slab.c */
+	atomic_t free_head;
+	atomic_t waiters;
+	atomic_t num_used;
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	atomic_t max_used;
+#endif
+#else
 	char *free_list;
 	uint32_t num_used;
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	uint32_t max_used;
+#endif
 #endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab)
 	_OBJECT_TRACING_LINKED_FLAG
 };
 
+/* Lock-free slabs keep an ABA counter in the upper bits of the list head */
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+#define Z_MEM_SLAB_MAX_BLOCKS \
+	(BIT(32 - CONFIG_MEM_SLAB_LOCKLESS_TAG_BITS) - 1U)
+#else
+#define Z_MEM_SLAB_MAX_BLOCKS UINT32_MAX
+#endif
+
 #define Z_MEM_SLAB_INITIALIZER(obj, slab_buffer, slab_block_size, \
 			       slab_num_blocks) \
 	{ \
@@ -4304,7 +5210,6 @@ struct k_mem_slab {
 	.num_blocks = slab_num_blocks, \
 	.block_size = slab_block_size, \
 	.buffer = slab_buffer, \
-	.free_list = NULL, \
 	.num_used = 0, \
 	_OBJECT_TRACING_INIT \
 	}
@@ -4340,6 +5245,8 @@ struct k_mem_slab {
  * @param slab_align Alignment of the memory slab's buffer (power of 2).
  */
 #define K_MEM_SLAB_DEFINE(name, slab_block_size, slab_num_blocks, slab_align) \
+	BUILD_ASSERT((slab_num_blocks) <= Z_MEM_SLAB_MAX_BLOCKS, \
+		     "Too many blocks for CONFIG_MEM_SLAB_LOCKLESS_TAG_BITS"); \
 	char __noinit __aligned(WB_UP(slab_align)) \
 	   _k_mem_slab_buf_##name[(slab_num_blocks) * WB_UP(slab_block_size)]; \
 	Z_STRUCT_SECTION_ITERABLE(k_mem_slab, name) = \
@@ -4358,6 +5265,10 @@ struct k_mem_slab {
  * To ensure that each memory block is similarly aligned to this boundary,
  * @a slab_block_size must also be a multiple of N.
  *
+ * With CONFIG_MEM_SLAB_LOCKLESS, @a num_blocks must be less than
+ * 2^(32 - CONFIG_MEM_SLAB_LOCKLESS_TAG_BITS), or -EINVAL is returned.
+ * K_MEM_SLAB_DEFINE() checks this at build time.
+ *
  * @param slab Address of the memory slab.
  * @param buffer Pointer to buffer used for the memory blocks.
  * @param block_size Size of each memory block (in bytes).
@@ -4417,7 +5328,11 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	return (uint32_t)atomic_get(&slab->num_used);
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4432,7 +5347,10 @@ static inline uint32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline uint32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
 {
-#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+#if defined(CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION) && \
+	defined(CONFIG_MEM_SLAB_LOCKLESS)
+	return (uint32_t)atomic_get(&slab->max_used);
+#elif defined(CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION)
 	return slab->max_used;
 #else
 	ARG_UNUSED(slab);
@@ -4452,7 +5370,7 @@ static inline uint32_t k_mem_slab_max_used_get(struct k_mem_slab *slab)
  */
 static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
 /** @} */
@@ -4464,10 +5382,38 @@ static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 
 /* kernel synchronized heap struct */
 
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+struct z_heap_cpu_cache {
+	struct k_spinlock lock;
+	struct sys_heap_magazine mag;
+};
+#endif
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS_GROUP
+STATS_SECT_START(k_heap)
+STATS_SECT_ENTRY32(allocated_bytes)
+STATS_SECT_ENTRY32(free_bytes)
+STATS_SECT_ENTRY32(max_allocated_bytes)
+STATS_SECT_ENTRY32(alloc_failures)
+STATS_SECT_END;
+
+#define Z_K_HEAP_STATS_INIT(name) .stats_name = STRINGIFY(name),
+#else
+#define Z_K_HEAP_STATS_INIT(name)
+#endif
+
 struct k_heap {
 	struct sys_heap heap;
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	struct z_heap_cpu_cache cpu_cache[CONFIG_MP_NUM_CPUS];
+	int waiters;
+#endif
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS_GROUP
+	const char *stats_name;
+	STATS_SECT_DECL(k_heap) stats;
+#endif
 };
 
 /**
@@ -4516,6 +5462,78 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout);
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+/**
+ * @brief Change the size of memory allocated by k_heap_alloc()
+ *
+ * Behaves like sys_heap_realloc(): the block is shrunk or grown in
+ * place when its neighbors allow it, and otherwise moved to a new
+ * block with its contents copied.  A NULL @a mem behaves like
+ * k_heap_alloc() and a zero @a bytes like k_heap_free().  If the
+ * memory is not available immediately, the call will block for the
+ * specified timeout waiting for memory to be freed.  On failure NULL
+ * is returned and the original block is left untouched.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param h Heap from which to allocate
+ * @param mem A valid memory block, or NULL
+ * @param bytes Desired new size of the block
+ * @param timeout How long to wait, or K_NO_WAIT
+ * @return A pointer to valid heap memory, or NULL
+ */
+void *k_heap_realloc(struct k_heap *h, void *mem, size_t bytes,
+		     k_timeout_t timeout);
+
+/**
+ * @brief Get size class cache statistics of a k_heap
+ *
+ * Like sys_heap_cache_stats_get(), but also accounts for the per-CPU
+ * magazines when CONFIG_SYS_HEAP_CACHE_PER_CPU is enabled.  Only
+ * available with CONFIG_SYS_HEAP_CACHE.
+ *
+ * @param h Heap to query
+ * @param stats Struct into which to store the statistics
+ */
+void k_heap_cache_stats_get(struct k_heap *h,
+			    struct sys_heap_cache_stats *stats);
+
+/**
+ * @brief Get runtime statistics of a k_heap
+ *
+ * Like sys_heap_runtime_stats_get(), taken under the heap's lock.
+ * Blocks held in per-CPU magazines (CONFIG_SYS_HEAP_CACHE_PER_CPU)
+ * are reported as allocated, as the heap only sees them when they
+ * enter or leave a magazine.  Only available with
+ * CONFIG_SYS_HEAP_RUNTIME_STATS.
+ *
+ * @param h Heap to query
+ * @param stats Struct into which to store the statistics
+ * @return 0 on success, -EINVAL if @a h or @a stats is NULL
+ */
+int k_heap_runtime_stats_get(struct k_heap *h,
+			     struct sys_heap_runtime_stats *stats);
+
+/**
+ * @brief Reset the high water mark of a k_heap
+ *
+ * @param h Heap to reset
+ * @return 0 on success, -EINVAL if @a h is NULL
+ */
+int k_heap_runtime_stats_reset_max(struct k_heap *h);
+
+/**
+ * @brief Register a k_heap with the stats subsystem
+ *
+ * Statically defined heaps are registered automatically under their
+ * variable name.  Only available with
+ * CONFIG_SYS_HEAP_RUNTIME_STATS_GROUP.
+ *
+ * @param h Heap to register, already initialized
+ * @param name Unique name of the statistics group
+ * @return 0 on success, negative error code on failure
+ */
+int k_heap_stats_register(struct k_heap *h, const char *name);
+
 /**
  * @brief Define a static k_heap
  *
@@ -4533,6 +5551,7 @@ void k_heap_free(struct k_heap *h, void *mem);
 			.init_mem = kheap_##name,		\
 			.init_bytes = (bytes),			\
 		 },						\
+		Z_K_HEAP_STATS_INIT(name)			\
 	}
 
 /**
@@ -4972,6 +5991,141 @@ __syscall void k_poll_signal_check(struct k_poll_signal *signal,
 
 __syscall int k_poll_signal_raise(struct k_poll_signal *signal, int result);
 
+/**
+ * @brief Poll event registered in a poll set
+ */
+struct k_poll_set_event {
+	/** event, initialized with k_poll_event_init() */
+	struct k_poll_event event;
+
+	/** PRIVATE - DO NOT TOUCH */
+	sys_dnode_t _ready_node;
+};
+
+/**
+ * @brief Poll set
+ *
+ * A set of poll events that stay registered on their objects across waits.
+ */
+struct k_poll_set {
+	/** PRIVATE - DO NOT TOUCH */
+	struct z_poller poller;
+
+	/** PRIVATE - DO NOT TOUCH */
+	struct k_spinlock lock;
+
+	/** PRIVATE - DO NOT TOUCH */
+	sys_dlist_t ready;
+
+	/** PRIVATE - DO NOT TOUCH */
+	_wait_q_t wait_q;
+
+	/** PRIVATE - DO NOT TOUCH */
+	bool canceled;
+};
+
+/**
+ * @brief Initialize a poll set.
+ *
+ * A poll set keeps its events registered on their objects from
+ * k_poll_set_add() to k_poll_set_remove(), and maintains a list of the
+ * events that were signaled, so that waiting on it costs only as much as
+ * the number of ready events, however many events it holds.
+ *
+ * @param set Address of the poll set.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_init(struct k_poll_set *set);
+
+/**
+ * @brief Add an event to a poll set.
+ *
+ * The event, initialized with k_poll_event_init(), is registered on its
+ * object until it is removed from the set. It is made ready at once if
+ * its condition is already met. An event can belong to one set only, and
+ * must not be passed to k_poll() while in a set.
+ *
+ * Events of type K_POLL_TYPE_IGNORE are not registered on any object,
+ * and only become ready through k_poll_set_ready().
+ *
+ * @param set Address of the poll set.
+ * @param sev Event to add.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_add(struct k_poll_set *set,
+			   struct k_poll_set_event *sev);
+
+/**
+ * @brief Remove an event from a poll set.
+ *
+ * @param set Address of the poll set.
+ * @param sev Event to remove, previously added to @a set.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_remove(struct k_poll_set *set,
+			      struct k_poll_set_event *sev);
+
+/**
+ * @brief Make an event of a poll set ready.
+ *
+ * Signals an event by hand, e.g. for a condition no kernel object reports,
+ * or to have an event that was returned by k_poll_set_wait() but is
+ * still ready returned again.
+ *
+ * @param sev Event, previously added to a poll set.
+ * @param state State to add to the event's state, from the
+ *              K_POLL_STATE_xxx values.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_ready(struct k_poll_set_event *sev, uint32_t state);
+
+/**
+ * @brief Wait for events of a poll set to be ready.
+ *
+ * Takes up to @a max ready events off the ready list of the set, waiting
+ * for one if there are none. Each one is returned once for any number of
+ * times it was signaled since it was last returned, with the states it
+ * was signaled with accumulated in its state field, which the caller has
+ * to reset to K_POLL_STATE_NOT_READY once it has handled them.
+ *
+ * As with k_poll(), a ready event only tells that its condition was met
+ * when it was signaled: the object may have been taken since.
+ *
+ * With @a max zero, only waits for an event to be ready, without taking
+ * any.
+ *
+ * @param set Address of the poll set.
+ * @param ready Array receiving the ready events.
+ * @param max Size of the array.
+ * @param timeout Waiting period for an event to be ready,
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of events stored in @a ready, or 0 if @a max is 0
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -ECANCELED The set was canceled with k_poll_set_cancel().
+ */
+extern int k_poll_set_wait(struct k_poll_set *set,
+			   struct k_poll_set_event **ready, int max,
+			   k_timeout_t timeout);
+
+/**
+ * @brief Cancel all waits on a poll set.
+ *
+ * Wakes up every thread waiting in k_poll_set_wait() on @a set, which then
+ * returns -ECANCELED, as do all later waits until the set is initialized
+ * again. Used before the owner of the set tears it down, so that no
+ * thread is left pended on it.
+ *
+ * @param set Address of the poll set.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_cancel(struct k_poll_set *set);
+
 /**
  * @internal
  */
@@ -5167,6 +6321,84 @@ int k_thread_runtime_stats_get(k_tid_t thread,
  */
 int k_thread_runtime_stats_all_get(k_thread_runtime_stats_t *stats);
 
+#ifdef CONFIG_CPU_LOAD
+
+/**
+ * @brief Runtime statistics of a CPU
+ */
+struct k_cpu_runtime_stats {
+	/** Cycles spent in the idle thread. */
+	uint64_t idle_cycles;
+	/** Cycles spent in the other threads. */
+	uint64_t busy_cycles;
+	/**
+	 * Cycles spent in ISRs. Only accounted for separately with
+	 * @option{CONFIG_CPU_LOAD_ISR}, otherwise the time spent in an ISR
+	 * is accounted to the thread it interrupted.
+	 */
+	uint64_t isr_cycles;
+};
+
+/**
+ * @brief Load averages
+ *
+ * Fraction of the time of a CPU spent on something, in per mille, over each
+ * of the windows of @ref k_load_window.
+ */
+struct k_load_avg {
+	uint16_t avg[K_LOAD_WINDOWS];
+};
+
+/**
+ * @brief Load of a CPU
+ */
+struct k_cpu_load {
+	/** Time spent in threads other than the idle thread, and in ISRs. */
+	struct k_load_avg busy;
+	/** Time spent in ISRs. */
+	struct k_load_avg isr;
+};
+
+/**
+ * @brief Get the runtime statistics of a CPU
+ *
+ * The statistics include the time spent up to the call.
+ *
+ * @param cpu Index of the CPU.
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if @a cpu is invalid or @a stats null, otherwise 0
+ */
+int k_cpu_runtime_stats_get(int cpu, struct k_cpu_runtime_stats *stats);
+
+/**
+ * @brief Get the load of a CPU
+ *
+ * Loads are sampled every @option{CONFIG_CPU_LOAD_SAMPLE_PERIOD}
+ * milliseconds. The average over a window is an exponentially weighted
+ * moving average of the samples, each one weighted by the sampling period
+ * divided by the window, as Unix load averages. With the defaults, the
+ * short window average is the load over the last second.
+ *
+ * @param cpu Index of the CPU.
+ * @param load Pointer to struct to copy the load into.
+ * @return -EINVAL if @a cpu is invalid or @a load null, otherwise 0
+ */
+int k_cpu_load_get(int cpu, struct k_cpu_load *load);
+
+/**
+ * @brief Get the load of a thread
+ *
+ * The load of a thread is the fraction of the time of one CPU it ran for,
+ * averaged as the load of CPUs, see k_cpu_load_get().
+ *
+ * @param thread ID of thread.
+ * @param load Pointer to struct to copy the load into.
+ * @return -EINVAL if null pointers, otherwise 0
+ */
+int k_thread_load_get(k_tid_t thread, struct k_load_avg *load);
+
+#endif /* CONFIG_CPU_LOAD */
+
 #endif
 
 #ifdef __cplusplus
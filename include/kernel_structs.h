@@ -27,6 +27,7 @@
 #include <sys/dlist.h>
 #include <sys/util.h>
 #include <sys/sys_heap.h>
+#include <sys/pheap.h>
 #endif
 
 #define K_NUM_PRIORITIES \
@@ -96,6 +97,29 @@ struct _ready_q {
 
 typedef struct _ready_q _ready_q_t;
 
+#ifdef CONFIG_CPU_LOAD
+struct _cpu_runtime_stats {
+	/* odd while the CPU updates its statistics, for readers on others */
+	atomic_t seq;
+
+	/* cycles spent in the idle thread, other threads and ISRs */
+	uint64_t idle_cycles;
+	uint64_t busy_cycles;
+	uint64_t isr_cycles;
+
+	/* thread switched in and accounted for, NULL while switching */
+	struct k_thread *accounted;
+
+	/* cycle count since which the time in progress is accounted to the
+	 * outermost ISR, or else to the accounted thread
+	 */
+	uint32_t since;
+
+	/* ISR nesting level */
+	uint32_t isr_nested;
+};
+#endif
+
 struct _cpu {
 	/* nested interrupt count */
 	uint32_t nested;
@@ -128,6 +152,15 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	uint8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Threads made ready on (or last run on) this CPU */
+	struct _ready_q ready_q;
+#endif
+
+#ifdef CONFIG_CPU_LOAD
+	struct _cpu_runtime_stats rt_stats;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -219,8 +252,21 @@ struct _timeout;
 typedef void (*_timeout_func_t)(struct _timeout *t);
 
 struct _timeout {
+#ifdef CONFIG_TIMEOUT_QUEUE_PHEAP
+	struct pheap_node node;
+	/* Insertion order, keeps equal expiry times in FIFO order */
+	uint32_t seq;
+#ifdef CONFIG_TIMEOUT_QUEUE_PER_CPU
+	/* CPU whose queue holds the timeout */
+	uint8_t cpu;
+#endif
+#else
 	sys_dnode_t node;
+#endif
 	_timeout_func_t fn;
+	/* Delta from the previous timeout in the list, or with
+	 * TIMEOUT_QUEUE_PHEAP the absolute expiry tick.
+	 */
 #ifdef CONFIG_TIMEOUT_64BIT
 	/* Can't use k_ticks_t for header dependency reasons */
 	int64_t dticks;
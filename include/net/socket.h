@@ -52,6 +52,44 @@ struct zsock_pollfd {
 /** zsock_poll: Invalid socket (output value only) */
 #define ZSOCK_POLLNVAL 0x20
 
+/* ZSOCK_EPOLL* values are compatible with Linux, and with ZSOCK_POLL* */
+/** zsock_epoll_ctl: Wait for readability */
+#define ZSOCK_EPOLLIN ZSOCK_POLLIN
+/** zsock_epoll_ctl: Compatibility value, ignored */
+#define ZSOCK_EPOLLPRI ZSOCK_POLLPRI
+/** zsock_epoll_ctl: Wait for writability */
+#define ZSOCK_EPOLLOUT ZSOCK_POLLOUT
+/** zsock_epoll_wait: Error condition, always reported */
+#define ZSOCK_EPOLLERR ZSOCK_POLLERR
+/** zsock_epoll_wait: Closed connection, always reported */
+#define ZSOCK_EPOLLHUP ZSOCK_POLLHUP
+/** zsock_epoll_ctl: Report the socket once, until it is modified */
+#define ZSOCK_EPOLLONESHOT (1U << 30)
+/** zsock_epoll_ctl: Edge-triggered, report only changes of readiness */
+#define ZSOCK_EPOLLET (1U << 31)
+
+/** zsock_epoll_ctl: Add a socket to the interest list */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Remove a socket from the interest list */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the events of a socket in the interest list */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/** User data returned with the events of a socket by zsock_epoll_wait() */
+union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+};
+
+struct zsock_epoll_event {
+	/** ZSOCK_EPOLL* events */
+	uint32_t events;
+	/** User data */
+	union zsock_epoll_data data;
+};
+
 /** zsock_recv: Read data without removing it from socket input queue */
 #define ZSOCK_MSG_PEEK 0x02
 /** zsock_recv/zsock_send: Override operation to non-blocking */
@@ -421,6 +459,60 @@ __syscall int zsock_fcntl(int sock, int cmd, int flags);
  */
 __syscall int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
 
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_create.2.html>`__
+ * for normative description. Returns a file descriptor, to be closed with
+ * :c:func:`zsock_close` once no longer needed.
+ *
+ * Unlike :c:func:`zsock_poll`, which registers every socket on every call,
+ * an epoll instance keeps its sockets registered and tracks which of them
+ * became ready, so that :c:func:`zsock_epoll_wait` only pays for the sockets
+ * that are ready. Instances are allocated from a pool of
+ * :option:`CONFIG_NET_SOCKETS_EPOLL_MAX` entries.
+ * @endrst
+ *
+ * @param flags Must be 0.
+ */
+__syscall int zsock_epoll_create1(int flags);
+
+/**
+ * @brief Control the interest list of an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_ctl.2.html>`__
+ * for normative description. Sockets are level-triggered, unless added
+ * with ZSOCK_EPOLLET: they are then reported once each time they are
+ * signaled, e.g. when data is received, but not again while that data is
+ * left unread. Any file descriptor supporting :c:func:`zsock_poll` can be
+ * added, e.g. an eventfd. Descriptors are removed from all the instances
+ * they were added to when they are closed.
+ * At most :option:`CONFIG_NET_SOCKETS_EPOLL_MAX_FDS` sockets can be added
+ * to all the instances together.
+ * @endrst
+ */
+__syscall int zsock_epoll_ctl(int epfd, int op, int sock,
+			      struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for events on the sockets of an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_wait.2.html>`__
+ * for normative description.
+ * @endrst
+ */
+__syscall int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			       int maxevents, int timeout);
+
 /**
  * @brief Get various socket options
  *
@@ -702,6 +794,31 @@ static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 	return zsock_poll(fds, nfds, timeout);
 }
 
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create1(flags);
+}
+
+/* The size hint is ignored, as by Linux */
+static inline int epoll_create(int size)
+{
+	ARG_UNUSED(size);
+
+	return zsock_epoll_create1(0);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
 static inline int getsockopt(int sock, int level, int optname,
 			     void *optval, socklen_t *optlen)
 {
@@ -769,6 +886,21 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define POLLHUP ZSOCK_POLLHUP
 #define POLLNVAL ZSOCK_POLLNVAL
 
+#define epoll_event zsock_epoll_event
+typedef union zsock_epoll_data epoll_data_t;
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLPRI ZSOCK_EPOLLPRI
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLONESHOT ZSOCK_EPOLLONESHOT
+#define EPOLLET ZSOCK_EPOLLET
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
 #define MSG_PEEK ZSOCK_MSG_PEEK
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 
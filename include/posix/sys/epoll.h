@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_POSIX_SYS_EPOLL_H_
+#define ZEPHYR_INCLUDE_POSIX_SYS_EPOLL_H_
+
+#include <net/socket.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define epoll_event zsock_epoll_event
+typedef union zsock_epoll_data epoll_data_t;
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLPRI ZSOCK_EPOLLPRI
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLONESHOT ZSOCK_EPOLLONESHOT
+#define EPOLLET ZSOCK_EPOLLET
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create1(flags);
+}
+
+/* The size hint is ignored, as by Linux */
+static inline int epoll_create(int size)
+{
+	ARG_UNUSED(size);
+
+	return zsock_epoll_create1(0);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* ZEPHYR_INCLUDE_POSIX_SYS_EPOLL_H_ */
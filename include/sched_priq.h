@@ -9,6 +9,7 @@
 #include <sys/util.h>
 #include <sys/dlist.h>
 #include <sys/rb.h>
+#include <sys/pheap.h>
 
 /* Two abstractions are defined here for "thread priority queues".
  *
@@ -47,13 +48,23 @@ struct k_thread *z_priq_rb_best(struct _priq_rb *pq);
 /* Traditional/textbook "multi-queue" structure.  Separate lists for a
  * small number (max 32 here) of fixed priorities.  This corresponds
  * to the original Zephyr scheduler.  RAM requirements are
- * comparatively high, but performance is very fast.  Won't work with
- * features like deadline scheduling which need large priority spaces
- * to represent their requirements.
+ * comparatively high, but performance is very fast.
+ *
+ * With deadline scheduling each priority level is instead a pairing
+ * heap ordered by deadline (FIFO among equal deadlines, via
+ * next_order_key), so finding the next thread stays a ctz plus a root
+ * pointer load and insertion stays constant time.  The bitmask is
+ * kept at the front so that the hot fields share a cache line.
  */
 struct _priq_mq {
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_DEADLINE)
+	unsigned int bitmask; /* bit 1<<i set if queues[i] is non-empty */
+	uint32_t next_order_key;
+	struct pheap queues[32];
+#else
 	sys_dlist_t queues[32];
 	unsigned int bitmask; /* bit 1<<i set if queues[i] is non-empty */
+#endif
 };
 
 void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread);
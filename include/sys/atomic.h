@@ -407,6 +407,19 @@ extern atomic_val_t atomic_nand(atomic_t *target, atomic_val_t value);
  * @cond INTERNAL_HIDDEN
  */
 
+/* Full memory barrier: memory accesses before it are seen by other CPUs
+ * before the accesses after it.  Only keeps the compiler from reordering
+ * them without SMP.
+ */
+static inline void z_smp_mb(void)
+{
+#ifdef CONFIG_SMP
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#else
+	compiler_barrier();
+#endif
+}
+
 #define ATOMIC_BITS (sizeof(atomic_val_t) * 8)
 #define ATOMIC_MASK(bit) (1U << ((uint32_t)(bit) & (ATOMIC_BITS - 1U)))
 #define ATOMIC_ELEM(addr, bit) ((addr) + ((bit) / ATOMIC_BITS))
@@ -101,6 +101,24 @@ void *z_get_fd_obj(int fd, const struct fd_op_vtable *vtable, int err);
  */
 void *z_get_fd_obj_and_vtable(int fd, const struct fd_op_vtable **vtable);
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+/**
+ * @brief Remove file descriptor from the epoll instances watching it.
+ *
+ * This function should be called before the object behind a file
+ * descriptor is closed, so that no epoll instance stays registered on
+ * the object's k_poll events.
+ *
+ * @param fd File descriptor about to be closed
+ */
+void z_fd_epoll_remove(int fd);
+#else
+static inline void z_fd_epoll_remove(int fd)
+{
+	(void)fd;
+}
+#endif
+
 /**
  * @brief Call ioctl vmethod on an object using varargs.
  *
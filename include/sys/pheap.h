@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Pairing heap data structure
+ *
+ * This implements an intrusive min-heap with O(1) insertion, O(1)
+ * access to the minimum element and amortized O(log2(N)) removal of
+ * arbitrary nodes (including the minimum).  The algorithm is the
+ * conventional "two pass" pairing heap, c.f.:
+ *
+ * https://en.wikipedia.org/wiki/Pairing_heap
+ *
+ * As with the rbtree, the struct pheap_node handle is meant to be
+ * embedded in a containing struct.  Each node stores three pointers:
+ * its leftmost child, its next sibling, and a "prev" pointer that
+ * references the previous sibling or (for leftmost children) the
+ * parent.  The prev pointer is what allows removal of arbitrary nodes
+ * without a search, and doubles as the "is this node in a heap" flag:
+ * it is NULL for detached nodes and points to the node itself for the
+ * root.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_PHEAP_H_
+#define ZEPHYR_INCLUDE_SYS_PHEAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pheap_node {
+	struct pheap_node *child;
+	struct pheap_node *next;
+	struct pheap_node *prev;
+};
+
+/**
+ * @typedef pheap_lessthan_t
+ * @brief Pairing heap comparison predicate
+ *
+ * Compares the two nodes and returns true if node A is strictly less
+ * than B according to the heap's sorting criteria, false otherwise.
+ * Nodes which compare as equal are returned in an unspecified order,
+ * users who need FIFO behavior must encode it in the predicate.
+ *
+ * The predicate is passed to each operation rather than stored in the
+ * heap, as users typically keep many heaps sorted the same way.  Every
+ * operation on one heap must use the same predicate.
+ */
+typedef bool (*pheap_lessthan_t)(struct pheap_node *a, struct pheap_node *b);
+
+struct pheap {
+	struct pheap_node *root;
+};
+
+/**
+ * @brief Statically initialize an empty pairing heap
+ */
+#define PHEAP_STATIC_INIT() { .root = NULL }
+
+/**
+ * @brief Initialize a detached pairing heap node
+ */
+static inline void pheap_node_init(struct pheap_node *node)
+{
+	node->child = NULL;
+	node->next = NULL;
+	node->prev = NULL;
+}
+
+/**
+ * @brief Returns true if the node is currently a member of a heap
+ */
+static inline bool pheap_node_is_linked(const struct pheap_node *node)
+{
+	return node->prev != NULL;
+}
+
+/**
+ * @brief Returns the lowest-sorted member of the heap, or NULL
+ */
+static inline struct pheap_node *pheap_get_min(struct pheap *heap)
+{
+	return heap->root;
+}
+
+/**
+ * @brief Insert node into heap
+ *
+ * Constant time.  The node must not already be in a heap.
+ */
+void pheap_insert(struct pheap *heap, struct pheap_node *node,
+		  pheap_lessthan_t lessthan);
+
+/**
+ * @brief Remove node from heap
+ *
+ * Amortized O(log2(N)).  The node must be a member of this heap.  On
+ * return the node is detached and may be re-inserted.
+ */
+void pheap_remove(struct pheap *heap, struct pheap_node *node,
+		  pheap_lessthan_t lessthan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_PHEAP_H_ */
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Read-copy-update
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_RCU_H_
+#define ZEPHYR_INCLUDE_SYS_RCU_H_
+
+#include <sys/atomic.h>
+#include <sys/slist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup rcu_apis Read-Copy-Update APIs
+ * @ingroup kernel_apis
+ *
+ * Read-copy-update lets readers walk linked data structures without any
+ * lock, while writers change them: a writer unlinks an element, or
+ * replaces it by an updated copy, then waits for a grace period, after
+ * which no reader can still hold a reference to the old element, before
+ * reusing or freeing it.
+ *
+ * Readers enter a read-side critical section with sys_rcu_read_lock(),
+ * which only increments a counter of the CPU they run on, so readers on
+ * different CPUs don't contend.  They may be preempted and may block
+ * inside it.  Writers still serialize among themselves, e.g. with a
+ * spinlock, publish new elements with SYS_RCU_ASSIGN_POINTER(), and wait
+ * for a grace period with sys_rcu_synchronize(), or have a callback run
+ * after one with sys_rcu_call().
+ *
+ * @{
+ */
+
+/**
+ * @brief Callback run after a grace period.
+ *
+ * @param head The sys_rcu_head passed to sys_rcu_call(), usually embedded
+ *             in the element to reclaim.
+ */
+struct sys_rcu_head;
+typedef void (*sys_rcu_callback_t)(struct sys_rcu_head *head);
+
+/**
+ * @brief Deferred reclaim request
+ */
+struct sys_rcu_head {
+	/** @cond INTERNAL_HIDDEN */
+	sys_snode_t node;
+	sys_rcu_callback_t func;
+	/** @endcond */
+};
+
+/**
+ * @brief Publish a pointer to readers.
+ *
+ * Stores @a v to the pointer @a p, after the stores initializing what it
+ * points to are visible to readers on other CPUs.
+ *
+ * @param p Pointer read by readers, as an lvalue.
+ * @param v New value.
+ */
+#define SYS_RCU_ASSIGN_POINTER(p, v) \
+	do { \
+		z_smp_mb(); \
+		*(volatile __typeof__(p) *)&(p) = (v); \
+	} while (false)
+
+/**
+ * @brief Read a pointer published with SYS_RCU_ASSIGN_POINTER().
+ *
+ * @param p Pointer, as an lvalue.
+ *
+ * @return The value of @a p, read once.
+ */
+#define SYS_RCU_DEREFERENCE(p) (*(volatile __typeof__(p) *)&(p))
+
+/**
+ * @brief Enter a read-side critical section.
+ *
+ * Elements reachable during the critical section are not reclaimed before
+ * it ends.  Critical sections may nest, and may be entered in ISRs.
+ *
+ * @return Token to pass to sys_rcu_read_unlock().
+ */
+unsigned int sys_rcu_read_lock(void);
+
+/**
+ * @brief Leave a read-side critical section.
+ *
+ * May be called on another CPU than the matching sys_rcu_read_lock().
+ *
+ * @param token Value returned by the matching sys_rcu_read_lock().
+ */
+void sys_rcu_read_unlock(unsigned int token);
+
+/**
+ * @brief Wait for a grace period.
+ *
+ * Returns once all the read-side critical sections entered before the
+ * call have ended.  Elements unlinked before the call may then be freed
+ * or reused.  Returns immediately when there are no readers.
+ *
+ * Must be called from a thread, outside of any read-side critical section.
+ */
+void sys_rcu_synchronize(void);
+
+/**
+ * @brief Run a callback after a grace period.
+ *
+ * Queues @a func to be called with @a head on the system work queue once
+ * all the read-side critical sections entered before this call have
+ * ended, typically to free the element @a head is embedded in.  May be
+ * called from ISRs.
+ *
+ * @param head Reclaim request, not to be used again before @a func runs.
+ * @param func Callback.
+ */
+void sys_rcu_call(struct sys_rcu_head *head, sys_rcu_callback_t func);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_RCU_H_ */
@@ -0,0 +1,336 @@
+/* ring_buffer_lockfree.h: Lock-free ring buffer API */
+
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/** @file */
+
+#ifndef ZEPHYR_INCLUDE_SYS_RING_BUFFER_LOCKFREE_H_
+#define ZEPHYR_INCLUDE_SYS_RING_BUFFER_LOCKFREE_H_
+
+#include <kernel.h>
+#include <sys/atomic.h>
+#include <sys/util.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A single producer, single consumer ring buffer for byte data
+ *
+ * One context may write to the buffer while another one reads from it,
+ * e.g. an ISR and a thread, without any lock, including on SMP.  Each
+ * side publishes its progress with an atomic store of its index, which
+ * orders the data accesses before it.  Both indexes run freely modulo
+ * 2^32, which is why the size must be a power of two.
+ */
+struct ring_buf_spsc {
+	atomic_t head;     /**< Read index, published by the consumer */
+	atomic_t tail;     /**< Write index, published by the producer */
+	uint32_t tmp_head; /**< Read index including claims, consumer only */
+	uint32_t tmp_tail; /**< Write index including claims, producer only */
+	uint32_t size;     /**< Size of buf in bytes, a power of 2 */
+	uint8_t *buf;      /**< Memory region for stored data */
+};
+
+/**
+ * @brief A multiple producer, single consumer ring buffer of records
+ *
+ * Any number of contexts, threads or ISRs on any CPU, may write
+ * records to the buffer while one context reads them, without any
+ * lock.  Producers reserve room for a record by moving the write
+ * index with a compare and swap, and publish the record with an
+ * atomic store of its header, so records can be completed in any
+ * order.  The consumer sees records in the order of reservation and
+ * stops at the first one not yet published.
+ */
+struct ring_buf_mpsc {
+	atomic_t head;   /**< Read index in words, published by the consumer */
+	atomic_t tail;   /**< Reservation index in words */
+	uint32_t size32; /**< Size of buf in 32-bit words, a power of 2 */
+	uint32_t *buf32; /**< Memory region for stored records */
+};
+
+/**
+ * @defgroup ring_buffer_lockfree_apis Lock-free Ring Buffer APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Statically define and initialize a lock-free SPSC ring buffer.
+ *
+ * @param name  Name of the ring buffer.
+ * @param size8 Size of ring buffer (in bytes), must be a power of 2.
+ */
+#define RING_BUF_SPSC_DECLARE(name, size8) \
+	BUILD_ASSERT(((size8) & ((size8) - 1)) == 0, \
+		     "Ring buffer size must be a power of 2"); \
+	static uint8_t _ring_buffer_data_##name[size8]; \
+	struct ring_buf_spsc name = { \
+		.size = size8, \
+		.buf = _ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Statically define and initialize a lock-free MPSC ring buffer.
+ *
+ * @param name  Name of the ring buffer.
+ * @param words Size of ring buffer (in 32-bit words), must be a power of 2.
+ */
+#define RING_BUF_MPSC_DECLARE(name, words) \
+	BUILD_ASSERT(((words) & ((words) - 1)) == 0, \
+		     "Ring buffer size must be a power of 2"); \
+	static uint32_t _ring_buffer_data_##name[words]; \
+	struct ring_buf_mpsc name = { \
+		.size32 = words, \
+		.buf32 = _ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Initialize a lock-free SPSC ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Ring buffer size (in bytes), must be a power of 2.
+ * @param data Ring buffer data area.
+ */
+static inline void ring_buf_spsc_init(struct ring_buf_spsc *buf,
+				      uint32_t size, uint8_t *data)
+{
+	__ASSERT(is_power_of_two(size), "size must be a power of 2");
+
+	memset(buf, 0, sizeof(*buf));
+	buf->size = size;
+	buf->buf = data;
+}
+
+/**
+ * @brief Determine if a lock-free SPSC ring buffer is empty.
+ *
+ * Only meaningful to the consumer, or while the buffer is idle.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return true if the ring buffer is empty.
+ */
+static inline bool ring_buf_spsc_is_empty(struct ring_buf_spsc *buf)
+{
+	return (uint32_t)atomic_get(&buf->tail) == buf->tmp_head;
+}
+
+/**
+ * @brief Determine free space in a lock-free SPSC ring buffer.
+ *
+ * Only meaningful to the producer, or while the buffer is idle.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Ring buffer free space (in bytes).
+ */
+static inline uint32_t ring_buf_spsc_space_get(struct ring_buf_spsc *buf)
+{
+	return buf->size - (buf->tmp_tail - (uint32_t)atomic_get(&buf->head));
+}
+
+/**
+ * @brief Allocate buffer for writing data to a lock-free SPSC ring buffer.
+ *
+ * Same as ring_buf_put_claim(), to be called by the producer only.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *		    ring buffer.
+ * @param[in]  size Requested allocation size (in bytes).
+ *
+ * @return Size of allocated buffer which can be smaller than requested if
+ *	   there is not enough free space or buffer wraps.
+ */
+uint32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Publish bytes written to allocated buffers.
+ *
+ * Same as ring_buf_put_finish(), to be called by the producer only.
+ * Claimed bytes beyond @a size are returned to the free space.
+ *
+ * @param  buf  Address of ring buffer.
+ * @param  size Number of valid bytes in the allocated buffers.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds the claimed bytes.
+ */
+int ring_buf_spsc_put_finish(struct ring_buf_spsc *buf, uint32_t size);
+
+/**
+ * @brief Write (copy) data to a lock-free SPSC ring buffer.
+ *
+ * To be called by the producer only.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written.
+ */
+uint32_t ring_buf_spsc_put(struct ring_buf_spsc *buf, const uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Get address of valid data in a lock-free SPSC ring buffer.
+ *
+ * Same as ring_buf_get_claim(), to be called by the consumer only.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to a location within
+ *		    ring buffer.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of valid bytes in the provided buffer which can be smaller
+ *	   than requested if there is not enough data or buffer wraps.
+ */
+uint32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Free bytes read from claimed buffers.
+ *
+ * Same as ring_buf_get_finish(), to be called by the consumer only.
+ * Claimed bytes beyond @a size stay available for reading.
+ *
+ * @param  buf  Address of ring buffer.
+ * @param  size Number of bytes that can be freed.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds the claimed bytes.
+ */
+int ring_buf_spsc_get_finish(struct ring_buf_spsc *buf, uint32_t size);
+
+/**
+ * @brief Read data from a lock-free SPSC ring buffer.
+ *
+ * To be called by the consumer only.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of the output buffer.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written to the output buffer.
+ */
+uint32_t ring_buf_spsc_get(struct ring_buf_spsc *buf, uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Initialize a lock-free MPSC ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ * @param size32 Ring buffer size (in 32-bit words), must be a power of 2.
+ * @param data Ring buffer data area.
+ */
+static inline void ring_buf_mpsc_init(struct ring_buf_mpsc *buf,
+				      uint32_t size32, uint32_t *data)
+{
+	__ASSERT(is_power_of_two(size32), "size must be a power of 2");
+
+	buf->head = ATOMIC_INIT(0);
+	buf->tail = ATOMIC_INIT(0);
+	buf->size32 = size32;
+	buf->buf32 = data;
+	memset(data, 0, size32 * sizeof(uint32_t));
+}
+
+/**
+ * @brief Reserve a record in a lock-free MPSC ring buffer.
+ *
+ * Reserves a contiguous, 32-bit aligned area of @a size bytes.  Unlike
+ * ring_buf_put_claim(), the record is not split at the end of the
+ * buffer: the allocation succeeds entirely or not at all.  Records are
+ * read in the order they were claimed, and a claimed record holds up
+ * the consumer until it is finished, so claims must be short lived.
+ *
+ * A record longer than half the buffer may not fit on either side of
+ * the tail of an empty buffer.  The claim then pads the buffer up to
+ * its end and fails, and succeeds once the consumer has skipped the
+ * padding, e.g. with a call to ring_buf_mpsc_get_claim().
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Set to the location of the record within ring buffer.
+ * @param[in]  size Record size (in bytes), non-zero and at most 4 bytes
+ *		    less than the buffer.
+ *
+ * @return @a size, or 0 if there is not enough free space.
+ */
+uint32_t ring_buf_mpsc_put_claim(struct ring_buf_mpsc *buf, uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Publish a record written to a lock-free MPSC ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Location of the record returned by ring_buf_mpsc_put_claim().
+ */
+void ring_buf_mpsc_put_finish(struct ring_buf_mpsc *buf, uint8_t *data);
+
+/**
+ * @brief Write (copy) a record to a lock-free MPSC ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @return @a size, or 0 if there is not enough free space.
+ */
+uint32_t ring_buf_mpsc_put(struct ring_buf_mpsc *buf, const uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Get the oldest record in a lock-free MPSC ring buffer.
+ *
+ * To be called by the consumer only.  The record stays in the buffer
+ * until freed with ring_buf_mpsc_get_finish().
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Set to the location of the record within ring buffer.
+ *
+ * @return Size of the record (in bytes), or 0 if there is no record
+ *	   or the oldest one is not finished yet.
+ */
+uint32_t ring_buf_mpsc_get_claim(struct ring_buf_mpsc *buf, uint8_t **data);
+
+/**
+ * @brief Free the record returned by ring_buf_mpsc_get_claim().
+ *
+ * To be called by the consumer only.
+ *
+ * @param buf Address of ring buffer.
+ */
+void ring_buf_mpsc_get_finish(struct ring_buf_mpsc *buf);
+
+/**
+ * @brief Read (copy) the oldest record from a lock-free MPSC ring buffer.
+ *
+ * To be called by the consumer only.  A record larger than @a size is
+ * truncated.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of the output buffer.
+ * @param size Output buffer size (in bytes).
+ *
+ * @return Size of the record (in bytes), or 0 if there is no record.
+ */
+uint32_t ring_buf_mpsc_get(struct ring_buf_mpsc *buf, uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_RING_BUFFER_LOCKFREE_H_ */
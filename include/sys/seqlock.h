@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Sequence locks
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_SEQLOCK_H_
+#define ZEPHYR_INCLUDE_SYS_SEQLOCK_H_
+
+#include <kernel.h>
+#include <sys/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup seqlock_apis Sequence Lock APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief A sequence lock
+ *
+ * Protects small data that is read much more often than it is written,
+ * such as a timestamp or a set of statistics, without readers writing to
+ * memory at all.  Writers serialize on a spinlock and increment the
+ * sequence number before and after updating the data, so it is odd while
+ * an update is in progress.  Readers copy the data out and start over if
+ * the sequence number was odd or changed meanwhile.
+ *
+ * Readers may therefore see torn data, which they must not act upon, or
+ * follow as pointers, before sys_seqlock_read_retry() returned false.
+ * Readers never wait for writers, but a reader interrupting a writer on
+ * the same CPU would retry forever, so writers lock out interrupts.
+ */
+struct sys_seqlock {
+	/** Sequence number, odd while a writer updates the data */
+	atomic_t seq;
+	/** Serializes writers */
+	struct k_spinlock lock;
+};
+
+/**
+ * @brief Statically define and initialize a sequence lock.
+ *
+ * @param name Name of the sequence lock.
+ */
+#define SYS_SEQLOCK_DEFINE(name) \
+	struct sys_seqlock name = { .seq = ATOMIC_INIT(0) }
+
+/**
+ * @brief Initialize a sequence lock.
+ *
+ * @param seqlock Address of the sequence lock.
+ */
+static inline void sys_seqlock_init(struct sys_seqlock *seqlock)
+{
+	atomic_clear(&seqlock->seq);
+	seqlock->lock = (struct k_spinlock) {};
+}
+
+/**
+ * @brief Start reading data protected by a sequence lock.
+ *
+ * @param seqlock Address of the sequence lock.
+ *
+ * @return Sequence number to pass to sys_seqlock_read_retry().
+ */
+static inline uint32_t sys_seqlock_read_begin(struct sys_seqlock *seqlock)
+{
+	uint32_t seq = (uint32_t)atomic_get(&seqlock->seq);
+
+	/* the data is read after the sequence number */
+	z_smp_mb();
+
+	return seq;
+}
+
+/**
+ * @brief Check whether data read under a sequence lock is consistent.
+ *
+ * Typical use:
+ *
+ * @code
+ * do {
+ *	seq = sys_seqlock_read_begin(&lock);
+ *	copy = data;
+ * } while (sys_seqlock_read_retry(&lock, seq));
+ * @endcode
+ *
+ * @param seqlock Address of the sequence lock.
+ * @param seq Value returned by sys_seqlock_read_begin().
+ *
+ * @retval true A writer was active: read the data again.
+ * @retval false The data read since sys_seqlock_read_begin() is consistent.
+ */
+static inline bool sys_seqlock_read_retry(struct sys_seqlock *seqlock,
+					  uint32_t seq)
+{
+	/* the data is read before the sequence number */
+	z_smp_mb();
+
+	return ((seq & 1U) != 0U) ||
+	       ((uint32_t)atomic_get(&seqlock->seq) != seq);
+}
+
+/**
+ * @brief Start updating data protected by a sequence lock.
+ *
+ * Locks out other writers, and interrupts on the calling CPU, until
+ * sys_seqlock_write_unlock().
+ *
+ * @param seqlock Address of the sequence lock.
+ *
+ * @return Key to pass to sys_seqlock_write_unlock().
+ */
+static inline k_spinlock_key_t sys_seqlock_write_lock(
+	struct sys_seqlock *seqlock)
+{
+	k_spinlock_key_t key = k_spin_lock(&seqlock->lock);
+
+	(void)atomic_inc(&seqlock->seq);
+	/* readers see the odd number before any of the update */
+	z_smp_mb();
+
+	return key;
+}
+
+/**
+ * @brief Finish updating data protected by a sequence lock.
+ *
+ * @param seqlock Address of the sequence lock.
+ * @param key Value returned by sys_seqlock_write_lock().
+ */
+static inline void sys_seqlock_write_unlock(struct sys_seqlock *seqlock,
+					    k_spinlock_key_t key)
+{
+	/* readers see the whole update before the even number */
+	z_smp_mb();
+	(void)atomic_inc(&seqlock->seq);
+
+	k_spin_unlock(&seqlock->lock, key);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_SEQLOCK_H_ */
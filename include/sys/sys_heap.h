@@ -54,6 +54,41 @@ struct sys_heap {
 	size_t init_bytes;
 };
 
+/** @brief Size class cache statistics, see sys_heap_cache_stats_get() */
+struct sys_heap_cache_stats {
+	/** Allocations served from a cache */
+	uint32_t hits;
+	/** Allocations of a cacheable size that found the cache empty */
+	uint32_t misses;
+	/** Number of times the caches were returned to the heap */
+	uint32_t flushes;
+	/** Bytes currently held in the caches, including headers */
+	size_t cached_bytes;
+};
+
+/** @brief Heap usage statistics, see sys_heap_runtime_stats_get() */
+struct sys_heap_runtime_stats {
+	/** Bytes not handed out, including chunk headers */
+	size_t free_bytes;
+	/** Bytes handed out, including chunk headers */
+	size_t allocated_bytes;
+	/** High water mark of allocated_bytes */
+	size_t max_allocated_bytes;
+	/** Size of the largest allocation that can currently succeed */
+	size_t largest_free_bytes;
+	/** Percentage of the free memory not in the largest free chunk */
+	unsigned int fragmentation;
+};
+
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+/* Per-CPU cache of small blocks, see sys_heap_magazine_alloc() */
+struct sys_heap_magazine {
+	void *head[CONFIG_SYS_HEAP_CACHE_CLASSES];
+	uint8_t count[CONFIG_SYS_HEAP_CACHE_CLASSES];
+	uint32_t hits;
+};
+#endif
+
 struct z_heap_stress_result {
 	uint32_t total_allocs;
 	uint32_t successful_allocs;
@@ -118,6 +153,174 @@ void *sys_heap_aligned_alloc(struct sys_heap *h, size_t align, size_t bytes);
  */
 void sys_heap_free(struct sys_heap *h, void *mem);
 
+/** @brief Return the usable size of an allocation
+ *
+ * Returns the number of bytes which can be used at @a mem, which is at
+ * least the size it was allocated with and may be more.
+ *
+ * @param h Heap the memory was allocated from
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ * @return Usable size of the allocation, in bytes
+ */
+size_t sys_heap_usable_size(struct sys_heap *h, void *mem);
+
+/** @brief Expand the size of an existing allocation
+ *
+ * Returns a pointer to a new memory region with the same contents,
+ * but a different allocated size.  If the new allocation can be
+ * expanded in place, the pointer returned will be identical.
+ * Otherwise the data will be copied to a new block and the old one
+ * will be freed as per sys_heap_free().  If the specified size is
+ * smaller than the original, the block will be truncated in place
+ * and the remaining memory returned to the heap.  If the allocation
+ * of a new block fails, then NULL will be returned and the old block
+ * will not be freed or modified.
+ *
+ * A block is grown in place when its right neighbor is free and
+ * large enough.  Failing that, a free left neighbor is used and the
+ * contents are moved down within the merged region, which still
+ * never requires both the old and the new block at the same time.
+ *
+ * @note The return of a NULL on failure is a different behavior than
+ * POSIX realloc(), which specifies that the original pointer will be
+ * returned (i.e. it is not possible to safely detect realloc()
+ * failure in POSIX, but it is here).
+ *
+ * @param h Heap from which to allocate
+ * @param ptr Original pointer returned from a previous allocation
+ * @param align Alignment in bytes, must be a power of two (0 for the
+ *              heap's default alignment)
+ * @param bytes Number of bytes requested for the new block
+ * @return Pointer to memory the caller can now use, or NULL
+ */
+void *sys_heap_aligned_realloc(struct sys_heap *h, void *ptr,
+			       size_t align, size_t bytes);
+
+/** @brief Change the size of an existing allocation
+ *
+ * As sys_heap_aligned_realloc() with the default alignment.
+ *
+ * @param h Heap from which to allocate
+ * @param ptr Original pointer returned from a previous allocation
+ * @param bytes Number of bytes requested for the new block
+ * @return Pointer to memory the caller can now use, or NULL
+ */
+static inline void *sys_heap_realloc(struct sys_heap *h, void *ptr,
+				     size_t bytes)
+{
+	return sys_heap_aligned_realloc(h, ptr, 0, bytes);
+}
+
+/** @brief Return cached chunks to a sys_heap
+ *
+ * With CONFIG_SYS_HEAP_CACHE, freed chunks of the smallest sizes are
+ * held in per-size caches rather than being merged back into the
+ * heap.  This is done automatically when an allocation would
+ * otherwise fail, but can be called explicitly (e.g. before
+ * allocating a large block) to reduce fragmentation.
+ *
+ * @note Same synchronization rules as sys_heap_free().
+ *
+ * @param h Heap whose caches to flush
+ */
+void sys_heap_cache_flush(struct sys_heap *h);
+
+/** @brief Get size class cache statistics
+ *
+ * @param h Heap to query
+ * @param stats Struct into which to store the statistics
+ */
+void sys_heap_cache_stats_get(struct sys_heap *h,
+			      struct sys_heap_cache_stats *stats);
+
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+/** @brief Allocate from a magazine of cached blocks
+ *
+ * Returns a block of the right size class from the magazine, or NULL
+ * if it has none (or @a bytes is not a cached size).  Does not touch
+ * the heap's own data structures and so needs no heap lock, only
+ * exclusive access to @a mag.  Blocks obtained this way are freed as
+ * usual.
+ *
+ * @param h Heap the magazine belongs to
+ * @param mag Magazine to allocate from
+ * @param bytes Number of bytes requested
+ * @return Pointer to memory the caller can now use, or NULL
+ */
+void *sys_heap_magazine_alloc(struct sys_heap *h,
+			      struct sys_heap_magazine *mag, size_t bytes);
+
+/** @brief Free a block into a magazine
+ *
+ * Stores the block in the magazine if it is of a cached size and the
+ * magazine has room for it.  Same locking rules as
+ * sys_heap_magazine_alloc().
+ *
+ * @param h Heap the block and magazine belong to
+ * @param mag Magazine to free into
+ * @param mem A pointer previously returned by this heap
+ * @return true if the block was taken, false if the caller must
+ *         free it with sys_heap_free()
+ */
+bool sys_heap_magazine_free(struct sys_heap *h,
+			    struct sys_heap_magazine *mag, void *mem);
+
+/** @brief Add a magazine's hits and cached bytes to @a stats
+ *
+ * @param mag Magazine to account
+ * @param stats Statistics to add to
+ */
+void sys_heap_magazine_stats_add(struct sys_heap_magazine *mag,
+				 struct sys_heap_cache_stats *stats);
+
+/** @brief Return all blocks of a magazine to its heap
+ *
+ * @note Same synchronization rules as sys_heap_free(), plus exclusive
+ * access to @a mag.
+ *
+ * @param h Heap the magazine belongs to
+ * @param mag Magazine to empty
+ */
+void sys_heap_magazine_flush(struct sys_heap *h,
+			     struct sys_heap_magazine *mag);
+#endif
+
+/** @brief Get runtime statistics of a sys_heap
+ *
+ * The allocated byte count and its high water mark are maintained on
+ * every allocation and free when CONFIG_SYS_HEAP_RUNTIME_STATS is
+ * enabled, so reading them is constant time.  Each size bucket also
+ * tracks the size of its largest free chunk, so finding the largest
+ * free chunk is constant time too, except after that chunk left the
+ * bucket, when its free list is walked once to find the new one.
+ * The fragmentation index is derived from the two: 0 means all free
+ * memory is in one chunk, values close to 100 mean it is scattered
+ * over many small ones.
+ *
+ * @note Same synchronization rules as sys_heap_free().
+ *
+ * @param h Heap to query
+ * @param stats Struct into which to store the statistics
+ * @return 0 on success, -EINVAL if @a h or @a stats is NULL
+ */
+int sys_heap_runtime_stats_get(struct sys_heap *h,
+			       struct sys_heap_runtime_stats *stats);
+
+/* Constant time subset of sys_heap_runtime_stats_get(): fills in
+ * only the free, allocated and high water mark byte counts.
+ */
+void z_sys_heap_usage_get(struct sys_heap *h,
+			  struct sys_heap_runtime_stats *stats);
+
+/** @brief Reset the high water mark of a sys_heap
+ *
+ * Sets max_allocated_bytes to the currently allocated byte count.
+ *
+ * @param h Heap to reset
+ * @return 0 on success, -EINVAL if @a h is NULL
+ */
+int sys_heap_runtime_stats_reset_max(struct sys_heap *h);
+
 /** @brief Validate heap integrity
  *
  * Validates the internal integrity of a sys_heap.  Intended for unit
@@ -170,6 +170,20 @@
  * @param mutex Mutex object
  */
 #define sys_trace_mutex_unlock(mutex)
+
+/**
+ * @brief Trace the start of a work handler
+ * @param work_q Workqueue running the work item
+ * @param work Work item
+ */
+#define sys_trace_work_start(work_q, work)
+
+/**
+ * @brief Trace the end of a work handler
+ * @param work_q Workqueue running the work item
+ * @param work Work item
+ */
+#define sys_trace_work_end(work_q, work)
 /**
  * @}
  */
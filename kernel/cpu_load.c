@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief CPU load averages
+ *
+ * A timer samples the runtime statistics of every CPU and thread
+ * periodically, and folds the fraction of the sampling period each of them
+ * was busy for into exponentially weighted moving averages, one per window.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <spinlock.h>
+#include <kernel_internal.h>
+
+/* averages are kept in per mille, with this many fractional bits */
+#define LOAD_FRAC_BITS 10
+#define LOAD_FULL (1000U << LOAD_FRAC_BITS)
+
+BUILD_ASSERT(CONFIG_CPU_LOAD_WINDOW_SHORT >= CONFIG_CPU_LOAD_SAMPLE_PERIOD &&
+	     CONFIG_CPU_LOAD_WINDOW_MEDIUM >= CONFIG_CPU_LOAD_SAMPLE_PERIOD &&
+	     CONFIG_CPU_LOAD_WINDOW_LONG >= CONFIG_CPU_LOAD_SAMPLE_PERIOD,
+	     "CPU load windows must not be shorter than the sampling period");
+
+static const uint32_t windows_ms[K_LOAD_WINDOWS] = {
+	[K_LOAD_WINDOW_SHORT] = CONFIG_CPU_LOAD_WINDOW_SHORT,
+	[K_LOAD_WINDOW_MEDIUM] = CONFIG_CPU_LOAD_WINDOW_MEDIUM,
+	[K_LOAD_WINDOW_LONG] = CONFIG_CPU_LOAD_WINDOW_LONG,
+};
+
+struct sample {
+	uint64_t period;
+	uint32_t now;
+};
+
+struct cpu_load {
+	struct k_cpu_runtime_stats sampled;
+	uint32_t busy[K_LOAD_WINDOWS];
+	uint32_t isr[K_LOAD_WINDOWS];
+};
+
+static struct k_spinlock lock;
+static struct cpu_load cpu_loads[CONFIG_MP_NUM_CPUS];
+static struct k_timer sample_timer;
+static int64_t sampled_ticks;
+
+static void load_update(uint32_t load[K_LOAD_WINDOWS], uint64_t cycles,
+			uint64_t period)
+{
+	uint32_t sample = (uint32_t)MIN(cycles * LOAD_FULL / period,
+					(uint64_t)LOAD_FULL);
+
+	for (int i = 0; i < K_LOAD_WINDOWS; i++) {
+		int64_t diff = (int64_t)sample - load[i];
+
+		load[i] += diff * CONFIG_CPU_LOAD_SAMPLE_PERIOD /
+			   (int64_t)windows_ms[i];
+	}
+}
+
+static void load_avg_get(const uint32_t load[K_LOAD_WINDOWS],
+			 struct k_load_avg *avg)
+{
+	for (int i = 0; i < K_LOAD_WINDOWS; i++) {
+		avg->avg[i] = (load[i] + BIT(LOAD_FRAC_BITS - 1)) >>
+			      LOAD_FRAC_BITS;
+	}
+}
+
+static void thread_sample(const struct k_thread *cthread, void *user_data)
+{
+	struct k_thread *thread = (struct k_thread *)cthread;
+	struct sample *sample = user_data;
+	uint64_t cycles, total;
+	k_spinlock_key_t key;
+
+	/* called with the thread list locked, which readers of the thread
+	 * loads take first as well
+	 */
+	key = k_spin_lock(&lock);
+
+	total = z_thread_runtime_cycles(thread, sample->now);
+	cycles = total - thread->rt_stats.sampled_cycles;
+	thread->rt_stats.sampled_cycles = total;
+
+	load_update(thread->rt_stats.load, cycles, sample->period);
+
+	k_spin_unlock(&lock, key);
+}
+
+static void sample_expired(struct k_timer *timer)
+{
+	struct k_cpu_runtime_stats stats;
+	struct sample sample;
+	k_spinlock_key_t key;
+	int64_t now;
+
+	key = k_spin_lock(&lock);
+
+	now = k_uptime_ticks();
+	sample.period = k_ticks_to_cyc_floor64(now - sampled_ticks);
+	sampled_ticks = now;
+
+	if (sample.period == 0U) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	/* every CPU and thread is read as of the same cycle count */
+	sample.now = k_cycle_get_32();
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct cpu_load *load = &cpu_loads[i];
+
+		z_cpu_runtime_stats_read(i, sample.now, &stats);
+		load_update(load->busy,
+			    (stats.busy_cycles - load->sampled.busy_cycles) +
+			    (stats.isr_cycles - load->sampled.isr_cycles),
+			    sample.period);
+		load_update(load->isr,
+			    stats.isr_cycles - load->sampled.isr_cycles,
+			    sample.period);
+		load->sampled = stats;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	/* not under the lock, which thread_sample() takes per thread:
+	 * k_thread_load_get() is called from k_thread_foreach() callbacks
+	 */
+	k_thread_foreach(thread_sample, &sample);
+}
+
+int k_cpu_load_get(int cpu, struct k_cpu_load *load)
+{
+	k_spinlock_key_t key;
+
+	if ((cpu < 0) || (cpu >= CONFIG_MP_NUM_CPUS) || (load == NULL)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	load_avg_get(cpu_loads[cpu].busy, &load->busy);
+	load_avg_get(cpu_loads[cpu].isr, &load->isr);
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+int k_thread_load_get(k_tid_t thread, struct k_load_avg *load)
+{
+	k_spinlock_key_t key;
+
+	if ((thread == NULL) || (load == NULL)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	load_avg_get(thread->rt_stats.load, load);
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+static int cpu_load_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	sampled_ticks = k_uptime_ticks();
+	k_timer_init(&sample_timer, sample_expired, NULL);
+	k_timer_start(&sample_timer, K_MSEC(CONFIG_CPU_LOAD_SAMPLE_PERIOD),
+		      K_MSEC(CONFIG_CPU_LOAD_SAMPLE_PERIOD));
+
+	return 0;
+}
+
+SYS_INIT(cpu_load_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -8,6 +8,9 @@
 #include <device.h>
 #include <sys/atomic.h>
 #include <syscall_handler.h>
+#include <kernel_internal.h>
+#include <ksched.h>
+#include <wait_q.h>
 
 extern const struct init_entry __init_start[];
 extern const struct init_entry __init_PRE_KERNEL_1_start[];
@@ -23,7 +26,10 @@ extern const struct init_entry __init_SMP_start[];
 extern const struct device __device_start[];
 extern const struct device __device_end[];
 
-extern uint32_t __device_init_status_start[];
+/* Set bit: the device failed its initialization, or has not finished
+ * an asynchronous one yet.  Devices may be initialized concurrently.
+ */
+extern atomic_t __device_init_status_start[];
 
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
 extern uint32_t __device_busy_start[];
@@ -31,6 +37,224 @@ extern uint32_t __device_busy_end[];
 #define DEVICE_BUSY_SIZE (__device_busy_end - __device_busy_start)
 #endif
 
+static int device_init_entry(const struct init_entry *entry)
+{
+	const struct device *dev = entry->dev;
+	int ret = entry->init(dev);
+
+	if ((ret != 0) && (dev != NULL)) {
+		/* Initialization failed.
+		 * Set the init status bit so device is not declared ready.
+		 */
+		atomic_set_bit(__device_init_status_start,
+			       (dev - __device_start));
+	}
+
+	return ret;
+}
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+/* Life cycle of an asynchronously initialized device.  Its level has
+ * not been reached while IDLE, which is the state of a device that is
+ * initialized in sequence as well.  DEFERRED and QUEUED devices are
+ * claimed with a CAS to RUNNING, by a worker or by the first
+ * device_get_binding() on them, whichever comes first.
+ */
+enum {
+	ASYNC_IDLE,
+	ASYNC_DEFERRED,
+	ASYNC_QUEUED,
+	ASYNC_RUNNING,
+	ASYNC_DONE,
+};
+
+static K_KERNEL_STACK_ARRAY_DEFINE(async_stacks,
+				   CONFIG_DEVICE_INIT_ASYNC_THREADS,
+				   CONFIG_DEVICE_INIT_ASYNC_STACK_SIZE);
+static struct k_thread async_threads[CONFIG_DEVICE_INIT_ASYNC_THREADS];
+static bool async_started;
+static bool async_closing;
+
+/* One token per queued device, plus one per worker on closing */
+static K_SEM_DEFINE(async_ready, 0, UINT_MAX);
+
+/* Threads waiting for a RUNNING device to finish */
+static struct k_spinlock async_lock;
+static _wait_q_t async_wait_q = Z_WAIT_Q_INIT(&async_wait_q);
+
+static const struct device_init_async *async_find(const struct device *dev)
+{
+	Z_STRUCT_SECTION_FOREACH(device_init_async, a) {
+		if (a->dev == dev) {
+			return a;
+		}
+	}
+
+	return NULL;
+}
+
+static bool async_claim(const struct device_init_async *a)
+{
+	return atomic_cas(&a->data->state, ASYNC_QUEUED, ASYNC_RUNNING) ||
+	       atomic_cas(&a->data->state, ASYNC_DEFERRED, ASYNC_RUNNING);
+}
+
+static void async_run(const struct device_init_async *a)
+{
+	k_spinlock_key_t key;
+
+	for (size_t i = 0; i < a->num_deps; i++) {
+		(void)z_impl_device_get_binding(a->deps[i]);
+	}
+
+	if (device_init_entry(a->data->entry) == 0) {
+		atomic_clear_bit(__device_init_status_start,
+				 (a->dev - __device_start));
+	}
+
+	key = k_spin_lock(&async_lock);
+	atomic_set(&a->data->state, ASYNC_DONE);
+	if (z_unpend_all(&async_wait_q) != 0) {
+		z_reschedule(&async_lock, key);
+	} else {
+		k_spin_unlock(&async_lock, key);
+	}
+}
+
+/* Make sure @dev is initialized if its init level has been reached:
+ * run its initialization now if still pending, or wait for whoever
+ * runs it.  Interrupts and the pre-kernel boot cannot wait and get a
+ * device that is not ready yet.
+ */
+static void async_complete(const struct device *dev)
+{
+	const struct device_init_async *a = async_find(dev);
+	k_spinlock_key_t key;
+
+	if (a == NULL) {
+		return;
+	}
+
+	if (async_claim(a)) {
+		async_run(a);
+		return;
+	}
+
+	if (k_is_in_isr() || k_is_pre_kernel()) {
+		return;
+	}
+
+	key = k_spin_lock(&async_lock);
+	while (atomic_get(&a->data->state) == ASYNC_RUNNING) {
+		(void)z_pend_curr(&async_lock, key, &async_wait_q, K_FOREVER);
+		key = k_spin_lock(&async_lock);
+	}
+	k_spin_unlock(&async_lock, key);
+}
+
+static void async_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (;;) {
+		bool ran = false;
+
+		k_sem_take(&async_ready, K_FOREVER);
+
+		Z_STRUCT_SECTION_FOREACH(device_init_async, a) {
+			if (atomic_cas(&a->data->state, ASYNC_QUEUED,
+				       ASYNC_RUNNING)) {
+				async_run(a);
+				ran = true;
+				break;
+			}
+		}
+
+		/* Nothing gets queued after closing, so once a
+		 * worker finds the queue empty it is done for good.
+		 */
+		if (!ran && async_closing) {
+			return;
+		}
+	}
+}
+
+static void async_start(void)
+{
+	for (int i = 0; i < CONFIG_DEVICE_INIT_ASYNC_THREADS; i++) {
+		k_thread_create(&async_threads[i], async_stacks[i],
+				K_KERNEL_STACK_SIZEOF(async_stacks[i]),
+				async_worker, NULL, NULL, NULL,
+				CONFIG_DEVICE_INIT_ASYNC_PRIORITY, 0,
+				K_NO_WAIT);
+		k_thread_name_set(&async_threads[i], "devinit");
+	}
+	async_started = true;
+}
+
+static void async_close(void)
+{
+	if (!async_started) {
+		return;
+	}
+
+	async_closing = true;
+	for (int i = 0; i < CONFIG_DEVICE_INIT_ASYNC_THREADS; i++) {
+		k_sem_give(&async_ready);
+	}
+}
+
+/* Hand the entry over if its device is marked for asynchronous or
+ * deferred initialization, returns false if it must run in sequence.
+ */
+static bool async_dispatch(const struct init_entry *entry, int32_t level)
+{
+	const struct device_init_async *a;
+
+	if ((entry->dev == NULL) ||
+	    ((level != _SYS_INIT_LEVEL_POST_KERNEL) &&
+	     (level != _SYS_INIT_LEVEL_APPLICATION))) {
+		return false;
+	}
+
+	a = async_find(entry->dev);
+	if (a == NULL) {
+		return false;
+	}
+
+	/* Not ready until async_run() is done with it */
+	atomic_set_bit(__device_init_status_start,
+		       (entry->dev - __device_start));
+
+	a->data->entry = entry;
+	if (a->deferred) {
+		atomic_set(&a->data->state, ASYNC_DEFERRED);
+		return true;
+	}
+
+	if (!async_started) {
+		async_start();
+	}
+	atomic_set(&a->data->state, ASYNC_QUEUED);
+	k_sem_give(&async_ready);
+
+	return true;
+}
+#endif /* CONFIG_DEVICE_INIT_ASYNC */
+
+/* Readiness check of device_get_binding(), which first completes a
+ * pending asynchronous initialization.
+ */
+static bool device_lookup_ready(const struct device *dev)
+{
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+	async_complete(dev);
+#endif
+	return z_device_ready(dev);
+}
+
 /**
  * @brief Execute all the init entry initialization functions at a given level
  *
@@ -64,34 +288,120 @@ void z_sys_init_run_level(int32_t level)
 			z_object_init(dev);
 		}
 
-		if ((entry->init(dev) != 0) && (dev != NULL)) {
-			/* Initialization failed.
-			 * Set the init status bit so device is not declared ready.
-			 */
-			sys_bitfield_set_bit(
-				(mem_addr_t) __device_init_status_start,
-				(dev - __device_start));
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+		if (async_dispatch(entry, level)) {
+			continue;
+		}
+#endif
+		device_init_entry(entry);
+	}
+
+#ifdef CONFIG_DEVICE_INIT_ASYNC
+	if (level == _SYS_INIT_LEVEL_APPLICATION) {
+		async_close();
+	}
+#endif
+}
+
+#ifdef CONFIG_DEVICE_NAME_HASH
+#define NAME_HASH_SLOTS CONFIG_DEVICE_NAME_HASH_SIZE
+#define NAME_HASH_MASK (NAME_HASH_SLOTS - 1U)
+
+BUILD_ASSERT((NAME_HASH_SLOTS & NAME_HASH_MASK) == 0,
+	     "CONFIG_DEVICE_NAME_HASH_SIZE must be a power of two");
+BUILD_ASSERT((NAME_HASH_SLOTS / 4U) * 3U <= UINT16_MAX,
+	     "device indices must fit in the hash table entries");
+
+/* Open addressing table with linear probing, holding 1 + the index
+ * of each device in the device array (0 marks an empty slot).
+ * Devices are inserted in array order, so among devices sharing a
+ * name a lookup meets them in the same order as the linear scan.
+ * The table is never more than 3/4 full, so with at most 1024 slots
+ * the indices always fit in 16 bits.
+ *
+ * The table could be generated after the final link, as the kernel
+ * object table is.  That takes an extra link pass, which the kernel
+ * object table only needs because userspace already requires it.
+ * Here it would be paid by every build enabling this option, to save
+ * hashing each device name once at boot.
+ */
+static uint16_t name_hash[NAME_HASH_SLOTS];
+static bool name_hash_built;
+
+/* FNV-1a */
+static uint32_t hash_name(const char *name)
+{
+	uint32_t h = 2166136261U;
+
+	while (*name != '\0') {
+		h = (h ^ (uint8_t)*name++) * 16777619U;
+	}
+	return h;
+}
+
+void z_device_name_hash_init(void)
+{
+	size_t count = __device_end - __device_start;
+
+	if (count > (NAME_HASH_SLOTS / 4U) * 3U) {
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		uint32_t slot = hash_name(__device_start[i].name);
+
+		while (name_hash[slot & NAME_HASH_MASK] != 0U) {
+			slot++;
 		}
+		name_hash[slot & NAME_HASH_MASK] = i + 1U;
 	}
+
+	name_hash_built = true;
 }
 
+static const struct device *name_hash_lookup(const char *name)
+{
+	uint32_t slot = hash_name(name);
+	uint16_t entry;
+
+	while ((entry = name_hash[slot & NAME_HASH_MASK]) != 0U) {
+		const struct device *dev = &__device_start[entry - 1U];
+
+		if (((dev->name == name) || (strcmp(name, dev->name) == 0)) &&
+		    device_lookup_ready(dev)) {
+			return dev;
+		}
+		slot++;
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_DEVICE_NAME_HASH */
+
 const struct device *z_impl_device_get_binding(const char *name)
 {
 	const struct device *dev;
 
+#ifdef CONFIG_DEVICE_NAME_HASH
+	if (name_hash_built) {
+		return name_hash_lookup(name);
+	}
+#endif
+
 	/* Split the search into two loops: in the common scenario, where
 	 * device names are stored in ROM (and are referenced by the user
 	 * with CONFIG_* macros), only cheap pointer comparisons will be
 	 * performed. Reserve string comparisons for a fallback.
 	 */
 	for (dev = __device_start; dev != __device_end; dev++) {
-		if (z_device_ready(dev) && (dev->name == name)) {
+		if ((dev->name == name) && device_lookup_ready(dev)) {
 			return dev;
 		}
 	}
 
 	for (dev = __device_start; dev != __device_end; dev++) {
-		if (z_device_ready(dev) && (strcmp(name, dev->name) == 0)) {
+		if ((strcmp(name, dev->name) == 0) &&
+		    device_lookup_ready(dev)) {
 			return dev;
 		}
 	}
@@ -122,9 +432,8 @@ size_t z_device_get_all_static(struct device const **devices)
 
 bool z_device_ready(const struct device *dev)
 {
-	/* Set bit indicates device failed initialization */
-	return !(sys_bitfield_test_bit((mem_addr_t)__device_init_status_start,
-					(dev - __device_start)));
+	return !atomic_test_bit(__device_init_status_start,
+				(dev - __device_start));
 }
 
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
@@ -37,6 +37,15 @@ static inline void z_data_copy(void)
 #endif
 FUNC_NORETURN void z_cstart(void);
 
+#ifdef CONFIG_DEVICE_NAME_HASH
+void z_device_name_hash_init(void);
+#else
+static inline void z_device_name_hash_init(void)
+{
+	/* Do nothing */
+}
+#endif
+
 extern FUNC_NORETURN void z_thread_entry(k_thread_entry_t entry,
 			  void *p1, void *p2, void *p3);
 
@@ -70,6 +79,11 @@ extern void z_thread_essential_clear(void);
 
 #if defined(CONFIG_THREAD_MONITOR)
 extern void z_thread_monitor_exit(struct k_thread *thread);
+
+/* true if k_thread_foreach_unlocked() calls in progress when the thread
+ * exited may still not have returned
+ */
+extern bool z_thread_monitor_walked(struct k_thread *thread);
 #else
 #define z_thread_monitor_exit(thread) \
 	do {/* nothing */    \
@@ -173,6 +187,26 @@ void z_thread_mark_switched_out(void);
 
 #endif /* CONFIG_INSTRUMENT_THREAD_SWITCHING */
 
+#ifdef CONFIG_CPU_LOAD
+/* Read the cycles accounted to a thread or CPU, adding the time in
+ * progress up to now, which a load sample reads once for all of them.
+ */
+uint64_t z_thread_runtime_cycles(struct k_thread *thread, uint32_t now);
+void z_cpu_runtime_stats_read(int id, uint32_t now,
+			      struct k_cpu_runtime_stats *stats);
+#endif /* CONFIG_CPU_LOAD */
+
+#ifdef CONFIG_CPU_LOAD_ISR
+/* Called by the arch layer when entering and leaving an ISR, so that the
+ * time spent in ISRs is not accounted to the interrupted thread.
+ */
+void z_cpu_load_isr_enter(void);
+void z_cpu_load_isr_exit(void);
+#else
+#define z_cpu_load_isr_enter()
+#define z_cpu_load_isr_exit()
+#endif /* CONFIG_CPU_LOAD_ISR */
+
 #ifdef __cplusplus
 }
 #endif
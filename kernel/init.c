@@ -376,6 +376,9 @@ FUNC_NORETURN void z_cstart(void)
 	z_dummy_thread_init(&dummy_thread);
 #endif
 
+	/* index devices by name before any driver looks one up */
+	z_device_name_hash_init();
+
 	/* perform basic hardware initialization */
 	z_sys_init_run_level(_SYS_INIT_LEVEL_PRE_KERNEL_1);
 	z_sys_init_run_level(_SYS_INIT_LEVEL_PRE_KERNEL_2);
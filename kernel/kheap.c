@@ -8,18 +8,184 @@
 #include <ksched.h>
 #include <wait_q.h>
 #include <init.h>
+#include <string.h>
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
 	z_waitq_init(&h->wait_q);
 	sys_heap_init(&h->heap, mem, bytes);
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	(void)memset(h->cpu_cache, 0, sizeof(h->cpu_cache));
+	h->waiters = 0;
+#endif
 }
 
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+/* Each CPU has a magazine of small blocks in front of the heap, with
+ * its own lock so that the common case never touches the shared heap
+ * lock.  Any CPU may flush any magazine, which lets a thread about to
+ * block flush them all, and "waiters" (incremented before that
+ * flush) tells a freeing CPU that it must not park blocks in its
+ * magazine where the waiter could miss them.  Lock order is the heap
+ * lock first, then magazine locks.
+ */
+static struct z_heap_cpu_cache *cpu_cache(struct k_heap *h)
+{
+	/* Migrating after reading the ID is harmless, we just end up
+	 * using another CPU's magazine
+	 */
+	return &h->cpu_cache[arch_curr_cpu()->id];
+}
+
+static void *cpu_cache_alloc(struct k_heap *h, size_t bytes)
+{
+	struct z_heap_cpu_cache *cc = cpu_cache(h);
+	k_spinlock_key_t key = k_spin_lock(&cc->lock);
+	void *ret = sys_heap_magazine_alloc(&h->heap, &cc->mag, bytes);
+
+	k_spin_unlock(&cc->lock, key);
+	return ret;
+}
+
+static bool cpu_cache_free(struct k_heap *h, void *mem)
+{
+	struct z_heap_cpu_cache *cc = cpu_cache(h);
+	k_spinlock_key_t key = k_spin_lock(&cc->lock);
+	bool ret = h->waiters == 0 &&
+		sys_heap_magazine_free(&h->heap, &cc->mag, mem);
+
+	k_spin_unlock(&cc->lock, key);
+	return ret;
+}
+
+/* Called with the heap lock held */
+static void cpu_cache_flush_all(struct k_heap *h)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_heap_cpu_cache *cc = &h->cpu_cache[i];
+		k_spinlock_key_t key = k_spin_lock(&cc->lock);
+
+		sys_heap_magazine_flush(&h->heap, &cc->mag);
+		k_spin_unlock(&cc->lock, key);
+	}
+}
+#endif
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+void k_heap_cache_stats_get(struct k_heap *h,
+			    struct sys_heap_cache_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	sys_heap_cache_stats_get(&h->heap, stats);
+
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_heap_cpu_cache *cc = &h->cpu_cache[i];
+		k_spinlock_key_t ckey = k_spin_lock(&cc->lock);
+
+		sys_heap_magazine_stats_add(&cc->mag, stats);
+		k_spin_unlock(&cc->lock, ckey);
+	}
+#endif
+
+	k_spin_unlock(&h->lock, key);
+}
+#endif
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+int k_heap_runtime_stats_get(struct k_heap *h,
+			     struct sys_heap_runtime_stats *stats)
+{
+	k_spinlock_key_t key;
+	int ret;
+
+	if (h == NULL || stats == NULL) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&h->lock);
+
+	ret = sys_heap_runtime_stats_get(&h->heap, stats);
+
+	k_spin_unlock(&h->lock, key);
+	return ret;
+}
+
+int k_heap_runtime_stats_reset_max(struct k_heap *h)
+{
+	k_spinlock_key_t key;
+	int ret;
+
+	if (h == NULL) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&h->lock);
+	ret = sys_heap_runtime_stats_reset_max(&h->heap);
+	k_spin_unlock(&h->lock, key);
+
+	return ret;
+}
+#endif
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS_GROUP
+STATS_NAME_START(k_heap)
+STATS_NAME(k_heap, allocated_bytes)
+STATS_NAME(k_heap, free_bytes)
+STATS_NAME(k_heap, max_allocated_bytes)
+STATS_NAME(k_heap, alloc_failures)
+STATS_NAME_END(k_heap);
+
+/* Called with the heap lock held, only touches the constant time
+ * counters
+ */
+static void stats_update(struct k_heap *h, bool failed)
+{
+	struct sys_heap_runtime_stats stats;
+
+	z_sys_heap_usage_get(&h->heap, &stats);
+	h->stats.allocated_bytes = stats.allocated_bytes;
+	h->stats.free_bytes = stats.free_bytes;
+	h->stats.max_allocated_bytes = stats.max_allocated_bytes;
+	if (failed) {
+		STATS_INC(h->stats, alloc_failures);
+	}
+}
+
+int k_heap_stats_register(struct k_heap *h, const char *name)
+{
+	k_spinlock_key_t key;
+	int ret;
+
+	h->stats_name = name;
+	ret = stats_init_and_reg(&h->stats.s_hdr, STATS_SIZE_32,
+				 (sizeof(h->stats) - sizeof(struct stats_hdr))
+				 / STATS_SIZE_32,
+				 STATS_NAME_INIT_PARMS(k_heap), name);
+
+	key = k_spin_lock(&h->lock);
+	stats_update(h, false);
+	k_spin_unlock(&h->lock, key);
+
+	return ret;
+}
+#else
+static inline void stats_update(struct k_heap *h, bool failed)
+{
+	ARG_UNUSED(h);
+	ARG_UNUSED(failed);
+}
+#endif
+
 static int statics_init(const struct device *unused)
 {
 	ARG_UNUSED(unused);
 	Z_STRUCT_SECTION_FOREACH(k_heap, h) {
 		k_heap_init(h, h->heap.init_mem, h->heap.init_bytes);
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS_GROUP
+		(void)k_heap_stats_register(h, h->stats_name);
+#endif
 	}
 	return 0;
 }
@@ -30,13 +196,40 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 {
 	int64_t now, end = z_timeout_end_calc(timeout);
 	void *ret = NULL;
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	bool waiting = false;
+#endif
 
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
 
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	ret = cpu_cache_alloc(h, bytes);
+	if (ret != NULL) {
+		return ret;
+	}
+#endif
+
+	key = k_spin_lock(&h->lock);
+
 	while (ret == NULL) {
 		ret = sys_heap_alloc(&h->heap, bytes);
 
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+		if (ret == NULL) {
+			/* Stop frees parking blocks in magazines for as
+			 * long as we might wait, then reclaim the ones
+			 * already parked
+			 */
+			if (!waiting) {
+				h->waiters++;
+				waiting = true;
+			}
+			cpu_cache_flush_all(h);
+			ret = sys_heap_alloc(&h->heap, bytes);
+		}
+#endif
+
 		now = z_tick_get();
 		if ((ret != NULL) || ((end - now) <= 0)) {
 			break;
@@ -47,15 +240,31 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 		key = k_spin_lock(&h->lock);
 	}
 
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	if (waiting) {
+		h->waiters--;
+	}
+#endif
+
+	stats_update(h, ret == NULL && bytes != 0U);
 	k_spin_unlock(&h->lock, key);
 	return ret;
 }
 
 void k_heap_free(struct k_heap *h, void *mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	if (cpu_cache_free(h, mem)) {
+		return;
+	}
+#endif
+
+	key = k_spin_lock(&h->lock);
 
 	sys_heap_free(&h->heap, mem);
+	stats_update(h, false);
 
 	if (z_unpend_all(&h->wait_q) != 0) {
 		z_reschedule(&h->lock, key);
@@ -64,6 +273,74 @@ void k_heap_free(struct k_heap *h, void *mem)
 	}
 }
 
+void *k_heap_realloc(struct k_heap *h, void *mem, size_t bytes,
+		     k_timeout_t timeout)
+{
+	int64_t now, end = z_timeout_end_calc(timeout);
+	void *ret = NULL;
+	k_spinlock_key_t key;
+	size_t old_size;
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	bool waiting = false;
+#endif
+
+	if (mem == NULL) {
+		return k_heap_alloc(h, bytes, timeout);
+	}
+	if (bytes == 0U) {
+		k_heap_free(h, mem);
+		return NULL;
+	}
+
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	key = k_spin_lock(&h->lock);
+	old_size = sys_heap_usable_size(&h->heap, mem);
+
+	while (ret == NULL) {
+		ret = sys_heap_realloc(&h->heap, mem, bytes);
+
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+		if (ret == NULL) {
+			if (!waiting) {
+				h->waiters++;
+				waiting = true;
+			}
+			cpu_cache_flush_all(h);
+			ret = sys_heap_realloc(&h->heap, mem, bytes);
+		}
+#endif
+
+		now = z_tick_get();
+		if ((ret != NULL) || ((end - now) <= 0)) {
+			break;
+		}
+
+		(void) z_pend_curr(&h->lock, key, &h->wait_q,
+				   K_TICKS(end - now));
+		key = k_spin_lock(&h->lock);
+	}
+
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+	if (waiting) {
+		h->waiters--;
+	}
+#endif
+
+	stats_update(h, ret == NULL);
+
+	/* Only a shrink or a move gives memory back to the heap */
+	if ((ret != NULL) &&
+	    ((ret != mem) ||
+	     (sys_heap_usable_size(&h->heap, ret) < old_size)) &&
+	    (z_unpend_all(&h->wait_q) != 0)) {
+		z_reschedule(&h->lock, key);
+	} else {
+		k_spin_unlock(&h->lock, key);
+	}
+	return ret;
+}
+
 #ifdef CONFIG_MEM_POOL_HEAP_BACKEND
 /* Compatibility layer for legacy k_mem_pool code on top of a k_heap
  * backend.
@@ -13,7 +13,6 @@
 #include <sys/dlist.h>
 #include <ksched.h>
 #include <init.h>
-#include <sys/check.h>
 
 static struct k_spinlock lock;
 
@@ -35,11 +34,29 @@ static int create_free_list(struct k_mem_slab *slab)
 	char *p;
 
 	/* blocks must be word aligned */
-	CHECKIF(((slab->block_size | (uintptr_t)slab->buffer) &
-				(sizeof(void *) - 1)) != 0) {
+	if (((slab->block_size | (uintptr_t)slab->buffer) &
+	     (sizeof(void *) - 1)) != 0) {
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	atomic_val_t head = 0;
+
+	/* keep room for the ABA counter in the list head */
+	if (slab->num_blocks > Z_MEM_SLAB_MAX_BLOCKS) {
+		return -EINVAL;
+	}
+
+	p = slab->buffer;
+
+	for (j = 0U; j < slab->num_blocks; j++) {
+		*(uint32_t *)p = (uint32_t)head;
+		head = j + 1;
+		p += slab->block_size;
+	}
+	atomic_set(&slab->free_head, head);
+	atomic_clear(&slab->waiters);
+#else
 	slab->free_list = NULL;
 	p = slab->buffer;
 
@@ -48,6 +65,7 @@ static int create_free_list(struct k_mem_slab *slab)
 		slab->free_list = p;
 		p += slab->block_size;
 	}
+#endif
 	return 0;
 }
 
@@ -87,10 +105,17 @@ int k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->num_blocks = num_blocks;
 	slab->block_size = block_size;
 	slab->buffer = buffer;
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	atomic_clear(&slab->num_used);
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	atomic_clear(&slab->max_used);
+#endif
+#else
 	slab->num_used = 0U;
 
 #ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
 	slab->max_used = 0U;
+#endif
 #endif
 
 	rc = create_free_list(slab);
@@ -106,6 +131,160 @@ out:
 	return rc;
 }
 
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+
+/* The free blocks form a Treiber stack.  Rather than pointers, the
+ * links stored in the first word of each free block and the list head
+ * are 1-based block indices, with 0 terminating the list.  The bits of
+ * the head above those needed for an index hold a counter that is
+ * bumped on every push and pop, so a CAS based on a stale head fails
+ * even if the same block has meanwhile been popped and pushed back
+ * (the ABA problem).  create_free_list() limits the number of blocks
+ * so that the counter is at least CONFIG_MEM_SLAB_LOCKLESS_TAG_BITS
+ * wide.  A block's link word may be read after another
+ * CPU has popped the block and started writing to it, but the CAS
+ * then fails and the value is discarded.
+ */
+static inline uint32_t slab_idx_mask(struct k_mem_slab *slab)
+{
+	uint32_t bits = 32U - __builtin_clz(slab->num_blocks | 1U);
+
+	return (bits >= 32U) ? UINT32_MAX : (1U << bits) - 1U;
+}
+
+static inline char *slab_idx_to_block(struct k_mem_slab *slab, uint32_t idx)
+{
+	return slab->buffer + (size_t)(idx - 1U) * slab->block_size;
+}
+
+static bool slab_pop(struct k_mem_slab *slab, void **mem)
+{
+	uint32_t mask = slab_idx_mask(slab);
+	uint32_t old, new, idx;
+	char *block;
+
+	do {
+		old = (uint32_t)atomic_get(&slab->free_head);
+		idx = old & mask;
+		if (idx == 0U) {
+			return false;
+		}
+		block = slab_idx_to_block(slab, idx);
+		new = ((old & ~mask) + mask + 1U) |
+		      *(volatile uint32_t *)block;
+	} while (!atomic_cas(&slab->free_head, (atomic_val_t)old,
+			     (atomic_val_t)new));
+
+	*mem = block;
+
+#ifdef CONFIG_MEM_SLAB_TRACE_MAX_UTILIZATION
+	atomic_val_t used = atomic_inc(&slab->num_used) + 1;
+	atomic_val_t max;
+
+	do {
+		max = atomic_get(&slab->max_used);
+	} while (used > max && !atomic_cas(&slab->max_used, max, used));
+#else
+	(void)atomic_inc(&slab->num_used);
+#endif
+
+	return true;
+}
+
+static void slab_push(struct k_mem_slab *slab, void *mem)
+{
+	uint32_t mask = slab_idx_mask(slab);
+	uint32_t idx = ((char *)mem - slab->buffer) / slab->block_size + 1U;
+	uint32_t old, new;
+
+	(void)atomic_dec(&slab->num_used);
+
+	do {
+		old = (uint32_t)atomic_get(&slab->free_head);
+		*(volatile uint32_t *)mem = old & mask;
+		new = ((old & ~mask) + mask + 1U) | idx;
+	} while (!atomic_cas(&slab->free_head, (atomic_val_t)old,
+			     (atomic_val_t)new));
+}
+
+int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	int result;
+
+	if (slab_pop(slab, mem)) {
+		return 0;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		/* don't wait for a free block to become available */
+		*mem = NULL;
+		return -ENOMEM;
+	}
+
+	/* Announce ourselves before the final check, so that a
+	 * concurrent k_mem_slab_free() either makes its block visible
+	 * to the pop below or sees the waiter and takes the lock to
+	 * hand the block over once we are pended.
+	 */
+	key = k_spin_lock(&lock);
+	(void)atomic_inc(&slab->waiters);
+
+	if (slab_pop(slab, mem)) {
+		(void)atomic_dec(&slab->waiters);
+		k_spin_unlock(&lock, key);
+		return 0;
+	}
+
+	/* wait for a free block or timeout */
+	result = z_pend_curr(&lock, key, &slab->wait_q, timeout);
+	(void)atomic_dec(&slab->waiters);
+	if (result == 0) {
+		*mem = _current->base.swap_data;
+	}
+
+	return result;
+}
+
+void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
+{
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+	bool resched = false;
+	void *block;
+
+	slab_push(slab, *mem);
+
+	if (atomic_get(&slab->waiters) == 0) {
+		return;
+	}
+
+	/* Blocks may have been freed by other CPUs (or taken by the
+	 * fast path) in the meantime, so hand out whatever is on the
+	 * list for as long as there are threads waiting.  A waiter can
+	 * still time out under us, in which case the block goes back.
+	 */
+	key = k_spin_lock(&lock);
+	while (z_waitq_head(&slab->wait_q) != NULL && slab_pop(slab, &block)) {
+		pending_thread = z_unpend_first_thread(&slab->wait_q);
+		if (pending_thread == NULL) {
+			slab_push(slab, block);
+			break;
+		}
+		z_thread_return_value_set_with_data(pending_thread, 0, block);
+		z_ready_thread(pending_thread);
+		resched = true;
+	}
+
+	if (resched) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
+}
+
+#else
+
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, k_timeout_t timeout)
 {
 	k_spinlock_key_t key = k_spin_lock(&lock);
@@ -156,3 +335,5 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 		k_spin_unlock(&lock, key);
 	}
 }
+
+#endif /* CONFIG_MEM_SLAB_LOCKLESS */
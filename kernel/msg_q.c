@@ -58,6 +58,7 @@ void k_msgq_init(struct k_msgq *msgq, char *buffer, size_t msg_size,
 	msgq->used_msgs = 0;
 	msgq->flags = 0;
 	z_waitq_init(&msgq->wait_q);
+	z_waitq_init(&msgq->claim_wait_q);
 	msgq->lock = (struct k_spinlock) {};
 
 	SYS_TRACING_OBJ_INIT(k_msgq, msgq);
@@ -101,7 +102,8 @@ int z_vrfy_k_msgq_alloc_init(struct k_msgq *q, size_t msg_size,
 
 int k_msgq_cleanup(struct k_msgq *msgq)
 {
-	CHECKIF(z_waitq_head(&msgq->wait_q) != NULL) {
+	CHECKIF((z_waitq_head(&msgq->wait_q) != NULL) ||
+		(z_waitq_head(&msgq->claim_wait_q) != NULL)) {
 		return -EBUSY;
 	}
 
@@ -113,38 +115,113 @@ int k_msgq_cleanup(struct k_msgq *msgq)
 }
 
 
+static inline bool msgq_wake_claimers(struct k_msgq *msgq)
+{
+	return (z_waitq_head(&msgq->claim_wait_q) != NULL) &&
+	       (z_unpend_all(&msgq->claim_wait_q) != 0);
+}
+
+/* Hand a message to the first thread waiting to receive one, or add it
+ * to the ring buffer if none is waiting.  The queue must not be full.
+ * @a data may be the write pointer itself, for a message already built
+ * in place.  Returns true if a thread was made ready.
+ */
+static bool msgq_put_one(struct k_msgq *msgq, const void *data)
+{
+	struct k_thread *pending_thread;
+
+	pending_thread = z_unpend_first_thread(&msgq->wait_q);
+	if (pending_thread != NULL) {
+		/* give message to waiting thread */
+		(void)memcpy(pending_thread->base.swap_data, data,
+		       msgq->msg_size);
+		/* wake up waiting thread */
+		arch_thread_return_value_set(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		return true;
+	}
+
+	/* put message in queue */
+	if (data != msgq->write_ptr) {
+		(void)memcpy(msgq->write_ptr, data, msgq->msg_size);
+	}
+	msgq->write_ptr += msgq->msg_size;
+	if (msgq->write_ptr == msgq->buffer_end) {
+		msgq->write_ptr = msgq->buffer_start;
+	}
+	msgq->used_msgs++;
+
+	/* a thread waiting to claim a message can retry */
+	return msgq_wake_claimers(msgq);
+}
+
+/* Remove the first message from the ring buffer, copying it to @a data
+ * unless NULL, and refill the freed slot with the message of the first
+ * thread waiting to send, if any.  The queue must not be empty.
+ * Returns true if a thread was made ready.
+ */
+static bool msgq_get_one(struct k_msgq *msgq, void *data)
+{
+	struct k_thread *pending_thread;
+
+	/* take first available message from queue */
+	if (data != NULL) {
+		(void)memcpy(data, msgq->read_ptr, msgq->msg_size);
+	}
+	msgq->read_ptr += msgq->msg_size;
+	if (msgq->read_ptr == msgq->buffer_end) {
+		msgq->read_ptr = msgq->buffer_start;
+	}
+	msgq->used_msgs--;
+
+	/* handle first thread waiting to write (if any) */
+	pending_thread = z_unpend_first_thread(&msgq->wait_q);
+	if (pending_thread != NULL) {
+		/* add thread's message to queue */
+		(void)memcpy(msgq->write_ptr, pending_thread->base.swap_data,
+		       msgq->msg_size);
+		msgq->write_ptr += msgq->msg_size;
+		if (msgq->write_ptr == msgq->buffer_end) {
+			msgq->write_ptr = msgq->buffer_start;
+		}
+		msgq->used_msgs++;
+
+		/* wake up waiting thread */
+		arch_thread_return_value_set(pending_thread, 0);
+		z_ready_thread(pending_thread);
+		return true;
+	}
+
+	/* a thread waiting to claim a slot can retry */
+	return msgq_wake_claimers(msgq);
+}
+
+static void msgq_unlock(struct k_msgq *msgq, k_spinlock_key_t key,
+			bool resched)
+{
+	if (resched) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+}
+
 int z_impl_k_msgq_put(struct k_msgq *msgq, const void *data, k_timeout_t timeout)
 {
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
 
-	struct k_thread *pending_thread;
 	k_spinlock_key_t key;
 	int result;
 
 	key = k_spin_lock(&msgq->lock);
 
-	if (msgq->used_msgs < msgq->max_msgs) {
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIMED) != 0U) {
+		/* a message is being built in place at the write pointer */
+		result = -EBUSY;
+	} else if (msgq->used_msgs < msgq->max_msgs) {
 		/* message queue isn't full */
-		pending_thread = z_unpend_first_thread(&msgq->wait_q);
-		if (pending_thread != NULL) {
-			/* give message to waiting thread */
-			(void)memcpy(pending_thread->base.swap_data, data,
-			       msgq->msg_size);
-			/* wake up waiting thread */
-			arch_thread_return_value_set(pending_thread, 0);
-			z_ready_thread(pending_thread);
-			z_reschedule(&msgq->lock, key);
-			return 0;
-		} else {
-			/* put message in queue */
-			(void)memcpy(msgq->write_ptr, data, msgq->msg_size);
-			msgq->write_ptr += msgq->msg_size;
-			if (msgq->write_ptr == msgq->buffer_end) {
-				msgq->write_ptr = msgq->buffer_start;
-			}
-			msgq->used_msgs++;
-		}
-		result = 0;
+		msgq_unlock(msgq, key, msgq_put_one(msgq, data));
+		return 0;
 	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
 		/* don't wait for message space to become available */
 		result = -ENOMSG;
@@ -194,39 +271,16 @@ int z_impl_k_msgq_get(struct k_msgq *msgq, void *data, k_timeout_t timeout)
 	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
 
 	k_spinlock_key_t key;
-	struct k_thread *pending_thread;
 	int result;
 
 	key = k_spin_lock(&msgq->lock);
 
-	if (msgq->used_msgs > 0) {
-		/* take first available message from queue */
-		(void)memcpy(data, msgq->read_ptr, msgq->msg_size);
-		msgq->read_ptr += msgq->msg_size;
-		if (msgq->read_ptr == msgq->buffer_end) {
-			msgq->read_ptr = msgq->buffer_start;
-		}
-		msgq->used_msgs--;
-
-		/* handle first thread waiting to write (if any) */
-		pending_thread = z_unpend_first_thread(&msgq->wait_q);
-		if (pending_thread != NULL) {
-			/* add thread's message to queue */
-			(void)memcpy(msgq->write_ptr, pending_thread->base.swap_data,
-			       msgq->msg_size);
-			msgq->write_ptr += msgq->msg_size;
-			if (msgq->write_ptr == msgq->buffer_end) {
-				msgq->write_ptr = msgq->buffer_start;
-			}
-			msgq->used_msgs++;
-
-			/* wake up waiting thread */
-			arch_thread_return_value_set(pending_thread, 0);
-			z_ready_thread(pending_thread);
-			z_reschedule(&msgq->lock, key);
-			return 0;
-		}
-		result = 0;
+	if ((msgq->flags & K_MSGQ_FLAG_GET_CLAIMED) != 0U) {
+		/* the first message is being read in place */
+		result = -EBUSY;
+	} else if (msgq->used_msgs > 0) {
+		msgq_unlock(msgq, key, msgq_get_one(msgq, data));
+		return 0;
 	} else if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
 		/* don't wait for a message to become available */
 		result = -ENOMSG;
@@ -253,6 +307,219 @@ static inline int z_vrfy_k_msgq_get(struct k_msgq *q, void *data,
 #include <syscalls/k_msgq_get_mrsh.c>
 #endif
 
+int z_impl_k_msgq_put_batch(struct k_msgq *msgq, const void *data,
+			    uint32_t num_msgs, k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	const char *src = data;
+	bool resched = false;
+	uint32_t count = 0;
+	k_spinlock_key_t key;
+	int result;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIMED) != 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EBUSY;
+	}
+
+	while ((count < num_msgs) && (msgq->used_msgs < msgq->max_msgs)) {
+		resched = msgq_put_one(msgq, src) || resched;
+		src += msgq->msg_size;
+		count++;
+	}
+
+	if ((count > 0U) || (num_msgs == 0U)) {
+		msgq_unlock(msgq, key, resched);
+		return count;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_spin_unlock(&msgq->lock, key);
+		return -ENOMSG;
+	}
+
+	/* queue full, wait as k_msgq_put() for the first message */
+	_current->base.swap_data = (void *) data;
+	result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+
+	return (result == 0) ? 1 : result;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_msgq_put_batch(struct k_msgq *q, const void *data,
+					  uint32_t num_msgs,
+					  k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_READ(data, num_msgs, q->msg_size));
+
+	return z_impl_k_msgq_put_batch(q, data, num_msgs, timeout);
+}
+#include <syscalls/k_msgq_put_batch_mrsh.c>
+#endif
+
+int z_impl_k_msgq_get_batch(struct k_msgq *msgq, void *data,
+			    uint32_t num_msgs, k_timeout_t timeout)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	char *dst = data;
+	bool resched = false;
+	uint32_t count = 0;
+	k_spinlock_key_t key;
+	int result;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if ((msgq->flags & K_MSGQ_FLAG_GET_CLAIMED) != 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EBUSY;
+	}
+
+	while ((count < num_msgs) && (msgq->used_msgs > 0)) {
+		resched = msgq_get_one(msgq, dst) || resched;
+		dst += msgq->msg_size;
+		count++;
+	}
+
+	if ((count > 0U) || (num_msgs == 0U)) {
+		msgq_unlock(msgq, key, resched);
+		return count;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		k_spin_unlock(&msgq->lock, key);
+		return -ENOMSG;
+	}
+
+	/* queue empty, wait as k_msgq_get() for a single message */
+	_current->base.swap_data = data;
+	result = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+
+	return (result == 0) ? 1 : result;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_msgq_get_batch(struct k_msgq *q, void *data,
+					  uint32_t num_msgs,
+					  k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(data, num_msgs, q->msg_size));
+
+	return z_impl_k_msgq_get_batch(q, data, num_msgs, timeout);
+}
+#include <syscalls/k_msgq_get_batch_mrsh.c>
+#endif
+
+/* Claim the slot under the write (@a put) or read pointer once there is
+ * room, respectively a message, waiting on claim_wait_q in between.
+ */
+static int msgq_claim(struct k_msgq *msgq, void **slot, k_timeout_t timeout,
+		      bool put)
+{
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	uint8_t flag = put ? K_MSGQ_FLAG_PUT_CLAIMED : K_MSGQ_FLAG_GET_CLAIMED;
+	uint64_t end = 0;
+	k_timeout_t wait = K_FOREVER;
+	k_spinlock_key_t key;
+	int result;
+
+	key = k_spin_lock(&msgq->lock);
+
+	for (;;) {
+		if ((msgq->flags & flag) != 0U) {
+			result = -EBUSY;
+			break;
+		}
+
+		if (put ? (msgq->used_msgs < msgq->max_msgs)
+			: (msgq->used_msgs > 0)) {
+			msgq->flags |= flag;
+			*slot = put ? msgq->write_ptr : msgq->read_ptr;
+			result = 0;
+			break;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			result = -ENOMSG;
+			break;
+		}
+
+		if (!K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+			int64_t remaining;
+
+			/* only pay for reading the clock when waiting */
+			if (end == 0U) {
+				end = z_timeout_end_calc(timeout);
+			}
+			remaining = end - z_tick_get();
+
+			if (remaining <= 0) {
+				result = -EAGAIN;
+				break;
+			}
+			wait = K_TICKS(remaining);
+		}
+
+		(void) z_pend_curr(&msgq->lock, key, &msgq->claim_wait_q,
+				   wait);
+		key = k_spin_lock(&msgq->lock);
+	}
+
+	k_spin_unlock(&msgq->lock, key);
+
+	return result;
+}
+
+int k_msgq_put_claim(struct k_msgq *msgq, void **slot, k_timeout_t timeout)
+{
+	return msgq_claim(msgq, slot, timeout, true);
+}
+
+int k_msgq_put_commit(struct k_msgq *msgq)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if ((msgq->flags & K_MSGQ_FLAG_PUT_CLAIMED) == 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EINVAL;
+	}
+
+	msgq->flags &= ~K_MSGQ_FLAG_PUT_CLAIMED;
+	msgq_unlock(msgq, key, msgq_put_one(msgq, msgq->write_ptr));
+
+	return 0;
+}
+
+int k_msgq_get_claim(struct k_msgq *msgq, void **slot, k_timeout_t timeout)
+{
+	return msgq_claim(msgq, slot, timeout, false);
+}
+
+int k_msgq_get_commit(struct k_msgq *msgq)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&msgq->lock);
+
+	if ((msgq->flags & K_MSGQ_FLAG_GET_CLAIMED) == 0U) {
+		k_spin_unlock(&msgq->lock, key);
+		return -EINVAL;
+	}
+
+	msgq->flags &= ~K_MSGQ_FLAG_GET_CLAIMED;
+	msgq_unlock(msgq, key, msgq_get_one(msgq, NULL));
+
+	return 0;
+}
+
 int z_impl_k_msgq_peek(struct k_msgq *msgq, void *data)
 {
 	k_spinlock_key_t key;
@@ -301,6 +568,10 @@ void z_impl_k_msgq_purge(struct k_msgq *msgq)
 	msgq->used_msgs = 0;
 	msgq->read_ptr = msgq->write_ptr;
 
+	/* a message claimed for reading is gone, slots are free to claim */
+	msgq->flags &= ~K_MSGQ_FLAG_GET_CLAIMED;
+	(void)z_unpend_all(&msgq->claim_wait_q);
+
 	z_reschedule(&msgq->lock, key);
 }
 
@@ -116,6 +116,39 @@ static bool adjust_owner_prio(struct k_mutex *mutex, int32_t new_prio)
 	return false;
 }
 
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+static inline bool owner_is_running(struct k_thread *owner)
+{
+	return _kernel.cpus[owner->base.cpu].current == owner;
+}
+
+/*
+ * Spin, with the lock released, while the mutex is owned by a thread
+ * running on another CPU, which will likely unlock it before this thread
+ * could pend and be switched back in.  Gives up once the owner stops
+ * running or changes, or the spin budget is spent.  Returns with the
+ * lock held again.
+ */
+static k_spinlock_key_t mutex_spin(struct k_mutex *mutex,
+				   k_spinlock_key_t key)
+{
+	struct k_thread *spun_on = mutex->owner;
+	uint32_t budget = k_us_to_cyc_ceil32(CONFIG_MUTEX_ADAPTIVE_SPIN_US);
+	uint32_t start = k_cycle_get_32();
+
+	k_spin_unlock(&lock, key);
+
+	/* the barrier makes each pass read the owner and CPU state again */
+	while ((mutex->owner == spun_on) && owner_is_running(spun_on) &&
+	       ((k_cycle_get_32() - start) < budget)) {
+		arch_nop();
+		compiler_barrier();
+	}
+
+	return k_spin_lock(&lock);
+}
+#endif /* CONFIG_MUTEX_ADAPTIVE_SPIN */
+
 int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 {
 	int new_prio;
@@ -127,6 +160,14 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 	sys_trace_mutex_lock(mutex);
 	key = k_spin_lock(&lock);
 
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+	if ((mutex->lock_count != 0U) && (mutex->owner != _current) &&
+	    !K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+	    owner_is_running(mutex->owner)) {
+		key = mutex_spin(mutex, key);
+	}
+#endif
+
 	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
 
 		mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
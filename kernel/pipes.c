@@ -20,10 +20,13 @@
 #include <syscall_handler.h>
 #include <kernel_internal.h>
 #include <sys/check.h>
+#include <sys/math_extras.h>
 
 struct k_pipe_desc {
 	unsigned char *buffer;           /* Position in src/dest buffer */
 	size_t bytes_to_xfer;            /* # bytes left to transfer */
+	size_t seg_bytes;                /* # bytes left at buffer */
+	const struct k_pipe_iovec *iov;  /* Next segments, if any */
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 	struct k_mem_block *block;       /* Pointer to memory block */
 	struct k_mem_block  copy_block;  /* For backwards compatibility */
@@ -134,8 +137,11 @@ void k_pipe_init(struct k_pipe *pipe, unsigned char *buffer, size_t size)
 	pipe->read_index = 0;
 	pipe->write_index = 0;
 	pipe->lock = (struct k_spinlock){};
+	pipe->put_claimed = 0;
+	pipe->get_claimed = 0;
 	z_waitq_init(&pipe->wait_q.writers);
 	z_waitq_init(&pipe->wait_q.readers);
+	z_waitq_init(&pipe->wait_q.claims);
 	SYS_TRACING_OBJ_INIT(k_pipe, pipe);
 	pipe->flags = 0;
 	z_object_init(pipe);
@@ -176,7 +182,8 @@ static inline int z_vrfy_k_pipe_alloc_init(struct k_pipe *pipe, size_t size)
 int k_pipe_cleanup(struct k_pipe *pipe)
 {
 	CHECKIF(z_waitq_head(&pipe->wait_q.readers) != NULL ||
-			z_waitq_head(&pipe->wait_q.writers) != NULL) {
+			z_waitq_head(&pipe->wait_q.writers) != NULL ||
+			z_waitq_head(&pipe->wait_q.claims) != NULL) {
 		return -EAGAIN;
 	}
 
@@ -208,6 +215,123 @@ static size_t pipe_xfer(unsigned char *dest, size_t dest_size,
 	return num_bytes;
 }
 
+/* Size of the free run of the pipe's circular buffer at write_index */
+static inline size_t pipe_put_run(struct k_pipe *pipe)
+{
+	return MIN(pipe->size - pipe->bytes_used,
+		   pipe->size - pipe->write_index);
+}
+
+/* Size of the used run of the pipe's circular buffer at read_index */
+static inline size_t pipe_get_run(struct k_pipe *pipe)
+{
+	return MIN(pipe->bytes_used, pipe->size - pipe->read_index);
+}
+
+/*
+ * Let threads waiting for space or data to claim retry, after the
+ * contents of the pipe's circular buffer changed. The pipe lock is held.
+ */
+static inline void pipe_claimers_ready(struct k_pipe *pipe)
+{
+	if (z_waitq_head(&pipe->wait_q.claims) != NULL) {
+		(void)z_unpend_all(&pipe->wait_q.claims);
+	}
+}
+
+/* Same as pipe_claimers_ready() with the scheduler locked instead */
+static void pipe_claimers_wake(struct k_pipe *pipe)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	pipe_claimers_ready(pipe);
+	k_spin_unlock(&pipe->lock, key);
+}
+
+/* Describe a single buffer of @a size bytes at @a buffer */
+static inline void pipe_desc_init(struct k_pipe_desc *desc,
+				  unsigned char *buffer, size_t size)
+{
+	desc->buffer = buffer;
+	desc->bytes_to_xfer = size;
+	desc->seg_bytes = size;
+	desc->iov = NULL;
+}
+
+/* Describe the @a iovcnt segments at @a iov, one after the other */
+static int pipe_desc_init_iov(struct k_pipe_desc *desc,
+			      const struct k_pipe_iovec *iov, size_t iovcnt)
+{
+	size_t size = 0;
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		if (size_add_overflow(size, iov[i].iov_len, &size)) {
+			return -EINVAL;
+		}
+	}
+
+	desc->buffer = NULL;
+	desc->bytes_to_xfer = size;
+	desc->seg_bytes = 0;
+	desc->iov = iov;
+
+	return 0;
+}
+
+/**
+ * @brief Get the size of the run of data or space at @a desc->buffer
+ *
+ * Moves on to the next non-empty segment when the current one is done.
+ *
+ * @return Number of bytes in the run, zero once the transfer is complete
+ */
+static size_t pipe_desc_run(struct k_pipe_desc *desc)
+{
+	while (desc->seg_bytes == 0 && desc->bytes_to_xfer > 0) {
+		desc->buffer = desc->iov->iov_base;
+		desc->seg_bytes = desc->iov->iov_len;
+		desc->iov++;
+	}
+
+	return desc->seg_bytes;
+}
+
+static inline void pipe_desc_advance(struct k_pipe_desc *desc, size_t bytes)
+{
+	desc->buffer        += bytes;
+	desc->seg_bytes     -= bytes;
+	desc->bytes_to_xfer -= bytes;
+}
+
+/**
+ * @brief Copy as much data as possible from @a src to @a dest
+ *
+ * @return Number of bytes copied
+ */
+static size_t pipe_desc_xfer(struct k_pipe_desc *dest,
+			     struct k_pipe_desc *src)
+{
+	size_t num_bytes = 0;
+	size_t run_length;
+
+	for (;;) {
+		run_length = pipe_desc_run(dest);
+		run_length = MIN(run_length, pipe_desc_run(src));
+		if (run_length == 0) {
+			break;
+		}
+
+		(void)pipe_xfer(dest->buffer, run_length,
+				src->buffer, run_length);
+
+		pipe_desc_advance(dest, run_length);
+		pipe_desc_advance(src, run_length);
+		num_bytes += run_length;
+	}
+
+	return num_bytes;
+}
+
 /**
  * @brief Put data from @a src into the pipe's circular buffer
  *
@@ -216,27 +340,25 @@ static size_t pipe_xfer(unsigned char *dest, size_t dest_size,
  *
  * @return Number of bytes written to the pipe's circular buffer
  */
-static size_t pipe_buffer_put(struct k_pipe *pipe,
-			       const unsigned char *src, size_t src_size)
+static size_t pipe_buffer_put(struct k_pipe *pipe, struct k_pipe_desc *src)
 {
-	size_t  bytes_copied;
 	size_t  run_length;
 	size_t  num_bytes_written = 0;
-	int     i;
-
 
-	for (i = 0; i < 2; i++) {
-		run_length = MIN(pipe->size - pipe->bytes_used,
-				 pipe->size - pipe->write_index);
+	for (;;) {
+		run_length = pipe_desc_run(src);
+		run_length = MIN(run_length, pipe_put_run(pipe));
+		if (run_length == 0) {
+			break;
+		}
 
-		bytes_copied = pipe_xfer(pipe->buffer + pipe->write_index,
-					  run_length,
-					  src + num_bytes_written,
-					  src_size - num_bytes_written);
+		(void)pipe_xfer(pipe->buffer + pipe->write_index, run_length,
+				src->buffer, run_length);
 
-		num_bytes_written += bytes_copied;
-		pipe->bytes_used += bytes_copied;
-		pipe->write_index += bytes_copied;
+		pipe_desc_advance(src, run_length);
+		num_bytes_written += run_length;
+		pipe->bytes_used += run_length;
+		pipe->write_index += run_length;
 		if (pipe->write_index == pipe->size) {
 			pipe->write_index = 0;
 		}
@@ -246,33 +368,32 @@ static size_t pipe_buffer_put(struct k_pipe *pipe,
 }
 
 /**
- * @brief Get data from the pipe's circular buffer
+ * @brief Get data from the pipe's circular buffer into @a dest
  *
  * Modifies the following fields in @a pipe:
  *        bytes_used, read_index
  *
  * @return Number of bytes read from the pipe's circular buffer
  */
-static size_t pipe_buffer_get(struct k_pipe *pipe,
-			       unsigned char *dest, size_t dest_size)
+static size_t pipe_buffer_get(struct k_pipe *pipe, struct k_pipe_desc *dest)
 {
-	size_t  bytes_copied;
 	size_t  run_length;
 	size_t  num_bytes_read = 0;
-	int     i;
 
-	for (i = 0; i < 2; i++) {
-		run_length = MIN(pipe->bytes_used,
-				 pipe->size - pipe->read_index);
+	for (;;) {
+		run_length = pipe_desc_run(dest);
+		run_length = MIN(run_length, pipe_get_run(pipe));
+		if (run_length == 0) {
+			break;
+		}
 
-		bytes_copied = pipe_xfer(dest + num_bytes_read,
-					  dest_size - num_bytes_read,
-					  pipe->buffer + pipe->read_index,
-					  run_length);
+		(void)pipe_xfer(dest->buffer, run_length,
+				pipe->buffer + pipe->read_index, run_length);
 
-		num_bytes_read += bytes_copied;
-		pipe->bytes_used -= bytes_copied;
-		pipe->read_index += bytes_copied;
+		pipe_desc_advance(dest, run_length);
+		num_bytes_read += run_length;
+		pipe->bytes_used -= run_length;
+		pipe->read_index += run_length;
 		if (pipe->read_index == pipe->size) {
 			pipe->read_index = 0;
 		}
@@ -424,17 +545,18 @@ static void pipe_thread_ready(struct k_thread *thread)
 
 /**
  * @brief Internal API used to send data to a pipe
+ *
+ * Sends the data described by @a src, which is left describing the data
+ * not sent. If the caller pends, its descriptor is @a src.
  */
 int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
-			 unsigned char *data, size_t bytes_to_write,
-			 size_t *bytes_written, size_t min_xfer,
-			 k_timeout_t timeout)
+			 struct k_pipe_desc *src, size_t *bytes_written,
+			 size_t min_xfer, k_timeout_t timeout)
 {
 	struct k_thread    *reader;
 	struct k_pipe_desc *desc;
 	sys_dlist_t    xfer_list;
-	size_t         num_bytes_written = 0;
-	size_t         bytes_copied;
+	size_t         bytes_to_write = src->bytes_to_xfer;
 
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS == 0)
 	ARG_UNUSED(async_desc);
@@ -446,6 +568,23 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
+	if (pipe->put_claimed != 0) {
+		__ASSERT(async_desc == NULL, "pipe has a claim for writing");
+		k_spin_unlock(&pipe->lock, key);
+		*bytes_written = 0;
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+		/* Nobody sees the return value of k_pipe_block_put(), so
+		 * drop the block rather than leak it and its descriptor
+		 */
+		if (async_desc != NULL) {
+			z_sched_lock();
+			pipe_async_finish(async_desc);
+			k_sched_unlock();
+		}
+#endif
+		return -EBUSY;
+	}
+
 	/*
 	 * Create a list of "working readers" into which the data will be
 	 * directly copied.
@@ -478,13 +617,7 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 				  sys_dlist_get(&xfer_list);
 	while (thread != NULL) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_xfer(desc->buffer, desc->bytes_to_xfer,
-					  data + num_bytes_written,
-					  bytes_to_write - num_bytes_written);
-
-		num_bytes_written   += bytes_copied;
-		desc->buffer        += bytes_copied;
-		desc->bytes_to_xfer -= bytes_copied;
+		(void)pipe_desc_xfer(desc, src);
 
 		/* The thread's read request has been satisfied. Ready it. */
 		z_ready_thread(thread);
@@ -498,13 +631,7 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	 */
 	if (reader != NULL) {
 		desc = (struct k_pipe_desc *)reader->base.swap_data;
-		bytes_copied = pipe_xfer(desc->buffer, desc->bytes_to_xfer,
-					  data + num_bytes_written,
-					  bytes_to_write - num_bytes_written);
-
-		num_bytes_written   += bytes_copied;
-		desc->buffer        += bytes_copied;
-		desc->bytes_to_xfer -= bytes_copied;
+		(void)pipe_desc_xfer(desc, src);
 	}
 
 	/*
@@ -512,12 +639,12 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	 * readers. Add as much as possible to the pipe's circular buffer.
 	 */
 
-	num_bytes_written +=
-		pipe_buffer_put(pipe, data + num_bytes_written,
-				 bytes_to_write - num_bytes_written);
+	if (pipe_buffer_put(pipe, src) > 0) {
+		pipe_claimers_wake(pipe);
+	}
 
-	if (num_bytes_written == bytes_to_write) {
-		*bytes_written = num_bytes_written;
+	if (src->bytes_to_xfer == 0) {
+		*bytes_written = bytes_to_write;
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 		if (async_desc != NULL) {
 			pipe_async_finish(async_desc);
@@ -528,9 +655,9 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	}
 
 	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)
-	    && num_bytes_written >= min_xfer
+	    && bytes_to_write - src->bytes_to_xfer >= min_xfer
 	    && min_xfer > 0) {
-		*bytes_written = num_bytes_written;
+		*bytes_written = bytes_to_write - src->bytes_to_xfer;
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 		if (async_desc != NULL) {
 			pipe_async_finish(async_desc);
@@ -551,10 +678,6 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		k_spinlock_key_t key2 = k_spin_lock(&pipe->lock);
 		z_sched_unlock_no_reschedule();
 
-		async_desc->desc.buffer = data + num_bytes_written;
-		async_desc->desc.bytes_to_xfer =
-			bytes_to_write - num_bytes_written;
-
 		z_pend_thread((struct k_thread *) &async_desc->thread,
 			     &pipe->wait_q.writers, K_FOREVER);
 		z_reschedule(&pipe->lock, key2);
@@ -562,13 +685,8 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	}
 #endif
 
-	struct k_pipe_desc  pipe_desc;
-
-	pipe_desc.buffer         = data + num_bytes_written;
-	pipe_desc.bytes_to_xfer  = bytes_to_write - num_bytes_written;
-
 	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
-		_current->base.swap_data = &pipe_desc;
+		_current->base.swap_data = src;
 		/*
 		 * Lock interrupts and unlock the scheduler before
 		 * manipulating the writers wait_q.
@@ -581,20 +699,28 @@ int z_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		k_sched_unlock();
 	}
 
-	*bytes_written = bytes_to_write - pipe_desc.bytes_to_xfer;
+	*bytes_written = bytes_to_write - src->bytes_to_xfer;
 
-	return pipe_return_code(min_xfer, pipe_desc.bytes_to_xfer,
+	return pipe_return_code(min_xfer, src->bytes_to_xfer,
 				 bytes_to_write);
 }
 
-int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
-		     size_t *bytes_read, size_t min_xfer, k_timeout_t timeout)
+/**
+ * @brief Receive data from a pipe
+ *
+ * Receives data into the space described by @a dest, which is left
+ * describing the space not filled. If the caller pends, its descriptor
+ * is @a dest.
+ */
+static int pipe_get_internal(struct k_pipe *pipe, struct k_pipe_desc *dest,
+			     size_t *bytes_read, size_t min_xfer,
+			     k_timeout_t timeout)
 {
 	struct k_thread    *writer;
 	struct k_pipe_desc *desc;
 	sys_dlist_t    xfer_list;
-	size_t         num_bytes_read = 0;
-	size_t         bytes_copied;
+	size_t         bytes_to_read = dest->bytes_to_xfer;
+	size_t         bytes_buffered;
 
 	CHECKIF((min_xfer > bytes_to_read) || bytes_read == NULL) {
 		return -EINVAL;
@@ -602,6 +728,12 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
 
+	if (pipe->get_claimed != 0) {
+		k_spin_unlock(&pipe->lock, key);
+		*bytes_read = 0;
+		return -EBUSY;
+	}
+
 	/*
 	 * Create a list of "working readers" into which the data will be
 	 * directly copied.
@@ -617,7 +749,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 	z_sched_lock();
 	k_spin_unlock(&pipe->lock, key);
 
-	num_bytes_read = pipe_buffer_get(pipe, data, bytes_to_read);
+	bytes_buffered = pipe_buffer_get(pipe, dest);
 
 	/*
 	 * 1. 'xfer_list' currently contains a list of writer threads that can
@@ -635,15 +767,9 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	struct k_thread *thread = (struct k_thread *)
 				  sys_dlist_get(&xfer_list);
-	while ((thread != NULL) && (num_bytes_read < bytes_to_read)) {
+	while ((thread != NULL) && (dest->bytes_to_xfer > 0)) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_xfer((uint8_t *)data + num_bytes_read,
-					  bytes_to_read - num_bytes_read,
-					  desc->buffer, desc->bytes_to_xfer);
-
-		num_bytes_read       += bytes_copied;
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_desc_xfer(dest, desc);
 
 		/*
 		 * It is expected that the write request will be satisfied.
@@ -651,7 +777,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		 * write request was satisfied, then the write request must
 		 * finish later when writing to the pipe's circular buffer.
 		 */
-		if (num_bytes_read == bytes_to_read) {
+		if (dest->bytes_to_xfer == 0) {
 			break;
 		}
 		pipe_thread_ready(thread);
@@ -659,15 +785,9 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
 	}
 
-	if ((writer != NULL) && (num_bytes_read < bytes_to_read)) {
+	if ((writer != NULL) && (dest->bytes_to_xfer > 0)) {
 		desc = (struct k_pipe_desc *)writer->base.swap_data;
-		bytes_copied = pipe_xfer((uint8_t *)data + num_bytes_read,
-					  bytes_to_read - num_bytes_read,
-					  desc->buffer, desc->bytes_to_xfer);
-
-		num_bytes_read       += bytes_copied;
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_desc_xfer(dest, desc);
 	}
 
 	/*
@@ -677,11 +797,7 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	while (thread != NULL) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
-						desc->bytes_to_xfer);
-
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+		(void)pipe_buffer_put(pipe, desc);
 
 		/* Write request has been satisfied */
 		pipe_thread_ready(thread);
@@ -691,40 +807,39 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	if (writer != NULL) {
 		desc = (struct k_pipe_desc *)writer->base.swap_data;
-		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
-						desc->bytes_to_xfer);
+		(void)pipe_buffer_put(pipe, desc);
+	}
 
-		desc->buffer         += bytes_copied;
-		desc->bytes_to_xfer  -= bytes_copied;
+	/*
+	 * Writers only wait on a full buffer, so it can only have been
+	 * refilled if some of its data was read.
+	 */
+	if (bytes_buffered > 0) {
+		pipe_claimers_wake(pipe);
 	}
 
-	if (num_bytes_read == bytes_to_read) {
+	if (dest->bytes_to_xfer == 0) {
 		k_sched_unlock();
 
-		*bytes_read = num_bytes_read;
+		*bytes_read = bytes_to_read;
 
 		return 0;
 	}
 
 	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)
-	    && num_bytes_read >= min_xfer
+	    && bytes_to_read - dest->bytes_to_xfer >= min_xfer
 	    && min_xfer > 0) {
 		k_sched_unlock();
 
-		*bytes_read = num_bytes_read;
+		*bytes_read = bytes_to_read - dest->bytes_to_xfer;
 
 		return 0;
 	}
 
 	/* Not all data was read */
 
-	struct k_pipe_desc  pipe_desc;
-
-	pipe_desc.buffer        = (uint8_t *)data + num_bytes_read;
-	pipe_desc.bytes_to_xfer = bytes_to_read - num_bytes_read;
-
 	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
-		_current->base.swap_data = &pipe_desc;
+		_current->base.swap_data = dest;
 		k_spinlock_key_t key2 = k_spin_lock(&pipe->lock);
 
 		z_sched_unlock_no_reschedule();
@@ -734,12 +849,23 @@ int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		k_sched_unlock();
 	}
 
-	*bytes_read = bytes_to_read - pipe_desc.bytes_to_xfer;
+	*bytes_read = bytes_to_read - dest->bytes_to_xfer;
 
-	return pipe_return_code(min_xfer, pipe_desc.bytes_to_xfer,
+	return pipe_return_code(min_xfer, dest->bytes_to_xfer,
 				 bytes_to_read);
 }
 
+int z_impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
+		     size_t *bytes_read, size_t min_xfer, k_timeout_t timeout)
+{
+	struct k_pipe_desc pipe_desc;
+
+	pipe_desc_init(&pipe_desc, data, bytes_to_read);
+
+	return pipe_get_internal(pipe, &pipe_desc, bytes_read, min_xfer,
+				 timeout);
+}
+
 #ifdef CONFIG_USERSPACE
 int z_vrfy_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 		      size_t *bytes_read, size_t min_xfer, k_timeout_t timeout)
@@ -759,8 +885,11 @@ int z_impl_k_pipe_put(struct k_pipe *pipe, void *data, size_t bytes_to_write,
 		     size_t *bytes_written, size_t min_xfer,
 		      k_timeout_t timeout)
 {
-	return z_pipe_put_internal(pipe, NULL, data,
-				    bytes_to_write, bytes_written,
+	struct k_pipe_desc pipe_desc;
+
+	pipe_desc_init(&pipe_desc, data, bytes_to_write);
+
+	return z_pipe_put_internal(pipe, NULL, &pipe_desc, bytes_written,
 				    min_xfer, timeout);
 }
 
@@ -780,6 +909,120 @@ int z_vrfy_k_pipe_put(struct k_pipe *pipe, void *data, size_t bytes_to_write,
 #include <syscalls/k_pipe_put_mrsh.c>
 #endif
 
+int z_impl_k_pipe_writev(struct k_pipe *pipe,
+			 const struct k_pipe_iovec *iov, size_t iovcnt,
+			 size_t *bytes_written, size_t min_xfer,
+			 k_timeout_t timeout)
+{
+	struct k_pipe_desc pipe_desc;
+
+	CHECKIF(pipe_desc_init_iov(&pipe_desc, iov, iovcnt) != 0) {
+		return -EINVAL;
+	}
+
+	return z_pipe_put_internal(pipe, NULL, &pipe_desc, bytes_written,
+				    min_xfer, timeout);
+}
+
+int z_impl_k_pipe_readv(struct k_pipe *pipe,
+			const struct k_pipe_iovec *iov, size_t iovcnt,
+			size_t *bytes_read, size_t min_xfer,
+			k_timeout_t timeout)
+{
+	struct k_pipe_desc pipe_desc;
+
+	CHECKIF(pipe_desc_init_iov(&pipe_desc, iov, iovcnt) != 0) {
+		return -EINVAL;
+	}
+
+	return pipe_get_internal(pipe, &pipe_desc, bytes_read, min_xfer,
+				 timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+/*
+ * Copy the segment array of a user thread, so that it can't change while
+ * in use, and check the thread may access the segments.
+ */
+static struct k_pipe_iovec *pipe_iov_copy(const struct k_pipe_iovec *iov,
+					  size_t iovcnt, bool write)
+{
+	struct k_pipe_iovec *iov_copy;
+	size_t size;
+	int ret = 0;
+
+	Z_OOPS(size_mul_overflow(iovcnt, sizeof(*iov), &size));
+	Z_OOPS(Z_SYSCALL_MEMORY_READ(iov, size));
+
+	iov_copy = z_thread_malloc(size);
+	if (iov_copy == NULL) {
+		return NULL;
+	}
+
+	(void)memcpy(iov_copy, iov, size);
+
+	for (size_t i = 0; i < iovcnt && ret == 0; i++) {
+		ret = Z_SYSCALL_MEMORY(iov_copy[i].iov_base,
+				       iov_copy[i].iov_len, write);
+	}
+
+	if (ret != 0) {
+		k_free(iov_copy);
+		Z_OOPS(ret);
+	}
+
+	return iov_copy;
+}
+
+static inline int z_vrfy_k_pipe_writev(struct k_pipe *pipe,
+				       const struct k_pipe_iovec *iov,
+				       size_t iovcnt, size_t *bytes_written,
+				       size_t min_xfer, k_timeout_t timeout)
+{
+	struct k_pipe_iovec *iov_copy;
+	int ret;
+
+	Z_OOPS(Z_SYSCALL_OBJ(pipe, K_OBJ_PIPE));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(bytes_written, sizeof(*bytes_written)));
+
+	iov_copy = pipe_iov_copy(iov, iovcnt, false);
+	if (iov_copy == NULL && iovcnt != 0) {
+		return -ENOMEM;
+	}
+
+	ret = z_impl_k_pipe_writev(pipe, iov_copy, iovcnt, bytes_written,
+				   min_xfer, timeout);
+	k_free(iov_copy);
+
+	return ret;
+}
+#include <syscalls/k_pipe_writev_mrsh.c>
+
+static inline int z_vrfy_k_pipe_readv(struct k_pipe *pipe,
+				      const struct k_pipe_iovec *iov,
+				      size_t iovcnt, size_t *bytes_read,
+				      size_t min_xfer, k_timeout_t timeout)
+{
+	struct k_pipe_iovec *iov_copy;
+	int ret;
+
+	Z_OOPS(Z_SYSCALL_OBJ(pipe, K_OBJ_PIPE));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(bytes_read, sizeof(*bytes_read)));
+
+	iov_copy = pipe_iov_copy(iov, iovcnt, true);
+	if (iov_copy == NULL && iovcnt != 0) {
+		return -ENOMEM;
+	}
+
+	ret = z_impl_k_pipe_readv(pipe, iov_copy, iovcnt, bytes_read,
+				  min_xfer, timeout);
+	k_free(iov_copy);
+
+	return ret;
+}
+#include <syscalls/k_pipe_readv_mrsh.c>
+#endif
+
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 		      size_t bytes_to_write, struct k_sem *sem)
@@ -790,6 +1033,7 @@ void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 	/* For simplicity, always allocate an asynchronous descriptor */
 	pipe_async_alloc(&async_desc);
 
+	pipe_desc_init(&async_desc->desc, block->data, bytes_to_write);
 	async_desc->desc.block = &async_desc->desc.copy_block;
 	async_desc->desc.copy_block = *block;
 	async_desc->desc.sem = sem;
@@ -798,12 +1042,207 @@ void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 	async_desc->thread.is_idle = 0;
 #endif
 
-	(void) z_pipe_put_internal(pipe, async_desc, block->data,
-				    bytes_to_write, &dummy_bytes_written,
-				    bytes_to_write, K_FOREVER);
+	(void) z_pipe_put_internal(pipe, async_desc, &async_desc->desc,
+				    &dummy_bytes_written, bytes_to_write,
+				    K_FOREVER);
 }
 #endif
 
+/*
+ * Claim the run of free space at write_index (@a put) or of data at
+ * read_index once there is one, waiting on the claims wait_q in between.
+ */
+static int pipe_claim(struct k_pipe *pipe, void **data, size_t *size,
+		      k_timeout_t timeout, bool put)
+{
+	size_t *claimed = put ? &pipe->put_claimed : &pipe->get_claimed;
+	uint64_t end = 0;
+	k_timeout_t wait = K_FOREVER;
+	k_spinlock_key_t key;
+	size_t run;
+	int result;
+
+	CHECKIF(pipe->size == 0 || *size == 0) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&pipe->lock);
+
+	for (;;) {
+		if (*claimed != 0) {
+			result = -EBUSY;
+			break;
+		}
+
+		run = put ? pipe_put_run(pipe) : pipe_get_run(pipe);
+		if (run > 0) {
+			*claimed = MIN(run, *size);
+			*size = *claimed;
+			*data = pipe->buffer +
+				(put ? pipe->write_index : pipe->read_index);
+			result = 0;
+			break;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			result = -EIO;
+			break;
+		}
+
+		if (!K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+			int64_t remaining;
+
+			/* only pay for reading the clock when waiting */
+			if (end == 0U) {
+				end = z_timeout_end_calc(timeout);
+			}
+			remaining = end - z_tick_get();
+
+			if (remaining <= 0) {
+				result = -EAGAIN;
+				break;
+			}
+			wait = K_TICKS(remaining);
+		}
+
+		(void)z_pend_curr(&pipe->lock, key, &pipe->wait_q.claims,
+				  wait);
+		key = k_spin_lock(&pipe->lock);
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return result;
+}
+
+int k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     k_timeout_t timeout)
+{
+	return pipe_claim(pipe, data, size, timeout, true);
+}
+
+int k_pipe_put_commit(struct k_pipe *pipe, size_t bytes)
+{
+	struct k_thread    *reader;
+	struct k_thread    *thread;
+	struct k_pipe_desc *desc;
+	sys_dlist_t    xfer_list;
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (pipe->put_claimed == 0 || bytes > pipe->put_claimed) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->put_claimed = 0;
+	pipe->bytes_used += bytes;
+	pipe->write_index += bytes;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+
+	if (bytes == 0) {
+		k_spin_unlock(&pipe->lock, key);
+		return 0;
+	}
+
+	pipe_claimers_ready(pipe);
+
+	/*
+	 * Readers only wait on an empty buffer, so the data just committed
+	 * is all they can get: hand it to them the way k_pipe_put() would,
+	 * copying with the scheduler locked instead of the pipe.
+	 */
+	(void)pipe_xfer_prepare(&xfer_list, &reader, &pipe->wait_q.readers,
+				0, pipe->bytes_used, 0, K_FOREVER);
+
+	z_sched_lock();
+	k_spin_unlock(&pipe->lock, key);
+
+	thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+	while (thread != NULL) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		(void)pipe_buffer_get(pipe, desc);
+
+		z_ready_thread(thread);
+
+		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+	}
+
+	if (reader != NULL) {
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		(void)pipe_buffer_get(pipe, desc);
+	}
+
+	k_sched_unlock();
+
+	return 0;
+}
+
+int k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     k_timeout_t timeout)
+{
+	return pipe_claim(pipe, data, size, timeout, false);
+}
+
+int k_pipe_get_release(struct k_pipe *pipe, size_t bytes)
+{
+	struct k_thread    *writer;
+	struct k_thread    *thread;
+	struct k_pipe_desc *desc;
+	sys_dlist_t    xfer_list;
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (pipe->get_claimed == 0 || bytes > pipe->get_claimed) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->get_claimed = 0;
+	pipe->bytes_used -= bytes;
+	pipe->read_index += bytes;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+
+	if (bytes == 0) {
+		k_spin_unlock(&pipe->lock, key);
+		return 0;
+	}
+
+	pipe_claimers_ready(pipe);
+
+	/*
+	 * Writers only wait on a full buffer: let them fill the space just
+	 * released, like k_pipe_get() does after reading from the buffer.
+	 */
+	(void)pipe_xfer_prepare(&xfer_list, &writer, &pipe->wait_q.writers,
+				0, pipe->size - pipe->bytes_used, 0,
+				K_FOREVER);
+
+	z_sched_lock();
+	k_spin_unlock(&pipe->lock, key);
+
+	thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+	while (thread != NULL) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		(void)pipe_buffer_put(pipe, desc);
+
+		pipe_thread_ready(thread);
+
+		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+	}
+
+	if (writer != NULL) {
+		desc = (struct k_pipe_desc *)writer->base.swap_data;
+		(void)pipe_buffer_put(pipe, desc);
+	}
+
+	k_sched_unlock();
+
+	return 0;
+}
+
 size_t z_impl_k_pipe_read_avail(struct k_pipe *pipe)
 {
 	size_t res;
@@ -34,7 +34,7 @@
  */
 static struct k_spinlock lock;
 
-enum POLL_MODE { MODE_NONE, MODE_POLL, MODE_TRIGGERED };
+enum POLL_MODE { MODE_NONE, MODE_POLL, MODE_TRIGGERED, MODE_SET };
 
 static int signal_poller(struct k_poll_event *event, uint32_t state);
 static int signal_triggered_work(struct k_poll_event *event, uint32_t status);
@@ -93,13 +93,28 @@ static struct k_thread *poller_thread(struct z_poller *p)
 	return p ? CONTAINER_OF(p, struct k_thread, poller) : NULL;
 }
 
+static inline bool is_set_event(struct k_poll_event *event)
+{
+	return (event->poller != NULL) && (event->poller->mode == MODE_SET);
+}
+
+/*
+ * Events of poll sets stay registered, at the head of the list of the
+ * object, where they are all signaled; the other events follow in
+ * priority order of their pollers, and only the first one is signaled.
+ */
 static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 			     struct z_poller *poller)
 {
 	struct k_poll_event *pending;
 
+	if (poller->mode == MODE_SET) {
+		sys_dlist_prepend(events, &event->_node);
+		return;
+	}
+
 	pending = (struct k_poll_event *)sys_dlist_peek_tail(events);
-	if ((pending == NULL) ||
+	if ((pending == NULL) || is_set_event(pending) ||
 	    z_is_t1_higher_prio_than_t2(poller_thread(pending->poller),
 					poller_thread(poller))) {
 		sys_dlist_append(events, &event->_node);
@@ -107,7 +122,8 @@ static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 	}
 
 	SYS_DLIST_FOR_EACH_CONTAINER(events, pending, _node) {
-		if (z_is_t1_higher_prio_than_t2(poller_thread(poller),
+		if (!is_set_event(pending) &&
+		    z_is_t1_higher_prio_than_t2(poller_thread(poller),
 					poller_thread(pending->poller))) {
 			sys_dlist_insert(&pending->_node, &event->_node);
 			return;
@@ -411,14 +427,64 @@ static int signal_poll_event(struct k_poll_event *event, uint32_t state)
 	return retcode;
 }
 
-void z_handle_obj_poll_events(sys_dlist_t *events, uint32_t state)
+/* must be called with the lock of the poll set held */
+static bool signal_set_event_locked(struct k_poll_set *set,
+				    struct k_poll_set_event *sev,
+				    uint32_t state)
+{
+	struct k_thread *thread;
+
+	sev->event.state |= state;
+
+	if (sys_dnode_is_linked(&sev->_ready_node)) {
+		return false;
+	}
+
+	sys_dlist_append(&set->ready, &sev->_ready_node);
+
+	thread = z_unpend_first_thread(&set->wait_q);
+	if (thread == NULL) {
+		return false;
+	}
+
+	arch_thread_return_value_set(thread, 0);
+	z_ready_thread(thread);
+
+	return true;
+}
+
+static void signal_set_event(struct k_poll_event *event, uint32_t state)
+{
+	struct k_poll_set *set =
+		CONTAINER_OF(event->poller, struct k_poll_set, poller);
+	struct k_poll_set_event *sev =
+		CONTAINER_OF(event, struct k_poll_set_event, event);
+	k_spinlock_key_t key = k_spin_lock(&set->lock);
+
+	(void)signal_set_event_locked(set, sev, state);
+	k_spin_unlock(&set->lock, key);
+}
+
+/* must be called with interrupts locked */
+static int handle_poll_events(sys_dlist_t *events, uint32_t state)
 {
-	struct k_poll_event *poll_event;
+	struct k_poll_event *poll_event, *next;
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(events, poll_event, next, _node) {
+		if (!is_set_event(poll_event)) {
+			sys_dlist_remove(&poll_event->_node);
+			return signal_poll_event(poll_event, state);
+		}
 
-	poll_event = (struct k_poll_event *)sys_dlist_get(events);
-	if (poll_event != NULL) {
-		(void) signal_poll_event(poll_event, state);
+		signal_set_event(poll_event, state);
 	}
+
+	return 0;
+}
+
+void z_handle_obj_poll_events(sys_dlist_t *events, uint32_t state)
+{
+	(void)handle_poll_events(events, state);
 }
 
 void z_impl_k_poll_signal_init(struct k_poll_signal *signal)
@@ -460,18 +526,17 @@ void z_vrfy_k_poll_signal_check(struct k_poll_signal *signal,
 int z_impl_k_poll_signal_raise(struct k_poll_signal *signal, int result)
 {
 	k_spinlock_key_t key = k_spin_lock(&lock);
-	struct k_poll_event *poll_event;
 
 	signal->result = result;
 	signal->signaled = 1U;
 
-	poll_event = (struct k_poll_event *)sys_dlist_get(&signal->poll_events);
-	if (poll_event == NULL) {
+	if (sys_dlist_is_empty(&signal->poll_events)) {
 		k_spin_unlock(&lock, key);
 		return 0;
 	}
 
-	int rc = signal_poll_event(poll_event, K_POLL_STATE_SIGNALED);
+	int rc = handle_poll_events(&signal->poll_events,
+				    K_POLL_STATE_SIGNALED);
 
 	z_reschedule(&lock, key);
 	return rc;
@@ -702,3 +767,139 @@ int k_work_poll_cancel(struct k_work_poll *work)
 
 	return retval;
 }
+
+void k_poll_set_init(struct k_poll_set *set)
+{
+	*set = (struct k_poll_set) {};
+	set->poller.mode = MODE_SET;
+	sys_dlist_init(&set->ready);
+	z_waitq_init(&set->wait_q);
+}
+
+void k_poll_set_add(struct k_poll_set *set, struct k_poll_set_event *sev)
+{
+	struct k_poll_event *event = &sev->event;
+	k_spinlock_key_t key;
+	uint32_t state;
+	bool met;
+
+	__ASSERT(event->poller == NULL, "event already registered\n");
+
+	sys_dnode_init(&sev->_ready_node);
+
+	key = k_spin_lock(&lock);
+	(void)register_event(event, &set->poller);
+	met = is_condition_met(event, &state);
+	k_spin_unlock(&lock, key);
+
+	if (met) {
+		k_poll_set_ready(sev, state);
+	}
+}
+
+void k_poll_set_remove(struct k_poll_set *set, struct k_poll_set_event *sev)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT(sev->event.poller == &set->poller, "event not in set\n");
+
+	key = k_spin_lock(&lock);
+	clear_event_registration(&sev->event);
+	k_spin_unlock(&lock, key);
+
+	key = k_spin_lock(&set->lock);
+	if (sys_dnode_is_linked(&sev->_ready_node)) {
+		sys_dlist_remove(&sev->_ready_node);
+	}
+	k_spin_unlock(&set->lock, key);
+}
+
+void k_poll_set_ready(struct k_poll_set_event *sev, uint32_t state)
+{
+	struct k_poll_set *set =
+		CONTAINER_OF(sev->event.poller, struct k_poll_set, poller);
+	k_spinlock_key_t key;
+
+	__ASSERT(is_set_event(&sev->event), "event not in a set\n");
+
+	key = k_spin_lock(&set->lock);
+	if (signal_set_event_locked(set, sev, state)) {
+		z_reschedule(&set->lock, key);
+	} else {
+		k_spin_unlock(&set->lock, key);
+	}
+}
+
+int k_poll_set_wait(struct k_poll_set *set, struct k_poll_set_event **ready,
+		    int max, k_timeout_t timeout)
+{
+	uint64_t end = 0U;
+	k_spinlock_key_t key;
+	sys_dnode_t *node;
+	int count = 0;
+
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+	__ASSERT(max >= 0, "<0 events\n");
+
+	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+	    !K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+		end = z_timeout_end_calc(timeout);
+	}
+
+	key = k_spin_lock(&set->lock);
+
+	/* another waiter may take the events we were woken up for */
+	while (sys_dlist_is_empty(&set->ready) || set->canceled) {
+		int ret;
+
+		if (set->canceled) {
+			k_spin_unlock(&set->lock, key);
+			return -ECANCELED;
+		}
+
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&set->lock, key);
+			return -EAGAIN;
+		}
+
+		ret = z_pend_curr(&set->lock, key, &set->wait_q, timeout);
+		if (ret != 0) {
+			return ret;
+		}
+
+		key = k_spin_lock(&set->lock);
+
+		if (end != 0U) {
+			int64_t remaining = end - z_tick_get();
+
+			timeout = (remaining > 0) ? K_TICKS(remaining) :
+				  K_NO_WAIT;
+		}
+	}
+
+	while ((count < max) &&
+	       ((node = sys_dlist_get(&set->ready)) != NULL)) {
+		ready[count++] =
+			CONTAINER_OF(node, struct k_poll_set_event,
+				     _ready_node);
+	}
+
+	k_spin_unlock(&set->lock, key);
+
+	return count;
+}
+
+void k_poll_set_cancel(struct k_poll_set *set)
+{
+	k_spinlock_key_t key = k_spin_lock(&set->lock);
+	struct k_thread *thread;
+
+	set->canceled = true;
+
+	while ((thread = z_unpend_first_thread(&set->wait_q)) != NULL) {
+		arch_thread_return_value_set(thread, -ECANCELED);
+		z_ready_thread(thread);
+	}
+
+	z_reschedule(&set->lock, key);
+}
@@ -84,6 +84,9 @@ void z_impl_k_queue_init(struct k_queue *queue)
 #if defined(CONFIG_POLL)
 	sys_dlist_init(&queue->poll_events);
 #endif
+#ifdef CONFIG_FIFO_MPSC
+	queue->mpsc = false;
+#endif
 
 	SYS_TRACING_OBJ_INIT(k_queue, queue);
 	z_object_init(queue);
@@ -135,11 +138,213 @@ static inline void z_vrfy_k_queue_cancel_wait(struct k_queue *queue)
 #include <syscalls/k_queue_cancel_wait_mrsh.c>
 #endif
 
+#ifdef CONFIG_FIFO_MPSC
+
+/* A single consumer queue is an intrusive list in the style of Dmitry
+ * Vyukov's MPSC queue.  data_q.tail is the last node appended, which
+ * producers swap atomically, and data_q.head the next node to get,
+ * which only the consumer touches.  The list always holds at least one
+ * node: the stub embedded in the queue takes its place when it would
+ * otherwise be empty.  Producers link the previous tail to their node
+ * after swapping the tail, so the consumer may find the list cut short
+ * of the tail for a moment.  It then treats the queue as empty, and
+ * the producer wakes it up once the link is in place.
+ */
+static inline sys_sfnode_t *mpsc_next(sys_sfnode_t *node)
+{
+	uintptr_t next = (uintptr_t)atomic_ptr_get(
+		(atomic_ptr_t *)&node->next_and_flags);
+
+	return (sys_sfnode_t *)(next & ~SYS_SFLIST_FLAGS_MASK);
+}
+
+static void mpsc_push(struct k_queue *queue, sys_sfnode_t *first,
+		      sys_sfnode_t *last)
+{
+	sys_sfnode_t *prev;
+	uintptr_t next;
+
+	prev = atomic_ptr_set((atomic_ptr_t *)&queue->data_q.tail, last);
+	next = (uintptr_t)first | sys_sfnode_flags_get(prev);
+	(void)atomic_ptr_set((atomic_ptr_t *)&prev->next_and_flags,
+			     (void *)next);
+}
+
+static sys_sfnode_t *mpsc_pop(struct k_queue *queue)
+{
+	sys_sfnode_t *stub = &queue->mpsc_stub;
+	sys_sfnode_t *head = queue->data_q.head;
+	sys_sfnode_t *next = mpsc_next(head);
+
+	if (head == stub) {
+		if (next == NULL) {
+			return NULL;
+		}
+		queue->data_q.head = next;
+		head = next;
+		next = mpsc_next(next);
+	}
+
+	if (next == NULL) {
+		if (head != atomic_ptr_get(
+			    (atomic_ptr_t *)&queue->data_q.tail)) {
+			/* a producer is still linking its node */
+			return NULL;
+		}
+
+		/* Put the stub back behind the last node to take it */
+		sys_sfnode_init(stub, 0x0);
+		mpsc_push(queue, stub, stub);
+		next = mpsc_next(head);
+		if (next == NULL) {
+			return NULL;
+		}
+	}
+
+	queue->data_q.head = next;
+	return head;
+}
+
+sys_sfnode_t *z_queue_mpsc_peek(struct k_queue *queue, bool head)
+{
+	sys_sfnode_t *stub = &queue->mpsc_stub;
+	sys_sfnode_t *node;
+
+	if (head) {
+		node = queue->data_q.head;
+		return (node == stub) ? mpsc_next(stub) : node;
+	}
+
+	node = atomic_ptr_get((atomic_ptr_t *)&queue->data_q.tail);
+	return (node == stub) ? NULL : node;
+}
+
+void k_queue_init_mpsc(struct k_queue *queue)
+{
+	z_impl_k_queue_init(queue);
+
+	sys_sfnode_init(&queue->mpsc_stub, 0x0);
+	queue->data_q.head = &queue->mpsc_stub;
+	queue->data_q.tail = &queue->mpsc_stub;
+	atomic_clear(&queue->mpsc_waiting);
+	queue->mpsc = true;
+}
+
+/* Wake up the consumer if it is waiting for data */
+static void mpsc_wake(struct k_queue *queue)
+{
+	struct k_thread *thread;
+	k_spinlock_key_t key;
+
+	if (atomic_get(&queue->mpsc_waiting) == 0) {
+		return;
+	}
+
+	key = k_spin_lock(&queue->lock);
+	thread = z_unpend_first_thread(&queue->wait_q);
+	if (thread != NULL) {
+		atomic_clear(&queue->mpsc_waiting);
+		/* any non-NULL value, NULL means k_queue_cancel_wait() */
+		prepare_thread_to_run(thread, queue);
+		z_reschedule(&queue->lock, key);
+	} else {
+		k_spin_unlock(&queue->lock, key);
+	}
+}
+
+static int32_t mpsc_insert(struct k_queue *queue, void *data, bool alloc)
+{
+	if (alloc) {
+		struct alloc_node *anode;
+
+		anode = z_thread_malloc(sizeof(*anode));
+		if (anode == NULL) {
+			return -ENOMEM;
+		}
+		anode->data = data;
+		sys_sfnode_init(&anode->node, 0x1);
+		data = anode;
+	} else {
+		sys_sfnode_init(data, 0x0);
+	}
+
+	mpsc_push(queue, data, data);
+	mpsc_wake(queue);
+	return 0;
+}
+
+static void *mpsc_get(struct k_queue *queue, k_timeout_t timeout)
+{
+	uint64_t end = 0;
+	k_timeout_t wait = K_FOREVER;
+	k_spinlock_key_t key;
+	sys_sfnode_t *node;
+	int ret;
+
+	for (;;) {
+		node = mpsc_pop(queue);
+		if ((node != NULL) || K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			break;
+		}
+
+		if (!K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+			int64_t remaining;
+
+			/* only pay for reading the clock when waiting */
+			if (end == 0U) {
+				end = z_timeout_end_calc(timeout);
+			}
+			remaining = end - z_tick_get();
+
+			if (remaining <= 0) {
+				break;
+			}
+			wait = K_TICKS(remaining);
+		}
+
+		/* Announce ourselves before the final check, so that a
+		 * producer either makes its node visible to the pop below
+		 * or sees the flag and takes the lock to wake us up once we
+		 * are pended.
+		 */
+		key = k_spin_lock(&queue->lock);
+		(void)atomic_set(&queue->mpsc_waiting, 1);
+
+		node = mpsc_pop(queue);
+		if (node != NULL) {
+			atomic_clear(&queue->mpsc_waiting);
+			k_spin_unlock(&queue->lock, key);
+			break;
+		}
+
+		ret = z_pend_curr(&queue->lock, key, &queue->wait_q, wait);
+		atomic_clear(&queue->mpsc_waiting);
+
+		if ((ret == 0) && (_current->base.swap_data == NULL)) {
+			/* k_queue_cancel_wait() */
+			break;
+		}
+	}
+
+	return z_queue_node_peek(node, true);
+}
+
+#endif /* CONFIG_FIFO_MPSC */
+
 static int32_t queue_insert(struct k_queue *queue, void *prev, void *data,
 			    bool alloc, bool is_append)
 {
 	struct k_thread *first_pending_thread;
-	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_FIFO_MPSC
+	if (queue->mpsc) {
+		__ASSERT(is_append, "can only append to single consumer queue");
+		return mpsc_insert(queue, data, alloc);
+	}
+#endif
+
+	key = k_spin_lock(&queue->lock);
 
 	if (is_append) {
 		prev = sys_sflist_peek_tail(&queue->data_q);
@@ -227,6 +432,15 @@ int k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_FIFO_MPSC
+	if (queue->mpsc) {
+		sys_sfnode_init(tail, sys_sfnode_flags_get(tail));
+		mpsc_push(queue, head, tail);
+		mpsc_wake(queue);
+		return 0;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 	struct k_thread *thread = NULL;
 
@@ -278,6 +492,12 @@ int k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list)
 
 void *z_impl_k_queue_get(struct k_queue *queue, k_timeout_t timeout)
 {
+#ifdef CONFIG_FIFO_MPSC
+	if (queue->mpsc) {
+		return mpsc_get(queue, timeout);
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 	void *data;
 
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file @brief read-copy-update
+ *
+ * Readers are counted in one of two phases, the current one when they
+ * enter their critical section, and in one slot per CPU so that readers
+ * on different CPUs don't write to the same cache line.  A reader may
+ * leave on another CPU than it entered on, so only the sum of a phase's
+ * counts over all slots is meaningful.
+ *
+ * A grace period flips the current phase, then waits for the count of
+ * the previous one to drop to zero: readers that entered later can't
+ * see what was unlinked before the flip.  A reader that read the phase
+ * just before a flip, and counted itself in the previous phase after
+ * the flip, checks the phase again and moves over to the current one.
+ * Since both sides write first and read second, separated by full
+ * barriers, either the reader sees the flip or the writer sees the
+ * reader.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <sys/rcu.h>
+
+#if defined(CONFIG_SMP) && (CONFIG_MP_NUM_CPUS > 1)
+#define RCU_SLOTS CONFIG_MP_NUM_CPUS
+#else
+#define RCU_SLOTS 1
+#endif
+
+struct rcu_slot {
+	atomic_t readers[2];
+#if RCU_SLOTS > 1
+	/* one typical cache line per CPU */
+	uint8_t pad[64 - 2 * sizeof(atomic_t)];
+#endif
+};
+
+static struct rcu_slot slots[RCU_SLOTS];
+
+/* current phase, in the lowest bit */
+static atomic_t phase;
+/* set while a grace period waits for readers */
+static atomic_t waiting;
+
+static K_MUTEX_DEFINE(gp_mutex);
+static K_SEM_DEFINE(gp_sem, 0, 1);
+
+static struct k_spinlock cb_lock;
+static sys_slist_t cb_list = SYS_SLIST_STATIC_INIT(&cb_list);
+
+static inline atomic_t *reader_count(unsigned int token)
+{
+#if RCU_SLOTS > 1
+	return &slots[_current_cpu->id].readers[token];
+#else
+	return &slots[0].readers[token];
+#endif
+}
+
+static atomic_val_t phase_readers(unsigned int token)
+{
+	atomic_val_t count = 0;
+
+	for (int i = 0; i < RCU_SLOTS; i++) {
+		count += atomic_get(&slots[i].readers[token]);
+	}
+
+	return count;
+}
+
+unsigned int sys_rcu_read_lock(void)
+{
+	unsigned int key = arch_irq_lock();
+	unsigned int token;
+
+	for (;;) {
+		token = (unsigned int)atomic_get(&phase) & 1U;
+		atomic_inc(reader_count(token));
+		z_smp_mb();
+
+		if (likely(((unsigned int)atomic_get(&phase) & 1U) == token)) {
+			break;
+		}
+
+		/* a grace period started meanwhile, it may have missed us */
+		atomic_dec(reader_count(token));
+	}
+
+	arch_irq_unlock(key);
+
+	return token;
+}
+
+void sys_rcu_read_unlock(unsigned int token)
+{
+	unsigned int key = arch_irq_lock();
+
+	z_smp_mb();
+	atomic_dec(reader_count(token));
+	arch_irq_unlock(key);
+
+	z_smp_mb();
+	if (unlikely(atomic_get(&waiting) != 0)) {
+		k_sem_give(&gp_sem);
+	}
+}
+
+void sys_rcu_synchronize(void)
+{
+	unsigned int old;
+
+	__ASSERT(!k_is_in_isr(), "grace periods can't be waited for in ISRs");
+
+	k_mutex_lock(&gp_mutex, K_FOREVER);
+
+	old = (unsigned int)atomic_inc(&phase) & 1U;
+	atomic_set(&waiting, 1);
+	z_smp_mb();
+
+	/* readers leaving give the semaphore, spurious wakeups are fine */
+	while (phase_readers(old) != 0) {
+		k_sem_take(&gp_sem, K_FOREVER);
+	}
+
+	atomic_clear(&waiting);
+	k_mutex_unlock(&gp_mutex);
+}
+
+static void rcu_reclaim(struct k_work *work)
+{
+	k_spinlock_key_t key;
+	sys_slist_t list;
+	sys_snode_t *node;
+
+	key = k_spin_lock(&cb_lock);
+	list = cb_list;
+	sys_slist_init(&cb_list);
+	k_spin_unlock(&cb_lock, key);
+
+	sys_rcu_synchronize();
+
+	while ((node = sys_slist_get(&list)) != NULL) {
+		struct sys_rcu_head *head =
+			CONTAINER_OF(node, struct sys_rcu_head, node);
+
+		head->func(head);
+	}
+}
+
+static K_WORK_DEFINE(reclaim_work, rcu_reclaim);
+
+void sys_rcu_call(struct sys_rcu_head *head, sys_rcu_callback_t func)
+{
+	k_spinlock_key_t key;
+
+	head->func = func;
+
+	key = k_spin_lock(&cb_lock);
+	sys_slist_append(&cb_list, &head->node);
+	k_spin_unlock(&cb_lock, key);
+
+	k_work_submit(&reclaim_work);
+}
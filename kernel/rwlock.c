@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file @brief reader-writer lock kernel services
+ *
+ * Readers are counted in one slot per CPU, so that readers on different
+ * CPUs don't bounce a cache line between them: a reader increments the
+ * slot of the CPU it runs on and decrements the slot of the CPU it runs
+ * on when it unlocks, which may be another one.  Only the sum of the
+ * slots is meaningful.
+ *
+ * Readers take the lock without the spinlock as long as no writer owns
+ * it or waits for it.  A writer first sets the writing flag, which sends
+ * new readers to the slow path, then waits for the sum of the slots to
+ * drop to zero.  Both sides increment (or set) first and check the other
+ * side second, with sequentially consistent atomics, so either the
+ * reader sees the flag or the writer sees the reader.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <toolchain.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <errno.h>
+#include <init.h>
+#include <syscall_handler.h>
+#include <sys/check.h>
+
+static inline atomic_t *reader_slot(struct k_rwlock *rwlock)
+{
+#if Z_RWLOCK_READER_SLOTS > 1
+	return &rwlock->readers[_current_cpu->id].count;
+#else
+	return &rwlock->readers[0].count;
+#endif
+}
+
+static atomic_val_t readers_count(struct k_rwlock *rwlock)
+{
+	atomic_val_t count = 0;
+
+	for (int i = 0; i < Z_RWLOCK_READER_SLOTS; i++) {
+		count += atomic_get(&rwlock->readers[i].count);
+	}
+
+	return count;
+}
+
+/*
+ * Wake up a writer waiting for the last readers to leave, if they have.
+ * Called with the lock held; returns true if a thread was readied.
+ */
+static bool wake_drained_writer(struct k_rwlock *rwlock)
+{
+	struct k_thread *thread;
+
+	if ((rwlock->writer == NULL) || (readers_count(rwlock) != 0)) {
+		return false;
+	}
+
+	thread = z_unpend_first_thread(&rwlock->drain_q);
+	if (thread == NULL) {
+		return false;
+	}
+
+	arch_thread_return_value_set(thread, 0);
+	z_ready_thread(thread);
+
+	return true;
+}
+
+/*
+ * Hand the lock over to the next waiting writer, or to all waiting
+ * readers if there is none.  Called with the lock held, by the owner or
+ * by a writer giving up waiting for readers; returns true if threads
+ * were readied.
+ */
+static bool release_writer(struct k_rwlock *rwlock)
+{
+	struct k_thread *thread;
+	bool readied = false;
+
+	thread = z_unpend_first_thread(&rwlock->write_q);
+	if (thread != NULL) {
+		/* it still has to wait for readers, if any are left */
+		rwlock->writer = thread;
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+		return true;
+	}
+
+	rwlock->writer = NULL;
+	atomic_clear(&rwlock->writing);
+
+	while ((thread = z_unpend_first_thread(&rwlock->read_q)) != NULL) {
+		/* counted on their behalf, in this CPU's slot */
+		atomic_inc(reader_slot(rwlock));
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+		readied = true;
+	}
+
+	return readied;
+}
+
+int z_impl_k_rwlock_init(struct k_rwlock *rwlock)
+{
+	for (int i = 0; i < Z_RWLOCK_READER_SLOTS; i++) {
+		atomic_clear(&rwlock->readers[i].count);
+	}
+	atomic_clear(&rwlock->writing);
+	rwlock->writer = NULL;
+	rwlock->lock = (struct k_spinlock) {};
+	z_waitq_init(&rwlock->read_q);
+	z_waitq_init(&rwlock->write_q);
+	z_waitq_init(&rwlock->drain_q);
+
+	z_object_init(rwlock);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_init(struct k_rwlock *rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ_INIT(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_init(rwlock);
+}
+#include <syscalls/k_rwlock_init_mrsh.c>
+#endif
+
+int z_impl_k_rwlock_read_lock(struct k_rwlock *rwlock, k_timeout_t timeout)
+{
+	k_spinlock_key_t key;
+	unsigned int irq_key;
+	bool resched;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	/* no migration between picking a slot and counting in it */
+	irq_key = arch_irq_lock();
+	atomic_inc(reader_slot(rwlock));
+	if (likely(atomic_get(&rwlock->writing) == 0)) {
+		arch_irq_unlock(irq_key);
+		return 0;
+	}
+	atomic_dec(reader_slot(rwlock));
+	arch_irq_unlock(irq_key);
+
+	key = k_spin_lock(&rwlock->lock);
+
+	/* backing off may have let a writer in */
+	resched = wake_drained_writer(rwlock);
+
+	if (rwlock->writer == NULL) {
+		atomic_inc(reader_slot(rwlock));
+		k_spin_unlock(&rwlock->lock, key);
+		return 0;
+	}
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		if (resched) {
+			z_reschedule(&rwlock->lock, key);
+		} else {
+			k_spin_unlock(&rwlock->lock, key);
+		}
+		return -EBUSY;
+	}
+
+	return z_pend_curr(&rwlock->lock, key, &rwlock->read_q, timeout);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_read_lock(struct k_rwlock *rwlock,
+					    k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_read_lock(rwlock, timeout);
+}
+#include <syscalls/k_rwlock_read_lock_mrsh.c>
+#endif
+
+void z_impl_k_rwlock_read_unlock(struct k_rwlock *rwlock)
+{
+	k_spinlock_key_t key;
+	unsigned int irq_key;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	irq_key = arch_irq_lock();
+	atomic_dec(reader_slot(rwlock));
+	arch_irq_unlock(irq_key);
+
+	if (likely(atomic_get(&rwlock->writing) == 0)) {
+		return;
+	}
+
+	key = k_spin_lock(&rwlock->lock);
+	if (wake_drained_writer(rwlock)) {
+		z_reschedule(&rwlock->lock, key);
+	} else {
+		k_spin_unlock(&rwlock->lock, key);
+	}
+}
+
+#ifdef CONFIG_USERSPACE
+static inline void z_vrfy_k_rwlock_read_unlock(struct k_rwlock *rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	z_impl_k_rwlock_read_unlock(rwlock);
+}
+#include <syscalls/k_rwlock_read_unlock_mrsh.c>
+#endif
+
+int z_impl_k_rwlock_write_lock(struct k_rwlock *rwlock, k_timeout_t timeout)
+{
+	k_timeout_t wait = timeout;
+	uint64_t end = 0;
+	k_spinlock_key_t key;
+	int ret;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	key = k_spin_lock(&rwlock->lock);
+
+	CHECKIF(rwlock->writer == _current) {
+		k_spin_unlock(&rwlock->lock, key);
+		return -EDEADLK;
+	}
+
+	if (rwlock->writer == NULL) {
+		rwlock->writer = _current;
+		atomic_set(&rwlock->writing, 1);
+	} else {
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			k_spin_unlock(&rwlock->lock, key);
+			return -EBUSY;
+		}
+
+		if (!K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+			end = z_timeout_end_calc(timeout);
+		}
+
+		ret = z_pend_curr(&rwlock->lock, key, &rwlock->write_q,
+				  timeout);
+		if (ret != 0) {
+			return ret;
+		}
+
+		/* handed over by the previous writer */
+		key = k_spin_lock(&rwlock->lock);
+	}
+
+	if (readers_count(rwlock) == 0) {
+		k_spin_unlock(&rwlock->lock, key);
+		return 0;
+	}
+
+	if (end != 0U) {
+		int64_t remaining = end - z_tick_get();
+
+		wait = (remaining > 0) ? K_TICKS(remaining) : K_NO_WAIT;
+	}
+
+	if (!K_TIMEOUT_EQ(wait, K_NO_WAIT)) {
+		ret = z_pend_curr(&rwlock->lock, key, &rwlock->drain_q, wait);
+		if (ret == 0) {
+			return 0;
+		}
+		key = k_spin_lock(&rwlock->lock);
+	}
+
+	/* give up, letting in whoever is waiting */
+	if (release_writer(rwlock)) {
+		z_reschedule(&rwlock->lock, key);
+	} else {
+		k_spin_unlock(&rwlock->lock, key);
+	}
+
+	return K_TIMEOUT_EQ(timeout, K_NO_WAIT) ? -EBUSY : -EAGAIN;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_write_lock(struct k_rwlock *rwlock,
+					     k_timeout_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_write_lock(rwlock, timeout);
+}
+#include <syscalls/k_rwlock_write_lock_mrsh.c>
+#endif
+
+int z_impl_k_rwlock_write_unlock(struct k_rwlock *rwlock)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT(!arch_is_in_isr(), "rwlocks cannot be used inside ISRs");
+
+	key = k_spin_lock(&rwlock->lock);
+
+	CHECKIF(rwlock->writer != _current) {
+		k_spin_unlock(&rwlock->lock, key);
+		return -EPERM;
+	}
+
+	if (release_writer(rwlock)) {
+		z_reschedule(&rwlock->lock, key);
+	} else {
+		k_spin_unlock(&rwlock->lock, key);
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_rwlock_write_unlock(struct k_rwlock *rwlock)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(rwlock, K_OBJ_RWLOCK));
+	return z_impl_k_rwlock_write_unlock(rwlock);
+}
+#include <syscalls/k_rwlock_write_unlock_mrsh.c>
+#endif
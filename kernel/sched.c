@@ -16,6 +16,7 @@
 #include <kernel_internal.h>
 #include <logging/log.h>
 #include <sys/atomic.h>
+#include <sys/rcu.h>
 LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
 /* Maximum time between the time a self-aborting thread flags itself
@@ -181,6 +182,106 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* With per-CPU run queues, thread->base.cpu doubles as the index of
+ * the queue holding the thread while it is queued.  It is otherwise
+ * only updated when the thread is switched in, at which point it is
+ * no longer queued.
+ */
+static ALWAYS_INLINE void *thread_runq(struct k_thread *thread)
+{
+	return &_kernel.cpus[thread->base.cpu].ready_q.runq;
+}
+
+/* Picks the queue for a thread becoming ready: the CPU it last ran
+ * on if its mask still allows that, else the first CPU it may use.
+ */
+static ALWAYS_INLINE void pick_runq(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	if ((thread->base.cpu_mask & BIT(thread->base.cpu)) == 0U &&
+	    thread->base.cpu_mask != 0U) {
+		thread->base.cpu = __builtin_ctz(thread->base.cpu_mask);
+	}
+#endif
+}
+
+/* Stamped on each thread as it is queued, so that threads of equal
+ * priority on different queues can still be picked in FIFO order.
+ * Protected by sched_spinlock.
+ */
+static uint32_t runq_seq;
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	pick_runq(thread);
+	thread->base.runq_seq = runq_seq++;
+	_priq_run_add(thread_runq(thread), thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(thread_runq(thread), thread);
+}
+
+/* True if t1 should run before t2: higher priority, or equal
+ * priority and queued earlier.
+ */
+static ALWAYS_INLINE bool runq_before(struct k_thread *t1,
+				      struct k_thread *t2)
+{
+	if (z_is_t1_higher_prio_than_t2(t1, t2)) {
+		return true;
+	}
+	if (z_is_t1_higher_prio_than_t2(t2, t1)) {
+		return false;
+	}
+
+	return (int32_t)(t1->base.runq_seq - t2->base.runq_seq) < 0;
+}
+
+/* Best thread for this CPU out of the heads of all queues.  Another
+ * CPU's head that is allowed to run here gets stolen if it has higher
+ * priority than this CPU's own head, or equal priority and was queued
+ * earlier, so that yield and timeslicing rotate equal priority threads
+ * across all CPUs as they would with a single queue.
+ */
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	struct k_thread *thread = _priq_run_best(&_current_cpu->ready_q.runq);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_thread *t;
+
+		if (i == _current_cpu->id) {
+			continue;
+		}
+
+		t = _priq_run_best(&_kernel.cpus[i].ready_q.runq);
+		if (t != NULL && (thread == NULL || runq_before(t, thread))) {
+			thread = t;
+		}
+	}
+
+	return thread;
+}
+#else
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	_priq_run_add(&_kernel.ready_q.runq, thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(&_kernel.ready_q.runq, thread);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_kernel.ready_q.runq);
+}
+#endif /* CONFIG_SCHED_CPU_RUNQ */
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
 	struct k_thread *thread;
@@ -192,7 +293,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 		return _current_cpu->idle_thread;
 	}
 
-	thread = _priq_run_best(&_kernel.ready_q.runq);
+	thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -262,16 +363,23 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
 	z_mark_thread_as_not_queued(thread);
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Record the new home queue now, under the lock, so that a
+	 * stolen thread is requeued here next time
+	 */
+	thread->base.cpu = _current_cpu->id;
+#endif
+
 	return thread;
 #endif
 }
@@ -279,9 +387,9 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 static void move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
-	_priq_run_add(&_kernel.ready_q.runq, thread);
+	runq_add(thread);
 	z_mark_thread_as_queued(thread);
 	update_cache(thread == _current);
 }
@@ -422,7 +530,7 @@ static void ready_thread(struct k_thread *thread)
 	 */
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		sys_trace_thread_ready(thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
@@ -465,7 +573,7 @@ void z_impl_k_thread_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 		}
 		z_mark_thread_as_suspended(thread);
@@ -552,8 +660,7 @@ void z_thread_single_abort(struct k_thread *thread)
 
 		if (z_is_thread_ready(thread)) {
 			if (z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 thread);
+				runq_remove(thread);
 				z_mark_thread_as_not_queued(thread);
 			}
 			update_cache(thread == _current);
@@ -637,7 +744,7 @@ void z_thread_single_abort(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 		z_mark_thread_as_not_queued(thread);
 	}
 	update_cache(thread == _current);
@@ -799,9 +906,9 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
+				runq_add(thread);
 			} else {
 				thread->base.prio = prio;
 			}
@@ -1076,11 +1183,41 @@ struct k_thread *z_priq_rb_best(struct _priq_rb *pq)
 # endif
 #endif
 
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_DEADLINE)
+/* All threads in one multiq heap share a priority, so only the
+ * deadline and then the insertion order matter.  Both are compared
+ * as wrapping differences.
+ */
+static bool priq_mq_lessthan(struct pheap_node *a, struct pheap_node *b)
+{
+	struct k_thread *thread_a, *thread_b;
+	int32_t d;
+
+	thread_a = CONTAINER_OF(a, struct k_thread, base.qnode_pheap);
+	thread_b = CONTAINER_OF(b, struct k_thread, base.qnode_pheap);
+
+	d = (int32_t)((uint32_t)thread_a->base.prio_deadline -
+		      (uint32_t)thread_b->base.prio_deadline);
+	if (d != 0) {
+		return d < 0;
+	}
+
+	return (int32_t)(thread_a->base.order_key -
+			 thread_b->base.order_key) < 0;
+}
+#endif
+
 ALWAYS_INLINE void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread)
 {
 	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
 
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_DEADLINE)
+	thread->base.order_key = pq->next_order_key++;
+	pheap_insert(&pq->queues[priority_bit], &thread->base.qnode_pheap,
+		     priq_mq_lessthan);
+#else
 	sys_dlist_append(&pq->queues[priority_bit], &thread->base.qnode_dlist);
+#endif
 	pq->bitmask |= BIT(priority_bit);
 }
 
@@ -1094,10 +1231,18 @@ ALWAYS_INLINE void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread
 #endif
 	int priority_bit = thread->base.prio - K_HIGHEST_THREAD_PRIO;
 
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_DEADLINE)
+	pheap_remove(&pq->queues[priority_bit], &thread->base.qnode_pheap,
+		     priq_mq_lessthan);
+	if (pheap_get_min(&pq->queues[priority_bit]) == NULL) {
+		pq->bitmask &= ~BIT(priority_bit);
+	}
+#else
 	sys_dlist_remove(&thread->base.qnode_dlist);
 	if (sys_dlist_is_empty(&pq->queues[priority_bit])) {
 		pq->bitmask &= ~BIT(priority_bit);
 	}
+#endif
 }
 
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
@@ -1107,12 +1252,21 @@ struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 	}
 
 	struct k_thread *thread = NULL;
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_DEADLINE)
+	struct pheap *q = &pq->queues[__builtin_ctz(pq->bitmask)];
+	struct pheap_node *n = pheap_get_min(q);
+
+	if (n != NULL) {
+		thread = CONTAINER_OF(n, struct k_thread, base.qnode_pheap);
+	}
+#else
 	sys_dlist_t *l = &pq->queues[__builtin_ctz(pq->bitmask)];
 	sys_dnode_t *n = sys_dlist_peek_head(l);
 
 	if (n != NULL) {
 		thread = CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
 	}
+#endif
 	return thread;
 }
 
@@ -1130,14 +1284,14 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -1145,10 +1299,25 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_DEADLINE)
+		rq->runq.queues[i] = (struct pheap)PHEAP_STATIC_INIT();
+#else
+		sys_dlist_init(&rq->runq.queues[i]);
+#endif
 	}
 #endif
+}
+
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
+	}
+#else
+	init_ready_q(&_kernel.ready_q);
+#endif
 
 #ifdef CONFIG_TIMESLICING
 	k_sched_time_slice_set(CONFIG_TIMESLICE_SIZE,
@@ -1205,10 +1374,17 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	struct k_thread *thread = tid;
 
 	LOCKED(&sched_spinlock) {
+		bool queued = z_is_thread_queued(thread);
+
+		/* Sorted queues locate the node by comparing keys, so it
+		 * must come out before its deadline changes
+		 */
+		if (queued) {
+			runq_remove(thread);
+		}
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
-		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			_priq_run_add(&_kernel.ready_q.runq, thread);
+		if (queued) {
+			runq_add(thread);
 		}
 	}
 }
@@ -1237,10 +1413,9 @@ void z_impl_k_yield(void)
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
+				runq_remove(_current);
 			}
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_add(_current);
 			z_mark_thread_as_queued(_current);
 			update_cache(1);
 		}
@@ -1420,7 +1595,7 @@ void z_sched_abort(struct k_thread *thread)
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
 		} else if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
@@ -1542,6 +1717,12 @@ int z_impl_k_thread_join(struct k_thread *thread, k_timeout_t timeout)
 
 	if ((thread->base.thread_state & _THREAD_DEAD) != 0) {
 		ret = 0;
+#ifdef CONFIG_THREAD_MONITOR
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+		    z_thread_monitor_walked(thread)) {
+			ret = -EBUSY;
+		}
+#endif
 		goto out;
 	}
 
@@ -1556,9 +1737,22 @@ int z_impl_k_thread_join(struct k_thread *thread, k_timeout_t timeout)
 	add_to_waitq_locked(_current, &thread->base.join_waiters);
 	add_thread_timeout(_current, timeout);
 
-	return z_swap(&sched_spinlock, key);
+	ret = z_swap(&sched_spinlock, key);
+	goto done;
 out:
 	k_spin_unlock(&sched_spinlock, key);
+done:
+#ifdef CONFIG_THREAD_MONITOR
+	/* let k_thread_foreach_unlocked() callers that were walking the
+	 * thread list when the thread exited leave the thread before its
+	 * object can be freed or reused.  Never waits with K_NO_WAIT,
+	 * so never in an ISR.
+	 */
+	if ((ret == 0) && z_thread_monitor_walked(thread)) {
+		sys_rcu_synchronize();
+		thread->monitor_walks = 0U;
+	}
+#endif
 	return ret;
 }
 
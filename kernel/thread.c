@@ -28,10 +28,11 @@
 #include <sys/check.h>
 #include <random/rand32.h>
 #include <sys/atomic.h>
+#include <sys/rcu.h>
 #include <logging/log.h>
 LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
-#ifdef CONFIG_THREAD_RUNTIME_STATS
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && !defined(CONFIG_CPU_LOAD)
 k_thread_runtime_stats_t threads_runtime_stats;
 #endif
 
@@ -41,6 +42,30 @@ k_thread_runtime_stats_t threads_runtime_stats;
  * thread->next_thread (until NULL)
  */
 static struct k_spinlock z_thread_monitor_lock;
+
+/* Number of k_thread_foreach_unlocked() calls in progress in the low
+ * bits, and in the high bits the number of times it dropped to zero:
+ * once those have changed, all the walks in progress earlier are done.
+ * Both are in a single word so that they are read together.
+ */
+static atomic_t monitor_walks;
+
+#define MONITOR_WALKS_COUNT BIT_MASK(16)
+#define MONITOR_WALKS_GEN(walks) ((uint32_t)(walks) >> 16)
+
+static void monitor_walk_end(void)
+{
+	atomic_val_t old, new;
+
+	do {
+		old = atomic_get(&monitor_walks);
+		if (((uint32_t)old & MONITOR_WALKS_COUNT) == 1U) {
+			new = (atomic_val_t)((uint32_t)old - 1U + BIT(16));
+		} else {
+			new = old - 1;
+		}
+	} while (!atomic_cas(&monitor_walks, old, new));
+}
 #endif /* CONFIG_THREAD_MONITOR */
 
 #define _FOREACH_STATIC_THREAD(thread_data)              \
@@ -72,17 +97,26 @@ void k_thread_foreach_unlocked(k_thread_user_cb_t user_cb, void *user_data)
 {
 #if defined(CONFIG_THREAD_MONITOR)
 	struct k_thread *thread;
-	k_spinlock_key_t key;
+	unsigned int token;
 
 	__ASSERT(user_cb != NULL, "user_cb can not be NULL");
 
-	key = k_spin_lock(&z_thread_monitor_lock);
-	for (thread = _kernel.threads; thread; thread = thread->next_thread) {
-		k_spin_unlock(&z_thread_monitor_lock, key);
+	/*
+	 * Threads are linked in before they are published and unlinked
+	 * with a single store, and k_thread_join() waits for a grace
+	 * period, so the list can be walked without the lock.  Threads
+	 * unlinked while no walk is in progress can't be reached by any
+	 * walk, and k_thread_join() doesn't wait for those.
+	 */
+	(void)atomic_inc(&monitor_walks);
+	z_smp_mb();
+	token = sys_rcu_read_lock();
+	for (thread = SYS_RCU_DEREFERENCE(_kernel.threads); thread != NULL;
+	     thread = SYS_RCU_DEREFERENCE(thread->next_thread)) {
 		user_cb(thread, user_data);
-		key = k_spin_lock(&z_thread_monitor_lock);
 	}
-	k_spin_unlock(&z_thread_monitor_lock, key);
+	sys_rcu_read_unlock(token);
+	monitor_walk_end();
 #endif
 }
 
@@ -195,9 +229,10 @@ static inline void *z_vrfy_k_thread_custom_data_get(void)
 void z_thread_monitor_exit(struct k_thread *thread)
 {
 	k_spinlock_key_t key = k_spin_lock(&z_thread_monitor_lock);
+	uint32_t walks;
 
 	if (thread == _kernel.threads) {
-		_kernel.threads = _kernel.threads->next_thread;
+		SYS_RCU_ASSIGN_POINTER(_kernel.threads, thread->next_thread);
 	} else {
 		struct k_thread *prev_thread;
 
@@ -207,12 +242,26 @@ void z_thread_monitor_exit(struct k_thread *thread)
 			prev_thread = prev_thread->next_thread;
 		}
 		if (prev_thread != NULL) {
-			prev_thread->next_thread = thread->next_thread;
+			SYS_RCU_ASSIGN_POINTER(prev_thread->next_thread,
+					       thread->next_thread);
 		}
 	}
 
+	/* Either a walk starting now misses the thread, or we see it */
+	z_smp_mb();
+	walks = (uint32_t)atomic_get(&monitor_walks);
+	thread->monitor_walks =
+		((walks & MONITOR_WALKS_COUNT) != 0U) ? walks : 0U;
+
 	k_spin_unlock(&z_thread_monitor_lock, key);
 }
+
+bool z_thread_monitor_walked(struct k_thread *thread)
+{
+	return (thread->monitor_walks != 0U) &&
+	       (MONITOR_WALKS_GEN(thread->monitor_walks) ==
+		MONITOR_WALKS_GEN(atomic_get(&monitor_walks)));
+}
 #endif
 
 int z_impl_k_thread_name_set(struct k_thread *thread, const char *value)
@@ -602,11 +651,12 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 	new_thread->entry.parameter1 = p1;
 	new_thread->entry.parameter2 = p2;
 	new_thread->entry.parameter3 = p3;
+	new_thread->monitor_walks = 0U;
 
 	k_spinlock_key_t key = k_spin_lock(&z_thread_monitor_lock);
 
 	new_thread->next_thread = _kernel.threads;
-	_kernel.threads = new_thread;
+	SYS_RCU_ASSIGN_POINTER(_kernel.threads, new_thread);
 	k_spin_unlock(&z_thread_monitor_lock, key);
 #endif
 #ifdef CONFIG_THREAD_NAME
@@ -821,6 +871,7 @@ void z_init_thread_base(struct _thread_base *thread_base, int priority,
 
 #ifdef CONFIG_SMP
 	thread_base->is_idle = 0;
+	thread_base->cpu = 0;
 #endif
 
 	/* swap_data does not need to be initialized */
@@ -1024,13 +1075,227 @@ static inline k_ticks_t z_vrfy_k_thread_timeout_expires_ticks(
 #endif
 
 #ifdef CONFIG_INSTRUMENT_THREAD_SWITCHING
+
+#ifdef CONFIG_CPU_LOAD
+/* The runtime statistics of a CPU, and of the thread it runs, are only
+ * updated by that CPU with its interrupts locked. Other CPUs read them
+ * under sequence counts, which are odd while an update is in progress,
+ * and add the time in progress themselves rather than account for it,
+ * so reading never writes to the statistics or takes a global lock.
+ */
+static inline void rt_stats_write_begin(atomic_t *seq)
+{
+	(void)atomic_inc(seq);
+	z_smp_mb();
+}
+
+static inline void rt_stats_write_end(atomic_t *seq)
+{
+	z_smp_mb();
+	(void)atomic_inc(seq);
+}
+
+static inline uint32_t rt_stats_read_begin(const atomic_t *seq)
+{
+	uint32_t val;
+
+	/* the writer can only be another CPU, which doesn't get preempted */
+	do {
+		val = (uint32_t)atomic_get(seq);
+	} while ((val & 1U) != 0U);
+	z_smp_mb();
+
+	return val;
+}
+
+static inline bool rt_stats_read_retry(const atomic_t *seq, uint32_t val)
+{
+	z_smp_mb();
+
+	return (uint32_t)atomic_get(seq) != val;
+}
+
+/* Cycles from since to now, 0 if now was read by another CPU before
+ * since was, so that an update racing with a reader is not counted
+ * as a wrapped around count.
+ */
+static inline uint32_t rt_stats_elapsed(uint32_t since, uint32_t now)
+{
+	int32_t diff = (int32_t)(now - since);
+
+	return (diff > 0) ? (uint32_t)diff : 0U;
+}
+
+/* Starts accounting the time in progress on the current CPU to thread */
+static void rt_stats_resume(struct _cpu *cpu, struct k_thread *thread,
+			    uint32_t now)
+{
+	cpu->rt_stats.since = now;
+
+	rt_stats_write_begin(&thread->rt_stats.seq);
+	thread->rt_stats.last_switched_in = now;
+	thread->rt_stats.accounting = true;
+	rt_stats_write_end(&thread->rt_stats.seq);
+}
+
+/* Accounts the time in progress on the current CPU to thread, and stops
+ * accounting it, with the CPU statistics being updated.
+ */
+static void rt_stats_charge(struct _cpu *cpu, struct k_thread *thread,
+			    uint32_t now)
+{
+	uint32_t diff = now - cpu->rt_stats.since;
+
+	rt_stats_write_begin(&thread->rt_stats.seq);
+	thread->rt_stats.stats.execution_cycles += diff;
+	thread->rt_stats.accounting = false;
+	rt_stats_write_end(&thread->rt_stats.seq);
+
+	if (thread == cpu->idle_thread) {
+		cpu->rt_stats.idle_cycles += diff;
+	} else {
+		cpu->rt_stats.busy_cycles += diff;
+	}
+}
+
+static void rt_stats_switched_in(void)
+{
+	unsigned int key = arch_irq_lock();
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *thread = k_current_get();
+
+	if (thread->base.thread_state == _THREAD_DUMMY) {
+		/* dummy thread has no stat struct */
+		thread = NULL;
+	}
+
+	rt_stats_write_begin(&cpu->rt_stats.seq);
+	cpu->rt_stats.accounted = thread;
+	if ((thread != NULL) && (cpu->rt_stats.isr_nested == 0U)) {
+		rt_stats_resume(cpu, thread, k_cycle_get_32());
+	}
+	rt_stats_write_end(&cpu->rt_stats.seq);
+
+	arch_irq_unlock(key);
+}
+
+static void rt_stats_switched_out(void)
+{
+	unsigned int key = arch_irq_lock();
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *thread = cpu->rt_stats.accounted;
+
+	rt_stats_write_begin(&cpu->rt_stats.seq);
+	if ((thread != NULL) && (cpu->rt_stats.isr_nested == 0U)) {
+		rt_stats_charge(cpu, thread, k_cycle_get_32());
+	}
+	cpu->rt_stats.accounted = NULL;
+	rt_stats_write_end(&cpu->rt_stats.seq);
+
+	arch_irq_unlock(key);
+}
+
+#ifdef CONFIG_CPU_LOAD_ISR
+void z_cpu_load_isr_enter(void)
+{
+	unsigned int key = arch_irq_lock();
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *thread = cpu->rt_stats.accounted;
+	uint32_t now;
+
+	rt_stats_write_begin(&cpu->rt_stats.seq);
+	if (cpu->rt_stats.isr_nested++ == 0U) {
+		now = k_cycle_get_32();
+		if (thread != NULL) {
+			rt_stats_charge(cpu, thread, now);
+		}
+		cpu->rt_stats.since = now;
+	}
+	rt_stats_write_end(&cpu->rt_stats.seq);
+
+	arch_irq_unlock(key);
+}
+
+void z_cpu_load_isr_exit(void)
+{
+	unsigned int key = arch_irq_lock();
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *thread = cpu->rt_stats.accounted;
+	uint32_t now;
+
+	rt_stats_write_begin(&cpu->rt_stats.seq);
+	if (--cpu->rt_stats.isr_nested == 0U) {
+		now = k_cycle_get_32();
+		cpu->rt_stats.isr_cycles += now - cpu->rt_stats.since;
+		cpu->rt_stats.since = now;
+		if (thread != NULL) {
+			/* resume accounting to the interrupted thread */
+			rt_stats_resume(cpu, thread, now);
+		}
+	}
+	rt_stats_write_end(&cpu->rt_stats.seq);
+
+	arch_irq_unlock(key);
+}
+#endif /* CONFIG_CPU_LOAD_ISR */
+
+uint64_t z_thread_runtime_cycles(struct k_thread *thread, uint32_t now)
+{
+	struct _thread_runtime_stats *rt_stats = &thread->rt_stats;
+	uint64_t cycles;
+	uint32_t val;
+
+	do {
+		val = rt_stats_read_begin(&rt_stats->seq);
+		cycles = rt_stats->stats.execution_cycles;
+		if (rt_stats->accounting) {
+			cycles += rt_stats_elapsed(rt_stats->last_switched_in,
+						   now);
+		}
+	} while (rt_stats_read_retry(&rt_stats->seq, val));
+
+	return cycles;
+}
+
+void z_cpu_runtime_stats_read(int id, uint32_t now,
+			      struct k_cpu_runtime_stats *stats)
+{
+	struct _cpu *cpu = &_kernel.cpus[id];
+	struct _cpu_runtime_stats *rt_stats = &cpu->rt_stats;
+	struct k_thread *thread;
+	uint32_t val, diff;
+
+	do {
+		val = rt_stats_read_begin(&rt_stats->seq);
+		stats->idle_cycles = rt_stats->idle_cycles;
+		stats->busy_cycles = rt_stats->busy_cycles;
+		stats->isr_cycles = rt_stats->isr_cycles;
+		thread = rt_stats->accounted;
+		diff = rt_stats_elapsed(rt_stats->since, now);
+
+		/* thread is only compared, not followed, as it may be torn */
+		if (rt_stats->isr_nested > 0U) {
+			stats->isr_cycles += diff;
+		} else if (thread == cpu->idle_thread) {
+			stats->idle_cycles += diff;
+		} else if (thread != NULL) {
+			stats->busy_cycles += diff;
+		} else {
+			/* switching, nothing accounted */
+		}
+	} while (rt_stats_read_retry(&rt_stats->seq, val));
+}
+#endif /* CONFIG_CPU_LOAD */
+
 void z_thread_mark_switched_in(void)
 {
 #ifdef CONFIG_TRACING
 	sys_trace_thread_switched_in();
 #endif
 
-#ifdef CONFIG_THREAD_RUNTIME_STATS
+#ifdef CONFIG_CPU_LOAD
+	rt_stats_switched_in();
+#elif defined(CONFIG_THREAD_RUNTIME_STATS)
 	struct k_thread *thread;
 
 	thread = k_current_get();
@@ -1039,13 +1304,14 @@ void z_thread_mark_switched_in(void)
 #else
 	thread->rt_stats.last_switched_in = k_cycle_get_32();
 #endif /* CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS */
-
-#endif /* CONFIG_THREAD_RUNTIME_STATS */
+#endif /* CONFIG_CPU_LOAD */
 }
 
 void z_thread_mark_switched_out(void)
 {
-#ifdef CONFIG_THREAD_RUNTIME_STATS
+#ifdef CONFIG_CPU_LOAD
+	rt_stats_switched_out();
+#elif defined(CONFIG_THREAD_RUNTIME_STATS)
 #ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
 	timing_t now;
 #else
@@ -1079,7 +1345,7 @@ void z_thread_mark_switched_out(void)
 	thread->rt_stats.stats.execution_cycles += diff;
 
 	threads_runtime_stats.execution_cycles += diff;
-#endif /* CONFIG_THREAD_RUNTIME_STATS */
+#endif /* CONFIG_CPU_LOAD */
 
 #ifdef CONFIG_TRACING
 	sys_trace_thread_switched_out();
@@ -1094,8 +1360,13 @@ int k_thread_runtime_stats_get(k_tid_t thread,
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_CPU_LOAD
+	stats->execution_cycles = z_thread_runtime_cycles(thread,
+							  k_cycle_get_32());
+#else
 	(void)memcpy(stats, &thread->rt_stats.stats,
 		     sizeof(thread->rt_stats.stats));
+#endif
 
 	return 0;
 }
@@ -1106,11 +1377,37 @@ int k_thread_runtime_stats_all_get(k_thread_runtime_stats_t *stats)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_CPU_LOAD
+	/* every cycle accounted to a thread is accounted to its CPU too */
+	struct k_cpu_runtime_stats cpu_stats;
+	uint32_t now = k_cycle_get_32();
+
+	stats->execution_cycles = 0U;
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		z_cpu_runtime_stats_read(i, now, &cpu_stats);
+		stats->execution_cycles += cpu_stats.idle_cycles +
+					   cpu_stats.busy_cycles;
+	}
+#else
 	(void)memcpy(stats, &threads_runtime_stats,
 		     sizeof(threads_runtime_stats));
+#endif
+
+	return 0;
+}
+
+#ifdef CONFIG_CPU_LOAD
+int k_cpu_runtime_stats_get(int cpu, struct k_cpu_runtime_stats *stats)
+{
+	if ((cpu < 0) || (cpu >= CONFIG_MP_NUM_CPUS) || (stats == NULL)) {
+		return -EINVAL;
+	}
+
+	z_cpu_runtime_stats_read(cpu, k_cycle_get_32(), stats);
 
 	return 0;
 }
+#endif /* CONFIG_CPU_LOAD */
 #endif /* CONFIG_THREAD_RUNTIME_STATS */
 
 #endif /* CONFIG_INSTRUMENT_THREAD_SWITCHING */
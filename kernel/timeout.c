@@ -19,8 +19,6 @@
 
 static uint64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
@@ -29,6 +27,14 @@ static struct k_spinlock timeout_lock;
 /* Cycles left to process in the currently-executing z_clock_announce() */
 static int announce_remaining;
 
+#ifdef CONFIG_TIMEOUT_QUEUE_PER_CPU
+/* Sequence count guarding curr_tick and announce_remaining, so that
+ * the per-CPU queue paths can sample the clock without taking
+ * timeout_lock.  Odd while an update is in progress.
+ */
+static atomic_t tick_seq;
+#endif
+
 #if defined(CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME)
 int z_clock_hw_cycles_per_sec = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC;
 
@@ -41,6 +47,99 @@ static inline int z_vrfy_z_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_QUEUE_PHEAP
+
+/* Timeouts live in a pairing heap keyed on their absolute expiry
+ * tick (stored in dticks, truncated to its width), with an insertion
+ * sequence number to preserve the FIFO ordering of the delta list
+ * between timeouts expiring on the same tick.
+ */
+static int64_t tick_diff(int64_t a, int64_t b)
+{
+#ifdef CONFIG_TIMEOUT_64BIT
+	return a - b;
+#else
+	return (int32_t)((uint32_t)a - (uint32_t)b);
+#endif
+}
+
+static bool timeout_lessthan(struct pheap_node *a, struct pheap_node *b)
+{
+	struct _timeout *ta = CONTAINER_OF(a, struct _timeout, node);
+	struct _timeout *tb = CONTAINER_OF(b, struct _timeout, node);
+	int64_t d = tick_diff(ta->dticks, tb->dticks);
+
+	return d < 0 || (d == 0 && (int32_t)(ta->seq - tb->seq) < 0);
+}
+
+struct timeout_q {
+	struct pheap heap;
+	uint32_t seq;
+#ifdef CONFIG_TIMEOUT_QUEUE_PER_CPU
+	struct k_spinlock lock;
+#endif
+};
+
+#ifdef CONFIG_TIMEOUT_QUEUE_PER_CPU
+static struct timeout_q timeout_qs[CONFIG_MP_NUM_CPUS] = {
+	[0 ... (CONFIG_MP_NUM_CPUS - 1)] = {
+		.heap = PHEAP_STATIC_INIT(),
+	},
+};
+#else
+static struct timeout_q timeout_q = {
+	.heap = PHEAP_STATIC_INIT(),
+};
+#endif
+
+static struct _timeout *q_first(struct timeout_q *q)
+{
+	struct pheap_node *n = pheap_get_min(&q->heap);
+
+	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
+}
+
+/* Ticks from curr_tick until the timeout expires */
+static int64_t timeout_delta(const struct _timeout *t)
+{
+	return tick_diff(t->dticks, curr_tick);
+}
+
+/* Inserts a timeout expiring at the absolute tick "end" */
+static void q_insert(struct timeout_q *q, struct _timeout *to, uint64_t end)
+{
+	to->dticks = end;
+	to->seq = q->seq++;
+	pheap_insert(&q->heap, &to->node, timeout_lessthan);
+}
+
+#ifndef CONFIG_TIMEOUT_QUEUE_PER_CPU
+static struct _timeout *first(void)
+{
+	return q_first(&timeout_q);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	pheap_remove(&timeout_q.heap, &t->node, timeout_lessthan);
+}
+
+/* Inserts a timeout expiring dt ticks after curr_tick */
+static void insert_timeout(struct _timeout *to, int64_t dt)
+{
+	q_insert(&timeout_q, to, curr_tick + dt);
+}
+#endif
+
+static bool is_linked(const struct _timeout *t)
+{
+	return pheap_node_is_linked(&t->node);
+}
+
+#else
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -55,6 +154,14 @@ static struct _timeout *next(struct _timeout *t)
 	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
+/* Ticks from curr_tick until the timeout expires, only meaningful
+ * for the head of the list
+ */
+static int64_t timeout_delta(const struct _timeout *t)
+{
+	return t->dticks;
+}
+
 static void remove_timeout(struct _timeout *t)
 {
 	if (next(t) != NULL) {
@@ -64,17 +171,126 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+static void insert_timeout(struct _timeout *to, int64_t dt)
+{
+	struct _timeout *t;
+
+	to->dticks = dt;
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+
+static bool is_linked(const struct _timeout *t)
+{
+	return sys_dnode_is_linked(&t->node);
+}
+
+#endif /* CONFIG_TIMEOUT_QUEUE_PHEAP */
+
 static int32_t elapsed(void)
 {
 	return announce_remaining == 0 ? z_clock_elapsed() : 0U;
 }
 
-static int32_t next_timeout(void)
+#ifdef CONFIG_TIMEOUT_QUEUE_PER_CPU
+
+static void clock_update_begin(void)
+{
+	atomic_inc(&tick_seq);
+}
+
+static void clock_update_end(void)
+{
+	atomic_inc(&tick_seq);
+}
+
+/* Lockless snapshot of curr_tick and (if ticks_elapsed is not NULL)
+ * elapsed(), consistent with any concurrent z_clock_announce()
+ */
+static uint64_t clock_read(int32_t *ticks_elapsed)
+{
+	for (;;) {
+		atomic_val_t seq = atomic_get(&tick_seq);
+		uint64_t tick;
+
+		if ((seq & 1) != 0) {
+			continue;
+		}
+
+		tick = curr_tick;
+		if (ticks_elapsed != NULL) {
+			*ticks_elapsed = elapsed();
+		}
+
+		if (atomic_get(&tick_seq) == seq) {
+			return tick;
+		}
+	}
+}
+
+/* Finds the queue holding the earliest timeout across all CPUs, and
+ * that timeout's delta from curr_tick.  Queue locks are taken one at
+ * a time, so the result is only a hint unless the caller holds
+ * timeout_lock, which serializes everything that reprograms the timer.
+ */
+static struct timeout_q *earliest_q(int64_t *delta)
+{
+	struct timeout_q *ret = NULL;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct timeout_q *q = &timeout_qs[i];
+
+		LOCKED(&q->lock) {
+			struct _timeout *t = q_first(q);
+
+			if (t != NULL &&
+			    (ret == NULL || timeout_delta(t) < *delta)) {
+				*delta = timeout_delta(t);
+				ret = q;
+			}
+		}
+	}
+
+	return ret;
+}
+
+static bool next_delta(int64_t *delta)
+{
+	return earliest_q(delta) != NULL;
+}
+
+#else
+
+static bool next_delta(int64_t *delta)
 {
 	struct _timeout *to = first();
+
+	if (to != NULL) {
+		*delta = timeout_delta(to);
+	}
+
+	return to != NULL;
+}
+
+#endif /* CONFIG_TIMEOUT_QUEUE_PER_CPU */
+
+static int32_t next_timeout(void)
+{
+	int64_t delta = 0;
+	bool pending = next_delta(&delta);
 	int32_t ticks_elapsed = elapsed();
-	int32_t ret = to == NULL ? MAX_WAIT
-		: CLAMP(to->dticks - ticks_elapsed, 0, MAX_WAIT);
+	int32_t ret = !pending ? MAX_WAIT
+		: CLAMP(delta - ticks_elapsed, 0, MAX_WAIT);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -84,6 +300,8 @@ static int32_t next_timeout(void)
 	return ret;
 }
 
+#ifndef CONFIG_TIMEOUT_QUEUE_PER_CPU
+
 void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 		   k_timeout_t timeout)
 {
@@ -105,26 +323,12 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 	}
 #endif
 
-	__ASSERT(!sys_dnode_is_linked(&to->node), "");
+	__ASSERT(!is_linked(to), "");
 	to->fn = fn;
 	ticks = MAX(1, ticks);
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+		insert_timeout(to, ticks + elapsed());
 
 		if (to == first()) {
 			z_clock_set_timeout(next_timeout(), false);
@@ -137,7 +341,7 @@ int z_abort_timeout(struct _timeout *to)
 	int ret = -EINVAL;
 
 	LOCKED(&timeout_lock) {
-		if (sys_dnode_is_linked(&to->node)) {
+		if (is_linked(to)) {
 			remove_timeout(to);
 			ret = 0;
 		}
@@ -155,12 +359,16 @@ static k_ticks_t timeout_rem(const struct _timeout *timeout)
 		return 0;
 	}
 
+#ifdef CONFIG_TIMEOUT_QUEUE_PHEAP
+	ticks = timeout_delta(timeout);
+#else
 	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
 		ticks += t->dticks;
 		if (timeout == t) {
 			break;
 		}
 	}
+#endif
 
 	return ticks - elapsed();
 }
@@ -187,6 +395,120 @@ k_ticks_t z_timeout_expires(const struct _timeout *timeout)
 	return ticks;
 }
 
+#else /* CONFIG_TIMEOUT_QUEUE_PER_CPU */
+
+/* Each CPU owns a queue and its lock, and timeouts are inserted into
+ * the queue of the CPU that arms them.  Expiry times are absolute, so
+ * a timeout never needs to move between queues.  The system timer is
+ * a single device, so it is still programmed (under timeout_lock) for
+ * the earliest timeout across all queues, but that only needs doing
+ * when a new timeout becomes the head of its queue.
+ */
+void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
+		   k_timeout_t timeout)
+{
+	struct timeout_q *q;
+	k_spinlock_key_t key;
+	unsigned int irq_key;
+	int32_t ticks_elapsed;
+	uint64_t now;
+	bool head;
+
+	if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+		return;
+	}
+
+#ifdef KERNEL_COHERENCE
+	__ASSERT_NO_MSG(arch_mem_coherent(to));
+#endif
+
+	__ASSERT(!is_linked(to), "");
+	to->fn = fn;
+
+	/* Pin ourselves to this CPU's queue */
+	irq_key = arch_irq_lock();
+	q = &timeout_qs[arch_curr_cpu()->id];
+	key = k_spin_lock(&q->lock);
+
+	now = clock_read(&ticks_elapsed);
+
+#ifdef CONFIG_LEGACY_TIMEOUT_API
+	k_ticks_t ticks = timeout;
+#else
+	k_ticks_t ticks = timeout.ticks + 1;
+
+	if (IS_ENABLED(CONFIG_TIMEOUT_64BIT) && Z_TICK_ABS(ticks) >= 0) {
+		ticks = Z_TICK_ABS(ticks) - (now + ticks_elapsed);
+	}
+#endif
+
+	ticks = MAX(1, ticks);
+
+	to->cpu = arch_curr_cpu()->id;
+	q_insert(q, to, now + ticks + ticks_elapsed);
+	head = to == q_first(q);
+
+	k_spin_unlock(&q->lock, key);
+
+	if (head) {
+		LOCKED(&timeout_lock) {
+			z_clock_set_timeout(next_timeout(), false);
+		}
+	}
+
+	arch_irq_unlock(irq_key);
+}
+
+int z_abort_timeout(struct _timeout *to)
+{
+	struct timeout_q *q = &timeout_qs[to->cpu];
+	int ret = -EINVAL;
+
+	LOCKED(&q->lock) {
+		if (is_linked(to)) {
+			pheap_remove(&q->heap, &to->node, timeout_lessthan);
+			ret = 0;
+		}
+	}
+
+	return ret;
+}
+
+/* Returns the remaining ticks and the matching curr_tick snapshot */
+static k_ticks_t timeout_rem(const struct _timeout *timeout, uint64_t *now)
+{
+	struct timeout_q *q = &timeout_qs[timeout->cpu];
+	k_ticks_t ticks = 0;
+	int32_t ticks_elapsed;
+
+	LOCKED(&q->lock) {
+		*now = clock_read(&ticks_elapsed);
+		if (!z_is_inactive_timeout(timeout)) {
+			ticks = tick_diff(timeout->dticks, *now)
+				- ticks_elapsed;
+		}
+	}
+
+	return ticks;
+}
+
+k_ticks_t z_timeout_remaining(const struct _timeout *timeout)
+{
+	uint64_t now;
+
+	return timeout_rem(timeout, &now);
+}
+
+k_ticks_t z_timeout_expires(const struct _timeout *timeout)
+{
+	uint64_t now;
+	k_ticks_t ticks = timeout_rem(timeout, &now);
+
+	return now + ticks;
+}
+
+#endif /* CONFIG_TIMEOUT_QUEUE_PER_CPU */
+
 int32_t z_get_next_timeout_expiry(void)
 {
 	int32_t ret = (int32_t) K_TICKS_FOREVER;
@@ -221,6 +543,8 @@ void z_set_timeout_expiry(int32_t ticks, bool is_idle)
 	}
 }
 
+#ifndef CONFIG_TIMEOUT_QUEUE_PER_CPU
+
 void z_clock_announce(int32_t ticks)
 {
 #ifdef CONFIG_TIMESLICING
@@ -231,9 +555,10 @@ void z_clock_announce(int32_t ticks)
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
+	while (first() != NULL &&
+	       timeout_delta(first()) <= announce_remaining) {
 		struct _timeout *t = first();
-		int dt = t->dticks;
+		int dt = timeout_delta(t);
 
 		curr_tick += dt;
 		announce_remaining -= dt;
@@ -245,9 +570,11 @@ void z_clock_announce(int32_t ticks)
 		key = k_spin_lock(&timeout_lock);
 	}
 
+#ifndef CONFIG_TIMEOUT_QUEUE_PHEAP
 	if (first() != NULL) {
 		first()->dticks -= announce_remaining;
 	}
+#endif
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
@@ -267,6 +594,88 @@ int64_t z_tick_get(void)
 	return t;
 }
 
+#else /* CONFIG_TIMEOUT_QUEUE_PER_CPU */
+
+/* Pops the earliest timeout across all queues if it expires within
+ * the current announcement, must be called with timeout_lock held.
+ */
+static struct _timeout *pop_expired(void)
+{
+	for (;;) {
+		int64_t delta = 0;
+		struct timeout_q *q = earliest_q(&delta);
+		struct _timeout *t = NULL;
+		bool changed = false;
+
+		if (q == NULL || delta > announce_remaining) {
+			return NULL;
+		}
+
+		/* The head may have been aborted (or a new one added)
+		 * since the scan, in which case look again
+		 */
+		LOCKED(&q->lock) {
+			t = q_first(q);
+			if (t == NULL ||
+			    timeout_delta(t) > announce_remaining) {
+				changed = true;
+			} else {
+				pheap_remove(&q->heap, &t->node,
+					     timeout_lessthan);
+			}
+		}
+
+		if (!changed) {
+			return t;
+		}
+	}
+}
+
+void z_clock_announce(int32_t ticks)
+{
+	struct _timeout *t;
+
+#ifdef CONFIG_TIMESLICING
+	z_time_slice(ticks);
+#endif
+
+	k_spinlock_key_t key = k_spin_lock(&timeout_lock);
+
+	clock_update_begin();
+	announce_remaining = ticks;
+	clock_update_end();
+
+	while ((t = pop_expired()) != NULL) {
+		int dt = MAX(0, timeout_delta(t));
+
+		clock_update_begin();
+		curr_tick += dt;
+		announce_remaining -= dt;
+		clock_update_end();
+		t->dticks = 0;
+
+		k_spin_unlock(&timeout_lock, key);
+		t->fn(t);
+		key = k_spin_lock(&timeout_lock);
+	}
+
+	clock_update_begin();
+	curr_tick += announce_remaining;
+	announce_remaining = 0;
+	clock_update_end();
+
+	z_clock_set_timeout(next_timeout(), false);
+
+	k_spin_unlock(&timeout_lock, key);
+}
+
+int64_t z_tick_get(void)
+{
+	return clock_read(NULL) + z_clock_elapsed();
+}
+
+#endif /* CONFIG_TIMEOUT_QUEUE_PER_CPU */
+
 uint32_t z_tick_get_32(void)
 {
 #ifdef CONFIG_TICKLESS_KERNEL
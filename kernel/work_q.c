@@ -17,6 +17,7 @@
 #include <errno.h>
 #include <stdbool.h>
 #include <sys/check.h>
+#include <tracing/tracing.h>
 
 #define WORKQUEUE_THREAD_NAME	"workqueue"
 
@@ -26,16 +27,395 @@ static struct k_spinlock lock;
 
 extern void z_work_q_main(void *work_q_ptr, void *p2, void *p3);
 
+#ifdef CONFIG_WORKQUEUE_RUNTIME_STATS
+static struct k_spinlock stats_lock;
+static sys_slist_t stats_queues = SYS_SLIST_STATIC_INIT(&stats_queues);
+static struct k_work_handler_stats
+	handler_stats[CONFIG_WORKQUEUE_RUNTIME_STATS_HANDLERS];
+
+static void stats_init(struct k_work_q *work_q)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	sys_snode_t *node;
+
+	/* the workqueue may be started again, it then stays in place so
+	 * that k_work_q_foreach() never sees a node move
+	 */
+	SYS_SLIST_FOR_EACH_NODE(&stats_queues, node) {
+		if (node == &work_q->stats_node) {
+			break;
+		}
+	}
+	if (node == NULL) {
+		sys_slist_append(&stats_queues, &work_q->stats_node);
+	}
+	work_q->stats = (struct k_work_q_runtime_stats){ 0 };
+	work_q->stats_enabled = true;
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void z_work_q_stats_submit(struct k_work_q *work_q, struct k_work *work)
+{
+	struct k_work_q_runtime_stats *stats = &work_q->stats;
+	k_spinlock_key_t key;
+
+	if (!work_q->stats_enabled) {
+		return;
+	}
+
+	work->_submitted_at = k_cycle_get_32();
+
+	key = k_spin_lock(&stats_lock);
+	stats->submitted++;
+	stats->depth++;
+	stats->max_depth = MAX(stats->max_depth, stats->depth);
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_cancel(struct k_work_q *work_q)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	if (work_q->stats.depth > 0U) {
+		work_q->stats.depth--;
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_start(struct k_work_q *work_q, struct k_work *work)
+{
+	struct k_work_q_runtime_stats *stats = &work_q->stats;
+	uint32_t us, bucket;
+	k_spinlock_key_t key;
+
+	us = k_cyc_to_us_floor32(k_cycle_get_32() - work->_submitted_at);
+	bucket = (us == 0U) ? 0U : (32U - __builtin_clz(us));
+	bucket = MIN(bucket, K_WORK_Q_LATENCY_BUCKETS - 1);
+
+	key = k_spin_lock(&stats_lock);
+
+	/* items submitted without z_work_q_stats_submit() weren't counted */
+	if (stats->depth > 0U) {
+		stats->depth--;
+		stats->latency_hist[bucket]++;
+		stats->max_latency_us = MAX(stats->max_latency_us, us);
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_end(struct k_work_q *work_q, k_work_handler_t handler,
+		      uint32_t cycles)
+{
+	struct k_work_q_runtime_stats *stats = &work_q->stats;
+	struct k_work_handler_stats *hs = NULL;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&stats_lock);
+
+	stats->handled++;
+	stats->handler_cycles += cycles;
+	stats->max_handler_cycles = MAX(stats->max_handler_cycles, cycles);
+
+	for (int i = 0; i < ARRAY_SIZE(handler_stats); i++) {
+		if (handler_stats[i].handler == NULL) {
+			hs = &handler_stats[i];
+			hs->work_q = work_q;
+			hs->handler = handler;
+			break;
+		}
+
+		if ((handler_stats[i].handler == handler) &&
+		    (handler_stats[i].work_q == work_q)) {
+			hs = &handler_stats[i];
+			break;
+		}
+	}
+
+	if (hs != NULL) {
+		hs->count++;
+		hs->cycles += cycles;
+		hs->max_cycles = MAX(hs->max_cycles, cycles);
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+int k_work_q_runtime_stats_get(struct k_work_q *work_q,
+			       struct k_work_q_runtime_stats *stats)
+{
+	k_spinlock_key_t key;
+
+	if (!work_q->stats_enabled) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&stats_lock);
+	*stats = work_q->stats;
+	k_spin_unlock(&stats_lock, key);
+
+	return 0;
+}
+
+void k_work_q_runtime_stats_reset(struct k_work_q *work_q)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	uint32_t depth = work_q->stats.depth;
+	int i, j;
+
+	work_q->stats = (struct k_work_q_runtime_stats){ 0 };
+	work_q->stats.depth = depth;
+	work_q->stats.max_depth = depth;
+
+	/* keep the entries of the other workqueues packed */
+	for (i = 0, j = 0; i < ARRAY_SIZE(handler_stats); i++) {
+		if (handler_stats[i].work_q != work_q) {
+			handler_stats[j++] = handler_stats[i];
+		}
+	}
+
+	for (; j < ARRAY_SIZE(handler_stats); j++) {
+		handler_stats[j] = (struct k_work_handler_stats){ 0 };
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+void k_work_q_foreach(k_work_q_user_cb_t user_cb, void *user_data)
+{
+	k_spinlock_key_t key;
+	sys_snode_t *node;
+
+	/* workqueues are only ever appended, so the list can be left
+	 * while user_cb runs, e.g. to get the statistics
+	 */
+	key = k_spin_lock(&stats_lock);
+	node = sys_slist_peek_head(&stats_queues);
+	while (node != NULL) {
+		k_spin_unlock(&stats_lock, key);
+		user_cb(CONTAINER_OF(node, struct k_work_q, stats_node),
+			user_data);
+		key = k_spin_lock(&stats_lock);
+		node = sys_slist_peek_next(node);
+	}
+	k_spin_unlock(&stats_lock, key);
+}
+
+void k_work_handler_stats_foreach(k_work_handler_stats_cb_t user_cb,
+				  void *user_data)
+{
+	struct k_work_handler_stats hs;
+	k_spinlock_key_t key;
+
+	for (int i = 0; i < ARRAY_SIZE(handler_stats); i++) {
+		key = k_spin_lock(&stats_lock);
+		hs = handler_stats[i];
+		k_spin_unlock(&stats_lock, key);
+
+		if (hs.handler == NULL) {
+			break;
+		}
+
+		user_cb(&hs, user_data);
+	}
+}
+#else
+#define stats_init(work_q) do { } while (false)
+#define stats_cancel(work_q) do { } while (false)
+#define stats_start(work_q, work) do { } while (false)
+#define stats_end(work_q, handler, cycles) do { } while (false)
+#endif /* CONFIG_WORKQUEUE_RUNTIME_STATS */
+
+#if defined(CONFIG_WORKQUEUE_RUNTIME_STATS) || defined(CONFIG_TRACING) || \
+	defined(CONFIG_WORKQUEUE_POOL)
+/* Runs a work item taken off the queue of work_q, returns the number of
+ * cycles its handler took.
+ */
+static uint32_t work_run(struct k_work_q *work_q, struct k_work *work)
+{
+	k_work_handler_t handler = work->handler;
+	uint32_t start, cycles;
+
+	stats_start(work_q, work);
+
+	/* Reset pending state so it can be resubmitted by handler */
+	if (!atomic_test_and_clear_bit(work->flags, K_WORK_STATE_PENDING)) {
+		return 0U;
+	}
+
+	__ASSERT(handler != NULL, "handler must be provided");
+
+	sys_trace_work_start(work_q, work);
+	start = k_cycle_get_32();
+	handler(work);
+	cycles = k_cycle_get_32() - start;
+	sys_trace_work_end(work_q, work);
+
+	stats_end(work_q, handler, cycles);
+
+	return cycles;
+}
+#endif
+
+#if defined(CONFIG_WORKQUEUE_RUNTIME_STATS) || defined(CONFIG_TRACING)
+/* Called by the threads of kernel mode workqueues with each work item
+ * they take, when they are instrumented.
+ */
+void z_work_q_run(struct k_work_q *work_q, struct k_work *work)
+{
+	(void)work_run(work_q, work);
+}
+#endif
+
 void k_work_q_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 		    size_t stack_size, int prio)
 {
 	k_queue_init(&work_q->queue);
+#ifdef CONFIG_WORKQUEUE_POOL
+	work_q->workers = NULL;
+#endif
+	stats_init(work_q);
 	(void)k_thread_create(&work_q->thread, stack, stack_size, z_work_q_main,
 			work_q, NULL, NULL, prio, 0, K_NO_WAIT);
 
 	k_thread_name_set(&work_q->thread, WORKQUEUE_THREAD_NAME);
 }
 
+#ifdef CONFIG_WORKQUEUE_POOL
+void k_work_q_pool_start(struct k_work_q *work_q,
+			 struct k_work_q_worker *workers,
+			 k_thread_stack_t *stacks, size_t stack_size,
+			 int num_workers, int prio, uint32_t options)
+{
+	__ASSERT(num_workers > 0, "a pool needs workers");
+
+	k_queue_init(&work_q->queue);
+	work_q->workers = workers;
+	work_q->num_workers = num_workers;
+	stats_init(work_q);
+
+	for (int i = 0; i < num_workers; i++) {
+		struct k_work_q_worker *worker = &workers[i];
+		k_thread_stack_t *stack = (k_thread_stack_t *)
+			((char *)stacks + i * Z_KERNEL_STACK_LEN(stack_size));
+
+		worker->work_q = work_q;
+		worker->current = NULL;
+		sys_slist_init(&worker->deferred);
+		worker->handled = 0U;
+		worker->max_cycles = 0U;
+		worker->cycles = 0U;
+
+		(void)k_thread_create(&worker->thread, stack, stack_size,
+				      z_work_q_main, work_q, worker, NULL,
+				      prio, 0, K_FOREVER);
+		k_thread_name_set(&worker->thread, WORKQUEUE_THREAD_NAME);
+#ifdef CONFIG_SCHED_CPU_MASK
+		if ((options & K_WORK_Q_POOL_PIN) != 0U) {
+			(void)k_thread_cpu_mask_clear(&worker->thread);
+			(void)k_thread_cpu_mask_enable(&worker->thread,
+						i % CONFIG_MP_NUM_CPUS);
+		}
+#else
+		ARG_UNUSED(options);
+#endif
+		k_thread_start(&worker->thread);
+	}
+}
+
+static struct k_work_q_worker *pool_find_current(struct k_work_q *work_q,
+						 struct k_work *work)
+{
+	for (int i = 0; i < work_q->num_workers; i++) {
+		if (work_q->workers[i].current == work) {
+			return &work_q->workers[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Called by the threads of a pool with each work item they take */
+void z_work_q_pool_run(struct k_work_q_worker *worker, struct k_work *work)
+{
+	struct k_work_q *work_q = worker->work_q;
+	struct k_work_q_worker *owner;
+	k_spinlock_key_t key;
+	uint32_t cycles;
+
+	key = k_spin_lock(&work_q->lock);
+
+	/* Hand a resubmitted item over to the worker still running it, so
+	 * that it doesn't run concurrently with itself.  The item is out
+	 * of the queue, so its node can be reused for the deferred list.
+	 */
+	owner = pool_find_current(work_q, work);
+	if (owner != NULL) {
+		sys_slist_append(&owner->deferred, (sys_snode_t *)work);
+		k_spin_unlock(&work_q->lock, key);
+		return;
+	}
+
+	while (work != NULL) {
+		worker->current = work;
+		k_spin_unlock(&work_q->lock, key);
+
+		cycles = work_run(work_q, work);
+
+		key = k_spin_lock(&work_q->lock);
+		worker->handled++;
+		worker->cycles += cycles;
+		worker->max_cycles = MAX(worker->max_cycles, cycles);
+		work = (struct k_work *)sys_slist_get(&worker->deferred);
+	}
+
+	worker->current = NULL;
+	k_spin_unlock(&work_q->lock, key);
+}
+
+int k_work_q_pool_stats_get(struct k_work_q *work_q,
+			    struct k_work_q_pool_stats *stats)
+{
+	k_spinlock_key_t key;
+	sys_sfnode_t *node;
+	sys_snode_t *dnode;
+
+	if (work_q->workers == NULL) {
+		return -EINVAL;
+	}
+
+	*stats = (struct k_work_q_pool_stats){ 0 };
+
+	key = k_spin_lock(&work_q->queue.lock);
+	SYS_SFLIST_FOR_EACH_NODE(&work_q->queue.data_q, node) {
+		stats->depth++;
+	}
+	k_spin_unlock(&work_q->queue.lock, key);
+
+	key = k_spin_lock(&work_q->lock);
+	for (int i = 0; i < work_q->num_workers; i++) {
+		struct k_work_q_worker *worker = &work_q->workers[i];
+
+		if (worker->current != NULL) {
+			stats->busy++;
+		}
+		/* resubmissions waiting for their previous run count too */
+		SYS_SLIST_FOR_EACH_NODE(&worker->deferred, dnode) {
+			stats->depth++;
+		}
+		stats->handled += worker->handled;
+		stats->handler_cycles += worker->cycles;
+		stats->max_handler_cycles = MAX(stats->max_handler_cycles,
+						worker->max_cycles);
+	}
+	k_spin_unlock(&work_q->lock, key);
+
+	return 0;
+}
+#endif /* CONFIG_WORKQUEUE_POOL */
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 static void work_timeout(struct _timeout *t)
 {
@@ -53,6 +433,8 @@ static int work_cancel(struct k_delayed_work *work)
 		if (!k_queue_remove(&work->work_q->queue, &work->work)) {
 			return -EINVAL;
 		}
+
+		stats_cancel(work->work_q);
 	} else {
 		int err = z_abort_timeout(&work->timeout);
 
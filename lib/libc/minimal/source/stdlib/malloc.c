@@ -9,7 +9,8 @@
 #include <init.h>
 #include <errno.h>
 #include <sys/math_extras.h>
-#include <sys/mempool.h>
+#include <sys/sys_heap.h>
+#include <sys/mutex.h>
 #include <string.h>
 #include <app_memory/app_memdomain.h>
 #include <logging/log.h>
@@ -25,18 +26,28 @@ K_APPMEM_PARTITION_DEFINE(z_malloc_partition);
 #define POOL_SECTION .data
 #endif /* CONFIG_USERSPACE */
 
-SYS_MEM_POOL_DEFINE(z_malloc_mem_pool, NULL, 16,
-		    CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE, 1, 4, POOL_SECTION);
+#define HEAP_BYTES CONFIG_MINIMAL_LIBC_MALLOC_ARENA_SIZE
+
+Z_GENERIC_SECTION(POOL_SECTION) static struct sys_heap z_malloc_heap;
+Z_GENERIC_SECTION(POOL_SECTION) static struct sys_mutex z_malloc_heap_mutex;
+Z_GENERIC_SECTION(POOL_SECTION) static char z_malloc_heap_mem[HEAP_BYTES];
 
 void *malloc(size_t size)
 {
+	int lock_ret;
 	void *ret;
 
-	ret = sys_mem_pool_alloc(&z_malloc_mem_pool, size);
-	if (ret == NULL) {
+	lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	__ASSERT_NO_MSG(lock_ret == 0);
+
+	ret = sys_heap_aligned_alloc(&z_malloc_heap,
+				     __alignof__(z_max_align_t), size);
+	if (ret == NULL && size != 0) {
 		errno = ENOMEM;
 	}
 
+	(void) sys_mutex_unlock(&z_malloc_heap_mutex);
+
 	return ret;
 }
 
@@ -44,11 +55,47 @@ static int malloc_prepare(const struct device *unused)
 {
 	ARG_UNUSED(unused);
 
-	sys_mem_pool_init(&z_malloc_mem_pool);
+	sys_heap_init(&z_malloc_heap, z_malloc_heap_mem, HEAP_BYTES);
+	sys_mutex_init(&z_malloc_heap_mutex);
 
 	return 0;
 }
 
+void *realloc(void *ptr, size_t requested_size)
+{
+	int lock_ret;
+	void *ret;
+
+	lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	__ASSERT_NO_MSG(lock_ret == 0);
+
+	/* Grows or shrinks in place whenever the neighboring chunks
+	 * allow it, and only copies otherwise
+	 */
+	ret = sys_heap_aligned_realloc(&z_malloc_heap, ptr,
+				       __alignof__(z_max_align_t),
+				       requested_size);
+	if (ret == NULL && requested_size != 0) {
+		errno = ENOMEM;
+	}
+
+	(void) sys_mutex_unlock(&z_malloc_heap_mutex);
+
+	return ret;
+}
+
+void free(void *ptr)
+{
+	int lock_ret;
+
+	lock_ret = sys_mutex_lock(&z_malloc_heap_mutex, K_FOREVER);
+	__ASSERT_NO_MSG(lock_ret == 0);
+
+	sys_heap_free(&z_malloc_heap, ptr);
+
+	(void) sys_mutex_unlock(&z_malloc_heap_mutex);
+}
+
 SYS_INIT(malloc_prepare, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
 #else /* No malloc arena */
 void *malloc(size_t size)
@@ -60,43 +107,20 @@ void *malloc(size_t size)
 
 	return NULL;
 }
-#endif
 
 void *realloc(void *ptr, size_t requested_size)
 {
-	void *new_ptr;
-	size_t copy_size;
-
-	if (ptr == NULL) {
-		return malloc(requested_size);
-	}
-
-	if (requested_size == 0) {
-		free(ptr);
-		return NULL;
-	}
-
-	copy_size = sys_mem_pool_try_expand_inplace(ptr, requested_size);
-	if (copy_size == 0) {
-		/* Existing block large enough, nothing else to do */
-		return ptr;
-	}
+	ARG_UNUSED(ptr);
 
-	new_ptr = malloc(requested_size);
-	if (new_ptr == NULL) {
-		return NULL;
-	}
-
-	memcpy(new_ptr, ptr, copy_size);
-	free(ptr);
-
-	return new_ptr;
+	return malloc(requested_size);
 }
 
 void free(void *ptr)
 {
-	sys_mem_pool_free(ptr);
+	ARG_UNUSED(ptr);
 }
+#endif
+
 #endif /* CONFIG_MINIMAL_LIBC_MALLOC */
 
 #ifdef CONFIG_MINIMAL_LIBC_CALLOC
@@ -234,6 +234,8 @@ int close(int fd)
 		return -1;
 	}
 
+	z_fd_epoll_remove(fd);
+
 	res = fdtable[fd].vtable->close(fdtable[fd].obj);
 
 	z_free_fd(fd);
@@ -75,6 +75,7 @@ static inline void check_nexts(struct z_heap *h, int bidx)
 bool sys_heap_validate(struct sys_heap *heap)
 {
 	struct z_heap *h = heap->heap;
+	size_t used_chunks = 0;
 	chunkid_t c;
 
 	/*
@@ -84,11 +85,38 @@ bool sys_heap_validate(struct sys_heap *heap)
 		if (!valid_chunk(h, c)) {
 			return false;
 		}
+		if (chunk_used(h, c)) {
+			used_chunks += chunk_size(h, c);
+		}
 	}
 	if (c != h->len) {
 		return false;  /* Should have exactly consumed the buffer */
 	}
 
+#ifdef CONFIG_SYS_HEAP_CACHE
+	/* Cached chunks must be in-use chunks of their class's size */
+	for (int i = 0; i < CONFIG_SYS_HEAP_CACHE_CLASSES; i++) {
+		uint32_t n = 0;
+
+		for (c = h->cache.head[i]; c != 0; c = next_free_chunk(h, c)) {
+			VALIDATE(valid_chunk(h, c));
+			VALIDATE(chunk_used(h, c));
+			VALIDATE(chunk_size(h, c) == i + 1);
+			VALIDATE(++n <= h->cache.count[i]);
+			used_chunks -= chunk_size(h, c);
+		}
+		VALIDATE(n == h->cache.count[i]);
+	}
+#endif
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	/* Cached chunks count as free in the runtime statistics */
+	VALIDATE(used_chunks == h->allocated_chunks);
+	VALIDATE(h->allocated_chunks <= h->max_allocated_chunks);
+#else
+	ARG_UNUSED(used_chunks);
+#endif
+
 	/* Check the free lists: entry count should match, empty bit
 	 * should be correct, and all chunk entries should point into
 	 * valid unused chunks.  Mark those chunks USED, temporarily.
@@ -96,6 +124,9 @@ bool sys_heap_validate(struct sys_heap *heap)
 	for (int b = 0; b <= bucket_idx(h, h->len); b++) {
 		chunkid_t c0 = h->buckets[b].next;
 		uint32_t n = 0;
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+		uint32_t max_size = 0U, max_count = 0U;
+#endif
 
 		check_nexts(h, b);
 
@@ -104,9 +135,27 @@ bool sys_heap_validate(struct sys_heap *heap)
 			if (!valid_chunk(h, c)) {
 				return false;
 			}
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+			if (chunk_size(h, c) > max_size) {
+				max_size = chunk_size(h, c);
+				max_count = 1U;
+			} else if (chunk_size(h, c) == max_size) {
+				max_count++;
+			}
+#endif
 			set_chunk_used(h, c, true);
 		}
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+		/* the tracked largest chunk is exact, or an upper bound */
+		if (h->buckets[b].max_count != 0U ?
+		    (h->buckets[b].max_size != max_size ||
+		     h->buckets[b].max_count != max_count) :
+		    (n != 0U && h->buckets[b].max_size < max_size)) {
+			return false;
+		}
+#endif
+
 		bool empty = (h->avail_buckets & (1 << b)) == 0;
 		bool zero = n == 0;
 
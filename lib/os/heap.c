@@ -5,6 +5,7 @@
  */
 #include <sys/sys_heap.h>
 #include <kernel.h>
+#include <string.h>
 #include "heap.h"
 
 static void *chunk_mem(struct z_heap *h, chunkid_t c)
@@ -25,6 +26,12 @@ static void free_list_remove_bidx(struct z_heap *h, chunkid_t c, int bidx)
 	CHECK(b->next != 0);
 	CHECK(h->avail_buckets & (1 << bidx));
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	if (chunk_size(h, c) == b->max_size && b->max_count != 0U) {
+		b->max_count--;
+	}
+#endif
+
 	if (next_free_chunk(h, c) == c) {
 		/* this is the last chunk */
 		h->avail_buckets &= ~(1 << bidx);
@@ -51,6 +58,21 @@ static void free_list_add_bidx(struct z_heap *h, chunkid_t c, int bidx)
 {
 	struct z_heap_bucket *b = &h->buckets[bidx];
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	size_t sz = chunk_size(h, c);
+
+	/* a stale max_size is still an upper bound of the remaining chunks,
+	 * so a chunk of that size is the largest one again
+	 */
+	if (b->next == 0U || sz > b->max_size ||
+	    (sz == b->max_size && b->max_count == 0U)) {
+		b->max_size = sz;
+		b->max_count = 1U;
+	} else if (sz == b->max_size) {
+		b->max_count++;
+	}
+#endif
+
 	if (b->next == 0U) {
 		CHECK((h->avail_buckets & (1 << bidx)) == 0);
 
@@ -138,6 +160,200 @@ static chunkid_t mem_to_chunkid(struct z_heap *h, void *p)
 	return (mem - chunk_header_bytes(h) - base) / CHUNK_UNIT;
 }
 
+/* Runtime statistics count chunks, headers included, from the time
+ * they are handed out until they are returned by the user.  Chunks
+ * parked in the caches count as free, those in magazines as used.
+ */
+static inline void stats_alloc(struct z_heap *h, chunkid_t c)
+{
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	h->allocated_chunks += chunk_size(h, c);
+	h->max_allocated_chunks = MAX(h->max_allocated_chunks,
+				      h->allocated_chunks);
+#endif
+}
+
+static inline void stats_free(struct z_heap *h, chunkid_t c)
+{
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	h->allocated_chunks -= chunk_size(h, c);
+#endif
+}
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+static chunkid_t cache_get(struct z_heap *h, size_t sz)
+{
+	struct z_heap_cache *cache = &h->cache;
+	int cls = cache_class(sz);
+	chunkid_t c;
+
+	if (cls < 0) {
+		return 0;
+	}
+
+	c = cache->head[cls];
+	if (c == 0) {
+		cache->misses++;
+		return 0;
+	}
+
+	CHECK(chunk_used(h, c) && chunk_size(h, c) == sz);
+	cache->head[cls] = next_free_chunk(h, c);
+	cache->count[cls]--;
+	cache->hits++;
+	return c;
+}
+
+static bool cache_put(struct z_heap *h, chunkid_t c)
+{
+	struct z_heap_cache *cache = &h->cache;
+	int cls = cache_class(chunk_size(h, c));
+
+	if (cls < 0 || cache->count[cls] >= CONFIG_SYS_HEAP_CACHE_DEPTH) {
+		return false;
+	}
+
+	set_next_free_chunk(h, c, cache->head[cls]);
+	cache->head[cls] = c;
+	cache->count[cls]++;
+	return true;
+}
+
+/* Returns every cached chunk to the heap proper, returns true if
+ * there were any
+ */
+static bool cache_flush(struct z_heap *h)
+{
+	struct z_heap_cache *cache = &h->cache;
+	bool flushed = false;
+
+	for (int i = 0; i < CONFIG_SYS_HEAP_CACHE_CLASSES; i++) {
+		while (cache->head[i] != 0) {
+			chunkid_t c = cache->head[i];
+
+			cache->head[i] = next_free_chunk(h, c);
+			set_chunk_used(h, c, false);
+			free_chunk(h, c);
+			flushed = true;
+		}
+		cache->count[i] = 0;
+	}
+
+	if (flushed) {
+		cache->flushes++;
+	}
+	return flushed;
+}
+
+void sys_heap_cache_flush(struct sys_heap *heap)
+{
+	(void)cache_flush(heap->heap);
+}
+
+void sys_heap_cache_stats_get(struct sys_heap *heap,
+			      struct sys_heap_cache_stats *stats)
+{
+	struct z_heap_cache *cache = &heap->heap->cache;
+
+	stats->hits = cache->hits;
+	stats->misses = cache->misses;
+	stats->flushes = cache->flushes;
+	stats->cached_bytes = 0;
+	for (int i = 0; i < CONFIG_SYS_HEAP_CACHE_CLASSES; i++) {
+		stats->cached_bytes += cache->count[i] * (i + 1) * CHUNK_UNIT;
+	}
+}
+#endif
+
+#ifdef CONFIG_SYS_HEAP_CACHE_PER_CPU
+/* Magazines hold blocks which are still marked used in the heap,
+ * linked through their first word.  Neither the pop nor the push
+ * touch any heap state other than the (owned) chunk's own header,
+ * which is what lets the caller skip the heap lock.
+ */
+void *sys_heap_magazine_alloc(struct sys_heap *heap,
+			      struct sys_heap_magazine *mag, size_t bytes)
+{
+	struct z_heap *h = heap->heap;
+	int cls;
+	void **mem;
+
+	if (bytes == 0U) {
+		return NULL;
+	}
+
+	cls = cache_class(bytes_to_chunksz(h, bytes));
+	if (cls < 0 || mag->head[cls] == NULL) {
+		return NULL;
+	}
+
+	mem = mag->head[cls];
+	mag->head[cls] = *mem;
+	mag->count[cls]--;
+	mag->hits++;
+	return mem;
+}
+
+bool sys_heap_magazine_free(struct sys_heap *heap,
+			    struct sys_heap_magazine *mag, void *mem)
+{
+	struct z_heap *h = heap->heap;
+	int cls;
+
+	if (mem == NULL) {
+		return true;
+	}
+
+	cls = cache_class(chunk_size(h, mem_to_chunkid(h, mem)));
+	if (cls < 0 || mag->count[cls] >= CONFIG_SYS_HEAP_CACHE_DEPTH) {
+		return false;
+	}
+
+	*(void **)mem = mag->head[cls];
+	mag->head[cls] = mem;
+	mag->count[cls]++;
+	return true;
+}
+
+void sys_heap_magazine_stats_add(struct sys_heap_magazine *mag,
+				 struct sys_heap_cache_stats *stats)
+{
+	stats->hits += mag->hits;
+	for (int i = 0; i < CONFIG_SYS_HEAP_CACHE_CLASSES; i++) {
+		stats->cached_bytes += mag->count[i] * (i + 1) * CHUNK_UNIT;
+	}
+}
+
+void sys_heap_magazine_flush(struct sys_heap *heap,
+			     struct sys_heap_magazine *mag)
+{
+	struct z_heap *h = heap->heap;
+
+	for (int i = 0; i < CONFIG_SYS_HEAP_CACHE_CLASSES; i++) {
+		while (mag->head[i] != NULL) {
+			void **mem = mag->head[i];
+			chunkid_t c = mem_to_chunkid(h, mem);
+
+			mag->head[i] = *mem;
+			stats_free(h, c);
+			set_chunk_used(h, c, false);
+			free_chunk(h, c);
+		}
+		mag->count[i] = 0;
+	}
+}
+#endif
+
+size_t sys_heap_usable_size(struct sys_heap *heap, void *mem)
+{
+	struct z_heap *h = heap->heap;
+	chunkid_t c = mem_to_chunkid(h, mem);
+	size_t align_gap = (uint8_t *)mem - (uint8_t *)chunk_mem(h, c);
+
+	return chunk_size(h, c) * CHUNK_UNIT - chunk_header_bytes(h) -
+	       align_gap;
+}
+
 void sys_heap_free(struct sys_heap *heap, void *mem)
 {
 	if (mem == NULL) {
@@ -162,6 +378,14 @@ void sys_heap_free(struct sys_heap *heap, void *mem)
 		 "corrupted heap bounds (buffer overflow?) for memory at %p",
 		 mem);
 
+	stats_free(h, c);
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+	if (cache_put(h, c)) {
+		return;
+	}
+#endif
+
 	set_chunk_used(h, c, false);
 	free_chunk(h, c);
 }
@@ -228,7 +452,22 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 
 	struct z_heap *h = heap->heap;
 	size_t chunk_sz = bytes_to_chunksz(h, bytes);
-	chunkid_t c = alloc_chunk(h, chunk_sz);
+	chunkid_t c;
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+	c = cache_get(h, chunk_sz);
+	if (c != 0U) {
+		stats_alloc(h, c);
+		return chunk_mem(h, c);
+	}
+#endif
+
+	c = alloc_chunk(h, chunk_sz);
+#ifdef CONFIG_SYS_HEAP_CACHE
+	if (c == 0U && cache_flush(h)) {
+		c = alloc_chunk(h, chunk_sz);
+	}
+#endif
 	if (c == 0U) {
 		return NULL;
 	}
@@ -240,6 +479,7 @@ void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
 	}
 
 	set_chunk_used(h, c, true);
+	stats_alloc(h, c);
 	return chunk_mem(h, c);
 }
 
@@ -265,6 +505,11 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 		bytes_to_chunksz(h, bytes + align - chunk_header_bytes(h));
 	chunkid_t c0 = alloc_chunk(h, padded_sz);
 
+#ifdef CONFIG_SYS_HEAP_CACHE
+	if (c0 == 0 && cache_flush(h)) {
+		c0 = alloc_chunk(h, padded_sz);
+	}
+#endif
 	if (c0 == 0) {
 		return NULL;
 	}
@@ -291,9 +536,185 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes)
 	}
 
 	set_chunk_used(h, c, true);
+	stats_alloc(h, c);
 	return mem;
 }
 
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+/* Only the highest non-empty bucket can hold the largest free chunk,
+ * and each bucket tracks its largest chunk as chunks are added and
+ * removed.  That bucket's list is only walked after all of its largest
+ * chunks were removed since the last lookup.
+ */
+static size_t largest_free_chunk(struct z_heap *h)
+{
+	struct z_heap_bucket *b;
+
+	if (h->avail_buckets == 0U) {
+		return 0;
+	}
+
+	b = &h->buckets[31 - __builtin_clz(h->avail_buckets)];
+	if (b->max_count == 0U) {
+		chunkid_t c = b->next;
+
+		b->max_size = 0U;
+		do {
+			size_t sz = chunk_size(h, c);
+
+			if (sz > b->max_size) {
+				b->max_size = sz;
+				b->max_count = 1U;
+			} else if (sz == b->max_size) {
+				b->max_count++;
+			}
+			c = next_free_chunk(h, c);
+		} while (c != b->next);
+	}
+
+	return b->max_size;
+}
+
+void z_sys_heap_usage_get(struct sys_heap *heap,
+			  struct sys_heap_runtime_stats *stats)
+{
+	struct z_heap *h = heap->heap;
+	size_t free_chunks = h->len - chunk_size(h, 0) - h->allocated_chunks;
+
+	stats->allocated_bytes = h->allocated_chunks * CHUNK_UNIT;
+	stats->free_bytes = free_chunks * CHUNK_UNIT;
+	stats->max_allocated_bytes = h->max_allocated_chunks * CHUNK_UNIT;
+}
+
+int sys_heap_runtime_stats_get(struct sys_heap *heap,
+			       struct sys_heap_runtime_stats *stats)
+{
+	if (heap == NULL || stats == NULL) {
+		return -EINVAL;
+	}
+
+	struct z_heap *h = heap->heap;
+	size_t free_chunks = h->len - chunk_size(h, 0) - h->allocated_chunks;
+	size_t largest = largest_free_chunk(h);
+
+	z_sys_heap_usage_get(heap, stats);
+	stats->largest_free_bytes = largest != 0U ?
+		largest * CHUNK_UNIT - chunk_header_bytes(h) : 0;
+	stats->fragmentation = free_chunks != 0U ?
+		100U - (largest * 100U) / free_chunks : 0U;
+
+	return 0;
+}
+
+int sys_heap_runtime_stats_reset_max(struct sys_heap *heap)
+{
+	if (heap == NULL) {
+		return -EINVAL;
+	}
+
+	heap->heap->max_allocated_chunks = heap->heap->allocated_chunks;
+
+	return 0;
+}
+#endif
+
+void *sys_heap_aligned_realloc(struct sys_heap *heap, void *ptr,
+			       size_t align, size_t bytes)
+{
+	struct z_heap *h = heap->heap;
+
+	/* special realloc semantics */
+	if (ptr == NULL) {
+		return sys_heap_aligned_alloc(heap, align, bytes);
+	}
+	if (bytes == 0) {
+		sys_heap_free(heap, ptr);
+		return NULL;
+	}
+
+	CHECK((align & (align - 1)) == 0);
+
+	chunkid_t c = mem_to_chunkid(h, ptr);
+	chunkid_t lc = left_chunk(h, c);
+	chunkid_t rc = right_chunk(h, c);
+	size_t align_gap = (uint8_t *)ptr - (uint8_t *)chunk_mem(h, c);
+	size_t chunks_need = bytes_to_chunksz(h, bytes + align_gap);
+	size_t csz = chunk_size(h, c);
+	size_t rsz = chunk_used(h, rc) ? 0 : chunk_size(h, rc);
+	size_t lsz = chunk_used(h, lc) ? 0 : chunk_size(h, lc);
+
+	__ASSERT(chunk_used(h, c),
+		 "unexpected heap state (double-free?) for memory at %p", ptr);
+
+	if (align != 0 && ((uintptr_t)ptr & (align - 1)) != 0) {
+		/* Misaligned for the new request, has to move */
+	} else if (csz >= chunks_need) {
+		/* Shrink in place, split off and free the unused suffix */
+		if (csz > chunks_need) {
+			stats_free(h, c);
+			split_chunks(h, c, c + chunks_need);
+			set_chunk_used(h, c, true);
+			stats_alloc(h, c);
+			free_chunk(h, c + chunks_need);
+		}
+		return ptr;
+	} else if (csz + rsz >= chunks_need) {
+		/* Grow in place into the free right neighbor, returning
+		 * whatever part of it is not needed
+		 */
+		size_t split_size = chunks_need - csz;
+
+		stats_free(h, c);
+		free_list_remove(h, rc);
+		if (split_size < rsz) {
+			split_chunks(h, rc, rc + split_size);
+			free_list_add(h, rc + split_size);
+		}
+		merge_chunks(h, c, rc);
+		set_chunk_used(h, c, true);
+		stats_alloc(h, c);
+		return ptr;
+	} else if (lsz != 0 && lsz + csz + rsz >= bytes_to_chunksz(h, bytes) &&
+		   (align <= chunk_header_bytes(h) ||
+		    ((uintptr_t)chunk_mem(h, lc) & (align - 1)) == 0)) {
+		/* Grow into the free left (and right) neighbors, which
+		 * needs the data moved down but never more memory
+		 * than the result
+		 */
+		size_t copy = MIN(csz * CHUNK_UNIT - chunk_header_bytes(h)
+				  - align_gap, bytes);
+
+		chunks_need = bytes_to_chunksz(h, bytes);
+		stats_free(h, c);
+		if (rsz != 0) {
+			free_list_remove(h, rc);
+			merge_chunks(h, c, rc);
+		}
+		free_list_remove(h, lc);
+		merge_chunks(h, lc, c);
+		memmove(chunk_mem(h, lc), ptr, copy);
+		if (chunk_size(h, lc) > chunks_need) {
+			split_chunks(h, lc, lc + chunks_need);
+			free_list_add(h, lc + chunks_need);
+		}
+		set_chunk_used(h, lc, true);
+		stats_alloc(h, lc);
+		return chunk_mem(h, lc);
+	}
+
+	/* Last resort: allocate, copy and free */
+	void *ptr2 = sys_heap_aligned_alloc(heap, align, bytes);
+
+	if (ptr2 != NULL) {
+		size_t prev_size = csz * CHUNK_UNIT - chunk_header_bytes(h)
+				   - align_gap;
+
+		memcpy(ptr2, ptr, MIN(prev_size, bytes));
+		sys_heap_free(heap, ptr);
+	}
+	return ptr2;
+}
+
 void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 {
 	/* Must fit in a 32 bit count of HUNK_UNIT */
@@ -316,6 +737,13 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 	h->chunk0_hdr_area = 0;
 	h->len = buf_sz;
 	h->avail_buckets = 0;
+#ifdef CONFIG_SYS_HEAP_CACHE
+	h->cache = (struct z_heap_cache) { 0 };
+#endif
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	h->allocated_chunks = 0;
+	h->max_allocated_chunks = 0;
+#endif
 
 	int nb_buckets = bucket_idx(h, buf_sz) + 1;
 	size_t chunk0_size = chunksz(sizeof(struct z_heap) +
@@ -324,7 +752,7 @@ void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
 	__ASSERT(chunk0_size + min_chunk_size(h) < buf_sz, "heap size is too small");
 
 	for (int i = 0; i < nb_buckets; i++) {
-		h->buckets[i].next = 0;
+		h->buckets[i] = (struct z_heap_bucket) { 0 };
 	}
 
 	/* chunk containing our struct z_heap */
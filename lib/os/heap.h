@@ -55,12 +55,43 @@ enum chunk_fields { LEFT_SIZE, SIZE_AND_USED, FREE_PREV, FREE_NEXT };
 
 struct z_heap_bucket {
 	chunkid_t next;
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	/* Size of the largest chunk in the list, and how many chunks have
+	 * it.  A zero count with a non-empty list means those chunks were
+	 * all removed: max_size is then only an upper bound.
+	 */
+	uint32_t max_size;
+	uint32_t max_count;
+#endif
+};
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+/* Front-end cache of recently freed small chunks, one LIFO list per
+ * exact chunk size (class N holds chunks of N+1 units).  Cached
+ * chunks stay marked used, so they are never merged with their
+ * neighbors, and are linked through their FREE_NEXT field (which
+ * every allocatable chunk is large enough to hold).
+ */
+struct z_heap_cache {
+	chunkid_t head[CONFIG_SYS_HEAP_CACHE_CLASSES];
+	uint8_t count[CONFIG_SYS_HEAP_CACHE_CLASSES];
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t flushes;
 };
+#endif
 
 struct z_heap {
 	uint64_t chunk0_hdr_area;  /* matches the largest header */
 	uint32_t len;
 	uint32_t avail_buckets;
+#ifdef CONFIG_SYS_HEAP_CACHE
+	struct z_heap_cache cache;
+#endif
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	uint32_t allocated_chunks;
+	uint32_t max_allocated_chunks;
+#endif
 	struct z_heap_bucket buckets[0];
 };
 
@@ -229,6 +260,14 @@ static inline int bucket_idx(struct z_heap *h, size_t sz)
 	return 31 - __builtin_clz(usable_sz);
 }
 
+#ifdef CONFIG_SYS_HEAP_CACHE
+/* Cache class of a chunk size in units, or -1 if not cacheable */
+static inline int cache_class(size_t sz)
+{
+	return sz <= CONFIG_SYS_HEAP_CACHE_CLASSES ? (int)sz - 1 : -1;
+}
+#endif
+
 /* For debugging */
 void heap_dump(struct z_heap *h);
 
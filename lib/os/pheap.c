@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/pheap.h>
+
+/* Links two detached subheaps, the larger root becoming the leftmost
+ * child of the smaller.  Returns the new root, whose prev and next
+ * fields are left for the caller to fix up.  On equal keys "a" wins.
+ */
+static struct pheap_node *meld(pheap_lessthan_t lessthan,
+			       struct pheap_node *a, struct pheap_node *b)
+{
+	if (b == NULL) {
+		return a;
+	}
+	if (a == NULL) {
+		return b;
+	}
+
+	if (lessthan(b, a)) {
+		struct pheap_node *tmp = a;
+
+		a = b;
+		b = tmp;
+	}
+
+	b->next = a->child;
+	if (a->child != NULL) {
+		a->child->prev = b;
+	}
+	b->prev = a;
+	a->child = b;
+
+	return a;
+}
+
+/* Standard two-pass combination of a sibling list: meld adjacent
+ * pairs left to right, then meld the results right to left.  The
+ * first pass pushes its results onto a stack (linked through "next")
+ * so that the second pass can be done iteratively.
+ */
+static struct pheap_node *combine(pheap_lessthan_t lessthan,
+				  struct pheap_node *list)
+{
+	struct pheap_node *stack = NULL, *root;
+
+	while (list != NULL) {
+		struct pheap_node *a = list, *b = a->next;
+
+		list = (b == NULL) ? NULL : b->next;
+		a->next = NULL;
+		if (b != NULL) {
+			b->next = NULL;
+		}
+
+		a = meld(lessthan, a, b);
+		a->next = stack;
+		stack = a;
+	}
+
+	if (stack == NULL) {
+		return NULL;
+	}
+
+	root = stack;
+	stack = stack->next;
+	root->next = NULL;
+
+	while (stack != NULL) {
+		struct pheap_node *n = stack->next;
+
+		stack->next = NULL;
+		root = meld(lessthan, root, stack);
+		stack = n;
+	}
+
+	return root;
+}
+
+static void set_root(struct pheap *heap, struct pheap_node *root)
+{
+	heap->root = root;
+	if (root != NULL) {
+		root->prev = root;
+		root->next = NULL;
+	}
+}
+
+void pheap_insert(struct pheap *heap, struct pheap_node *node,
+		  pheap_lessthan_t lessthan)
+{
+	node->child = NULL;
+	node->next = NULL;
+	set_root(heap, meld(lessthan, heap->root, node));
+}
+
+void pheap_remove(struct pheap *heap, struct pheap_node *node,
+		  pheap_lessthan_t lessthan)
+{
+	struct pheap_node *sub = combine(lessthan, node->child);
+
+	if (node == heap->root) {
+		set_root(heap, sub);
+	} else {
+		if (node->prev->child == node) {
+			node->prev->child = node->next;
+		} else {
+			node->prev->next = node->next;
+		}
+		if (node->next != NULL) {
+			node->next->prev = node->prev;
+		}
+
+		set_root(heap, meld(lessthan, heap->root, sub));
+	}
+
+	pheap_node_init(node);
+}
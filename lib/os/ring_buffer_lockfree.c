@@ -0,0 +1,283 @@
+/* ring_buffer_lockfree.c: Lock-free ring buffer API */
+
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/ring_buffer_lockfree.h>
+#include <string.h>
+
+/*
+ * Both variants keep free running indexes which are only ever reduced
+ * modulo the (power of 2) buffer size when the buffer is accessed, so
+ * they never need to be rewound.
+ *
+ * Every index is written by a single context and published with
+ * atomic_set(), which is a full barrier: data written to the buffer
+ * before the index is moved is visible to any context which reads the
+ * new index with atomic_get().
+ */
+
+uint32_t ring_buf_spsc_put_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t space, trail, off;
+
+	space = buf->size -
+		(buf->tmp_tail - (uint32_t)atomic_get(&buf->head));
+	off = buf->tmp_tail & (buf->size - 1);
+	trail = buf->size - off;
+
+	size = MIN(size, space);
+	size = MIN(size, trail);
+
+	*data = &buf->buf[off];
+	buf->tmp_tail += size;
+
+	return size;
+}
+
+int ring_buf_spsc_put_finish(struct ring_buf_spsc *buf, uint32_t size)
+{
+	uint32_t tail = (uint32_t)atomic_get(&buf->tail);
+
+	if (size > (buf->tmp_tail - tail)) {
+		return -EINVAL;
+	}
+
+	buf->tmp_tail = tail + size;
+	(void)atomic_set(&buf->tail, (atomic_val_t)buf->tmp_tail);
+
+	return 0;
+}
+
+uint32_t ring_buf_spsc_put(struct ring_buf_spsc *buf, const uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *dst;
+	uint32_t partial_size;
+	uint32_t total_size = 0U;
+	int err;
+
+	do {
+		partial_size = ring_buf_spsc_put_claim(buf, &dst, size);
+		memcpy(dst, data, partial_size);
+		total_size += partial_size;
+		size -= partial_size;
+		data += partial_size;
+	} while (size && partial_size);
+
+	err = ring_buf_spsc_put_finish(buf, total_size);
+	__ASSERT_NO_MSG(err == 0);
+
+	return total_size;
+}
+
+uint32_t ring_buf_spsc_get_claim(struct ring_buf_spsc *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t space, trail, off;
+
+	space = (uint32_t)atomic_get(&buf->tail) - buf->tmp_head;
+	off = buf->tmp_head & (buf->size - 1);
+	trail = buf->size - off;
+
+	size = MIN(size, space);
+	size = MIN(size, trail);
+
+	*data = &buf->buf[off];
+	buf->tmp_head += size;
+
+	return size;
+}
+
+int ring_buf_spsc_get_finish(struct ring_buf_spsc *buf, uint32_t size)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+
+	if (size > (buf->tmp_head - head)) {
+		return -EINVAL;
+	}
+
+	buf->tmp_head = head + size;
+	(void)atomic_set(&buf->head, (atomic_val_t)buf->tmp_head);
+
+	return 0;
+}
+
+uint32_t ring_buf_spsc_get(struct ring_buf_spsc *buf, uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *src;
+	uint32_t partial_size;
+	uint32_t total_size = 0U;
+	int err;
+
+	do {
+		partial_size = ring_buf_spsc_get_claim(buf, &src, size);
+		memcpy(data, src, partial_size);
+		total_size += partial_size;
+		size -= partial_size;
+		data += partial_size;
+	} while (size && partial_size);
+
+	err = ring_buf_spsc_get_finish(buf, total_size);
+	__ASSERT_NO_MSG(err == 0);
+
+	return total_size;
+}
+
+/*
+ * Each MPSC record starts with a header word holding its length in
+ * bytes, or for padding records the number of words skipped to reach
+ * the end of the buffer.  The consumer only reads a record once the
+ * producer has set its committed bit, and clears all the words of a
+ * record it frees, so that stale data is never mistaken for the header
+ * of a record which has been reserved but not written yet.
+ */
+#define MPSC_COMMITTED BIT(31)
+#define MPSC_PAD BIT(30)
+#define MPSC_LEN_MASK (MPSC_PAD - 1)
+
+static inline atomic_t *mpsc_word(struct ring_buf_mpsc *buf, uint32_t idx)
+{
+	return (atomic_t *)&buf->buf32[idx & (buf->size32 - 1)];
+}
+
+uint32_t ring_buf_mpsc_put_claim(struct ring_buf_mpsc *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t words = 1 + ceiling_fraction(size, sizeof(uint32_t));
+	uint32_t tail, head, trail, pad;
+
+	if (size == 0 || size > MPSC_LEN_MASK || words > buf->size32) {
+		return 0;
+	}
+
+	for (;;) {
+		tail = (uint32_t)atomic_get(&buf->tail);
+		head = (uint32_t)atomic_get(&buf->head);
+		trail = buf->size32 - (tail & (buf->size32 - 1));
+		pad = (words > trail) ? trail : 0;
+
+		if ((tail == head) && (pad + words > buf->size32)) {
+			/* Empty, but the record fits neither before nor
+			 * after the tail: pad to the end of the buffer so
+			 * that it fits once the consumer has skipped that.
+			 */
+			if (atomic_cas(&buf->tail, (atomic_val_t)tail,
+				       (atomic_val_t)(tail + pad))) {
+				(void)atomic_set(mpsc_word(buf, tail),
+						 MPSC_COMMITTED | MPSC_PAD |
+						 pad);
+				return 0;
+			}
+		} else if ((tail - head) + pad + words > buf->size32) {
+			/* Head may have been read after other producers
+			 * moved the tail, only give up on a stable tail.
+			 */
+			if (tail == (uint32_t)atomic_get(&buf->tail)) {
+				return 0;
+			}
+		} else if (atomic_cas(&buf->tail, (atomic_val_t)tail,
+				      (atomic_val_t)(tail + pad + words))) {
+			break;
+		}
+	}
+
+	if (pad) {
+		(void)atomic_set(mpsc_word(buf, tail),
+				 MPSC_COMMITTED | MPSC_PAD | pad);
+		tail += pad;
+	}
+
+	(void)atomic_set(mpsc_word(buf, tail), size);
+	*data = (uint8_t *)mpsc_word(buf, tail + 1);
+
+	return size;
+}
+
+void ring_buf_mpsc_put_finish(struct ring_buf_mpsc *buf, uint8_t *data)
+{
+	atomic_t *hdr = (atomic_t *)data - 1;
+
+	__ASSERT_NO_MSG(!(atomic_get(hdr) & MPSC_COMMITTED));
+
+	(void)atomic_or(hdr, MPSC_COMMITTED);
+}
+
+uint32_t ring_buf_mpsc_put(struct ring_buf_mpsc *buf, const uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *dst;
+
+	if (ring_buf_mpsc_put_claim(buf, &dst, size) == 0) {
+		return 0;
+	}
+
+	memcpy(dst, data, size);
+	ring_buf_mpsc_put_finish(buf, dst);
+
+	return size;
+}
+
+/* Clear and free @a words words at the head. */
+static void mpsc_free(struct ring_buf_mpsc *buf, uint32_t head,
+		      uint32_t words)
+{
+	memset(mpsc_word(buf, head), 0, words * sizeof(uint32_t));
+	(void)atomic_set(&buf->head, (atomic_val_t)(head + words));
+}
+
+uint32_t ring_buf_mpsc_get_claim(struct ring_buf_mpsc *buf, uint8_t **data)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+	uint32_t hdr;
+
+	while (head != (uint32_t)atomic_get(&buf->tail)) {
+		hdr = (uint32_t)atomic_get(mpsc_word(buf, head));
+		if (!(hdr & MPSC_COMMITTED)) {
+			break;
+		}
+
+		if (hdr & MPSC_PAD) {
+			mpsc_free(buf, head, hdr & MPSC_LEN_MASK);
+			head += hdr & MPSC_LEN_MASK;
+			continue;
+		}
+
+		*data = (uint8_t *)mpsc_word(buf, head + 1);
+		return hdr & MPSC_LEN_MASK;
+	}
+
+	return 0;
+}
+
+void ring_buf_mpsc_get_finish(struct ring_buf_mpsc *buf)
+{
+	uint32_t head = (uint32_t)atomic_get(&buf->head);
+	uint32_t hdr = (uint32_t)atomic_get(mpsc_word(buf, head));
+
+	__ASSERT_NO_MSG((hdr & (MPSC_COMMITTED | MPSC_PAD)) == MPSC_COMMITTED);
+
+	mpsc_free(buf, head, 1 + ceiling_fraction(hdr & MPSC_LEN_MASK,
+						  sizeof(uint32_t)));
+}
+
+uint32_t ring_buf_mpsc_get(struct ring_buf_mpsc *buf, uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *src;
+	uint32_t len = ring_buf_mpsc_get_claim(buf, &src);
+
+	if (len == 0) {
+		return 0;
+	}
+
+	memcpy(data, src, MIN(len, size));
+	ring_buf_mpsc_get_finish(buf);
+
+	return len;
+}
@@ -8,11 +8,19 @@
 #include <kernel.h>
 #define WORKQUEUE_THREAD_NAME	"workqueue"
 
+#ifdef CONFIG_WORKQUEUE_POOL
+extern void z_work_q_pool_run(struct k_work_q_worker *worker,
+			      struct k_work *work);
+#endif
+
+#if defined(CONFIG_WORKQUEUE_RUNTIME_STATS) || defined(CONFIG_TRACING)
+extern void z_work_q_run(struct k_work_q *work_q, struct k_work *work);
+#endif
+
 void z_work_q_main(void *work_q_ptr, void *p2, void *p3)
 {
 	struct k_work_q *work_q = work_q_ptr;
 
-	ARG_UNUSED(p2);
 	ARG_UNUSED(p3);
 
 	while (true) {
@@ -24,6 +32,26 @@ void z_work_q_main(void *work_q_ptr, void *p2, void *p3)
 			continue;
 		}
 
+#ifdef CONFIG_WORKQUEUE_POOL
+		/* p2 is the worker for threads of a pool */
+		if (p2 != NULL) {
+			z_work_q_pool_run(p2, work);
+			k_yield();
+			continue;
+		}
+#else
+		ARG_UNUSED(p2);
+#endif
+
+#if defined(CONFIG_WORKQUEUE_RUNTIME_STATS) || defined(CONFIG_TRACING)
+		/* only kernel mode workqueues are instrumented */
+		if (!_is_user_context()) {
+			z_work_q_run(work_q, work);
+			k_yield();
+			continue;
+		}
+#endif
+
 		handler = work->handler;
 		__ASSERT(handler != NULL, "handler must be provided");
 
@@ -44,6 +72,12 @@ void k_work_q_user_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 			 size_t stack_size, int prio)
 {
 	k_queue_init(&work_q->queue);
+#ifdef CONFIG_WORKQUEUE_POOL
+	work_q->workers = NULL;
+#endif
+#ifdef CONFIG_WORKQUEUE_RUNTIME_STATS
+	work_q->stats_enabled = false;
+#endif
 
 	/* Created worker thread will inherit object permissions and memory
 	 * domain configuration of the caller
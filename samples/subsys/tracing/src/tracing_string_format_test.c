@@ -128,3 +128,13 @@ void sys_trace_mutex_unlock(struct k_mutex *mutex)
 {
 	TRACING_STRING("%s: %p\n", __func__, mutex);
 }
+
+void sys_trace_work_start(struct k_work_q *work_q, struct k_work *work)
+{
+	TRACING_STRING("%s: %p %p\n", __func__, work_q, work);
+}
+
+void sys_trace_work_end(struct k_work_q *work_q, struct k_work *work)
+{
+	TRACING_STRING("%s: %p %p\n", __func__, work_q, work);
+}
@@ -1191,6 +1191,7 @@ class SizeCalculator:
         "init_array",
         "reset",
         "z_object_assignment_area",
+        "device_init_async_area",
         "rodata",
         "net_l2",
         "vector",
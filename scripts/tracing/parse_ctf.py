@@ -132,6 +132,11 @@ def main():
         elif event.name in ['mutex_init', 'mutex_take', 'mutex_give']:
             c = Fore.MAGENTA
             print(c + f"{dt} (+{diff_s:.6f} s): {event.name} ({event.payload_field['id']})" + Fore.RESET)
+        elif event.name in ['work_start', 'work_end']:
+            c = Fore.BLUE
+            work_q = event.payload_field['work_q']
+            work = event.payload_field['work']
+            print(c + f"{dt} (+{diff_s:.6f} s): {event.name} (work_q: {work_q:#x}, work: {work:#x})" + Fore.RESET)
 
         else:
             print(f"{dt} (+{diff_s:.6f} s): {event.name}")
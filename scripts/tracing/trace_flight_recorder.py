@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2020 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Script to extract the tracing data kept by the RAM tracing backend
+(CONFIG_TRACING_BACKEND_RAM) to a trace file.
+
+The data is taken either from the console output of the boot following a
+reset, where CONFIG_TRACING_BACKEND_RAM_DUMP_ON_BOOT prints it, or from a
+binary core dump, as generated by scripts/coredump/coredump_serial_log_parser.py:
+
+    ./scripts/tracing/trace_flight_recorder.py -l console.log -o ctf/channel0_0
+    ./scripts/tracing/trace_flight_recorder.py -c coredump.bin -o ctf/channel0_0
+    cp subsys/tracing/ctf/tsdl/metadata ctf/
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+RECORDER_PREFIX = "#TR:"
+RECORDER_BEGIN = "BEGIN#"
+RECORDER_END = "END#"
+
+# struct ram_recorder in subsys/tracing/tracing_backend_ram.c
+RECORDER_MAGIC = 0x52465254
+RECORDER_HDR_STRUCT = "<IIIII"
+RECORDER_HDR_SIZE = struct.calcsize(RECORDER_HDR_STRUCT)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+            description=__doc__,
+            formatter_class=argparse.RawDescriptionHelpFormatter)
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument("-l", "--log",
+            help="console output with the data dumped at boot")
+    group.add_argument("-c", "--coredump",
+            help="binary core dump")
+    parser.add_argument("-o", "--output", required=True,
+            help="trace file to write")
+    return parser.parse_args()
+
+
+def from_log(logfile):
+    """Returns the data of the last dump in the console output"""
+    data = None
+    last = None
+
+    with open(logfile, "r", errors="ignore") as f:
+        for line in f:
+            idx = line.find(RECORDER_PREFIX)
+            if idx < 0:
+                continue
+
+            payload = line[idx + len(RECORDER_PREFIX):].strip()
+            if payload == RECORDER_BEGIN:
+                data = bytearray()
+            elif payload == RECORDER_END:
+                if data is not None:
+                    last = bytes(data)
+                data = None
+            elif data is not None:
+                data += bytes.fromhex(payload)
+
+    return last
+
+
+def recorder_packets(mem, offset):
+    """Returns the packets of the recorder at offset in mem, or None"""
+    if offset + RECORDER_HDR_SIZE > len(mem):
+        return None
+
+    magic, size, start, used, check = struct.unpack_from(RECORDER_HDR_STRUCT,
+                                                         mem, offset)
+    if (magic != RECORDER_MAGIC or check != magic ^ size ^ start ^ used or
+            start >= size or used > size or
+            offset + RECORDER_HDR_SIZE + size > len(mem)):
+        return None
+
+    buf = mem[offset + RECORDER_HDR_SIZE:offset + RECORDER_HDR_SIZE + size]
+    ring = (buf[start:] + buf[:start])[:used]
+
+    data = bytearray()
+    pos = 0
+    while pos + 2 <= used:
+        length, = struct.unpack_from("<H", ring, pos)
+        pos += 2
+        if pos + length > used:
+            break
+        data += ring[pos:pos + length]
+        pos += length
+
+    return bytes(data)
+
+
+def from_coredump(coredump):
+    """Returns the data of the recorder found in the core dump memory"""
+    sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..",
+                                    "coredump"))
+    from parser.log_parser import CoredumpLogFile
+
+    logf = CoredumpLogFile(coredump)
+    logf.open()
+    if not logf.parse():
+        logf.close()
+        sys.exit("Cannot parse core dump")
+    logf.close()
+
+    magic = struct.pack("<I", RECORDER_MAGIC)
+    for region in logf.get_memory_regions():
+        mem = region["data"]
+        offset = mem.find(magic)
+        while offset >= 0:
+            data = recorder_packets(mem, offset)
+            if data is not None:
+                return data
+            offset = mem.find(magic, offset + 1)
+
+    return None
+
+
+def main():
+    args = parse_args()
+
+    if args.log:
+        data = from_log(args.log)
+    else:
+        data = from_coredump(args.coredump)
+
+    if data is None:
+        sys.exit("No tracing data found")
+
+    with open(args.output, "wb") as f:
+        f.write(data)
+
+    print(f"{len(data)} bytes of tracing data written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
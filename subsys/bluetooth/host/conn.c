@@ -993,7 +993,7 @@ static struct bt_conn_tx *conn_tx_alloc(void)
 	 * so if we're in the same workqueue but there are no immediate
 	 * contexts available, there's no chance we'll get one by waiting.
 	 */
-	if (k_current_get() == &k_sys_work_q.thread) {
+	if (k_work_q_is_current(&k_sys_work_q)) {
 		return k_fifo_get(&free_tx, K_NO_WAIT);
 	}
 
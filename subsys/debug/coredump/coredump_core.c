@@ -11,6 +11,10 @@
 #include <sys/byteorder.h>
 #include <sys/util.h>
 
+#ifdef CONFIG_TRACING_BACKEND_RAM
+#include <tracing_backend.h>
+#endif
+
 #include "coredump_internal.h"
 
 #if defined(CONFIG_DEBUG_COREDUMP_BACKEND_LOGGING)
@@ -93,6 +97,22 @@ void process_memory_region_list(void)
 #endif
 }
 
+static void dump_tracing(void)
+{
+#if defined(CONFIG_TRACING_BACKEND_RAM) && \
+	defined(CONFIG_DEBUG_COREDUMP_MEMORY_DUMP_MIN)
+	uintptr_t start, end;
+
+	/*
+	 * The latest tracing data tells what led to the fatal
+	 * error, dump it even when dumping minimum information.
+	 */
+	tracing_backend_ram_region_get(&start, &end);
+
+	z_coredump_memory_dump(start, end);
+#endif
+}
+
 void z_coredump(unsigned int reason, const z_arch_esf_t *esf,
 		struct k_thread *thread)
 {
@@ -112,6 +132,8 @@ void z_coredump(unsigned int reason, const z_arch_esf_t *esf,
 
 	process_memory_region_list();
 
+	dump_tracing();
+
 	if (error != 0)	{
 		z_coredump_error();
 	}
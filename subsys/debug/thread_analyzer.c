@@ -45,8 +45,48 @@ static void thread_print_cb(struct thread_analyzer_info *info)
 		THREAD_ANALYZER_VSTR(info->name),
 		info->stack_size - info->stack_used, info->stack_used,
 		info->stack_size, pcnt);
+
+#ifdef CONFIG_CPU_LOAD
+	THREAD_ANALYZER_PRINT(
+		THREAD_ANALYZER_FMT(
+			" %-20s: load %u.%u %% / %u.%u %% / %u.%u %%"),
+		"",
+		info->load.avg[K_LOAD_WINDOW_SHORT] / 10U,
+		info->load.avg[K_LOAD_WINDOW_SHORT] % 10U,
+		info->load.avg[K_LOAD_WINDOW_MEDIUM] / 10U,
+		info->load.avg[K_LOAD_WINDOW_MEDIUM] % 10U,
+		info->load.avg[K_LOAD_WINDOW_LONG] / 10U,
+		info->load.avg[K_LOAD_WINDOW_LONG] % 10U);
+#endif
 }
 
+#ifdef CONFIG_CPU_LOAD
+static void cpu_load_print(void)
+{
+	struct k_cpu_load load;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (k_cpu_load_get(i, &load) != 0) {
+			continue;
+		}
+
+		THREAD_ANALYZER_PRINT(
+			THREAD_ANALYZER_FMT(
+				" CPU %d: load %u.%u %% / %u.%u %% / %u.%u %%"
+				", ISRs %u.%u %%"),
+			i,
+			load.busy.avg[K_LOAD_WINDOW_SHORT] / 10U,
+			load.busy.avg[K_LOAD_WINDOW_SHORT] % 10U,
+			load.busy.avg[K_LOAD_WINDOW_MEDIUM] / 10U,
+			load.busy.avg[K_LOAD_WINDOW_MEDIUM] % 10U,
+			load.busy.avg[K_LOAD_WINDOW_LONG] / 10U,
+			load.busy.avg[K_LOAD_WINDOW_LONG] % 10U,
+			load.isr.avg[K_LOAD_WINDOW_SHORT] / 10U,
+			load.isr.avg[K_LOAD_WINDOW_SHORT] % 10U);
+	}
+}
+#endif
+
 static void thread_analyze_cb(const struct k_thread *cthread, void *user_data)
 {
 	struct k_thread *thread = (struct k_thread *)cthread;
@@ -77,6 +117,9 @@ static void thread_analyze_cb(const struct k_thread *cthread, void *user_data)
 	info.name = name;
 	info.stack_size = size;
 	info.stack_used = size - unused;
+#ifdef CONFIG_CPU_LOAD
+	(void)k_thread_load_get(thread, &info.load);
+#endif
 	cb(&info);
 }
 
@@ -93,6 +136,9 @@ void thread_analyzer_print(void)
 {
 	THREAD_ANALYZER_PRINT(THREAD_ANALYZER_FMT("Thread analyze:"));
 	thread_analyzer_run(thread_print_cb);
+#ifdef CONFIG_CPU_LOAD
+	cpu_load_print();
+#endif
 }
 
 #if IS_ENABLED(CONFIG_THREAD_ANALYZER_AUTO)
@@ -256,6 +256,8 @@ int z_impl_zsock_close(int sock)
 
 	NET_DBG("close: ctx=%p, fd=%d", ctx, sock);
 
+	z_fd_epoll_remove(sock);
+
 	ret = vtable->fd_vtable.close(ctx);
 
 	z_free_fd(sock);
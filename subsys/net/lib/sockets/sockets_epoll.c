@@ -0,0 +1,682 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief epoll for BSD sockets
+ *
+ * An epoll instance keeps, for each socket in its interest list, the
+ * k_poll events that zsock_poll() would have the socket prepare on every
+ * call, registered in a k_poll_set. Waiting only looks at the sockets
+ * whose events were signaled, and asks each of them for its actual
+ * readiness, as zsock_poll() does after k_poll() returns. Level-triggered
+ * sockets still ready are put back on the ready list, so that they are
+ * checked again by the next wait. Edge-triggered ones are not: they are
+ * only reported again once one of their events is signaled again.
+ *
+ * Each socket also has an event of its own, which is only made ready by
+ * hand, for readiness no kernel object signals, e.g. a socket that is
+ * always writable.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <net/socket.h>
+#include <syscall_handler.h>
+#include <sys/fdtable.h>
+
+#include "sockets_internal.h"
+
+/* k_poll events a socket can prepare for zsock_poll() */
+#define EPOLL_POLL_EVENTS 2
+
+/* events passed down to the sockets, the others are reported anyway */
+#define EPOLL_SOCK_EVENTS (ZSOCK_EPOLLIN | ZSOCK_EPOLLPRI | ZSOCK_EPOLLOUT)
+#define EPOLL_ALWAYS_EVENTS (ZSOCK_EPOLLERR | ZSOCK_EPOLLHUP)
+#define EPOLL_FLAGS (ZSOCK_EPOLLONESHOT | ZSOCK_EPOLLET)
+
+/* ready events taken off the ready list at once */
+#define EPOLL_WAIT_BATCH 8
+
+__net_socket struct epoll_instance {
+	struct k_poll_set set;
+	/* serializes changes of the interest list and waits */
+	struct k_mutex lock;
+	sys_dlist_t items;
+	/* the fields below are protected by epoll_pool_lock */
+	bool in_use;
+	/* set once the fd is closed, until the instance is reused */
+	bool closed;
+	/* calls using the instance, which is reused only once they left */
+	int refs;
+};
+
+struct epoll_item {
+	sys_dnode_t node;
+	/* linked while reported by a wait */
+	sys_dnode_t report_node;
+	struct epoll_instance *ep;
+	int fd;
+	void *obj;
+	struct zsock_epoll_event event;
+	/* set once reported with ZSOCK_EPOLLONESHOT, until modified */
+	bool disabled;
+	int num_events;
+	/* the event made ready by hand first, then the prepared ones, with
+	 * their index as tag
+	 */
+	struct k_poll_set_event sev[1 + EPOLL_POLL_EVENTS];
+};
+
+static const struct fd_op_vtable epoll_fd_op_vtable;
+
+static struct epoll_instance epoll_instances[CONFIG_NET_SOCKETS_EPOLL_MAX];
+static struct epoll_item epoll_items[CONFIG_NET_SOCKETS_EPOLL_MAX_FDS];
+
+/* protects allocations from the pools */
+static K_MUTEX_DEFINE(epoll_pool_lock);
+
+/* Takes a reference to an instance, unless its fd was closed */
+static bool epoll_get(struct epoll_instance *ep)
+{
+	bool ret;
+
+	k_mutex_lock(&epoll_pool_lock, K_FOREVER);
+	ret = ep->in_use && !ep->closed;
+	if (ret) {
+		ep->refs++;
+	}
+	k_mutex_unlock(&epoll_pool_lock);
+
+	return ret;
+}
+
+/* Drops a reference, freeing the instance after the last one if closed */
+static void epoll_put(struct epoll_instance *ep)
+{
+	k_mutex_lock(&epoll_pool_lock, K_FOREVER);
+	ep->refs--;
+	if ((ep->refs == 0) && ep->closed) {
+		ep->in_use = false;
+	}
+	k_mutex_unlock(&epoll_pool_lock);
+}
+
+static struct epoll_item *epoll_item_alloc(struct epoll_instance *ep)
+{
+	struct epoll_item *item = NULL;
+
+	k_mutex_lock(&epoll_pool_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(epoll_items); i++) {
+		if (epoll_items[i].ep == NULL) {
+			item = &epoll_items[i];
+			item->ep = ep;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&epoll_pool_lock);
+
+	return item;
+}
+
+static void epoll_item_free(struct epoll_item *item)
+{
+	k_mutex_lock(&epoll_pool_lock, K_FOREVER);
+	item->ep = NULL;
+	k_mutex_unlock(&epoll_pool_lock);
+}
+
+static struct epoll_item *epoll_item_find(struct epoll_instance *ep, int fd)
+{
+	struct epoll_item *item;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&ep->items, item, node) {
+		if (item->fd == fd) {
+			return item;
+		}
+	}
+
+	return NULL;
+}
+
+/* Registers the events the socket prepares for zsock_poll() */
+static int epoll_item_register(struct epoll_item *item,
+			       const struct fd_op_vtable *vtable)
+{
+	struct k_poll_event events[EPOLL_POLL_EVENTS];
+	struct k_poll_event *pev = events;
+	struct zsock_pollfd pfd = {
+		.fd = item->fd,
+		.events = item->event.events & EPOLL_SOCK_EVENTS,
+	};
+	struct k_poll_set_event *sev;
+	bool ready = false;
+	int ret;
+
+	item->disabled = false;
+
+	ret = z_fdtable_call_ioctl(vtable, item->obj, ZFD_IOCTL_POLL_PREPARE,
+				   &pfd, &pev, events + ARRAY_SIZE(events));
+	if (ret == -EALREADY) {
+		ready = true;
+	} else if (ret == -EXDEV) {
+		/* offloaded sockets have to be polled by their driver */
+		return -EOPNOTSUPP;
+	} else if (ret == -1) {
+		return -errno;
+	} else if (ret != 0) {
+		return ret;
+	}
+
+	item->num_events = pev - events;
+
+	k_poll_event_init(&item->sev[0].event, K_POLL_TYPE_IGNORE,
+			  K_POLL_MODE_NOTIFY_ONLY, item);
+	item->sev[0].event.tag = 0;
+	k_poll_set_add(&item->ep->set, &item->sev[0]);
+
+	for (int i = 0; i < item->num_events; i++) {
+		sev = &item->sev[1 + i];
+		k_poll_event_init(&sev->event, events[i].type,
+				  K_POLL_MODE_NOTIFY_ONLY, events[i].obj);
+		sev->event.tag = 1 + i;
+		k_poll_set_add(&item->ep->set, sev);
+	}
+
+	if (ready) {
+		k_poll_set_ready(&item->sev[0], K_POLL_STATE_SIGNALED);
+	}
+
+	return 0;
+}
+
+static void epoll_item_unregister(struct epoll_item *item)
+{
+	for (int i = 0; i <= item->num_events; i++) {
+		k_poll_set_remove(&item->ep->set, &item->sev[i]);
+	}
+
+	item->num_events = 0;
+}
+
+static void epoll_item_remove(struct epoll_item *item)
+{
+	epoll_item_unregister(item);
+	sys_dlist_remove(&item->node);
+	epoll_item_free(item);
+}
+
+/* Returns the events the socket is ready for, as zsock_poll() would */
+static uint32_t epoll_item_poll(struct epoll_item *item)
+{
+	struct k_poll_event events[EPOLL_POLL_EVENTS];
+	struct k_poll_event *pev = events;
+	struct zsock_pollfd pfd = {
+		.fd = item->fd,
+		.events = item->event.events & EPOLL_SOCK_EVENTS,
+	};
+	const struct fd_op_vtable *vtable;
+	void *obj;
+	int ret;
+
+	obj = z_get_fd_obj_and_vtable(item->fd, &vtable);
+	if (obj != item->obj) {
+		/* closed without z_fd_epoll_remove() */
+		return EPOLL_ALWAYS_EVENTS;
+	}
+
+	for (int i = 0; i < item->num_events; i++) {
+		struct k_poll_event *event = &item->sev[1 + i].event;
+
+		k_poll_event_init(&events[i], event->type,
+				  K_POLL_MODE_NOTIFY_ONLY, event->obj);
+	}
+
+	/* only checks the conditions, without registering anything */
+	if (item->num_events > 0) {
+		(void)k_poll(events, item->num_events, K_NO_WAIT);
+	}
+
+	ret = z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_POLL_UPDATE,
+				   &pfd, &pev);
+	if (ret != 0) {
+		/* e.g. -EAGAIN, while a TLS handshake is in progress */
+		return 0;
+	}
+
+	return (uint32_t)pfd.revents &
+	       ((item->event.events & ~EPOLL_FLAGS) | EPOLL_ALWAYS_EVENTS);
+}
+
+/* Must be called with the instance locked */
+static int epoll_collect(struct epoll_instance *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	struct k_poll_set_event *ready[EPOLL_WAIT_BATCH];
+	sys_dlist_t reported;
+	struct epoll_item *item;
+	sys_dnode_t *node;
+	int count = 0;
+
+	sys_dlist_init(&reported);
+
+	while (count < maxevents) {
+		int max = MIN(maxevents - count, ARRAY_SIZE(ready));
+		int n = k_poll_set_wait(&ep->set, ready, max, K_NO_WAIT);
+
+		for (int i = 0; i < n; i++) {
+			struct k_poll_set_event *sev = ready[i];
+			uint32_t revents;
+
+			item = CONTAINER_OF(sev - sev->event.tag,
+					    struct epoll_item, sev);
+			sev->event.state = K_POLL_STATE_NOT_READY;
+
+			if (item->disabled ||
+			    sys_dnode_is_linked(&item->report_node)) {
+				continue;
+			}
+
+			revents = epoll_item_poll(item);
+			if (revents == 0U) {
+				/* no longer ready */
+				continue;
+			}
+
+			events[count].events = revents;
+			events[count].data = item->event.data;
+			count++;
+			sys_dlist_append(&reported, &item->report_node);
+
+			if (item->event.events & ZSOCK_EPOLLONESHOT) {
+				item->disabled = true;
+			}
+		}
+
+		if (n < max) {
+			break;
+		}
+	}
+
+	/* have the next wait check again whether level-triggered ones are
+	 * still ready
+	 */
+	while ((node = sys_dlist_get(&reported)) != NULL) {
+		item = CONTAINER_OF(node, struct epoll_item, report_node);
+		if ((item->event.events & EPOLL_FLAGS) == 0U) {
+			k_poll_set_ready(&item->sev[0],
+					 K_POLL_STATE_SIGNALED);
+		}
+	}
+
+	return count;
+}
+
+static ssize_t epoll_read_op(void *obj, void *buf, size_t sz)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buf);
+	ARG_UNUSED(sz);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_op(void *obj, const void *buf, size_t sz)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buf);
+	ARG_UNUSED(sz);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_close_op(void *obj)
+{
+	struct epoll_instance *ep = obj;
+	struct epoll_item *item, *next;
+
+	/* no new calls from now on, and ours keeps the instance alive */
+	k_mutex_lock(&epoll_pool_lock, K_FOREVER);
+	ep->closed = true;
+	ep->refs++;
+	k_mutex_unlock(&epoll_pool_lock);
+
+	k_mutex_lock(&ep->lock, K_FOREVER);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ep->items, item, next, node) {
+		epoll_item_remove(item);
+	}
+
+	k_mutex_unlock(&ep->lock);
+
+	/* threads in epoll_wait() return with EBADF */
+	k_poll_set_cancel(&ep->set);
+
+	epoll_put(ep);
+
+	return 0;
+}
+
+static int epoll_ioctl_op(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(request);
+	ARG_UNUSED(args);
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+static const struct fd_op_vtable epoll_fd_op_vtable = {
+	.read = epoll_read_op,
+	.write = epoll_write_op,
+	.close = epoll_close_op,
+	.ioctl = epoll_ioctl_op,
+};
+
+void z_fd_epoll_remove(int fd)
+{
+	struct epoll_instance *ep;
+	struct epoll_item *item;
+
+	for (int i = 0; i < ARRAY_SIZE(epoll_instances); i++) {
+		ep = &epoll_instances[i];
+		if (!epoll_get(ep)) {
+			continue;
+		}
+
+		k_mutex_lock(&ep->lock, K_FOREVER);
+
+		item = epoll_item_find(ep, fd);
+		if (item != NULL) {
+			epoll_item_remove(item);
+		}
+
+		k_mutex_unlock(&ep->lock);
+		epoll_put(ep);
+	}
+}
+
+int z_impl_zsock_epoll_create1(int flags)
+{
+	struct epoll_instance *ep = NULL;
+	int fd;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	k_mutex_lock(&epoll_pool_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(epoll_instances); i++) {
+		if (!epoll_instances[i].in_use) {
+			ep = &epoll_instances[i];
+			ep->in_use = true;
+			ep->closed = false;
+			ep->refs = 0;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&epoll_pool_lock);
+
+	if (ep == NULL) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	k_poll_set_init(&ep->set);
+	k_mutex_init(&ep->lock);
+	sys_dlist_init(&ep->items);
+
+	z_finalize_fd(fd, ep, &epoll_fd_op_vtable);
+
+	NET_DBG("epoll: ep=%p, fd=%d", ep, fd);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_create1(int flags)
+{
+	return z_impl_zsock_epoll_create1(flags);
+}
+#include <syscalls/zsock_epoll_create1_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int z_impl_zsock_epoll_ctl(int epfd, int op, int sock,
+			   struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_instance *ep;
+	struct epoll_item *item;
+	void *obj;
+	int ret = 0;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	/* Any descriptor that can be polled, such as an eventfd, not only
+	 * sockets: like zsock_poll(), this goes by the fd table alone.
+	 */
+	obj = z_get_fd_obj_and_vtable(sock, &vtable);
+	if (obj == NULL) {
+		return -1;
+	}
+
+	if (vtable == &epoll_fd_op_vtable) {
+		/* nested instances are not supported */
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (vtable->ioctl == NULL) {
+		errno = EPERM;
+		return -1;
+	}
+
+	if ((op != ZSOCK_EPOLL_CTL_DEL) && (event == NULL)) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	/* closed meanwhile */
+	if (!epoll_get(ep)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	k_mutex_lock(&ep->lock, K_FOREVER);
+
+	item = epoll_item_find(ep, sock);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		if (item != NULL) {
+			ret = -EEXIST;
+			break;
+		}
+
+		item = epoll_item_alloc(ep);
+		if (item == NULL) {
+			ret = -ENOSPC;
+			break;
+		}
+
+		item->fd = sock;
+		item->obj = obj;
+		item->event = *event;
+		item->num_events = 0;
+		sys_dnode_init(&item->report_node);
+
+		ret = epoll_item_register(item, vtable);
+		if (ret < 0) {
+			epoll_item_free(item);
+			break;
+		}
+
+		sys_dlist_append(&ep->items, &item->node);
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_item_unregister(item);
+		item->event = *event;
+
+		ret = epoll_item_register(item, vtable);
+		if (ret < 0) {
+			sys_dlist_remove(&item->node);
+			epoll_item_free(item);
+		}
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_item_remove(item);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_mutex_unlock(&ep->lock);
+	epoll_put(ep);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_ctl(int epfd, int op, int sock,
+					 struct zsock_epoll_event *event)
+{
+	struct zsock_epoll_event event_copy;
+
+	if (event == NULL) {
+		return z_impl_zsock_epoll_ctl(epfd, op, sock, NULL);
+	}
+
+	Z_OOPS(z_user_from_copy(&event_copy, (void *)event,
+				sizeof(event_copy)));
+
+	return z_impl_zsock_epoll_ctl(epfd, op, sock, &event_copy);
+}
+#include <syscalls/zsock_epoll_ctl_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int z_impl_zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			    int maxevents, int timeout)
+{
+	struct epoll_instance *ep;
+	k_timeout_t wait;
+	uint64_t end;
+	int count;
+	int ret;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_op_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* keeps the instance from being reused while we wait on it */
+	if (!epoll_get(ep)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (timeout < 0) {
+		wait = K_FOREVER;
+	} else {
+		wait = K_MSEC(timeout);
+	}
+
+	end = z_timeout_end_calc(wait);
+
+	for (;;) {
+		k_mutex_lock(&ep->lock, K_FOREVER);
+		count = epoll_collect(ep, events, maxevents);
+		k_mutex_unlock(&ep->lock);
+
+		if ((count > 0) || K_TIMEOUT_EQ(wait, K_NO_WAIT)) {
+			break;
+		}
+
+		ret = k_poll_set_wait(&ep->set, NULL, 0, wait);
+		if (ret == -EAGAIN) {
+			count = 0;
+			break;
+		} else if (ret == -ECANCELED) {
+			/* the fd was closed under us */
+			errno = EBADF;
+			count = -1;
+			break;
+		}
+
+		if (!K_TIMEOUT_EQ(wait, K_FOREVER)) {
+			int64_t remaining = end - z_tick_get();
+
+			wait = (remaining > 0) ? K_TICKS(remaining) :
+			       K_NO_WAIT;
+		}
+	}
+
+	epoll_put(ep);
+
+	return count;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_wait(int epfd,
+					  struct zsock_epoll_event *events,
+					  int maxevents, int timeout)
+{
+	size_t size;
+
+	if (size_mul_overflow(maxevents, sizeof(struct zsock_epoll_event),
+			      &size)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(events, size));
+
+	return z_impl_zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+#include <syscalls/zsock_epoll_wait_mrsh.c>
+#endif /* CONFIG_USERSPACE */
@@ -214,6 +214,171 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+static int cmd_kernel_heaps(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	struct sys_heap_runtime_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	/* Only statically defined heaps can be enumerated */
+	Z_STRUCT_SECTION_FOREACH(k_heap, h) {
+		if (k_heap_runtime_stats_get(h, &stats) != 0) {
+			continue;
+		}
+
+		shell_print(shell,
+			"%p %-16s allocated %zu\tfree %zu\tmax allocated %zu"
+			"\tlargest free %zu\tfragmentation %u %%",
+			h,
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS_GROUP)
+			h->stats_name,
+#else
+			"",
+#endif
+			stats.allocated_bytes, stats.free_bytes,
+			stats.max_allocated_bytes, stats.largest_free_bytes,
+			stats.fragmentation);
+	}
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_CPU_LOAD)
+#define LOAD_FMT "%3u.%u %%"
+#define LOAD_ARG(load) ((load) / 10U), ((load) % 10U)
+
+static void shell_load_avg(const struct shell *shell, const char *what,
+			   const struct k_load_avg *load)
+{
+	shell_print(shell, "%-20s " LOAD_FMT "  " LOAD_FMT "  " LOAD_FMT,
+		    what,
+		    LOAD_ARG(load->avg[K_LOAD_WINDOW_SHORT]),
+		    LOAD_ARG(load->avg[K_LOAD_WINDOW_MEDIUM]),
+		    LOAD_ARG(load->avg[K_LOAD_WINDOW_LONG]));
+}
+
+static void shell_thread_load(const struct k_thread *cthread, void *user_data)
+{
+	const struct shell *shell = (const struct shell *)user_data;
+	struct k_thread *thread = (struct k_thread *)cthread;
+	struct k_load_avg load;
+	char name[21];
+	const char *tname;
+
+	tname = k_thread_name_get(thread);
+	if ((tname == NULL) || (tname[0] == '\0')) {
+		snprintk(name, sizeof(name), "%p", thread);
+		tname = name;
+	}
+
+	if (k_thread_load_get(thread, &load) == 0) {
+		shell_load_avg(shell, tname, &load);
+	}
+}
+
+static int cmd_kernel_load(const struct shell *shell,
+			   size_t argc, char **argv)
+{
+	struct k_cpu_load load;
+	char what[21];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "%-20s %7u ms %7u ms %7u ms", "",
+		    CONFIG_CPU_LOAD_WINDOW_SHORT,
+		    CONFIG_CPU_LOAD_WINDOW_MEDIUM,
+		    CONFIG_CPU_LOAD_WINDOW_LONG);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (k_cpu_load_get(i, &load) != 0) {
+			continue;
+		}
+
+		snprintk(what, sizeof(what), "CPU %d", i);
+		shell_load_avg(shell, what, &load.busy);
+		snprintk(what, sizeof(what), "CPU %d ISRs", i);
+		shell_load_avg(shell, what, &load.isr);
+	}
+
+	k_thread_foreach(shell_thread_load, (void *)shell);
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_WORKQUEUE_RUNTIME_STATS)
+static void shell_work_q_stats(struct k_work_q *work_q, void *user_data)
+{
+	const struct shell *shell = (const struct shell *)user_data;
+	struct k_work_q_runtime_stats stats;
+	struct k_thread *thread = &work_q->thread;
+	const char *tname;
+
+	if (k_work_q_runtime_stats_get(work_q, &stats) != 0) {
+		return;
+	}
+
+#if defined(CONFIG_WORKQUEUE_POOL)
+	if (work_q->workers != NULL) {
+		thread = &work_q->workers[0].thread;
+	}
+#endif
+	tname = k_thread_name_get(thread);
+
+	shell_print(shell, "%p %-16s submitted %u\thandled %u\tdepth %u"
+		    "\tmax depth %u\tmax latency %u us\thandlers %u us",
+		    work_q, tname ? tname : "NA", stats.submitted,
+		    stats.handled, stats.depth, stats.max_depth,
+		    stats.max_latency_us,
+		    (uint32_t)k_cyc_to_us_floor64(stats.handler_cycles));
+
+	for (int i = 0; i < K_WORK_Q_LATENCY_BUCKETS; i++) {
+		if (stats.latency_hist[i] == 0U) {
+			continue;
+		}
+
+		if (i == K_WORK_Q_LATENCY_BUCKETS - 1) {
+			shell_print(shell, "\tlatency >= %u us: %u",
+				    1U << (i - 1), stats.latency_hist[i]);
+		} else {
+			shell_print(shell, "\tlatency < %u us: %u",
+				    1U << i, stats.latency_hist[i]);
+		}
+	}
+}
+
+static void shell_work_handler_stats(const struct k_work_handler_stats *hs,
+				     void *user_data)
+{
+	const struct shell *shell = (const struct shell *)user_data;
+
+	shell_print(shell, "%p %p count %u\tavg %u us\tmax %u us",
+		    hs->work_q, hs->handler, hs->count,
+		    (uint32_t)k_cyc_to_us_floor64(hs->cycles / hs->count),
+		    k_cyc_to_us_floor32(hs->max_cycles));
+}
+
+static int cmd_kernel_workq(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "Workqueues:");
+	k_work_q_foreach(shell_work_q_stats, (void *)shell);
+
+	shell_print(shell, "Work handlers:");
+	k_work_handler_stats_foreach(shell_work_handler_stats, (void *)shell);
+
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -242,6 +407,13 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_reboot,
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 	SHELL_CMD(cycles, NULL, "Kernel cycles.", cmd_kernel_cycles),
+#if defined(CONFIG_SYS_HEAP_RUNTIME_STATS)
+	SHELL_CMD(heaps, NULL, "List k_heap usage.", cmd_kernel_heaps),
+#endif
+#if defined(CONFIG_CPU_LOAD)
+	SHELL_CMD(load, NULL, "CPU and thread load averages.",
+		  cmd_kernel_load),
+#endif
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
@@ -252,6 +424,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
+#if defined(CONFIG_WORKQUEUE_RUNTIME_STATS)
+	SHELL_CMD(workq, NULL, "List workqueue statistics.", cmd_kernel_workq),
+#endif
 	SHELL_SUBCMD_SET_END /* Array terminated. */
 );
 
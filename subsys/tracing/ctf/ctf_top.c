@@ -210,6 +210,23 @@ void sys_trace_mutex_unlock(struct k_mutex *mutex)
 		);
 }
 
+void sys_trace_work_start(struct k_work_q *work_q, struct k_work *work)
+{
+	ctf_top_work_start(
+		(uint32_t)(uintptr_t)work_q,
+		(uint32_t)(uintptr_t)work,
+		(uint32_t)(uintptr_t)work->handler
+		);
+}
+
+void sys_trace_work_end(struct k_work_q *work_q, struct k_work *work)
+{
+	ctf_top_work_end(
+		(uint32_t)(uintptr_t)work_q,
+		(uint32_t)(uintptr_t)work
+		);
+}
+
 void sys_trace_end_call(unsigned int id)
 {
 	ctf_top_end_call(id);
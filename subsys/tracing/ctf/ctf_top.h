@@ -41,7 +41,11 @@
 	tracing_format_raw_data(epacket, sizeof(epacket));		    \
 }
 
-#ifdef CONFIG_TRACING_CTF_TIMESTAMP
+/*
+ * Per-CPU tracing timestamps events itself, by the time they are buffered.
+ */
+#if defined(CONFIG_TRACING_CTF_TIMESTAMP) && \
+	!defined(CONFIG_TRACING_PER_CPU_TIMESTAMP)
 #define CTF_EVENT(...)							    \
 	{								    \
 		const uint32_t tstamp = k_cyc_to_ns_floor64(		    \
@@ -91,6 +95,8 @@ typedef enum {
 	CTF_EVENT_MUTEX_INIT			=  0x46,
 	CTF_EVENT_MUTEX_LOCK			=  0x47,
 	CTF_EVENT_MUTEX_UNLOCK			=  0x48,
+	CTF_EVENT_WORK_START            =  0x50,
+	CTF_EVENT_WORK_END              =  0x51,
 } ctf_event_t;
 
 
@@ -322,4 +328,28 @@ static inline void ctf_top_mutex_unlock(uint32_t mutex_id)
 		);
 }
 
+static inline void ctf_top_work_start(
+	uint32_t work_q_id,
+	uint32_t work_id,
+	uint32_t handler)
+{
+	CTF_EVENT(
+		CTF_LITERAL(uint8_t, CTF_EVENT_WORK_START),
+		work_q_id,
+		work_id,
+		handler
+		);
+}
+
+static inline void ctf_top_work_end(
+	uint32_t work_q_id,
+	uint32_t work_id)
+{
+	CTF_EVENT(
+		CTF_LITERAL(uint8_t, CTF_EVENT_WORK_END),
+		work_q_id,
+		work_id
+		);
+}
+
 #endif /* SUBSYS_DEBUG_TRACING_CTF_TOP_H */
@@ -101,6 +101,26 @@ static inline struct tracing_backend *tracing_backend_get(char *name)
 	return NULL;
 }
 
+#ifdef CONFIG_TRACING_BACKEND_RAM
+/**
+ * @brief Copy the tracing data kept by the RAM backend.
+ *
+ * @param data Address of the output buffer.
+ * @param size Output buffer size (in bytes).
+ *
+ * @return Number of bytes copied, of whole packets from the oldest one.
+ */
+uint32_t tracing_backend_ram_copy(uint8_t *data, uint32_t size);
+
+/**
+ * @brief Get the memory region the RAM backend keeps tracing data in.
+ *
+ * @param start Set to the start address of the region.
+ * @param end   Set to the end address of the region.
+ */
+void tracing_backend_ram_region_get(uintptr_t *start, uintptr_t *end);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
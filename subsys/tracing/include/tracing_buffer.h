@@ -113,6 +113,39 @@ uint32_t tracing_buffer_get(uint8_t *data, uint32_t size);
  */
 uint32_t tracing_cmd_buffer_alloc(uint8_t **data);
 
+#ifdef CONFIG_TRACING_PER_CPU
+/**
+ * @brief Reserve space for a packet in the buffer of the current CPU.
+ *
+ * Interrupts are masked on the current CPU until the packet is committed,
+ * if space was reserved.
+ *
+ * @param size Packet size (in bytes).
+ * @param key Set to the key to pass to tracing_cpu_buffer_commit().
+ *
+ * @return Address to write the packet to, or NULL if the buffer is full.
+ */
+void *tracing_cpu_buffer_reserve(uint32_t size, unsigned int *key);
+
+/**
+ * @brief Commit a packet written to reserved space, for output.
+ *
+ * @param data Address returned by tracing_cpu_buffer_reserve().
+ * @param size Packet size (in bytes), as reserved.
+ * @param key Key set by tracing_cpu_buffer_reserve().
+ */
+void tracing_cpu_buffer_commit(void *data, uint32_t size, unsigned int key);
+
+/**
+ * @brief Output the committed packets of all CPUs, in timestamp order.
+ *
+ * Must only be called from the tracing thread.
+ *
+ * @return Number of packets output.
+ */
+uint32_t tracing_cpu_buffer_export(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,6 +50,8 @@ void cpu_stats_reset_counters(void);
 #define sys_trace_mutex_init(mutex)
 #define sys_trace_mutex_lock(mutex)
 #define sys_trace_mutex_unlock(mutex)
+#define sys_trace_work_start(work_q, work)
+#define sys_trace_work_end(work_q, work)
 
 #ifdef __cplusplus
 }
@@ -37,6 +37,8 @@ void sys_trace_semaphore_give(struct k_sem *sem);
 void sys_trace_mutex_init(struct k_mutex *mutex);
 void sys_trace_mutex_lock(struct k_mutex *mutex);
 void sys_trace_mutex_unlock(struct k_mutex *mutex);
+void sys_trace_work_start(struct k_work_q *work_q, struct k_work *work);
+void sys_trace_work_end(struct k_work_q *work_q, struct k_work *work);
 #ifdef __cplusplus
 }
 #endif
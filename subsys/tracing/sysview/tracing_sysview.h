@@ -53,4 +53,8 @@ void sys_trace_thread_info(struct k_thread *thread);
 
 #define sys_trace_end_call(id) SEGGER_SYSVIEW_RecordEndCall(id)
 
+#define sys_trace_work_start(work_q, work)
+
+#define sys_trace_work_end(work_q, work)
+
 #endif /* _TRACE_SYSVIEW_H */
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2020 Intel corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief RAM tracing backend, a flight recorder
+ *
+ * Packets are kept in a ring buffer in RAM which is not initialized at
+ * boot, each preceded by its length, and the oldest ones are overwritten to
+ * make room for new ones. A header tells a trace retained across a reset
+ * from garbage, so that it can be dumped at the next boot.
+ */
+
+#include <string.h>
+#include <kernel.h>
+#include <sys/util.h>
+#include <tracing_backend.h>
+
+#define RECORDER_SIZE CONFIG_TRACING_BACKEND_RAM_SIZE
+#define RECORDER_MAGIC 0x52465254 /* "TRFR" */
+
+/* Dump strings, as the ones of core dumps over logging */
+#define RECORDER_PREFIX_STR "#TR:"
+#define RECORDER_BEGIN_STR "BEGIN#"
+#define RECORDER_END_STR "END#"
+
+/* Layout known to scripts/tracing/trace_flight_recorder.py, which finds it
+ * in core dumps by its magic
+ */
+struct ram_recorder {
+	uint32_t magic;
+	uint32_t size;
+	/* offset of the oldest packet, and bytes in use */
+	uint32_t start;
+	uint32_t used;
+	/* magic ^ size ^ start ^ used */
+	uint32_t check;
+	uint8_t buf[RECORDER_SIZE];
+};
+
+static __noinit struct ram_recorder recorder;
+
+static void ring_write(uint32_t offset, const uint8_t *data, uint32_t len)
+{
+	uint32_t first;
+
+	offset %= RECORDER_SIZE;
+	first = MIN(len, RECORDER_SIZE - offset);
+
+	memcpy(&recorder.buf[offset], data, first);
+	memcpy(&recorder.buf[0], data + first, len - first);
+}
+
+static void ring_read(uint32_t offset, uint8_t *data, uint32_t len)
+{
+	uint32_t first;
+
+	offset %= RECORDER_SIZE;
+	first = MIN(len, RECORDER_SIZE - offset);
+
+	memcpy(data, &recorder.buf[offset], first);
+	memcpy(data + first, &recorder.buf[0], len - first);
+}
+
+static bool recorder_is_valid(void)
+{
+	return (recorder.magic == RECORDER_MAGIC) &&
+	       (recorder.size == RECORDER_SIZE) &&
+	       (recorder.start < RECORDER_SIZE) &&
+	       (recorder.used <= RECORDER_SIZE) &&
+	       (recorder.check == (recorder.magic ^ recorder.size ^
+				   recorder.start ^ recorder.used));
+}
+
+static void recorder_update(uint32_t start, uint32_t used)
+{
+	recorder.start = start;
+	recorder.used = used;
+	recorder.check = RECORDER_MAGIC ^ RECORDER_SIZE ^ start ^ used;
+}
+
+/* Gets the length of the packet at offset from the oldest one, returns
+ * false past the newest one
+ */
+static bool packet_get(uint32_t offset, uint16_t *len)
+{
+	if (offset + sizeof(*len) > recorder.used) {
+		return false;
+	}
+
+	ring_read(recorder.start + offset, (uint8_t *)len, sizeof(*len));
+
+	return offset + sizeof(*len) + *len <= recorder.used;
+}
+
+uint32_t tracing_backend_ram_copy(uint8_t *data, uint32_t size)
+{
+	uint32_t offset = 0U, copied = 0U;
+	uint16_t len;
+
+	while (packet_get(offset, &len) && (copied + len <= size)) {
+		ring_read(recorder.start + offset + sizeof(len),
+			  data + copied, len);
+		offset += sizeof(len) + len;
+		copied += len;
+	}
+
+	return copied;
+}
+
+void tracing_backend_ram_region_get(uintptr_t *start, uintptr_t *end)
+{
+	*start = POINTER_TO_UINT(&recorder);
+	*end = POINTER_TO_UINT(&recorder) + sizeof(recorder);
+}
+
+#ifdef CONFIG_TRACING_BACKEND_RAM_DUMP_ON_BOOT
+/* Prints the packets retained, one per line */
+static void recorder_dump(void)
+{
+	uint32_t offset = 0U;
+	uint16_t len;
+
+	printk(RECORDER_PREFIX_STR RECORDER_BEGIN_STR "\n");
+
+	while (packet_get(offset, &len)) {
+		offset += sizeof(len);
+
+		printk(RECORDER_PREFIX_STR);
+		for (uint32_t i = 0; i < len; i++) {
+			printk("%02x", recorder.buf[(recorder.start + offset +
+						     i) % RECORDER_SIZE]);
+		}
+		printk("\n");
+
+		offset += len;
+	}
+
+	printk(RECORDER_PREFIX_STR RECORDER_END_STR "\n");
+}
+#endif
+
+static void tracing_backend_ram_init(void)
+{
+	if (recorder_is_valid()) {
+		/* retained across a reset, keep recording after it unless
+		 * dumped
+		 */
+#ifdef CONFIG_TRACING_BACKEND_RAM_DUMP_ON_BOOT
+		if (recorder.used > 0U) {
+			recorder_dump();
+		}
+		recorder_update(0U, 0U);
+#endif
+		return;
+	}
+
+	recorder.magic = RECORDER_MAGIC;
+	recorder.size = RECORDER_SIZE;
+	recorder_update(0U, 0U);
+}
+
+static void tracing_backend_ram_output(
+		const struct tracing_backend *backend,
+		uint8_t *data, uint32_t length)
+{
+	uint32_t start = recorder.start, used = recorder.used;
+	uint16_t len = length;
+
+	if (sizeof(len) + length > RECORDER_SIZE) {
+		return;
+	}
+
+	/* overwrite the oldest packets */
+	while (used + sizeof(len) + length > RECORDER_SIZE) {
+		uint16_t old;
+
+		ring_read(start, (uint8_t *)&old, sizeof(old));
+		start = (start + sizeof(old) + old) % RECORDER_SIZE;
+		used -= sizeof(old) + old;
+	}
+
+	/* so that the trace stays consistent if writing is interrupted */
+	recorder_update(start, used);
+
+	ring_write(start + used, (uint8_t *)&len, sizeof(len));
+	ring_write(start + used + sizeof(len), data, length);
+
+	recorder_update(start, used + sizeof(len) + length);
+}
+
+const struct tracing_backend_api tracing_backend_ram_api = {
+	.init = tracing_backend_ram_init,
+	.output  = tracing_backend_ram_output
+};
+
+TRACING_BACKEND_DEFINE(tracing_backend_ram, tracing_backend_ram_api);
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2020 Intel corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Per-CPU tracing buffers
+ *
+ * Each CPU writes its packets to a buffer of its own, without locking:
+ * with its interrupts masked, it moves the head of the buffer forward,
+ * timestamps the record, copies the packet in and commits it by setting
+ * its record header. Nothing else writes to the buffer meanwhile, and a
+ * record never stays uncommitted for longer than a copy. The tracing
+ * thread is the only reader. It outputs the committed records of all
+ * CPUs in timestamp order, then zeroes them and moves the tail of their
+ * buffer forward, so that uncommitted records always read as zero.
+ */
+
+#include <string.h>
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <sys/atomic.h>
+#include <tracing_core.h>
+#include <tracing_buffer.h>
+
+#define BUFFER_SIZE CONFIG_TRACING_BUFFER_SIZE
+#define BUFFER_MASK (BUFFER_SIZE - 1)
+
+BUILD_ASSERT((BUFFER_SIZE & BUFFER_MASK) == 0,
+	     "Per-CPU tracing buffers must be a power of two in size");
+
+/* record info, 0 until the record is committed */
+#define RECORD_COMMITTED BIT(31)
+#define RECORD_PAD BIT(30)
+#define RECORD_SIZE_MASK 0xffff
+
+struct tracing_record {
+	atomic_t info;
+	/* cycle count when the record was reserved */
+	uint32_t timestamp;
+	uint8_t data[];
+};
+
+#define RECORD_LEN(size) ROUND_UP(sizeof(struct tracing_record) + (size), \
+				  sizeof(atomic_t))
+
+BUILD_ASSERT(RECORD_LEN(CONFIG_TRACING_PACKET_MAX_SIZE) <= BUFFER_SIZE,
+	     "Per-CPU tracing buffers can't hold a packet");
+
+struct tracing_cpu_buffer {
+	/* free running offsets, of the space reserved and consumed */
+	atomic_t head;
+	atomic_t tail;
+	uint8_t data[BUFFER_SIZE] __aligned(sizeof(atomic_t));
+};
+
+static struct tracing_cpu_buffer cpu_buffers[CONFIG_MP_NUM_CPUS];
+static uint8_t tracing_cmd_buffer[CONFIG_TRACING_CMD_BUFFER_SIZE];
+
+uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
+{
+	*data = &tracing_cmd_buffer[0];
+
+	return sizeof(tracing_cmd_buffer);
+}
+
+static inline int get_cpu(void)
+{
+#if defined(CONFIG_SMP)
+	return arch_curr_cpu()->id;
+#else
+	return 0;
+#endif
+}
+
+static inline struct tracing_record *record_get(struct tracing_cpu_buffer *buf,
+						uint32_t offset)
+{
+	return (struct tracing_record *)&buf->data[offset & BUFFER_MASK];
+}
+
+void *tracing_cpu_buffer_reserve(uint32_t size, unsigned int *key)
+{
+	uint32_t len = RECORD_LEN(size);
+	struct tracing_cpu_buffer *buf;
+	struct tracing_record *record;
+	uint32_t head, pad;
+
+	if (size > CONFIG_TRACING_PACKET_MAX_SIZE) {
+		return NULL;
+	}
+
+	/* only masks the local CPU, unlike irq_lock() on SMP */
+	*key = arch_irq_lock();
+
+	buf = &cpu_buffers[get_cpu()];
+	head = (uint32_t)atomic_get(&buf->head);
+
+	/* records don't wrap, pad up to the end of the buffer */
+	pad = (head & BUFFER_MASK) + len > BUFFER_SIZE ?
+	      BUFFER_SIZE - (head & BUFFER_MASK) : 0U;
+
+	if (head + pad + len - (uint32_t)atomic_get(&buf->tail) >
+	    BUFFER_SIZE) {
+		arch_irq_unlock(*key);
+		return NULL;
+	}
+
+	if (pad != 0U) {
+		atomic_set(&record_get(buf, head)->info,
+			   RECORD_COMMITTED | RECORD_PAD | pad);
+	}
+
+	atomic_set(&buf->head, head + pad + len);
+
+	/* timestamped once the tracing thread sees the record pending, so
+	 * that it is not older than any record merged meanwhile
+	 */
+	record = record_get(buf, head + pad);
+	record->timestamp = k_cycle_get_32();
+
+	return record->data;
+}
+
+void tracing_cpu_buffer_commit(void *data, uint32_t size, unsigned int key)
+{
+	struct tracing_record *record =
+		CONTAINER_OF(data, struct tracing_record, data);
+
+	atomic_set(&record->info, RECORD_COMMITTED | size);
+
+	arch_irq_unlock(key);
+}
+
+/* Returns the first committed record of buf, NULL if there is none or if
+ * the first one is still being written, which sets *pending.
+ */
+static struct tracing_record *record_peek(struct tracing_cpu_buffer *buf,
+					  bool *pending)
+{
+	uint32_t tail = (uint32_t)atomic_get(&buf->tail);
+	struct tracing_record *record;
+	uint32_t info;
+
+	while (tail != (uint32_t)atomic_get(&buf->head)) {
+		record = record_get(buf, tail);
+		info = (uint32_t)atomic_get(&record->info);
+
+		if ((info & RECORD_COMMITTED) == 0U) {
+			/* being written, with interrupts masked on its CPU */
+			*pending = true;
+			return NULL;
+		}
+
+		if ((info & RECORD_PAD) == 0U) {
+			return record;
+		}
+
+		(void)memset(record, 0, info & RECORD_SIZE_MASK);
+		tail += info & RECORD_SIZE_MASK;
+		atomic_set(&buf->tail, tail);
+	}
+
+	return NULL;
+}
+
+static void record_output(struct tracing_record *record, uint32_t size)
+{
+#ifdef CONFIG_TRACING_PER_CPU_TIMESTAMP
+	uint32_t tstamp = k_cyc_to_ns_floor64(record->timestamp);
+
+	tracing_buffer_handle((uint8_t *)&tstamp, sizeof(tstamp));
+#endif
+	tracing_buffer_handle(record->data, size);
+}
+
+uint32_t tracing_cpu_buffer_export(void)
+{
+	struct tracing_cpu_buffer *first_buf;
+	struct tracing_record *record, *first;
+	uint32_t size, start, count = 0U;
+	bool pending;
+
+	while (true) {
+		/* records reserved from now on are timestamped later */
+		start = k_cycle_get_32();
+		pending = false;
+		first = NULL;
+		first_buf = NULL;
+
+		for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+			record = record_peek(&cpu_buffers[i], &pending);
+			if ((record != NULL) &&
+			    ((first == NULL) ||
+			     ((int32_t)(record->timestamp -
+					first->timestamp) < 0))) {
+				first = record;
+				first_buf = &cpu_buffers[i];
+			}
+		}
+
+		/* A record being written, or reserved after start on a
+		 * buffer already peeked, might be older than the first one:
+		 * leave the rest to the next round.
+		 */
+		if (pending || (first == NULL) ||
+		    ((int32_t)(first->timestamp - start) >= 0)) {
+			break;
+		}
+
+		size = (uint32_t)atomic_get(&first->info) & RECORD_SIZE_MASK;
+		record_output(first, size);
+
+		size = RECORD_LEN(size);
+		(void)memset(first, 0, size);
+		atomic_add(&first_buf->tail, size);
+		count++;
+	}
+
+	return count;
+}
@@ -22,6 +22,8 @@
 #define TRACING_BACKEND_NAME "tracing_backend_usb"
 #elif defined CONFIG_TRACING_BACKEND_POSIX
 #define TRACING_BACKEND_NAME "tracing_backend_posix"
+#elif defined CONFIG_TRACING_BACKEND_RAM
+#define TRACING_BACKEND_NAME "tracing_backend_ram"
 #else
 #define TRACING_BACKEND_NAME ""
 #endif
@@ -35,15 +37,31 @@ static atomic_t tracing_state;
 static atomic_t tracing_packet_drop_num;
 static struct tracing_backend *working_backend;
 
-#ifdef CONFIG_TRACING_ASYNC
+#if defined(CONFIG_TRACING_ASYNC) || defined(CONFIG_TRACING_PER_CPU)
 #define TRACING_THREAD_NAME "tracing_thread"
 
 static k_tid_t tracing_thread_tid;
 static struct k_thread tracing_thread;
-static struct k_timer tracing_thread_timer;
-static K_SEM_DEFINE(tracing_thread_sem, 0, 1);
 static K_THREAD_STACK_DEFINE(tracing_thread_stack,
 			CONFIG_TRACING_THREAD_STACK_SIZE);
+#endif
+
+#ifdef CONFIG_TRACING_PER_CPU
+static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
+{
+	tracing_thread_tid = k_current_get();
+
+	/* hooks don't wake the thread up, to stay cheap */
+	while (true) {
+		k_sleep(K_MSEC(CONFIG_TRACING_THREAD_WAIT_THRESHOLD));
+		(void)tracing_cpu_buffer_export();
+	}
+}
+#endif
+
+#ifdef CONFIG_TRACING_ASYNC
+static struct k_timer tracing_thread_timer;
+static K_SEM_DEFINE(tracing_thread_sem, 0, 1);
 
 static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 {
@@ -84,7 +102,9 @@ static int tracing_init(const struct device *arg)
 {
 	ARG_UNUSED(arg);
 
+#ifndef CONFIG_TRACING_PER_CPU
 	tracing_buffer_init();
+#endif
 
 	working_backend = tracing_backend_get(TRACING_BACKEND_NAME);
 	tracing_backend_init(working_backend);
@@ -100,7 +120,9 @@ static int tracing_init(const struct device *arg)
 #ifdef CONFIG_TRACING_ASYNC
 	k_timer_init(&tracing_thread_timer,
 		     tracing_thread_timer_expiry_fn, NULL);
+#endif
 
+#if defined(CONFIG_TRACING_ASYNC) || defined(CONFIG_TRACING_PER_CPU)
 	k_thread_create(&tracing_thread, tracing_thread_stack,
 			K_THREAD_STACK_SIZEOF(tracing_thread_stack),
 			tracing_thread_func, NULL, NULL, NULL,
@@ -122,7 +144,9 @@ void tracing_trigger_output(bool before_put_is_empty)
 			      K_NO_WAIT);
 	}
 }
+#endif
 
+#if defined(CONFIG_TRACING_ASYNC) || defined(CONFIG_TRACING_PER_CPU)
 bool is_tracing_thread(void)
 {
 	return (!k_is_in_isr() && (k_current_get() == tracing_thread_tid));
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2020 Intel corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <sys/cbprintf.h>
+#include <tracing_core.h>
+#include <tracing_buffer.h>
+#include <tracing_format_common.h>
+
+struct str_ctx {
+	tracing_ctx_t ctx;
+	uint8_t buf[CONFIG_TRACING_PACKET_MAX_SIZE];
+};
+
+static int str_put(int c, void *ctx)
+{
+	struct str_ctx *str_ctx = (struct str_ctx *)ctx;
+
+	if (str_ctx->ctx.length < sizeof(str_ctx->buf)) {
+		str_ctx->buf[str_ctx->ctx.length++] = (uint8_t)c;
+	} else {
+		str_ctx->ctx.status = -1;
+	}
+
+	return 0;
+}
+
+static void packet_put(uint8_t *data, uint32_t length)
+{
+	unsigned int key;
+	uint8_t *buf = tracing_cpu_buffer_reserve(length, &key);
+
+	if (buf == NULL) {
+		tracing_packet_drop_handle();
+		return;
+	}
+
+	memcpy(buf, data, length);
+	tracing_cpu_buffer_commit(buf, length, key);
+}
+
+void tracing_format_string(const char *str, ...)
+{
+	struct str_ctx str_ctx = { 0 };
+	va_list args;
+
+	if (!is_tracing_enabled() || is_tracing_thread()) {
+		return;
+	}
+
+	va_start(args, str);
+	(void)cbvprintf(str_put, (void *)&str_ctx, str, args);
+	va_end(args);
+
+	if (str_ctx.ctx.status != 0) {
+		tracing_packet_drop_handle();
+		return;
+	}
+
+	packet_put(str_ctx.buf, str_ctx.ctx.length);
+}
+
+void tracing_format_raw_data(uint8_t *data, uint32_t length)
+{
+	if (!is_tracing_enabled() || is_tracing_thread()) {
+		return;
+	}
+
+	packet_put(data, length);
+}
+
+void tracing_format_data(tracing_data_t *tracing_data_array, uint32_t count)
+{
+	uint32_t length = 0U;
+	uint8_t *buf, *cursor;
+	unsigned int key;
+
+	if (!is_tracing_enabled() || is_tracing_thread()) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		length += tracing_data_array[i].length;
+	}
+
+	buf = tracing_cpu_buffer_reserve(length, &key);
+	if (buf == NULL) {
+		tracing_packet_drop_handle();
+		return;
+	}
+
+	cursor = buf;
+	for (uint32_t i = 0; i < count; i++) {
+		memcpy(cursor, tracing_data_array[i].data,
+		       tracing_data_array[i].length);
+		cursor += tracing_data_array[i].length;
+	}
+
+	tracing_cpu_buffer_commit(buf, length, key);
+}
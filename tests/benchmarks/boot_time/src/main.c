@@ -16,15 +16,55 @@
  */
 
 #include <zephyr.h>
+#include <device.h>
+#include <string.h>
 #include <tc_util.h>
 #include <kernel_internal.h>
 
+#define LOOKUP_ROUNDS 16
+
+#ifdef CONFIG_BOOT_TIME_SLOW_DEVICES
+extern uint32_t slow_devices_ready(void);
+#endif
+
+/* Average cost of looking up every static device by name, the way a
+ * syscall does it: from a copy of the name, so pointer comparison
+ * cannot short-cut the string comparisons.
+ */
+static uint32_t device_lookup_cycles(size_t *count)
+{
+	const struct device *devices;
+	char name[Z_DEVICE_MAX_NAME_LEN];
+	uint32_t start, cycles = 0U;
+	size_t n = z_device_get_all_static(&devices);
+
+	for (int r = 0; r < LOOKUP_ROUNDS; r++) {
+		for (size_t i = 0; i < n; i++) {
+			strncpy(name, devices[i].name, sizeof(name) - 1);
+			name[sizeof(name) - 1] = '\0';
+
+			start = k_cycle_get_32();
+			(void)device_get_binding(name);
+			cycles += k_cycle_get_32() - start;
+		}
+	}
+
+	*count = n;
+	return n == 0 ? 0 : cycles / (n * LOOKUP_ROUNDS);
+}
+
 void main(void)
 {
 	uint32_t task_time_stamp;	/* timestamp at beginning of first task */
 	uint32_t main_us;		/* begin of main timestamp in us */
 	uint32_t task_us;		/* begin of task timestamp in us */
 	uint32_t idle_us;		/* begin of idle timestamp in us */
+	uint32_t lookup_cycles;		/* average device_get_binding() */
+#ifdef CONFIG_BOOT_TIME_SLOW_DEVICES
+	uint32_t ready_time_stamp;	/* slow devices ready timestamp */
+	uint32_t ready_us;		/* slow devices ready in us */
+#endif
+	size_t devices;
 
 	task_time_stamp = k_cycle_get_32();
 
@@ -43,6 +83,15 @@ void main(void)
 					  (uint64_t)z_timestamp_idle,
 					  sys_clock_hw_cycles_per_sec());
 
+#ifdef CONFIG_BOOT_TIME_SLOW_DEVICES
+	ready_time_stamp = slow_devices_ready();
+	ready_us = (uint32_t)ceiling_fraction(USEC_PER_SEC *
+					   (uint64_t)ready_time_stamp,
+					   sys_clock_hw_cycles_per_sec());
+#endif
+
+	lookup_cycles = device_lookup_cycles(&devices);
+
 	TC_START("Boot Time Measurement");
 	TC_PRINT("Boot Result: Clock Frequency: %d Hz\n",
 					  sys_clock_hw_cycles_per_sec());
@@ -52,6 +101,14 @@ void main(void)
 						       task_us);
 	TC_PRINT("_start->idle  : %u cycles, %u us\n", z_timestamp_idle,
 						       idle_us);
+#ifdef CONFIG_BOOT_TIME_SLOW_DEVICES
+	TC_PRINT("_start->ready : %u cycles, %u us (%s)\n", ready_time_stamp,
+		 ready_us, IS_ENABLED(CONFIG_DEVICE_INIT_ASYNC) ?
+		 "async" : "sequential");
+#endif
+	TC_PRINT("device_get_binding(): %zu devices, %u cycles per lookup"
+		 " (%s)\n", devices, lookup_cycles,
+		 IS_ENABLED(CONFIG_DEVICE_NAME_HASH) ? "hashed" : "linear");
 	TC_PRINT("Boot Time Measurement finished\n");
 
 	TC_END_RESULT(TC_PASS);
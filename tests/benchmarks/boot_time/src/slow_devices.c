@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <device.h>
+
+/* Three devices, each blocking SLOW_INIT_MS in its init function.  The
+ * last one depends on the first, so with two or more workers the
+ * asynchronous initialization takes two rounds instead of three.
+ */
+#define SLOW_INIT_MS 10
+
+static int slow_init(const struct device *dev)
+{
+	k_sleep(K_MSEC(SLOW_INIT_MS));
+
+	return 0;
+}
+
+DEVICE_DEFINE(slow_0, "SLOW_0", slow_init, device_pm_control_nop,
+	      NULL, NULL, POST_KERNEL, 60, NULL);
+DEVICE_INIT_ASYNC(slow_0);
+
+DEVICE_DEFINE(slow_1, "SLOW_1", slow_init, device_pm_control_nop,
+	      NULL, NULL, POST_KERNEL, 61, NULL);
+DEVICE_INIT_ASYNC(slow_1);
+
+DEVICE_DEFINE(slow_2, "SLOW_2", slow_init, device_pm_control_nop,
+	      NULL, NULL, POST_KERNEL, 62, NULL);
+DEVICE_INIT_ASYNC(slow_2, "SLOW_0");
+
+/* Returns the cycle count at which all slow devices are ready */
+uint32_t slow_devices_ready(void)
+{
+	static const char * const names[] = { "SLOW_0", "SLOW_1", "SLOW_2" };
+
+	for (int i = 0; i < ARRAY_SIZE(names); i++) {
+		__ASSERT_NO_MSG(device_get_binding(names[i]) != NULL);
+	}
+
+	return k_cycle_get_32();
+}
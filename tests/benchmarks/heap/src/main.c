@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/sys_heap.h>
+#include <timing/timing.h>
+
+/* Small block heap microbenchmark, see README.rst */
+
+#define HEAP_SZ (32 * 1024)
+#define LIFO_BLOCKS 32
+#define LIFO_ROUNDS 100
+#define RANDOM_SLOTS 256
+#define RANDOM_OPS 20000
+
+static const size_t lifo_sizes[] = { 8, 16, 32, 48 };
+
+static char __aligned(8) heapmem[HEAP_SZ];
+static struct sys_heap heap;
+static void *blocks[RANDOM_SLOTS];
+
+K_HEAP_DEFINE(kheap, HEAP_SZ);
+
+/* Same LCRNG as the rbtree test: we need repeatability, not quality */
+static uint32_t next_rand(void)
+{
+	static uint64_t state = 123456789; /* seed */
+
+	state = state * 2862933555777941757ULL + 3037000493ULL;
+
+	return (uint32_t)(state >> 32);
+}
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+static void print_stats(const char *name, struct sys_heap_cache_stats *st)
+{
+	printk("%-8s cache hits %u misses %u flushes %u cached %u bytes\n",
+	       name, st->hits, st->misses, st->flushes,
+	       (uint32_t)st->cached_bytes);
+}
+#endif
+
+static void bench_lifo(size_t sz)
+{
+	uint64_t alloc_cycles = 0, free_cycles = 0;
+	timing_t start, end;
+
+	sys_heap_init(&heap, heapmem, sizeof(heapmem));
+
+	for (int r = 0; r < LIFO_ROUNDS; r++) {
+		start = timing_counter_get();
+		for (int i = 0; i < LIFO_BLOCKS; i++) {
+			blocks[i] = sys_heap_alloc(&heap, sz);
+		}
+		end = timing_counter_get();
+		alloc_cycles += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		for (int i = LIFO_BLOCKS - 1; i >= 0; i--) {
+			sys_heap_free(&heap, blocks[i]);
+		}
+		end = timing_counter_get();
+		free_cycles += timing_cycles_get(&start, &end);
+	}
+
+	printk("lifo   %3u bytes: alloc %5u free %5u cycles (%u / %u ns)\n",
+	       (uint32_t)sz,
+	       (uint32_t)(alloc_cycles / (LIFO_ROUNDS * LIFO_BLOCKS)),
+	       (uint32_t)(free_cycles / (LIFO_ROUNDS * LIFO_BLOCKS)),
+	       (uint32_t)timing_cycles_to_ns_avg(alloc_cycles,
+						 LIFO_ROUNDS * LIFO_BLOCKS),
+	       (uint32_t)timing_cycles_to_ns_avg(free_cycles,
+						 LIFO_ROUNDS * LIFO_BLOCKS));
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+	struct sys_heap_cache_stats st;
+
+	sys_heap_cache_stats_get(&heap, &st);
+	print_stats("lifo", &st);
+#endif
+}
+
+static void bench_random(void)
+{
+	uint64_t alloc_cycles = 0, free_cycles = 0;
+	uint32_t allocs = 0, frees = 0, failed = 0;
+	timing_t start, end;
+
+	sys_heap_init(&heap, heapmem, sizeof(heapmem));
+	(void)memset(blocks, 0, sizeof(blocks));
+
+	for (int i = 0; i < RANDOM_OPS; i++) {
+		int slot = next_rand() % RANDOM_SLOTS;
+
+		if (blocks[slot] != NULL) {
+			start = timing_counter_get();
+			sys_heap_free(&heap, blocks[slot]);
+			end = timing_counter_get();
+			free_cycles += timing_cycles_get(&start, &end);
+			blocks[slot] = NULL;
+			frees++;
+		} else {
+			size_t sz = 8 + next_rand() % 57;
+
+			start = timing_counter_get();
+			blocks[slot] = sys_heap_alloc(&heap, sz);
+			end = timing_counter_get();
+			alloc_cycles += timing_cycles_get(&start, &end);
+			allocs++;
+			failed += blocks[slot] == NULL;
+		}
+	}
+
+	printk("random 8-64 bytes: alloc %5u free %5u cycles (%u / %u ns),"
+	       " %u failed\n",
+	       (uint32_t)(alloc_cycles / allocs),
+	       (uint32_t)(free_cycles / frees),
+	       (uint32_t)timing_cycles_to_ns_avg(alloc_cycles, allocs),
+	       (uint32_t)timing_cycles_to_ns_avg(free_cycles, frees),
+	       failed);
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+	struct sys_heap_cache_stats st;
+
+	sys_heap_cache_stats_get(&heap, &st);
+	print_stats("random", &st);
+#endif
+}
+
+static void bench_k_heap(size_t sz)
+{
+	uint64_t alloc_cycles = 0, free_cycles = 0;
+	timing_t start, end;
+
+	for (int r = 0; r < LIFO_ROUNDS; r++) {
+		start = timing_counter_get();
+		for (int i = 0; i < LIFO_BLOCKS; i++) {
+			blocks[i] = k_heap_alloc(&kheap, sz, K_NO_WAIT);
+		}
+		end = timing_counter_get();
+		alloc_cycles += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		for (int i = LIFO_BLOCKS - 1; i >= 0; i--) {
+			k_heap_free(&kheap, blocks[i]);
+		}
+		end = timing_counter_get();
+		free_cycles += timing_cycles_get(&start, &end);
+	}
+
+	printk("k_heap %3u bytes: alloc %5u free %5u cycles (%u / %u ns)\n",
+	       (uint32_t)sz,
+	       (uint32_t)(alloc_cycles / (LIFO_ROUNDS * LIFO_BLOCKS)),
+	       (uint32_t)(free_cycles / (LIFO_ROUNDS * LIFO_BLOCKS)),
+	       (uint32_t)timing_cycles_to_ns_avg(alloc_cycles,
+						 LIFO_ROUNDS * LIFO_BLOCKS),
+	       (uint32_t)timing_cycles_to_ns_avg(free_cycles,
+						 LIFO_ROUNDS * LIFO_BLOCKS));
+
+#ifdef CONFIG_SYS_HEAP_CACHE
+	struct sys_heap_cache_stats st;
+
+	k_heap_cache_stats_get(&kheap, &st);
+	print_stats("k_heap", &st);
+#endif
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+
+	printk("Heap benchmark (%s)\n",
+	       IS_ENABLED(CONFIG_SYS_HEAP_CACHE_PER_CPU) ?
+	       "size class caches, per-CPU magazines" :
+	       IS_ENABLED(CONFIG_SYS_HEAP_CACHE) ? "size class caches" :
+	       "plain");
+
+	for (int i = 0; i < ARRAY_SIZE(lifo_sizes); i++) {
+		bench_lifo(lifo_sizes[i]);
+	}
+
+	bench_random();
+
+	for (int i = 0; i < ARRAY_SIZE(lifo_sizes); i++) {
+		bench_k_heap(lifo_sizes[i]);
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -23,6 +23,9 @@ extern void int_to_thread(void);
 extern void int_to_thread_evt(void);
 extern void sema_test_signal(void);
 extern void mutex_lock_unlock(void);
+extern int msgq_batch(void);
+extern int pipe_claim(void);
+extern int read_mostly(void);
 extern int coop_ctx_switch(void);
 extern int sema_test(void);
 extern int sema_context_switch(void);
@@ -57,6 +60,12 @@ void test_thread(void *arg1, void *arg2, void *arg3)
 
 	mutex_lock_unlock();
 
+	msgq_batch();
+
+	pipe_claim();
+
+	read_mostly();
+
 	TC_END_REPORT(error_count);
 }
 
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <timing/timing.h>
+#include <string.h>
+#include "utils.h"
+
+/* size of a message, e.g. a timestamped sensor sample */
+#define MSG_SIZE 16
+/* messages moved per round, the whole queue */
+#define N_MSGS 32
+/* the number of rounds */
+#define N_ROUNDS 32
+
+K_MSGQ_DEFINE(bench_msgq, MSG_SIZE, N_MSGS, 4);
+
+static uint32_t msgs[N_MSGS][MSG_SIZE / sizeof(uint32_t)];
+
+/**
+ *
+ * @brief Test for the message queue put/get time
+ *
+ * The routine fills and drains a message queue, one message per call,
+ * with one call per batch and by claiming slots in place, and reports
+ * the average cost of moving one message in and out of the queue.
+ *
+ * @return 0 on success
+ */
+int msgq_batch(void)
+{
+	uint32_t single = 0, batch = 0, claim = 0;
+	timing_t start, end;
+	void *slot;
+
+	timing_start();
+
+	for (int r = 0; r < N_ROUNDS; r++) {
+		start = timing_counter_get();
+		for (int i = 0; i < N_MSGS; i++) {
+			(void)k_msgq_put(&bench_msgq, msgs[i], K_NO_WAIT);
+		}
+		for (int i = 0; i < N_MSGS; i++) {
+			(void)k_msgq_get(&bench_msgq, msgs[i], K_NO_WAIT);
+		}
+		end = timing_counter_get();
+		single += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		(void)k_msgq_put_batch(&bench_msgq, msgs, N_MSGS, K_NO_WAIT);
+		(void)k_msgq_get_batch(&bench_msgq, msgs, N_MSGS, K_NO_WAIT);
+		end = timing_counter_get();
+		batch += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		for (int i = 0; i < N_MSGS; i++) {
+			(void)k_msgq_put_claim(&bench_msgq, &slot, K_NO_WAIT);
+			((uint32_t *)slot)[0] = i;
+			(void)k_msgq_put_commit(&bench_msgq);
+		}
+		for (int i = 0; i < N_MSGS; i++) {
+			(void)k_msgq_get_claim(&bench_msgq, &slot, K_NO_WAIT);
+			msgs[i][0] = ((uint32_t *)slot)[0];
+			(void)k_msgq_get_commit(&bench_msgq);
+		}
+		end = timing_counter_get();
+		claim += timing_cycles_get(&start, &end);
+	}
+
+	PRINT_STATS_AVG("Average time to put and get a message", single,
+			N_MSGS * N_ROUNDS);
+	PRINT_STATS_AVG("Average time to put and get a message in a batch",
+			batch, N_MSGS * N_ROUNDS);
+	PRINT_STATS_AVG("Average time to claim, commit a message both ways",
+			claim, N_MSGS * N_ROUNDS);
+
+	timing_stop();
+	return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <timing/timing.h>
+#include "utils.h"
+
+/* the largest chunk, 16 KiB (e.g. a camera line) on boards with the RAM */
+#define MAX_CHUNK CONFIG_BENCHMARK_PIPE_MAX_CHUNK
+/* the number of rounds per chunk size */
+#define N_ROUNDS 16
+
+K_PIPE_DEFINE(bench_pipe, MAX_CHUNK, 4);
+
+/* where the producer builds, and the consumer takes, the copied data */
+static uint8_t staging[MAX_CHUNK];
+
+static const size_t chunk_sizes[] = {
+	64, 1024,
+#if MAX_CHUNK > 1024
+	MAX_CHUNK,
+#endif
+};
+
+/* reads every byte, standing in for a consumer of the data */
+static uint32_t checksum(const uint8_t *data, size_t len)
+{
+	uint32_t sum = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		sum += data[i];
+	}
+	return sum;
+}
+
+/**
+ *
+ * @brief Test for the pipe put/get time
+ *
+ * The routine passes chunks of 64 B, 1 KiB and, if larger, of
+ * CONFIG_BENCHMARK_PIPE_MAX_CHUNK bytes through a pipe, copying them in
+ * and out, then by claiming regions of the pipe buffer in place, and
+ * reports the average cost of moving one chunk.  Both ways
+ * include writing the chunk and reading it back, from the staging
+ * buffer when copying and from the pipe buffer when claiming, so the
+ * difference is the cost of the copies.
+ *
+ * @return 0 on success
+ */
+int pipe_claim(void)
+{
+	char label[64];
+	timing_t start, end;
+	size_t chunk, bytes;
+	void *region;
+	volatile uint32_t sum = 0;
+
+	timing_start();
+
+	for (int s = 0; s < ARRAY_SIZE(chunk_sizes); s++) {
+		uint32_t copy = 0, claim = 0;
+
+		chunk = chunk_sizes[s];
+
+		for (int r = 0; r < N_ROUNDS; r++) {
+			start = timing_counter_get();
+			(void)memset(staging, r, chunk);
+			(void)k_pipe_put(&bench_pipe, staging, chunk, &bytes,
+					 chunk, K_NO_WAIT);
+			(void)k_pipe_get(&bench_pipe, staging, chunk, &bytes,
+					 chunk, K_NO_WAIT);
+			sum += checksum(staging, bytes);
+			end = timing_counter_get();
+			copy += timing_cycles_get(&start, &end);
+
+			start = timing_counter_get();
+			bytes = chunk;
+			(void)k_pipe_put_claim(&bench_pipe, &region, &bytes,
+					       K_NO_WAIT);
+			(void)memset(region, r, bytes);
+			(void)k_pipe_put_commit(&bench_pipe, bytes);
+			bytes = chunk;
+			(void)k_pipe_get_claim(&bench_pipe, &region, &bytes,
+					       K_NO_WAIT);
+			sum += checksum(region, bytes);
+			(void)k_pipe_get_release(&bench_pipe, bytes);
+			end = timing_counter_get();
+			claim += timing_cycles_get(&start, &end);
+		}
+
+		snprintk(label, sizeof(label),
+			 "Average time to put and get a %u byte chunk",
+			 (uint32_t)chunk);
+		PRINT_STATS_AVG(label, copy, N_ROUNDS);
+		snprintk(label, sizeof(label),
+			 "Average time to claim, commit a %u byte chunk",
+			 (uint32_t)chunk);
+		PRINT_STATS_AVG(label, claim, N_ROUNDS);
+	}
+
+	timing_stop();
+	return 0;
+}
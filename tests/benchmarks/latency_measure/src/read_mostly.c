@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <timing/timing.h>
+#include <sys/seqlock.h>
+#include <sys/rcu.h>
+#include "utils.h"
+
+/* the number of rounds */
+#define N_ROUNDS 64
+
+static struct k_spinlock stamp_lock;
+static SYS_SEQLOCK_DEFINE(stamp_seqlock);
+
+/* a value too wide to be read atomically, e.g. a 64-bit timestamp
+ * with its sequence number
+ */
+static struct {
+	uint64_t time;
+	uint32_t seq;
+} stamp;
+
+static void count_thread(const struct k_thread *thread, void *user_data)
+{
+	(*(uint32_t *)user_data)++;
+}
+
+/**
+ *
+ * @brief Test for the read-side cost of read-mostly data
+ *
+ * The routine reads a timestamp protected by a spinlock, then by a
+ * sequence lock, walks the list of threads with k_thread_foreach() and
+ * with k_thread_foreach_unlocked(), which uses read-copy-update, and
+ * reports the average cost of each.  Readers of the sequence lock and
+ * of read-copy-update don't write to memory shared with other CPUs,
+ * unlike spinlock holders, so the difference grows on SMP.
+ *
+ * @return 0 on success
+ */
+int read_mostly(void)
+{
+	uint32_t locked = 0, seq_read = 0, foreach = 0, unlocked = 0;
+	uint32_t threads = 0, seq;
+	timing_t start, end;
+	uint64_t time;
+
+	timing_start();
+
+	for (int r = 0; r < N_ROUNDS; r++) {
+		start = timing_counter_get();
+		k_spinlock_key_t key = k_spin_lock(&stamp_lock);
+
+		time = stamp.time;
+		k_spin_unlock(&stamp_lock, key);
+		end = timing_counter_get();
+		locked += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		do {
+			seq = sys_seqlock_read_begin(&stamp_seqlock);
+			time = stamp.time;
+		} while (sys_seqlock_read_retry(&stamp_seqlock, seq));
+		end = timing_counter_get();
+		seq_read += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		k_thread_foreach(count_thread, &threads);
+		end = timing_counter_get();
+		foreach += timing_cycles_get(&start, &end);
+
+		start = timing_counter_get();
+		k_thread_foreach_unlocked(count_thread, &threads);
+		end = timing_counter_get();
+		unlocked += timing_cycles_get(&start, &end);
+	}
+	ARG_UNUSED(time);
+
+	PRINT_STATS_AVG("Average time to read a value under a spinlock",
+			locked, N_ROUNDS);
+	PRINT_STATS_AVG("Average time to read a value under a seqlock",
+			seq_read, N_ROUNDS);
+	PRINT_STATS_AVG("Average time to walk the threads, locked",
+			foreach, N_ROUNDS);
+	PRINT_STATS_AVG("Average time to walk the threads, RCU",
+			unlocked, N_ROUNDS);
+
+	timing_stop();
+	return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This is a mutex handoff microbenchmark for SMP.  Main and a partner
+ * thread, running on different CPUs, take turns with a mutex: each
+ * locks it, holds it for crit_us[] microseconds, unlocks it and works
+ * outside of it for OUTSIDE_US, N_RUNS times.  When a thread asked for
+ * the mutex before the other unlocked it, the time between that unlock
+ * and the return from k_mutex_lock() is a handoff, and the average
+ * handoff is reported for each critical section length.
+ *
+ * Run it with and without CONFIG_MUTEX_ADAPTIVE_SPIN to compare
+ * spinning on a mutex owned by a running thread with pending on it.
+ */
+
+#define N_RUNS 2000
+#define OUTSIDE_US 1
+#define STACK_SIZE 1024
+
+static const uint32_t crit_us[] = { 1, 5, 20 };
+
+static K_THREAD_STACK_DEFINE(partner_stack, STACK_SIZE);
+static struct k_thread partner_thread;
+
+static K_MUTEX_DEFINE(bench_mutex);
+
+/* cycle count at the last unlock, written with the mutex held */
+static volatile uint32_t unlock_stamp;
+
+static uint64_t handoff_cycles;
+static uint32_t handoffs;
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	uint32_t crit = POINTER_TO_UINT(p1);
+
+	for (int i = 0; i < N_RUNS; i++) {
+		uint32_t asked = k_cycle_get_32();
+
+		k_mutex_lock(&bench_mutex, K_FOREVER);
+
+		uint32_t now = k_cycle_get_32();
+
+		/* the mutex was released after we asked for it */
+		if ((int32_t)(unlock_stamp - asked) > 0) {
+			handoff_cycles += now - unlock_stamp;
+			handoffs++;
+		}
+
+		k_busy_wait(crit);
+		unlock_stamp = k_cycle_get_32();
+		k_mutex_unlock(&bench_mutex);
+
+		k_busy_wait(OUTSIDE_US);
+	}
+}
+
+void main(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+
+	for (int i = 0; i < ARRAY_SIZE(crit_us); i++) {
+		void *crit = UINT_TO_POINTER(crit_us[i]);
+		uint32_t avg;
+
+		handoff_cycles = 0;
+		handoffs = 0;
+
+		k_thread_create(&partner_thread, partner_stack,
+				K_THREAD_STACK_SIZEOF(partner_stack), worker,
+				crit, NULL, NULL, prio, 0, K_NO_WAIT);
+		worker(crit, NULL, NULL);
+		k_thread_join(&partner_thread, K_FOREVER);
+
+		avg = handoffs ? (uint32_t)(handoff_cycles / handoffs) : 0;
+		printk("crit %2u us handoffs %5u avg %6u cycles (%u ns)\n",
+		       crit_us[i], handoffs, avg,
+		       (uint32_t)k_cyc_to_ns_floor64(avg));
+	}
+
+	printk("fin\n");
+}
@@ -32,6 +32,28 @@
 #define N_RUNS 1000
 #define N_SETTLE 10
 
+/* On SMP a second phase measures context switch throughput as the
+ * number of busy CPUs grows: for each P from 1 to CONFIG_MP_NUM_CPUS,
+ * P independent pairs of threads ping-pong a pair of semaphores for
+ * SMP_RUN_MS while main sleeps at a higher priority.  Only one thread
+ * of each pair is ever runnable, so P pairs keep (at most) P CPUs
+ * busy, and with a scheduler that scales the switches per second
+ * should grow linearly with P.
+ */
+#define SMP_RUN_MS 1000
+
+/* With CONFIG_SCHED_DEADLINE a third phase measures how the ready
+ * queue copes with many threads sharing one priority: for each count
+ * in dl_counts[], that many threads are made ready at a priority
+ * below main's, so they sit in the ready queue without running, and
+ * the average cost of k_thread_deadline_set() on them (a removal and
+ * reinsertion in the ready queue) is reported.  Main then sleeps so
+ * that every thread runs once, in deadline order, and the average
+ * cost per switch of draining the queue is reported too.  Run with
+ * the different SCHED_* backends to compare them.
+ */
+#define MAX_DL_THREADS 200
+
 
 static K_THREAD_STACK_DEFINE(partner_stack, 1024);
 static struct k_thread partner_thread;
@@ -49,7 +71,7 @@ enum {
 
 uint32_t stamps[NUM_STAMP_STATES];
 
-static inline int _stamp(int state)
+static inline uint32_t cycles(void)
 {
 	uint32_t t;
 
@@ -63,6 +85,13 @@ static inline int _stamp(int state)
 	t = k_cycle_get_32();
 #endif
 
+	return t;
+}
+
+static inline int _stamp(int state)
+{
+	uint32_t t = cycles();
+
 	stamps[state] = t;
 	return t;
 }
@@ -86,6 +115,129 @@ static void partner_fn(void *arg1, void *arg2, void *arg3)
 	}
 }
 
+#ifdef CONFIG_SMP
+#define MAX_PAIRS CONFIG_MP_NUM_CPUS
+
+static K_THREAD_STACK_ARRAY_DEFINE(pair_stacks, 2 * MAX_PAIRS, 1024);
+static struct k_thread pair_threads[2 * MAX_PAIRS];
+static struct k_sem pair_sems[2 * MAX_PAIRS];
+static volatile uint32_t pair_switches[MAX_PAIRS];
+
+static void pair_fn(void *arg1, void *arg2, void *arg3)
+{
+	int idx = POINTER_TO_INT(arg1);
+	int pair = idx / 2;
+	struct k_sem *mine = &pair_sems[idx];
+	struct k_sem *other = &pair_sems[idx ^ 1];
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		k_sem_take(mine, K_FOREVER);
+		pair_switches[pair]++;
+		k_sem_give(other);
+	}
+}
+
+static void smp_throughput(int prio)
+{
+	for (int pairs = 1; pairs <= MAX_PAIRS; pairs++) {
+		uint32_t total = 0U;
+		int64_t start, elapsed;
+
+		for (int i = 0; i < 2 * pairs; i++) {
+			k_sem_init(&pair_sems[i], 0, 1);
+			pair_switches[i / 2] = 0U;
+			k_thread_create(&pair_threads[i], pair_stacks[i],
+					K_THREAD_STACK_SIZEOF(pair_stacks[i]),
+					pair_fn, INT_TO_POINTER(i), NULL, NULL,
+					prio, 0, K_NO_WAIT);
+		}
+
+		start = k_uptime_get();
+		for (int i = 0; i < pairs; i++) {
+			k_sem_give(&pair_sems[2 * i]);
+		}
+		k_sleep(K_MSEC(SMP_RUN_MS));
+
+		for (int i = 0; i < pairs; i++) {
+			total += pair_switches[i];
+		}
+		elapsed = k_uptime_get() - start;
+
+		for (int i = 0; i < 2 * pairs; i++) {
+			k_thread_abort(&pair_threads[i]);
+		}
+
+		printk("smp pairs %2d switches %8u (%u/s)\n", pairs, total,
+		       (uint32_t)((uint64_t)total * 1000U / MAX(elapsed, 1)));
+	}
+}
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE
+static K_THREAD_STACK_ARRAY_DEFINE(dl_stacks, MAX_DL_THREADS, 512);
+static struct k_thread dl_threads[MAX_DL_THREADS];
+static const int dl_counts[] = { 10, 50, MAX_DL_THREADS };
+static volatile int dl_ran;
+static uint32_t dl_last;
+
+/* Same LCRNG as the rbtree test: we need repeatability, not quality */
+static uint32_t next_rand(void)
+{
+	static uint64_t state = 123456789; /* seed */
+
+	state = state * 2862933555777941757ULL + 3037000493ULL;
+
+	return (uint32_t)(state >> 32);
+}
+
+static void dl_fn(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	dl_ran++;
+	dl_last = cycles();
+}
+
+static void deadline_sched(int prio)
+{
+	for (int i = 0; i < ARRAY_SIZE(dl_counts); i++) {
+		int n = dl_counts[i];
+		uint32_t start, set, drain;
+
+		dl_ran = 0;
+		for (int j = 0; j < n; j++) {
+			k_thread_create(&dl_threads[j], dl_stacks[j],
+					K_THREAD_STACK_SIZEOF(dl_stacks[j]),
+					dl_fn, NULL, NULL, NULL,
+					prio, 0, K_NO_WAIT);
+		}
+
+		start = cycles();
+		for (int j = 0; j < n; j++) {
+			k_thread_deadline_set(&dl_threads[j],
+					      1000000 + next_rand() % 1000000);
+		}
+		set = cycles() - start;
+
+		start = cycles();
+		k_sleep(K_MSEC(100));
+		drain = dl_last - start;
+
+		printk("deadline threads %3d set %5u drain %5u (%d ran)\n",
+		       n, set / n, drain / n, dl_ran);
+
+		for (int j = 0; j < n; j++) {
+			k_thread_join(&dl_threads[j], K_FOREVER);
+		}
+	}
+}
+#endif
+
 void main(void)
 {
 	z_waitq_init(&waitq);
@@ -148,5 +300,13 @@ void main(void)
 		       stamps[4] - stamps[3],
 		       whole, avg);
 	}
+
+#ifdef CONFIG_SCHED_DEADLINE
+	deadline_sched(main_prio + 1);
+#endif
+
+#ifdef CONFIG_SMP
+	smp_throughput(main_prio + 1);
+#endif
 	printk("fin\n");
 }
@@ -9,6 +9,9 @@
 
 #include "syskernel.h"
 
+/* elements put at once by the burst test, must divide number_of_loops */
+#define BURST 10
+
 struct k_fifo fifo1;
 struct k_fifo fifo2;
 
@@ -28,6 +31,25 @@ void fifo_test_init(void)
 }
 
 
+/**
+ *
+ * @brief Initialize FIFOs read by a single thread for the test
+ *
+ * With CONFIG_FIFO_MPSC the FIFOs are initialized with k_fifo_init_mpsc().
+ *
+ * @return N/A
+ */
+static void fifo_test_init_single_consumer(void)
+{
+#ifdef CONFIG_FIFO_MPSC
+	k_fifo_init_mpsc(&fifo1);
+	k_fifo_init_mpsc(&fifo2);
+#else
+	fifo_test_init();
+#endif
+}
+
+
 /**
  *
  * @brief Fifo test thread
@@ -130,6 +152,35 @@ void fifo_thread3(void *par1, void *par2, void *par3)
 }
 
 
+/**
+ *
+ * @brief Put and get bursts of elements without context switches
+ *
+ * @return Number of elements which went through fifo1 in order
+ */
+static int fifo_burst(void)
+{
+	static intptr_t elements[BURST][2];
+	intptr_t *pelement;
+	int i, j;
+
+	for (i = 0; i < number_of_loops; i += BURST) {
+		for (j = 0; j < BURST; j++) {
+			elements[j][1] = i + j;
+			k_fifo_put(&fifo1, elements[j]);
+		}
+		for (j = 0; j < BURST; j++) {
+			pelement = k_fifo_get(&fifo1, K_NO_WAIT);
+			if (pelement == NULL || pelement[1] != i + j) {
+				return i + j;
+			}
+		}
+	}
+
+	return i;
+}
+
+
 /**
  *
  * @brief The main test entry
@@ -155,7 +206,7 @@ int fifo_test(void)
 			"\n\tk_fifo_put");
 	printf(sz_test_start_fmt);
 
-	fifo_test_init();
+	fifo_test_init_single_consumer();
 
 	t = BENCH_START();
 
@@ -186,7 +237,7 @@ int fifo_test(void)
 			"\n\tk_yield");
 	printf(sz_test_start_fmt);
 
-	fifo_test_init();
+	fifo_test_init_single_consumer();
 
 	t = BENCH_START();
 
@@ -255,5 +306,28 @@ int fifo_test(void)
 		k_fifo_put(&sync_fifo, element);
 	}
 
+	/* test put & get functions without waiting, in a single thread */
+	fprintf(output_file, sz_test_case_fmt,
+			"FIFO #4");
+	fprintf(output_file, sz_description,
+#ifdef CONFIG_FIFO_MPSC
+			"\n\tk_fifo_init_mpsc"
+#else
+			"\n\tk_fifo_init"
+#endif
+			"\n\tk_fifo_put"
+			"\n\tk_fifo_get(K_NO_WAIT)");
+	printf(sz_test_start_fmt);
+
+	fifo_test_init_single_consumer();
+
+	t = BENCH_START();
+
+	i = fifo_burst();
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	return_value += check_result(i, t);
+
 	return return_value;
 }
@@ -167,8 +167,8 @@ void main(void)
 		test_result += stack_test();
 
 		if (test_result) {
-			/* sema/lifo/fifo/stack account for 12 tests in total */
-			if (test_result == 12) {
+			/* sema/lifo/fifo/stack account for 13 tests in total */
+			if (test_result == 13) {
 				fprintf(output_file, sz_module_result_fmt,
 					sz_success);
 			} else {
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+#include <timing/timing.h>
+
+/* Timeout queue microbenchmark.  For each queue size N it measures,
+ * directly on the internal z_add_timeout()/z_abort_timeout() API so
+ * that no k_timer or scheduler overhead is included:
+ *
+ * 1. The average cost of inserting N timeouts with expiry times
+ *    spread randomly over 10*N ticks in the future
+ * 2. The average cost of aborting all of them again
+ * 3. The average cost of expiring a timeout: N timeouts are queued
+ *    to expire randomly over the next EXPIRE_SPREAD ticks, and the
+ *    gap between consecutive callbacks that expire on the same tick
+ *    (i.e. within one z_clock_announce() pass) is accumulated.  That
+ *    gap covers the removal from the queue plus the dispatch.
+ */
+
+#define MAX_TIMEOUTS 10000
+#define EXPIRE_SPREAD 8
+
+struct bench_timeout {
+	struct _timeout to;
+	int64_t tick;
+};
+
+static struct bench_timeout timeouts[MAX_TIMEOUTS];
+
+static const int sizes[] = { 10, 100, 1000, MAX_TIMEOUTS };
+
+static volatile int expired;
+static int64_t last_tick;
+static timing_t last_stamp;
+static uint64_t expire_cycles;
+static uint32_t expire_count;
+
+/* Same LCRNG as the rbtree test: we need repeatability, not quality */
+static uint32_t next_rand(void)
+{
+	static uint64_t state = 123456789; /* seed */
+
+	state = state * 2862933555777941757ULL + 3037000493ULL;
+
+	return (uint32_t)(state >> 32);
+}
+
+static void idle_handler(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+}
+
+static void expire_handler(struct _timeout *t)
+{
+	struct bench_timeout *bt = CONTAINER_OF(t, struct bench_timeout, to);
+	timing_t now = timing_counter_get();
+
+	/* The first expiry of each tick also pays for the timer
+	 * interrupt, so only count gaps within a single announce.
+	 */
+	if (expired != 0 && bt->tick == last_tick) {
+		expire_cycles += timing_cycles_get(&last_stamp, &now);
+		expire_count++;
+	}
+
+	last_tick = bt->tick;
+	expired++;
+	last_stamp = timing_counter_get();
+}
+
+static uint64_t bench_insert(int n)
+{
+	timing_t start, end;
+
+	start = timing_counter_get();
+	for (int i = 0; i < n; i++) {
+		k_ticks_t dt = 1000 + (next_rand() % (10 * n));
+
+		z_add_timeout(&timeouts[i].to, idle_handler, K_TICKS(dt));
+	}
+	end = timing_counter_get();
+
+	return timing_cycles_get(&start, &end);
+}
+
+static uint64_t bench_abort(int n)
+{
+	timing_t start, end;
+
+	start = timing_counter_get();
+	for (int i = 0; i < n; i++) {
+		z_abort_timeout(&timeouts[i].to);
+	}
+	end = timing_counter_get();
+
+	return timing_cycles_get(&start, &end);
+}
+
+static uint64_t bench_expire(int n)
+{
+	unsigned int key;
+	int64_t base;
+
+	expired = 0;
+	expire_cycles = 0;
+	expire_count = 0;
+
+	/* Queue everything with interrupts masked so that no timeout
+	 * can fire before all of them are in place
+	 */
+	key = irq_lock();
+	base = k_uptime_ticks() + 1;
+	for (int i = 0; i < n; i++) {
+		timeouts[i].tick = base + (next_rand() % EXPIRE_SPREAD);
+		z_add_timeout(&timeouts[i].to, expire_handler,
+			      K_TIMEOUT_ABS_TICKS(timeouts[i].tick));
+	}
+	irq_unlock(key);
+
+	while (expired < n) {
+		k_sleep(K_TICKS(EXPIRE_SPREAD));
+	}
+
+	return expire_count == 0 ? 0 : expire_cycles / expire_count;
+}
+
+void main(void)
+{
+	timing_init();
+	timing_start();
+
+	printk("Timeout queue benchmark (%s)\n",
+	       IS_ENABLED(CONFIG_TIMEOUT_QUEUE_PHEAP) ? "pairing heap"
+						      : "delta list");
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		int n = sizes[i];
+		uint64_t ins = bench_insert(n);
+		uint64_t abt = bench_abort(n);
+		uint64_t exp = bench_expire(n);
+
+		printk("timeouts %5d insert %6u abort %6u expire %6u cycles"
+		       " (%u / %u / %u ns)\n", n,
+		       (uint32_t)(ins / n), (uint32_t)(abt / n),
+		       (uint32_t)exp,
+		       (uint32_t)timing_cycles_to_ns_avg(ins, n),
+		       (uint32_t)timing_cycles_to_ns_avg(abt, n),
+		       (uint32_t)timing_cycles_to_ns(exp));
+	}
+
+	timing_stop();
+	printk("fin\n");
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <ztest.h>
+
+#define ASYNC_SLOW	"async_slow"
+#define ASYNC_DEPENDENT	"async_dependent"
+#define ASYNC_LAZY	"async_lazy"
+
+static volatile bool slow_done;
+static volatile bool dependent_saw_slow;
+static volatile int lazy_inits;
+
+static int async_slow_init(const struct device *dev)
+{
+	/* Stands for a device waiting on hardware, e.g. a PHY */
+	k_sleep(K_MSEC(50));
+	slow_done = true;
+
+	return 0;
+}
+
+static int async_dependent_init(const struct device *dev)
+{
+	dependent_saw_slow = slow_done;
+
+	return 0;
+}
+
+static int async_lazy_init(const struct device *dev)
+{
+	lazy_inits++;
+
+	return 0;
+}
+
+DEVICE_DEFINE(async_slow, ASYNC_SLOW, async_slow_init,
+	      device_pm_control_nop, NULL, NULL, POST_KERNEL, 50, NULL);
+DEVICE_INIT_ASYNC(async_slow);
+
+DEVICE_DEFINE(async_dependent, ASYNC_DEPENDENT, async_dependent_init,
+	      device_pm_control_nop, NULL, NULL, POST_KERNEL, 51, NULL);
+DEVICE_INIT_ASYNC(async_dependent, ASYNC_SLOW);
+
+DEVICE_DEFINE(async_lazy, ASYNC_LAZY, async_lazy_init,
+	      device_pm_control_nop, NULL, NULL, APPLICATION, 50, NULL);
+DEVICE_INIT_DEFERRED(async_lazy);
+
+/**
+ * @brief Test concurrent and deferred device initialization
+ *
+ * @details Look up devices marked with DEVICE_INIT_ASYNC() and
+ * DEVICE_INIT_DEFERRED() and check they are initialized once, and
+ * after the devices they depend on.  With CONFIG_DEVICE_INIT_ASYNC
+ * the deferred device must not be initialized before its first
+ * lookup; without it all of them are initialized in sequence.
+ *
+ * @ingroup kernel_device_tests
+ */
+void test_device_init_async(void)
+{
+	const struct device *dev;
+
+	dev = device_get_binding(ASYNC_DEPENDENT);
+	zassert_not_null(dev, "dependent device not found");
+	zassert_true(dependent_saw_slow,
+		     "dependent initialized before its dependency");
+	zassert_true(slow_done, NULL);
+
+	dev = device_get_binding(ASYNC_SLOW);
+	zassert_not_null(dev, "slow device not found");
+	zassert_true(device_is_ready(dev), NULL);
+
+	if (IS_ENABLED(CONFIG_DEVICE_INIT_ASYNC)) {
+		zassert_equal(lazy_inits, 0, "deferred device initialized");
+		zassert_false(device_is_ready(DEVICE_GET(async_lazy)),
+			      "deferred device ready before first use");
+	}
+
+	dev = device_get_binding(ASYNC_LAZY);
+	zassert_not_null(dev, "deferred device not found");
+	zassert_true(device_is_ready(dev), NULL);
+	zassert_equal(lazy_inits, 1, "deferred device initialized %d times",
+		      lazy_inits);
+
+	(void)device_get_binding(ASYNC_LAZY);
+	zassert_equal(lazy_inits, 1, NULL);
+}
@@ -11,6 +11,7 @@
  *
  * - API coverage
  *   -# k_fifo_init K_FIFO_DEFINE
+ *   -# k_fifo_init_mpsc K_FIFO_MPSC_DEFINE
  *   -# k_fifo_put k_fifo_put_list k_fifo_put_slist
  *   -# k_fifo_get *
  *
@@ -29,6 +30,7 @@ extern void test_fifo_loop(void);
 extern void test_fifo_cancel_wait(void);
 extern void test_fifo_is_empty_thread(void);
 extern void test_fifo_is_empty_isr(void);
+extern void test_fifo_mpsc(void);
 
 /*test case main entry*/
 void test_main(void)
@@ -41,6 +43,7 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_fifo_loop),
 			 ztest_1cpu_unit_test(test_fifo_cancel_wait),
 			 ztest_unit_test(test_fifo_is_empty_thread),
-			 ztest_unit_test(test_fifo_is_empty_isr));
+			 ztest_unit_test(test_fifo_is_empty_isr),
+			 ztest_1cpu_unit_test(test_fifo_mpsc));
 	ztest_run_test_suite(fifo_api);
 }
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_fifo.h"
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define LIST_LEN 2
+#define PRODUCERS 3
+#define ITEMS 200
+
+#ifdef CONFIG_FIFO_MPSC
+
+/**TESTPOINT: init via K_FIFO_MPSC_DEFINE*/
+K_FIFO_MPSC_DEFINE(kfifo_mpsc);
+
+static struct k_fifo fifo_mpsc;
+static fdata_t data[LIST_LEN];
+static fdata_t data_l[LIST_LEN];
+static fdata_t data_sl[LIST_LEN];
+static fdata_t data_a;
+
+struct item {
+	sys_snode_t snode;
+	uint32_t id;
+	uint32_t seq;
+};
+
+static struct item items[PRODUCERS + 1][ITEMS];
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstacks, PRODUCERS, STACK_SIZE);
+static struct k_thread tdata[PRODUCERS];
+
+static void tfifo_put_get(struct k_fifo *pfifo)
+{
+	static fdata_t *head = &data_l[0], *tail = &data_l[LIST_LEN - 1];
+	sys_slist_t slist;
+
+	zassert_true(k_fifo_is_empty(pfifo), NULL);
+	zassert_is_null(k_fifo_peek_head(pfifo), NULL);
+	zassert_is_null(k_fifo_peek_tail(pfifo), NULL);
+	zassert_is_null(k_fifo_get(pfifo, K_NO_WAIT), NULL);
+
+	for (int i = 0; i < LIST_LEN; i++) {
+		k_fifo_put(pfifo, &data[i]);
+	}
+
+	head->snode.next = (sys_snode_t *)tail;
+	tail->snode.next = NULL;
+	k_fifo_put_list(pfifo, head, tail);
+
+	sys_slist_init(&slist);
+	sys_slist_append(&slist, &data_sl[0].snode);
+	sys_slist_append(&slist, &data_sl[1].snode);
+	k_fifo_put_slist(pfifo, &slist);
+
+	zassert_equal(k_fifo_alloc_put(pfifo, &data_a), 0, NULL);
+
+	zassert_false(k_fifo_is_empty(pfifo), NULL);
+	zassert_equal(k_fifo_peek_head(pfifo), &data[0], NULL);
+	zassert_equal(k_fifo_peek_tail(pfifo), &data_a, NULL);
+
+	for (int i = 0; i < LIST_LEN; i++) {
+		zassert_equal(k_fifo_get(pfifo, K_NO_WAIT), &data[i], NULL);
+	}
+	for (int i = 0; i < LIST_LEN; i++) {
+		zassert_equal(k_fifo_get(pfifo, K_NO_WAIT), &data_l[i], NULL);
+	}
+	for (int i = 0; i < LIST_LEN; i++) {
+		zassert_equal(k_fifo_get(pfifo, K_NO_WAIT), &data_sl[i], NULL);
+	}
+	zassert_equal(k_fifo_peek_head(pfifo), &data_a, NULL);
+	zassert_equal(k_fifo_get(pfifo, K_NO_WAIT), &data_a, NULL);
+
+	zassert_true(k_fifo_is_empty(pfifo), NULL);
+	zassert_is_null(k_fifo_get(pfifo, K_NO_WAIT), NULL);
+}
+
+static void tdelayed_put(void *p1, void *p2, void *p3)
+{
+	k_sleep(K_MSEC(10));
+	k_fifo_put(&fifo_mpsc, p2);
+}
+
+static void tdelayed_cancel(void *p1, void *p2, void *p3)
+{
+	k_sleep(K_MSEC(10));
+	k_fifo_cancel_wait(&fifo_mpsc);
+}
+
+static void tproducer(void *p1, void *p2, void *p3)
+{
+	struct item *item = p1;
+
+	for (int i = 0; i < ITEMS; i++) {
+		k_fifo_put(&fifo_mpsc, &item[i]);
+		if ((i % 4) == 0) {
+			k_yield();
+		}
+	}
+}
+
+static void isr_producer(struct k_timer *timer)
+{
+	static int seq;
+
+	k_fifo_put(&fifo_mpsc, &items[PRODUCERS][seq]);
+	if (++seq == ITEMS) {
+		seq = 0;
+		k_timer_stop(timer);
+	}
+}
+
+/**
+ * @addtogroup kernel_fifo_tests
+ * @{
+ */
+
+/**
+ * @brief Test FIFO queues with a single consumer
+ *
+ * @details Verify the put and get variants, waking up the consumer,
+ * timeouts and cancelling waits, then have several threads and an ISR
+ * put items while the test thread gets them, and check each producer's
+ * items arrive in order.
+ *
+ * @see k_fifo_init_mpsc(), K_FIFO_MPSC_DEFINE()
+ */
+void test_fifo_mpsc(void)
+{
+	uint32_t expected[PRODUCERS + 1] = { 0 };
+	struct k_timer timer;
+	struct item *item;
+	int64_t start;
+
+	/* for k_fifo_alloc_put() */
+	k_thread_system_pool_assign(k_current_get());
+
+	/**TESTPOINT: init via k_fifo_init_mpsc*/
+	k_fifo_init_mpsc(&fifo_mpsc);
+	tfifo_put_get(&fifo_mpsc);
+	tfifo_put_get(&kfifo_mpsc);
+
+	/* wake up on put */
+	k_thread_create(&tdata[0], tstacks[0], STACK_SIZE, tdelayed_put,
+			NULL, &data[0], NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	zassert_equal(k_fifo_get(&fifo_mpsc, K_MSEC(500)), &data[0], NULL);
+	k_thread_join(&tdata[0], K_FOREVER);
+
+	/* timeout */
+	start = k_uptime_get();
+	zassert_is_null(k_fifo_get(&fifo_mpsc, K_MSEC(20)), NULL);
+	zassert_true(k_uptime_get() - start >= 20, NULL);
+
+	/* cancel */
+	k_thread_create(&tdata[0], tstacks[0], STACK_SIZE, tdelayed_cancel,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	start = k_uptime_get();
+	zassert_is_null(k_fifo_get(&fifo_mpsc, K_MSEC(500)), NULL);
+	zassert_true(k_uptime_get() - start < 100, NULL);
+	k_thread_join(&tdata[0], K_FOREVER);
+
+	/* concurrent producers */
+	for (int p = 0; p <= PRODUCERS; p++) {
+		for (int i = 0; i < ITEMS; i++) {
+			items[p][i].id = p;
+			items[p][i].seq = i;
+		}
+	}
+
+	for (int p = 0; p < PRODUCERS; p++) {
+		k_thread_create(&tdata[p], tstacks[p], STACK_SIZE, tproducer,
+				items[p], NULL, NULL,
+				k_thread_priority_get(k_current_get()), 0,
+				K_NO_WAIT);
+	}
+	k_timer_init(&timer, isr_producer, NULL);
+	k_timer_start(&timer, K_MSEC(1), K_MSEC(1));
+
+	for (int i = 0; i < (PRODUCERS + 1) * ITEMS; i++) {
+		item = k_fifo_get(&fifo_mpsc, K_MSEC(1000));
+		zassert_not_null(item, "item %d not received", i);
+		zassert_equal(item->seq, expected[item->id],
+			      "producer %u: got %u, expected %u",
+			      item->id, item->seq, expected[item->id]);
+		expected[item->id]++;
+	}
+
+	for (int p = 0; p < PRODUCERS; p++) {
+		k_thread_join(&tdata[p], K_FOREVER);
+	}
+	zassert_true(k_fifo_is_empty(&fifo_mpsc), NULL);
+}
+
+/**
+ * @}
+ */
+
+#else
+
+void test_fifo_mpsc(void)
+{
+	ztest_test_skip();
+}
+
+#endif /* CONFIG_FIFO_MPSC */
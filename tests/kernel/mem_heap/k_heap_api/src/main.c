@@ -8,6 +8,8 @@
 extern void test_k_heap_alloc(void);
 extern void test_k_heap_alloc_fail(void);
 extern void test_k_heap_free(void);
+extern void test_k_heap_realloc(void);
+extern void test_k_heap_runtime_stats(void);
 
 /**
  * @brief k heap api tests
@@ -24,6 +26,8 @@ void test_main(void)
 	ztest_test_suite(k_heap_api,
 			 ztest_unit_test(test_k_heap_alloc),
 			 ztest_unit_test(test_k_heap_alloc_fail),
-			 ztest_unit_test(test_k_heap_free));
+			 ztest_unit_test(test_k_heap_free),
+			 ztest_unit_test(test_k_heap_realloc),
+			 ztest_unit_test(test_k_heap_runtime_stats));
 	ztest_run_test_suite(k_heap_api);
 }
@@ -91,3 +91,95 @@ void test_k_heap_free(void)
 	}
 	k_heap_free(&k_heap_test, p);
 }
+
+/**
+ * @brief Test to demonstrate k_heap_realloc() API usage
+ *
+ * @ingroup kernel_kheap_api_tests
+ *
+ * @details The test allocates a block, grows it, checks that the
+ * contents are preserved, then checks that a request larger than the
+ * heap fails without touching the block and that shrinking it keeps
+ * it in place.
+ *
+ * @see k_heap_realloc()
+ */
+void test_k_heap_realloc(void)
+{
+	k_timeout_t timeout = Z_TIMEOUT_US(TIMEOUT);
+	char *p = (char *)k_heap_realloc(&k_heap_test, NULL, ALLOC_SIZE_1 / 2,
+					 timeout);
+	char *q;
+
+	zassert_not_null(p, "k_heap_realloc operation failed");
+	for (int i = 0; i < ALLOC_SIZE_1 / 2; i++) {
+		p[i] = (char)i;
+	}
+
+	q = (char *)k_heap_realloc(&k_heap_test, p, ALLOC_SIZE_1, timeout);
+	zassert_equal(q, p, "block with a free neighbor was moved");
+	for (int i = 0; i < ALLOC_SIZE_1 / 2; i++) {
+		zassert_equal(q[i], (char)i, "contents not preserved");
+	}
+
+	p = (char *)k_heap_realloc(&k_heap_test, q, ALLOC_SIZE_3, K_NO_WAIT);
+	zassert_is_null(p, NULL);
+
+	p = (char *)k_heap_realloc(&k_heap_test, q, ALLOC_SIZE_1 / 4, timeout);
+	zassert_equal(p, q, "shrink moved the block");
+	zassert_is_null(k_heap_realloc(&k_heap_test, p, 0, K_NO_WAIT), NULL);
+}
+
+/**
+ * @brief Test to demonstrate k_heap_runtime_stats_get() API usage
+ *
+ * @ingroup kernel_kheap_api_tests
+ *
+ * @details The test checks that the allocated byte count and the high
+ * water mark follow an allocation and a free, and that with the stats
+ * subsystem enabled the heap's statistics group mirrors them.
+ *
+ * @see k_heap_runtime_stats_get()
+ */
+void test_k_heap_runtime_stats(void)
+{
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	struct sys_heap_runtime_stats before, stats;
+	char *p;
+
+	zassert_equal(k_heap_runtime_stats_get(&k_heap_test, &before), 0, NULL);
+
+	p = (char *)k_heap_alloc(&k_heap_test, ALLOC_SIZE_1, K_NO_WAIT);
+	zassert_not_null(p, "k_heap_alloc operation failed");
+
+	k_heap_runtime_stats_get(&k_heap_test, &stats);
+	zassert_true(stats.allocated_bytes >=
+		     before.allocated_bytes + ALLOC_SIZE_1, NULL);
+	zassert_equal(stats.allocated_bytes + stats.free_bytes,
+		      before.allocated_bytes + before.free_bytes, NULL);
+	zassert_true(stats.max_allocated_bytes >= stats.allocated_bytes, NULL);
+	zassert_true(stats.largest_free_bytes < ALLOC_SIZE_1, NULL);
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS_GROUP
+	zassert_equal(stats_group_find("k_heap_test"), &k_heap_test.stats.s_hdr,
+		      "stats group not registered");
+	zassert_equal(k_heap_test.stats.allocated_bytes, stats.allocated_bytes,
+		      NULL);
+	zassert_is_null(k_heap_alloc(&k_heap_test, ALLOC_SIZE_3, K_NO_WAIT),
+			NULL);
+	zassert_true(k_heap_test.stats.alloc_failures > 0, NULL);
+#endif
+
+	k_heap_free(&k_heap_test, p);
+	k_heap_runtime_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.allocated_bytes, before.allocated_bytes, NULL);
+	zassert_true(stats.max_allocated_bytes >=
+		     before.allocated_bytes + ALLOC_SIZE_1, NULL);
+
+	k_heap_runtime_stats_reset_max(&k_heap_test);
+	k_heap_runtime_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.max_allocated_bytes, stats.allocated_bytes, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
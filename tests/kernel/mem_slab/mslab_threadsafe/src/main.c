@@ -7,11 +7,15 @@
 #include <ztest.h>
 
 extern void test_mslab_threadsafe(void);
+extern void test_mslab_threadsafe_stress(void);
+extern void test_mslab_lockless_tag_bits(void);
 
 /*test case main entry*/
 void test_main(void)
 {
 	ztest_test_suite(mslab_threadsafe,
-			 ztest_unit_test(test_mslab_threadsafe));
+			 ztest_unit_test(test_mslab_threadsafe),
+			 ztest_unit_test(test_mslab_threadsafe_stress),
+			 ztest_unit_test(test_mslab_lockless_tag_bits));
 	ztest_run_test_suite(mslab_threadsafe);
 }
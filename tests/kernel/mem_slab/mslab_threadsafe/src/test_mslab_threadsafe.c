@@ -36,6 +36,21 @@ static char __aligned(BLK_ALIGN) tslab[BLK_SIZE2 * SLAB_BLOCKS];
 static atomic_t slab_id;
 static volatile bool success[THREAD_NUM];
 
+/* Stress test: every thread repeatedly takes a few blocks from a slab
+ * that cannot satisfy all of them at once, stamps them with its id,
+ * and checks that nobody else wrote to them before freeing them again.
+ * On SMP the threads run on all CPUs at once.
+ */
+#define STRESS_MS 500
+#define STRESS_HELD 2
+#define STRESS_BLOCKS (THREAD_NUM * STRESS_HELD - 1)
+#define STRESS_BLK_SIZE 16
+
+K_MEM_SLAB_DEFINE(stress_slab, STRESS_BLK_SIZE, STRESS_BLOCKS, BLK_ALIGN);
+static volatile bool stress_stop;
+static uint32_t stress_ops[THREAD_NUM];
+static atomic_t stress_errors;
+
 /* thread entry simply invoke the APIs*/
 static void tmslab_api(void *p1, void *p2, void *p3)
 {
@@ -92,3 +107,114 @@ void test_mslab_threadsafe(void)
 		zassert_true(success[i], "thread %d failed", i);
 	}
 }
+
+static void tmslab_stress(void *p1, void *p2, void *p3)
+{
+	uintptr_t id = (uintptr_t)p1;
+	void *block[STRESS_HELD];
+	uint32_t ops = 0U;
+
+	while (!stress_stop) {
+		int held = 0;
+
+		for (int i = 0; i < STRESS_HELD; i++) {
+			/* Alternate between waiting and non-blocking
+			 * allocations to cover both paths
+			 */
+			k_timeout_t tmo = ((ops + i) & 1) ? TIMEOUT : K_NO_WAIT;
+
+			if (k_mem_slab_alloc(&stress_slab, &block[held],
+					     tmo) == 0) {
+				*(volatile uintptr_t *)block[held] = id;
+				held++;
+			}
+		}
+
+		k_busy_wait(1);
+
+		for (int i = 0; i < held; i++) {
+			if (*(volatile uintptr_t *)block[i] != id) {
+				atomic_inc(&stress_errors);
+			}
+			k_mem_slab_free(&stress_slab, &block[i]);
+			ops++;
+		}
+	}
+
+	stress_ops[id] = ops;
+}
+
+/**
+ * @brief Stress alloc and free of a contended slab from all CPUs
+ *
+ * @details Test creates 4 preemptive threads that keep allocating and
+ * freeing blocks of a slab holding fewer blocks than they need at
+ * once, so that both the uncontended path and the path waiting for a
+ * block are exercised.  Validates that no block is ever handed to two
+ * threads at the same time, that all blocks are returned at the end,
+ * and reports the resulting alloc/free throughput.
+ *
+ * @ingroup kernel_memory_slab_tests
+ */
+void test_mslab_threadsafe_stress(void)
+{
+	k_tid_t tid[THREAD_NUM];
+	uint32_t total = 0U;
+
+	stress_stop = false;
+
+	for (int i = 0; i < THREAD_NUM; i++) {
+		tid[i] = k_thread_create(&tdata[i], tstack[i], STACK_SIZE,
+					 tmslab_stress, (void *)(uintptr_t)i,
+					 NULL, NULL, K_PRIO_PREEMPT(1), 0,
+					 K_NO_WAIT);
+	}
+
+	k_sleep(K_MSEC(STRESS_MS));
+	stress_stop = true;
+
+	for (int i = 0; i < THREAD_NUM; i++) {
+		int ret = k_thread_join(tid[i], K_FOREVER);
+
+		zassert_false(ret, "k_thread_join() failed");
+		total += stress_ops[i];
+	}
+
+	TC_PRINT("%u alloc/free pairs in %d ms on %d CPUs (%u/s)\n", total,
+		 STRESS_MS, CONFIG_MP_NUM_CPUS, total * (1000 / STRESS_MS));
+
+	zassert_equal(atomic_get(&stress_errors), 0,
+		      "block handed out twice");
+	zassert_equal(k_mem_slab_num_used_get(&stress_slab), 0,
+		      "blocks leaked");
+	zassert_equal(k_mem_slab_num_free_get(&stress_slab), STRESS_BLOCKS,
+		      "blocks leaked");
+	zassert_true(total > 0, "no progress");
+}
+
+/**
+ * @brief Test that a lock-free slab keeps room for its ABA counter
+ *
+ * @details Check that k_mem_slab_init() rejects a slab whose block
+ * index would need more bits than CONFIG_MEM_SLAB_LOCKLESS_TAG_BITS
+ * leaves free, without touching its buffer, and still accepts a
+ * small slab.
+ *
+ * @ingroup kernel_memory_slab_tests
+ */
+void test_mslab_lockless_tag_bits(void)
+{
+#ifdef CONFIG_MEM_SLAB_LOCKLESS
+	static struct k_mem_slab slab;
+	uint32_t max_blocks = BIT(32 - CONFIG_MEM_SLAB_LOCKLESS_TAG_BITS) - 1;
+
+	zassert_equal(k_mem_slab_init(&slab, tslab, BLK_SIZE2,
+				      max_blocks + 1U), -EINVAL,
+		      "slab without room for the ABA counter accepted");
+	zassert_equal(k_mem_slab_init(&slab, tslab, BLK_SIZE2,
+				      SLAB_BLOCKS), 0,
+		      "k_mem_slab_init() failed");
+#else
+	ztest_test_skip();
+#endif
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+#define BATCH_LEN 4
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+K_MSGQ_DEFINE(batch_q, MSG_SIZE, BATCH_LEN, 4);
+
+static uint32_t tx[BATCH_LEN + 2];
+static uint32_t rx[BATCH_LEN + 2];
+static volatile int thread_ret;
+
+static void batch_put_entry(void *p1, void *p2, void *p3)
+{
+	thread_ret = k_msgq_put_batch(&batch_q, p1, 2, K_FOREVER);
+}
+
+static void claim_put_entry(void *p1, void *p2, void *p3)
+{
+	void *slot;
+
+	thread_ret = k_msgq_put_claim(&batch_q, &slot, K_FOREVER);
+	if (thread_ret == 0) {
+		*(uint32_t *)slot = POINTER_TO_UINT(p1);
+		thread_ret = k_msgq_put_commit(&batch_q);
+	}
+}
+
+static void claim_get_entry(void *p1, void *p2, void *p3)
+{
+	void *slot;
+
+	thread_ret = k_msgq_get_claim(&batch_q, &slot, K_FOREVER);
+	if (thread_ret == 0) {
+		thread_ret = *(uint32_t *)slot;
+		(void)k_msgq_get_commit(&batch_q);
+	}
+}
+
+static void spawn(k_thread_entry_t entry, void *p1)
+{
+	thread_ret = -1;
+	k_thread_create(&tdata, tstack, STACK_SIZE, entry, p1, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_msleep(TIMEOUT_MS >> 1);
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test sending and receiving batches of messages
+ * @see k_msgq_put_batch(), k_msgq_get_batch()
+ */
+void test_msgq_batch(void)
+{
+	int ret;
+
+	k_msgq_purge(&batch_q);
+	for (int i = 0; i < ARRAY_SIZE(tx); i++) {
+		tx[i] = MSG0 + i;
+	}
+
+	/**TESTPOINT: a batch larger than the free space is cut short */
+	ret = k_msgq_put_batch(&batch_q, tx, ARRAY_SIZE(tx), K_NO_WAIT);
+	zassert_equal(ret, BATCH_LEN, NULL);
+	ret = k_msgq_put_batch(&batch_q, tx, 1, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, NULL);
+
+	/**TESTPOINT: messages come out in order, in pieces */
+	ret = k_msgq_get_batch(&batch_q, rx, 3, K_NO_WAIT);
+	zassert_equal(ret, 3, NULL);
+	ret = k_msgq_get_batch(&batch_q, &rx[3], ARRAY_SIZE(rx), K_NO_WAIT);
+	zassert_equal(ret, 1, NULL);
+	for (int i = 0; i < BATCH_LEN; i++) {
+		zassert_equal(rx[i], tx[i], NULL);
+	}
+	ret = k_msgq_get_batch(&batch_q, rx, 1, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, NULL);
+	ret = k_msgq_get_batch(&batch_q, rx, 1, TIMEOUT);
+	zassert_equal(ret, -EAGAIN, NULL);
+
+	/**TESTPOINT: a waiting batch sender gets one message in for
+	 * each slot freed, the first one in its batch
+	 */
+	ret = k_msgq_put_batch(&batch_q, tx, BATCH_LEN, K_NO_WAIT);
+	zassert_equal(ret, BATCH_LEN, NULL);
+	spawn(batch_put_entry, &tx[BATCH_LEN]);
+	zassert_equal(thread_ret, -1, "sender did not wait");
+
+	ret = k_msgq_get_batch(&batch_q, rx, BATCH_LEN + 2, K_NO_WAIT);
+	zassert_equal(ret, BATCH_LEN + 1, NULL);
+	for (int i = 0; i < BATCH_LEN + 1; i++) {
+		zassert_equal(rx[i], tx[i], NULL);
+	}
+	k_thread_join(&tdata, K_FOREVER);
+	zassert_equal(thread_ret, 1, NULL);
+}
+
+/**
+ * @brief Test building and reading messages in place
+ * @see k_msgq_put_claim(), k_msgq_put_commit(), k_msgq_get_claim(),
+ * k_msgq_get_commit()
+ */
+void test_msgq_claim(void)
+{
+	uint32_t msg = MSG0;
+	void *slot, *slot2;
+	int ret;
+
+	k_msgq_purge(&batch_q);
+
+	/**TESTPOINT: one put claim at a time, other senders are held off */
+	zassert_equal(k_msgq_put_claim(&batch_q, &slot, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_put_claim(&batch_q, &slot2, K_NO_WAIT), -EBUSY,
+		      NULL);
+	zassert_equal(k_msgq_put(&batch_q, &msg, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_num_used_get(&batch_q), 0, NULL);
+	*(uint32_t *)slot = MSG1;
+	zassert_equal(k_msgq_put_commit(&batch_q), 0, NULL);
+	zassert_equal(k_msgq_put_commit(&batch_q), -EINVAL, NULL);
+	zassert_equal(k_msgq_num_used_get(&batch_q), 1, NULL);
+
+	/**TESTPOINT: the claimed message is the one in the slot */
+	zassert_equal(k_msgq_get_claim(&batch_q, &slot2, K_NO_WAIT), 0, NULL);
+	zassert_equal_ptr(slot2, slot, NULL);
+	zassert_equal(*(uint32_t *)slot2, MSG1, NULL);
+	zassert_equal(k_msgq_get(&batch_q, &msg, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_get_commit(&batch_q), 0, NULL);
+	zassert_equal(k_msgq_get_commit(&batch_q), -EINVAL, NULL);
+	ret = k_msgq_get_claim(&batch_q, &slot, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, NULL);
+	ret = k_msgq_get_claim(&batch_q, &slot, TIMEOUT);
+	zassert_equal(ret, -EAGAIN, NULL);
+
+	/**TESTPOINT: a claim waiting for room gets the freed slot */
+	for (int i = 0; i < BATCH_LEN; i++) {
+		zassert_equal(k_msgq_put(&batch_q, &msg, K_NO_WAIT), 0, NULL);
+	}
+	spawn(claim_put_entry, UINT_TO_POINTER(MSG1));
+	zassert_equal(thread_ret, -1, "claim did not wait");
+	zassert_equal(k_msgq_get(&batch_q, &msg, K_NO_WAIT), 0, NULL);
+	k_thread_join(&tdata, K_FOREVER);
+	zassert_equal(thread_ret, 0, NULL);
+	k_msgq_purge(&batch_q);
+
+	/**TESTPOINT: a claim waiting for a message gets the next one */
+	spawn(claim_get_entry, NULL);
+	zassert_equal(thread_ret, -1, "claim did not wait");
+	msg = MSG1;
+	zassert_equal(k_msgq_put(&batch_q, &msg, K_NO_WAIT), 0, NULL);
+	k_thread_join(&tdata, K_FOREVER);
+	zassert_equal(thread_ret, MSG1, NULL);
+	zassert_equal(k_msgq_num_used_get(&batch_q), 0, NULL);
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <kernel_structs.h> /* for _THREAD_PENDING */
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define N_THREADS 2
+#define N_LOCKS 10000
+#define MAIN_PRIO 10
+#define SPINNER_PRIO 5
+/* how long the owner holds the mutex in the short critical section,
+ * well within the spin budget (see testcase.yaml) but long enough for
+ * the spinner to reach k_mutex_lock()
+ */
+#define SHORT_HOLD_US (CONFIG_MUTEX_ADAPTIVE_SPIN_US / 4)
+
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+
+static K_MUTEX_DEFINE(spin_mutex);
+static K_THREAD_STACK_ARRAY_DEFINE(spin_stacks, N_THREADS, STACK_SIZE);
+static struct k_thread spin_tdata[N_THREADS];
+
+static volatile uint32_t counter;
+static atomic_t asking;
+
+static void tcount(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < N_LOCKS; i++) {
+		zassert_equal(k_mutex_lock(&spin_mutex, K_FOREVER), 0, NULL);
+		/* not atomic: lost updates show broken mutual exclusion */
+		counter = counter + 1;
+		zassert_equal(k_mutex_unlock(&spin_mutex), 0, NULL);
+	}
+}
+
+static void tspin_lock(void *p1, void *p2, void *p3)
+{
+	/* started at the priority of main, so it runs on another CPU */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(SPINNER_PRIO));
+	atomic_set(&asking, 1);
+	zassert_equal(k_mutex_lock(&spin_mutex, K_FOREVER), 0, NULL);
+	zassert_equal(k_mutex_unlock(&spin_mutex), 0, NULL);
+}
+
+/**
+ * @addtogroup kernel_mutex_tests
+ * @{
+ */
+
+/**
+ * @brief Test mutexes with adaptive spinning
+ *
+ * @details Have threads on different CPUs contend for a mutex and check
+ * none of their critical sections overlapped.  Then check a thread
+ * spinning on a mutex never pends, doesn't raise the priority of the
+ * owner, and gets the mutex when it is unlocked, and that a thread which
+ * spins longer than CONFIG_MUTEX_ADAPTIVE_SPIN_US pends and raises the
+ * priority of the owner.
+ *
+ * @see k_mutex_lock(), k_mutex_unlock()
+ */
+void test_mutex_adaptive_spin(void)
+{
+	int old_prio = k_thread_priority_get(k_current_get());
+	uint32_t start;
+
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(MAIN_PRIO));
+
+	/* mutual exclusion */
+	counter = 0;
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_create(&spin_tdata[i], spin_stacks[i], STACK_SIZE,
+				tcount, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(MAIN_PRIO), 0, K_NO_WAIT);
+	}
+	tcount(NULL, NULL, NULL);
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_join(&spin_tdata[i], K_FOREVER);
+	}
+	zassert_equal(counter, (N_THREADS + 1) * N_LOCKS, NULL);
+
+	/* a short critical section: the other thread spins */
+	zassert_equal(k_mutex_lock(&spin_mutex, K_FOREVER), 0, NULL);
+	atomic_clear(&asking);
+	k_thread_create(&spin_tdata[0], spin_stacks[0], STACK_SIZE,
+			tspin_lock, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(MAIN_PRIO), 0, K_NO_WAIT);
+	while (!atomic_get(&asking)) {
+	}
+	start = k_cycle_get_32();
+	while (k_cyc_to_us_floor32(k_cycle_get_32() - start) <
+	       SHORT_HOLD_US) {
+		zassert_false(spin_tdata[0].base.thread_state &
+			      _THREAD_PENDING, "spinner pended");
+	}
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(MAIN_PRIO), "spinner boosted owner");
+	zassert_equal(k_mutex_unlock(&spin_mutex), 0, NULL);
+	k_thread_join(&spin_tdata[0], K_FOREVER);
+
+	/* a long one: it pends, and priority inheritance applies */
+	zassert_equal(k_mutex_lock(&spin_mutex, K_FOREVER), 0, NULL);
+	atomic_clear(&asking);
+	k_thread_create(&spin_tdata[0], spin_stacks[0], STACK_SIZE,
+			tspin_lock, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(MAIN_PRIO), 0, K_NO_WAIT);
+	while (!atomic_get(&asking)) {
+	}
+	k_busy_wait(CONFIG_MUTEX_ADAPTIVE_SPIN_US * 2 + 1000);
+	zassert_true(spin_tdata[0].base.thread_state & _THREAD_PENDING,
+		     "spinner did not pend");
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(SPINNER_PRIO), "owner not boosted");
+	zassert_equal(k_mutex_unlock(&spin_mutex), 0, NULL);
+	k_thread_join(&spin_tdata[0], K_FOREVER);
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(MAIN_PRIO), NULL);
+
+	k_thread_priority_set(k_current_get(), old_prio);
+}
+
+/**
+ * @}
+ */
+
+#else
+
+void test_mutex_adaptive_spin(void)
+{
+	ztest_test_skip();
+}
+
+#endif /* CONFIG_MUTEX_ADAPTIVE_SPIN */
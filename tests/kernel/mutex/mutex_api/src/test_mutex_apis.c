@@ -386,6 +386,8 @@ void test_mutex_priority_inheritance(void)
 	k_msleep(TIMEOUT+1000);
 }
 
+extern void test_mutex_adaptive_spin(void);
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -400,7 +402,8 @@ void test_main(void)
 		 ztest_user_unit_test(test_mutex_reent_lock_timeout_fail),
 		 ztest_1cpu_user_unit_test(test_mutex_reent_lock_timeout_pass),
 		 ztest_user_unit_test(test_mutex_recursive),
-		 ztest_user_unit_test(test_mutex_priority_inheritance)
+		 ztest_user_unit_test(test_mutex_priority_inheritance),
+		 ztest_unit_test(test_mutex_adaptive_spin)
 		 );
 	ztest_run_test_suite(mutex_api);
 }
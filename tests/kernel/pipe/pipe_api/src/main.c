@@ -25,6 +25,9 @@ extern void test_half_pipe_block_put_sema(void);
 extern void test_pipe_alloc(void);
 extern void test_pipe_reader_wait(void);
 extern void test_pipe_block_writer_wait(void);
+extern void test_pipe_claim(void);
+extern void test_pipe_claim_wait(void);
+extern void test_pipe_writev_readv(void);
 #ifdef CONFIG_USERSPACE
 extern void test_pipe_user_thread2thread(void);
 extern void test_pipe_user_put_fail(void);
@@ -84,6 +87,9 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_pipe_alloc),
 			 ztest_unit_test(test_pipe_reader_wait),
 			 ztest_1cpu_unit_test(test_pipe_block_writer_wait),
+			 ztest_1cpu_unit_test(test_pipe_claim),
+			 ztest_1cpu_unit_test(test_pipe_claim_wait),
+			 ztest_1cpu_unit_test(test_pipe_writev_readv),
 			 ztest_unit_test(test_pipe_avail_r_lt_w),
 			 ztest_unit_test(test_pipe_avail_w_lt_r),
 			 ztest_unit_test(test_pipe_avail_r_eq_w_full),
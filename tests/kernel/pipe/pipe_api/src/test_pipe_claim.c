@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE	(1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define CLAIM_PIPE_LEN	32
+#define CHUNK		8
+
+K_PIPE_DEFINE(claim_pipe, CLAIM_PIPE_LEN, 4);
+K_PIPE_DEFINE(claim_nobuf_pipe, 0, 4);
+
+static K_THREAD_STACK_DEFINE(claim_stack, STACK_SIZE);
+static struct k_thread claim_tdata;
+static K_SEM_DEFINE(claim_sema, 0, 1);
+
+/* sequence numbers of the next bytes written and read */
+static uint8_t tx_seq, rx_seq;
+
+static void claim_produce(size_t want, size_t expected, size_t commit)
+{
+	uint8_t *region;
+	size_t size = want;
+
+	zassert_equal(k_pipe_put_claim(&claim_pipe, (void **)&region, &size,
+				       K_NO_WAIT), 0, NULL);
+	zassert_equal(size, expected, NULL);
+	for (size_t i = 0; i < commit; i++) {
+		region[i] = tx_seq++;
+	}
+	zassert_equal(k_pipe_put_commit(&claim_pipe, commit), 0, NULL);
+}
+
+static void claim_consume(size_t want, size_t expected, size_t release)
+{
+	uint8_t *region;
+	size_t size = want;
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, (void **)&region, &size,
+				       K_NO_WAIT), 0, NULL);
+	zassert_equal(size, expected, NULL);
+	for (size_t i = 0; i < release; i++) {
+		zassert_equal(region[i], rx_seq++, NULL);
+	}
+	zassert_equal(k_pipe_get_release(&claim_pipe, release), 0, NULL);
+}
+
+static void tclaim_get(void *p1, void *p2, void *p3)
+{
+	uint8_t rx_data[CHUNK];
+	size_t rd_byte;
+
+	zassert_equal(k_pipe_get(&claim_pipe, rx_data, CHUNK, &rd_byte, CHUNK,
+				 K_FOREVER), 0, NULL);
+	zassert_equal(rd_byte, CHUNK, NULL);
+	for (size_t i = 0; i < CHUNK; i++) {
+		zassert_equal(rx_data[i], rx_seq++, NULL);
+	}
+	k_sem_give(&claim_sema);
+}
+
+static void tclaim_put(void *p1, void *p2, void *p3)
+{
+	uint8_t tx_data[CHUNK];
+	size_t wt_byte;
+
+	for (size_t i = 0; i < CHUNK; i++) {
+		tx_data[i] = tx_seq++;
+	}
+	zassert_equal(k_pipe_put(&claim_pipe, tx_data, CHUNK, &wt_byte, CHUNK,
+				 K_FOREVER), 0, NULL);
+	zassert_equal(wt_byte, CHUNK, NULL);
+	k_sem_give(&claim_sema);
+}
+
+static void tclaim_put_claim(void *p1, void *p2, void *p3)
+{
+	uint8_t *region;
+	size_t size = CLAIM_PIPE_LEN;
+
+	zassert_equal(k_pipe_put_claim(&claim_pipe, (void **)&region, &size,
+				       K_FOREVER), 0, NULL);
+	zassert_true(size > 0, NULL);
+	for (size_t i = 0; i < size; i++) {
+		region[i] = tx_seq++;
+	}
+	zassert_equal(k_pipe_put_commit(&claim_pipe, size), 0, NULL);
+	k_sem_give(&claim_sema);
+}
+
+static void tclaim_delayed_put(void *p1, void *p2, void *p3)
+{
+	k_sleep(K_MSEC(10));
+	tclaim_put(p1, p2, p3);
+}
+
+static void claim_spawn(k_thread_entry_t entry, int prio)
+{
+	k_thread_create(&claim_tdata, claim_stack, STACK_SIZE, entry,
+			NULL, NULL, NULL, prio, 0, K_NO_WAIT);
+}
+
+/**
+ * @addtogroup kernel_pipe_tests
+ * @{
+ */
+
+/**
+ * @brief Test writing and reading a pipe in place
+ *
+ * @details Claim regions of the ring buffer for writing and reading,
+ * check they stop at the end of the buffer and hold the data in order,
+ * and that the other routines in the direction of a claim are refused
+ * until it is committed.
+ *
+ * @see k_pipe_put_claim(), k_pipe_put_commit(), k_pipe_get_claim(),
+ * k_pipe_get_release()
+ */
+void test_pipe_claim(void)
+{
+	uint8_t byte, *region;
+	size_t size, bytes;
+
+	/* invalid requests */
+	size = 1;
+	zassert_equal(k_pipe_put_claim(&claim_nobuf_pipe, (void **)&region,
+				       &size, K_NO_WAIT), -EINVAL, NULL);
+	size = 0;
+	zassert_equal(k_pipe_put_claim(&claim_pipe, (void **)&region, &size,
+				       K_NO_WAIT), -EINVAL, NULL);
+	zassert_equal(k_pipe_put_commit(&claim_pipe, 0), -EINVAL, NULL);
+	zassert_equal(k_pipe_get_release(&claim_pipe, 0), -EINVAL, NULL);
+
+	/* nothing to read */
+	size = CLAIM_PIPE_LEN;
+	zassert_equal(k_pipe_get_claim(&claim_pipe, (void **)&region, &size,
+				       K_NO_WAIT), -EIO, NULL);
+
+	/* a claim blocks the other writers and can't be overrun */
+	size = 20;
+	zassert_equal(k_pipe_put_claim(&claim_pipe, (void **)&region, &size,
+				       K_NO_WAIT), 0, NULL);
+	zassert_equal(size, 20, NULL);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, (void **)&region, &size,
+				       K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_pipe_put(&claim_pipe, &byte, 1, &bytes, 1,
+				 K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_pipe_put_commit(&claim_pipe, 21), -EINVAL, NULL);
+	for (size_t i = 0; i < size; i++) {
+		region[i] = tx_seq++;
+	}
+	zassert_equal(k_pipe_put_commit(&claim_pipe, size), 0, NULL);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 20, NULL);
+
+	/* claims stop at the end of the ring buffer */
+	claim_produce(CLAIM_PIPE_LEN, 12, 8);
+
+	/* a claim blocks the other readers */
+	size = CLAIM_PIPE_LEN;
+	zassert_equal(k_pipe_get_claim(&claim_pipe, (void **)&region, &size,
+				       K_NO_WAIT), 0, NULL);
+	zassert_equal(size, 28, NULL);
+	zassert_equal(k_pipe_get(&claim_pipe, &byte, 1, &bytes, 1,
+				 K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_pipe_get_release(&claim_pipe, 29), -EINVAL, NULL);
+	for (size_t i = 0; i < 24; i++) {
+		zassert_equal(region[i], rx_seq++, NULL);
+	}
+	zassert_equal(k_pipe_get_release(&claim_pipe, 24), 0, NULL);
+
+	/* wrap around */
+	claim_produce(CLAIM_PIPE_LEN, 4, 4);
+	claim_produce(CLAIM_PIPE_LEN, 24, 10);
+	claim_consume(CLAIM_PIPE_LEN, 8, 8);
+	claim_consume(CLAIM_PIPE_LEN, 10, 3);
+	claim_consume(4, 4, 4);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 3, NULL);
+
+	/* mixed with copying routines */
+	zassert_equal(k_pipe_get(&claim_pipe, &byte, 1, &bytes, 1,
+				 K_NO_WAIT), 0, NULL);
+	zassert_equal(byte, rx_seq++, NULL);
+	byte = tx_seq++;
+	zassert_equal(k_pipe_put(&claim_pipe, &byte, 1, &bytes, 1,
+				 K_NO_WAIT), 0, NULL);
+	claim_consume(CLAIM_PIPE_LEN, 3, 3);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0, NULL);
+}
+
+/**
+ * @brief Test threads waiting on a pipe written or read in place
+ *
+ * @details Check that committing a claim wakes up a waiting reader, that
+ * releasing a claim wakes up a waiting writer, and that threads wait for
+ * space or data to claim, or time out.
+ *
+ * @see k_pipe_put_claim(), k_pipe_put_commit(), k_pipe_get_claim(),
+ * k_pipe_get_release()
+ */
+void test_pipe_claim_wait(void)
+{
+	const int main_low_prio = 10;
+	const int prio = K_PRIO_PREEMPT(main_low_prio - 1);
+	int old_prio = k_thread_priority_get(k_current_get());
+	uint8_t *region;
+	size_t size;
+	int64_t start;
+
+	/* let the spawned threads run as soon as they are ready */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(main_low_prio));
+
+	/* a reader waits for committed data */
+	claim_spawn(tclaim_get, prio);
+	zassert_equal(k_sem_take(&claim_sema, K_NO_WAIT), -EBUSY, NULL);
+	claim_produce(CLAIM_PIPE_LEN, 21, CHUNK);
+	zassert_equal(k_sem_take(&claim_sema, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0, NULL);
+	k_thread_join(&claim_tdata, K_FOREVER);
+
+	/* a writer waits for released space */
+	claim_produce(CLAIM_PIPE_LEN, 13, 13);
+	claim_produce(CLAIM_PIPE_LEN, 19, 19);
+	claim_spawn(tclaim_put, prio);
+	zassert_equal(k_sem_take(&claim_sema, K_NO_WAIT), -EBUSY, NULL);
+	claim_consume(CHUNK, CHUNK, CHUNK);
+	zassert_equal(k_sem_take(&claim_sema, K_NO_WAIT), 0, NULL);
+	k_thread_join(&claim_tdata, K_FOREVER);
+
+	/* so does a thread claiming space */
+	claim_spawn(tclaim_put_claim, prio);
+	zassert_equal(k_sem_take(&claim_sema, K_NO_WAIT), -EBUSY, NULL);
+	claim_consume(CLAIM_PIPE_LEN, 5, 5);
+	zassert_equal(k_sem_take(&claim_sema, K_NO_WAIT), 0, NULL);
+	k_thread_join(&claim_tdata, K_FOREVER);
+	claim_consume(CLAIM_PIPE_LEN, CLAIM_PIPE_LEN, CLAIM_PIPE_LEN);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0, NULL);
+
+	/* a thread claiming data waits for it, or times out */
+	claim_spawn(tclaim_delayed_put, prio);
+	size = CLAIM_PIPE_LEN;
+	zassert_equal(k_pipe_get_claim(&claim_pipe, (void **)&region, &size,
+				       K_MSEC(500)), 0, NULL);
+	zassert_equal(size, CHUNK, NULL);
+	zassert_equal(k_pipe_get_release(&claim_pipe, 0), 0, NULL);
+	claim_consume(CLAIM_PIPE_LEN, CHUNK, CHUNK);
+	zassert_equal(k_sem_take(&claim_sema, K_NO_WAIT), 0, NULL);
+	k_thread_join(&claim_tdata, K_FOREVER);
+
+	start = k_uptime_get();
+	zassert_equal(k_pipe_get_claim(&claim_pipe, (void **)&region, &size,
+				       K_MSEC(20)), -EAGAIN, NULL);
+	zassert_true(k_uptime_get() - start >= 20, NULL);
+
+	k_thread_priority_set(k_current_get(), old_prio);
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE	(1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define IOV_PIPE_LEN	32
+
+K_PIPE_DEFINE(iov_pipe, IOV_PIPE_LEN, 4);
+
+static K_THREAD_STACK_DEFINE(iov_stack, STACK_SIZE);
+static struct k_thread iov_tdata;
+static K_SEM_DEFINE(iov_sema, 0, 1);
+
+static uint8_t tx_data[2 * IOV_PIPE_LEN];
+static uint8_t rx_data[2 * IOV_PIPE_LEN];
+
+static void tiov_readv(void *p1, void *p2, void *p3)
+{
+	struct k_pipe_iovec iov[] = {
+		{ &rx_data[0], 8 },
+		{ &rx_data[8], 8 },
+	};
+	size_t rd_byte;
+
+	zassert_equal(k_pipe_readv(&iov_pipe, iov, ARRAY_SIZE(iov), &rd_byte,
+				   16, K_FOREVER), 0, NULL);
+	zassert_equal(rd_byte, 16, NULL);
+	k_sem_give(&iov_sema);
+}
+
+static void tiov_writev(void *p1, void *p2, void *p3)
+{
+	struct k_pipe_iovec iov[] = {
+		{ &tx_data[IOV_PIPE_LEN], 4 },
+		{ &tx_data[IOV_PIPE_LEN + 4], 4 },
+		{ &tx_data[IOV_PIPE_LEN + 8], 4 },
+	};
+	size_t wt_byte;
+
+	zassert_equal(k_pipe_writev(&iov_pipe, iov, ARRAY_SIZE(iov), &wt_byte,
+				    12, K_FOREVER), 0, NULL);
+	zassert_equal(wt_byte, 12, NULL);
+	k_sem_give(&iov_sema);
+}
+
+static void iov_spawn(k_thread_entry_t entry, int prio)
+{
+	k_thread_create(&iov_tdata, iov_stack, STACK_SIZE, entry,
+			NULL, NULL, NULL, prio, 0, K_NO_WAIT);
+}
+
+/**
+ * @addtogroup kernel_pipe_tests
+ * @{
+ */
+
+/**
+ * @brief Test vectored pipe writes and reads
+ *
+ * @details Write data gathered from several segments, including empty
+ * ones, and read it back scattered to segments of other sizes, directly
+ * and through waiting readers and writers, and check it arrives whole and
+ * in order.
+ *
+ * @see k_pipe_writev(), k_pipe_readv()
+ */
+void test_pipe_writev_readv(void)
+{
+	const int main_low_prio = 10;
+	const int prio = K_PRIO_PREEMPT(main_low_prio - 1);
+	int old_prio = k_thread_priority_get(k_current_get());
+	struct k_pipe_iovec wiov[] = {
+		{ &tx_data[0], 4 },
+		{ NULL, 0 },
+		{ &tx_data[4], 10 },
+		{ &tx_data[14], 2 },
+	};
+	struct k_pipe_iovec riov[] = {
+		{ &rx_data[0], 5 },
+		{ NULL, 0 },
+		{ &rx_data[5], 11 },
+	};
+	struct k_pipe_iovec big_iov[] = {
+		{ &tx_data[0], SIZE_MAX },
+		{ &tx_data[0], 2 },
+	};
+	size_t bytes;
+
+	for (int i = 0; i < sizeof(tx_data); i++) {
+		tx_data[i] = i;
+	}
+
+	/* invalid requests */
+	zassert_equal(k_pipe_writev(&iov_pipe, wiov, ARRAY_SIZE(wiov), &bytes,
+				    17, K_NO_WAIT), -EINVAL, NULL);
+	zassert_equal(k_pipe_writev(&iov_pipe, big_iov, ARRAY_SIZE(big_iov),
+				    &bytes, 0, K_NO_WAIT), -EINVAL, NULL);
+
+	/* through the buffer */
+	zassert_equal(k_pipe_writev(&iov_pipe, wiov, ARRAY_SIZE(wiov), &bytes,
+				    16, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, 16, NULL);
+	zassert_equal(k_pipe_read_avail(&iov_pipe), 16, NULL);
+	zassert_equal(k_pipe_readv(&iov_pipe, riov, ARRAY_SIZE(riov), &bytes,
+				   16, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, 16, NULL);
+	zassert_mem_equal(rx_data, tx_data, 16, NULL);
+
+	/* straight to a waiting reader */
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(main_low_prio));
+	memset(rx_data, 0, sizeof(rx_data));
+	iov_spawn(tiov_readv, prio);
+	zassert_equal(k_sem_take(&iov_sema, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_pipe_writev(&iov_pipe, wiov, ARRAY_SIZE(wiov), &bytes,
+				    16, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_sem_take(&iov_sema, K_NO_WAIT), 0, NULL);
+	zassert_mem_equal(rx_data, tx_data, 16, NULL);
+	zassert_equal(k_pipe_read_avail(&iov_pipe), 0, NULL);
+	k_thread_join(&iov_tdata, K_FOREVER);
+
+	/* partly written without waiting */
+	wiov[2].iov_len = 2 * IOV_PIPE_LEN - 6;
+	zassert_equal(k_pipe_writev(&iov_pipe, wiov, 3, &bytes, 1, K_NO_WAIT),
+		      0, NULL);
+	zassert_equal(bytes, IOV_PIPE_LEN, NULL);
+
+	/* then from a waiting writer */
+	memset(rx_data, 0, sizeof(rx_data));
+	iov_spawn(tiov_writev, prio);
+	zassert_equal(k_sem_take(&iov_sema, K_NO_WAIT), -EBUSY, NULL);
+	riov[0].iov_len = 20;
+	riov[2].iov_base = &rx_data[20];
+	riov[2].iov_len = IOV_PIPE_LEN + 12 - 20;
+	zassert_equal(k_pipe_readv(&iov_pipe, riov, ARRAY_SIZE(riov), &bytes,
+				   IOV_PIPE_LEN + 12, K_NO_WAIT), 0, NULL);
+	zassert_equal(bytes, IOV_PIPE_LEN + 12, NULL);
+	zassert_mem_equal(rx_data, tx_data, IOV_PIPE_LEN + 12, NULL);
+	zassert_equal(k_sem_take(&iov_sema, K_NO_WAIT), 0, NULL);
+	k_thread_join(&iov_tdata, K_FOREVER);
+	zassert_equal(k_pipe_read_avail(&iov_pipe), 0, NULL);
+
+	k_thread_priority_set(k_current_get(), old_prio);
+}
+
+/**
+ * @}
+ */
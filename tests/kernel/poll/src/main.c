@@ -13,6 +13,8 @@ extern void test_poll_cancel_main_high_prio(void);
 extern void test_poll_multi(void);
 extern void test_poll_threadstate(void);
 extern void test_poll_grant_access(void);
+extern void test_poll_set_no_wait(void);
+extern void test_poll_set_wait(void);
 
 #ifdef CONFIG_64BIT
 #define MAX_SZ	256
@@ -36,6 +38,8 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_poll_cancel_main_low_prio),
 			 ztest_1cpu_unit_test(test_poll_cancel_main_high_prio),
 			 ztest_unit_test(test_poll_multi),
-			 ztest_1cpu_unit_test(test_poll_threadstate));
+			 ztest_1cpu_unit_test(test_poll_threadstate),
+			 ztest_unit_test(test_poll_set_no_wait),
+			 ztest_1cpu_unit_test(test_poll_set_wait));
 	ztest_run_test_suite(poll_api);
 }
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static struct k_poll_set set;
+static struct k_sem set_sem;
+static struct k_fifo set_fifo;
+static struct k_poll_signal set_signal;
+static struct k_poll_set_event set_events[4];
+
+static struct k_thread set_thread;
+K_THREAD_STACK_DEFINE(set_stack, STACK_SIZE);
+static volatile int poll_result = 1;
+
+static void init_set(void)
+{
+	k_poll_set_init(&set);
+	k_sem_init(&set_sem, 0, 10);
+	k_fifo_init(&set_fifo);
+	k_poll_signal_init(&set_signal);
+
+	k_poll_event_init(&set_events[0].event, K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_sem);
+	k_poll_event_init(&set_events[1].event, K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_fifo);
+	k_poll_event_init(&set_events[2].event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_signal);
+	k_poll_event_init(&set_events[3].event, K_POLL_TYPE_IGNORE,
+			  K_POLL_MODE_NOTIFY_ONLY, &set);
+
+	for (int i = 0; i < ARRAY_SIZE(set_events); i++) {
+		k_poll_set_add(&set, &set_events[i]);
+	}
+}
+
+static void remove_set(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(set_events); i++) {
+		k_poll_set_remove(&set, &set_events[i]);
+	}
+}
+
+/**
+ * @brief Test poll sets without waiting
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @details Check that events of a poll set stay registered across waits,
+ * that an event signaled several times is returned once, with its states
+ * accumulated, and that removed events are no longer signaled.
+ *
+ * @see k_poll_set_init(), k_poll_set_add(), k_poll_set_wait(),
+ * k_poll_set_ready(), k_poll_set_remove()
+ */
+void test_poll_set_no_wait(void)
+{
+	struct k_poll_set_event *ready[4];
+	void *data = NULL;
+
+	init_set();
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_NO_WAIT), -EAGAIN,
+		      NULL);
+
+	k_sem_give(&set_sem);
+	k_sem_give(&set_sem);
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_NO_WAIT), 1, NULL);
+	zassert_equal_ptr(ready[0], &set_events[0], NULL);
+	zassert_equal(ready[0]->event.state, K_POLL_STATE_SEM_AVAILABLE, NULL);
+	ready[0]->event.state = K_POLL_STATE_NOT_READY;
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_NO_WAIT), -EAGAIN,
+		      NULL);
+
+	/* still registered */
+	k_poll_signal_raise(&set_signal, 0);
+	k_fifo_put(&set_fifo, &data);
+	k_poll_set_ready(&set_events[3], K_POLL_STATE_SIGNALED);
+	k_sem_give(&set_sem);
+
+	/* only as many events as asked for, in order */
+	zassert_equal(k_poll_set_wait(&set, ready, 2, K_NO_WAIT), 2, NULL);
+	zassert_equal_ptr(ready[0], &set_events[2], NULL);
+	zassert_equal_ptr(ready[1], &set_events[1], NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_NO_WAIT), 2, NULL);
+	zassert_equal_ptr(ready[0], &set_events[3], NULL);
+	zassert_equal_ptr(ready[1], &set_events[0], NULL);
+
+	/* conditions already met when added */
+	remove_set();
+	init_set();
+	k_sem_give(&set_sem);
+	k_poll_set_remove(&set, &set_events[0]);
+	k_poll_set_add(&set, &set_events[0]);
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_NO_WAIT), 1, NULL);
+	zassert_equal_ptr(ready[0], &set_events[0], NULL);
+
+	/* removed events are not signaled, ready ones are dropped */
+	k_poll_signal_raise(&set_signal, 0);
+	k_poll_set_remove(&set, &set_events[2]);
+	k_poll_set_remove(&set, &set_events[0]);
+	k_sem_give(&set_sem);
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_NO_WAIT), -EAGAIN,
+		      NULL);
+
+	k_poll_set_remove(&set, &set_events[1]);
+	k_poll_set_remove(&set, &set_events[3]);
+}
+
+static void set_poller(void *p1, void *p2, void *p3)
+{
+	struct k_poll_event event;
+
+	k_poll_event_init(&event, K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_sem);
+	poll_result = k_poll(&event, 1, K_MSEC(500));
+}
+
+static void set_waiter(void *p1, void *p2, void *p3)
+{
+	poll_result = k_poll_set_wait(&set, NULL, 0, K_FOREVER);
+}
+
+static void give_expired(struct k_timer *timer)
+{
+	k_sem_give(&set_sem);
+}
+
+/**
+ * @brief Test waiting on poll sets
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @details Check that a thread waiting on a poll set is woken up by an
+ * event signaled from an ISR, that the wait times out otherwise, and that
+ * a thread in k_poll() on the same object is woken up too.  Check that
+ * canceling the set wakes up its waiters, and fails later waits.
+ *
+ * @see k_poll_set_wait(), k_poll_set_cancel()
+ */
+void test_poll_set_wait(void)
+{
+	struct k_poll_set_event *ready[4];
+	struct k_timer timer;
+
+	init_set();
+	k_timer_init(&timer, give_expired, NULL);
+
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_MSEC(20)), -EAGAIN,
+		      NULL);
+
+	k_timer_start(&timer, K_MSEC(10), K_NO_WAIT);
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_MSEC(500)), 1, NULL);
+	zassert_equal_ptr(ready[0], &set_events[0], NULL);
+	ready[0]->event.state = K_POLL_STATE_NOT_READY;
+	zassert_equal(k_sem_take(&set_sem, K_NO_WAIT), 0, NULL);
+
+	/* only wait, without taking the event */
+	k_timer_start(&timer, K_MSEC(10), K_NO_WAIT);
+	zassert_equal(k_poll_set_wait(&set, NULL, 0, K_FOREVER), 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_NO_WAIT), 1, NULL);
+	ready[0]->event.state = K_POLL_STATE_NOT_READY;
+	zassert_equal(k_sem_take(&set_sem, K_NO_WAIT), 0, NULL);
+
+	/* sets don't steal the one-shot notification of k_poll() */
+	k_thread_create(&set_thread, set_stack, STACK_SIZE, set_poller,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(1));
+	k_sem_give(&set_sem);
+	k_thread_join(&set_thread, K_FOREVER);
+	zassert_equal(poll_result, 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_NO_WAIT), 1, NULL);
+	zassert_equal_ptr(ready[0], &set_events[0], NULL);
+	ready[0]->event.state = K_POLL_STATE_NOT_READY;
+
+	/* canceling wakes up waiters */
+	poll_result = 1;
+	k_thread_create(&set_thread, set_stack, STACK_SIZE, set_waiter,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(1));
+	zassert_equal(poll_result, 1, "waiter not pended");
+	k_poll_set_cancel(&set);
+	k_thread_join(&set_thread, K_FOREVER);
+	zassert_equal(poll_result, -ECANCELED, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, 4, K_FOREVER), -ECANCELED,
+		      NULL);
+
+	remove_set();
+}
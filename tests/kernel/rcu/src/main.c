@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+#include <sys/rcu.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define N_THREADS 3
+/* higher than the test thread's, so spawned threads run at once */
+#define THREAD_PRIO K_PRIO_PREEMPT(5)
+#define N_UPDATES 200
+#define POISON 0xdeadbeef
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstacks, N_THREADS, STACK_SIZE);
+static struct k_thread tdata[N_THREADS];
+
+static K_SEM_DEFINE(entered, 0, N_THREADS);
+static K_SEM_DEFINE(leave, 0, N_THREADS);
+static K_SEM_DEFINE(reclaimed, 0, 1);
+static K_SEM_DEFINE(done, 0, 1);
+static K_SEM_DEFINE(victim_exit, 0, 1);
+static volatile bool synchronized;
+static volatile bool reader_left;
+
+extern void test_seqlock(void);
+extern void test_seqlock_concurrent(void);
+
+static void spawn(int i, k_thread_entry_t entry, int prio)
+{
+	k_thread_create(&tdata[i], tstacks[i], STACK_SIZE, entry,
+			NULL, NULL, NULL, prio, 0, K_NO_WAIT);
+}
+
+static void treader(void *p1, void *p2, void *p3)
+{
+	unsigned int token = sys_rcu_read_lock();
+
+	k_sem_give(&entered);
+	k_sem_take(&leave, K_FOREVER);
+	reader_left = true;
+	sys_rcu_read_unlock(token);
+}
+
+static void tsynchronize(void *p1, void *p2, void *p3)
+{
+	sys_rcu_synchronize();
+	synchronized = true;
+	k_sem_give(&done);
+}
+
+/**
+ * @defgroup kernel_rcu_tests Read-Copy-Update
+ * @ingroup all_tests
+ * @{
+ */
+
+/**
+ * @brief Test grace periods
+ *
+ * @details Check that a grace period waits for a reader that entered
+ * before it started, even one that blocks, but not for readers that
+ * entered after it started, and ends at once without readers.
+ *
+ * @see sys_rcu_read_lock(), sys_rcu_read_unlock(), sys_rcu_synchronize()
+ */
+void test_rcu_grace_period(void)
+{
+	unsigned int token, nested;
+
+	sys_rcu_synchronize();
+
+	token = sys_rcu_read_lock();
+	nested = sys_rcu_read_lock();
+	sys_rcu_read_unlock(nested);
+	sys_rcu_read_unlock(token);
+	sys_rcu_synchronize();
+
+	synchronized = false;
+	reader_left = false;
+	spawn(0, treader, THREAD_PRIO);
+	zassert_equal(k_sem_take(&entered, K_NO_WAIT), 0, NULL);
+	spawn(1, tsynchronize, THREAD_PRIO);
+	zassert_false(synchronized, NULL);
+
+	/* a reader entering now doesn't hold up the grace period; joining
+	 * a thread waits for a grace period, so wait for it to end with a
+	 * semaphore instead
+	 */
+	token = sys_rcu_read_lock();
+	k_sem_give(&leave);
+	zassert_equal(k_sem_take(&done, K_MSEC(500)), 0, NULL);
+	zassert_true(synchronized, NULL);
+	zassert_true(reader_left, NULL);
+	sys_rcu_read_unlock(token);
+	k_thread_join(&tdata[0], K_FOREVER);
+	k_thread_join(&tdata[1], K_FOREVER);
+}
+
+struct element {
+	struct sys_rcu_head rcu;
+	uint32_t value;
+};
+
+static struct element elements[2];
+
+static void reclaim(struct sys_rcu_head *head)
+{
+	struct element *elem = CONTAINER_OF(head, struct element, rcu);
+
+	elem->value = POISON;
+	k_sem_give(&reclaimed);
+}
+
+static void offload_call(const void *param)
+{
+	sys_rcu_call((struct sys_rcu_head *)param, reclaim);
+}
+
+/**
+ * @brief Test deferred reclaim
+ *
+ * @details Queue a callback from an ISR while a reader holds a reference,
+ * and check it runs only once the reader has left.
+ *
+ * @see sys_rcu_call()
+ */
+void test_rcu_call(void)
+{
+	reader_left = false;
+	elements[0].value = 1;
+	spawn(0, treader, THREAD_PRIO);
+	zassert_equal(k_sem_take(&entered, K_NO_WAIT), 0, NULL);
+
+	irq_offload(offload_call, &elements[0].rcu);
+	zassert_equal(k_sem_take(&reclaimed, K_MSEC(50)), -EAGAIN, NULL);
+	zassert_equal(elements[0].value, 1, NULL);
+
+	k_sem_give(&leave);
+	zassert_equal(k_sem_take(&reclaimed, K_MSEC(500)), 0, NULL);
+	zassert_true(reader_left, NULL);
+	zassert_equal(elements[0].value, POISON, NULL);
+	k_thread_join(&tdata[0], K_FOREVER);
+}
+
+static struct element *volatile published;
+static atomic_t stop;
+static atomic_t bad_reads;
+
+static void tlist_reader(void *p1, void *p2, void *p3)
+{
+	while (!atomic_get(&stop)) {
+		unsigned int token = sys_rcu_read_lock();
+		struct element *elem = SYS_RCU_DEREFERENCE(published);
+		uint32_t value = elem->value;
+
+		k_yield();
+		if ((value == POISON) || (elem->value != value)) {
+			atomic_inc(&bad_reads);
+		}
+		sys_rcu_read_unlock(token);
+	}
+}
+
+/**
+ * @brief Test replacing an element under concurrent readers
+ *
+ * @details Have readers dereference a published element and check it
+ * while a writer repeatedly publishes a copy, waits for a grace period
+ * and poisons the old one. No reader may see a poisoned element or one
+ * changing under it. On SMP the readers run on other CPUs.
+ *
+ * @see SYS_RCU_ASSIGN_POINTER(), SYS_RCU_DEREFERENCE()
+ */
+void test_rcu_replace(void)
+{
+	int cur = 0;
+
+	elements[0].value = 0;
+	published = &elements[0];
+	atomic_clear(&stop);
+	atomic_clear(&bad_reads);
+
+	for (int i = 0; i < N_THREADS; i++) {
+		spawn(i, tlist_reader,
+		      K_PRIO_PREEMPT(CONFIG_ZTEST_THREAD_PRIORITY));
+	}
+
+	for (uint32_t v = 1; v <= N_UPDATES; v++) {
+		struct element *old = &elements[cur];
+
+		cur = !cur;
+		elements[cur].value = v;
+		SYS_RCU_ASSIGN_POINTER(published, &elements[cur]);
+		sys_rcu_synchronize();
+		old->value = POISON;
+		k_yield();
+	}
+
+	atomic_set(&stop, 1);
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_join(&tdata[i], K_FOREVER);
+	}
+	zassert_equal(atomic_get(&bad_reads), 0, NULL);
+}
+
+static void tvictim(void *p1, void *p2, void *p3)
+{
+	k_sem_take(&victim_exit, K_FOREVER);
+}
+
+static void visit_thread(const struct k_thread *thread, void *user_data)
+{
+	/* linger on the first thread, until the main thread gives */
+	if (k_sem_count_get(&entered) == 0) {
+		k_sem_give(&entered);
+		k_sem_take(&leave, K_FOREVER);
+	}
+}
+
+static void twalker(void *p1, void *p2, void *p3)
+{
+	k_thread_foreach_unlocked(visit_thread, NULL);
+	reader_left = true;
+}
+
+static void leave_expired(struct k_timer *timer)
+{
+	k_sem_give(&leave);
+}
+
+/**
+ * @brief Test joining a thread while threads are being walked
+ *
+ * @details Check k_thread_join() doesn't return before a call of
+ * k_thread_foreach_unlocked() that was in progress when the joined thread
+ * exited, and may still visit it, has returned, and that it returns
+ * -EBUSY instead with K_NO_WAIT.  Check it returns at once, even with
+ * K_NO_WAIT, for a thread that exited while no walk was in progress, or
+ * once the walks in progress when it exited have returned.
+ *
+ * @see k_thread_foreach_unlocked(), k_thread_join()
+ */
+void test_rcu_thread_join(void)
+{
+	struct k_timer timer;
+
+	reader_left = false;
+	k_sem_reset(&entered);
+	k_sem_reset(&leave);
+
+	k_sem_reset(&victim_exit);
+
+	spawn(0, tvictim, THREAD_PRIO);
+	spawn(1, twalker, THREAD_PRIO);
+	zassert_equal(k_sem_count_get(&entered), 1, NULL);
+	zassert_false(reader_left, NULL);
+
+	/* the victim exits while the walker is still in the list */
+	k_sem_give(&victim_exit);
+	zassert_equal(k_thread_join(&tdata[0], K_NO_WAIT), -EBUSY, NULL);
+
+	k_timer_init(&timer, leave_expired, NULL);
+	k_timer_start(&timer, K_MSEC(50), K_NO_WAIT);
+	zassert_equal(k_thread_join(&tdata[0], K_FOREVER), 0, NULL);
+	zassert_true(reader_left, NULL);
+
+	k_thread_join(&tdata[1], K_FOREVER);
+	k_sem_reset(&entered);
+
+	/* no walk in progress, so nothing to wait for */
+	spawn(0, tvictim, THREAD_PRIO);
+	k_sem_give(&victim_exit);
+	zassert_equal(k_thread_join(&tdata[0], K_NO_WAIT), 0, NULL);
+
+	/* the walk in progress at exit has returned since */
+	reader_left = false;
+	spawn(0, tvictim, THREAD_PRIO);
+	spawn(1, twalker, THREAD_PRIO);
+	k_sem_give(&victim_exit);
+	zassert_equal(k_thread_join(&tdata[0], K_NO_WAIT), -EBUSY, NULL);
+	k_sem_give(&leave);
+	k_thread_join(&tdata[1], K_FOREVER);
+	zassert_true(reader_left, NULL);
+	zassert_equal(k_thread_join(&tdata[0], K_NO_WAIT), 0, NULL);
+	k_sem_reset(&entered);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(rcu,
+			 ztest_unit_test(test_seqlock),
+			 ztest_unit_test(test_seqlock_concurrent),
+			 ztest_1cpu_unit_test(test_rcu_grace_period),
+			 ztest_1cpu_unit_test(test_rcu_call),
+			 ztest_unit_test(test_rcu_replace),
+			 ztest_1cpu_unit_test(test_rcu_thread_join));
+	ztest_run_test_suite(rcu);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/seqlock.h>
+
+#define N_READS 20000
+
+static SYS_SEQLOCK_DEFINE(kseqlock);
+static struct sys_seqlock seqlock;
+
+/* the two halves always hold the same value */
+static volatile uint32_t pair[2];
+
+static void update_pair(struct k_timer *timer)
+{
+	k_spinlock_key_t key = sys_seqlock_write_lock(&seqlock);
+
+	pair[0]++;
+	pair[1]++;
+	sys_seqlock_write_unlock(&seqlock, key);
+}
+
+/**
+ * @addtogroup kernel_rcu_tests
+ * @{
+ */
+
+/**
+ * @brief Test sequence lock reads and writes
+ *
+ * @details Check that a read must be retried when a write started or
+ * completed since it began, and only then.
+ *
+ * @see sys_seqlock_read_begin(), sys_seqlock_read_retry(),
+ * sys_seqlock_write_lock(), sys_seqlock_write_unlock()
+ */
+void test_seqlock(void)
+{
+	k_spinlock_key_t key;
+	uint32_t seq, inner;
+
+	seq = sys_seqlock_read_begin(&kseqlock);
+	zassert_false(sys_seqlock_read_retry(&kseqlock, seq), NULL);
+
+	key = sys_seqlock_write_lock(&kseqlock);
+	/* a reader interrupting the writer retries */
+	inner = sys_seqlock_read_begin(&kseqlock);
+	zassert_true(sys_seqlock_read_retry(&kseqlock, inner), NULL);
+	sys_seqlock_write_unlock(&kseqlock, key);
+
+	zassert_true(sys_seqlock_read_retry(&kseqlock, seq), NULL);
+	seq = sys_seqlock_read_begin(&kseqlock);
+	zassert_false(sys_seqlock_read_retry(&kseqlock, seq), NULL);
+}
+
+/**
+ * @brief Test sequence lock reads racing with writes
+ *
+ * @details Have a timer update a pair of values while a thread reads
+ * them, and check the reader never accepts a torn pair.
+ *
+ * @see sys_seqlock_read_begin(), sys_seqlock_read_retry()
+ */
+void test_seqlock_concurrent(void)
+{
+	struct k_timer timer;
+	uint32_t seq, a, b;
+	int retries = 0;
+
+	sys_seqlock_init(&seqlock);
+	k_timer_init(&timer, update_pair, NULL);
+	k_timer_start(&timer, K_MSEC(1), K_MSEC(1));
+
+	for (int i = 0; i < N_READS; i++) {
+		do {
+			seq = sys_seqlock_read_begin(&seqlock);
+			a = pair[0];
+			k_busy_wait(1);
+			b = pair[1];
+			retries++;
+		} while (sys_seqlock_read_retry(&seqlock, seq));
+		zassert_equal(a, b, "torn read %u %u", a, b);
+	}
+
+	k_timer_stop(&timer);
+	zassert_true(pair[0] > 0, NULL);
+	TC_PRINT("%d reads, %d retries\n", N_READS, retries - N_READS);
+}
+
+/**
+ * @}
+ */
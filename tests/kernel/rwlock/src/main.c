@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define N_THREADS 3
+/* higher than the test thread's, so spawned threads run at once */
+#define THREAD_PRIO K_PRIO_PREEMPT(5)
+#define STRESS_PRIO K_PRIO_PREEMPT(CONFIG_ZTEST_THREAD_PRIORITY)
+#define STRESS_ROUNDS 2000
+
+/**TESTPOINT: init via K_RWLOCK_DEFINE*/
+K_RWLOCK_DEFINE(krwlock);
+static struct k_rwlock rwlock;
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstacks, N_THREADS, STACK_SIZE);
+static struct k_thread tdata[N_THREADS];
+
+/* order in which the spawned threads got the lock */
+static char order[N_THREADS + 1];
+static atomic_t order_len;
+
+static void got_lock(char who)
+{
+	order[atomic_inc(&order_len)] = who;
+}
+
+static void reset_order(void)
+{
+	memset(order, 0, sizeof(order));
+	atomic_clear(&order_len);
+}
+
+static void treader(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_FOREVER), 0, NULL);
+	got_lock('r');
+	k_rwlock_read_unlock(&rwlock);
+}
+
+static void twriter(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_FOREVER), 0, NULL);
+	got_lock('w');
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+}
+
+static void twriter_timeout(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_MSEC(50)), -EAGAIN,
+		      NULL);
+	got_lock('t');
+}
+
+static void tunlock_other(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_rwlock_write_unlock(&rwlock), -EPERM, NULL);
+}
+
+static void spawn(int i, k_thread_entry_t entry, int prio)
+{
+	k_thread_create(&tdata[i], tstacks[i], STACK_SIZE, entry,
+			NULL, NULL, NULL, prio, 0, K_NO_WAIT);
+}
+
+static void join_all(int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_thread_join(&tdata[i], K_FOREVER);
+	}
+}
+
+/**
+ * @defgroup kernel_rwlock_tests Reader-Writer Locks
+ * @ingroup all_tests
+ * @{
+ */
+
+/**
+ * @brief Test locking for reading and writing without waiting
+ *
+ * @details Check that readers share the lock, that a writer excludes
+ * readers and other writers, and that the writer can't lock it again and
+ * only the writer can unlock it. Runs in user mode when available.
+ *
+ * @see k_rwlock_init(), k_rwlock_read_lock(), k_rwlock_read_unlock(),
+ * k_rwlock_write_lock(), k_rwlock_write_unlock()
+ */
+void test_rwlock_no_wait(void)
+{
+	struct k_rwlock *rw = &krwlock;
+
+	zassert_equal(k_rwlock_read_lock(rw, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_read_lock(rw, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(rw, K_NO_WAIT), -EBUSY, NULL);
+	k_rwlock_read_unlock(rw);
+	zassert_equal(k_rwlock_write_lock(rw, K_NO_WAIT), -EBUSY, NULL);
+	k_rwlock_read_unlock(rw);
+
+	zassert_equal(k_rwlock_write_lock(rw, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_read_lock(rw, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_rwlock_write_lock(rw, K_NO_WAIT), -EDEADLK, NULL);
+	zassert_equal(k_rwlock_write_unlock(rw), 0, NULL);
+	zassert_equal(k_rwlock_write_unlock(rw), -EPERM, NULL);
+
+	zassert_equal(k_rwlock_read_lock(rw, K_NO_WAIT), 0, NULL);
+	k_rwlock_read_unlock(rw);
+}
+
+/**
+ * @brief Test waiting readers and writers
+ *
+ * @details Check that a writer waiting for readers keeps new readers
+ * out, that the lock goes to waiting writers before waiting readers, and
+ * that only the owner can unlock it for writing.
+ *
+ * @see k_rwlock_read_lock(), k_rwlock_write_lock()
+ */
+void test_rwlock_writer_preference(void)
+{
+	k_rwlock_init(&rwlock);
+	reset_order();
+
+	/* a writer waits for a reader, and keeps new readers out */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	spawn(0, twriter, THREAD_PRIO);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+	spawn(1, treader, THREAD_PRIO);
+	zassert_equal(atomic_get(&order_len), 0, NULL);
+	k_rwlock_read_unlock(&rwlock);
+	join_all(2);
+	zassert_mem_equal(order, "wr", 2, NULL);
+
+	/* waiting writers go first */
+	reset_order();
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	spawn(0, treader, THREAD_PRIO);
+	spawn(1, twriter, THREAD_PRIO);
+	spawn(2, tunlock_other, THREAD_PRIO);
+	k_thread_join(&tdata[2], K_FOREVER);
+	zassert_equal(atomic_get(&order_len), 0, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+	join_all(2);
+	zassert_mem_equal(order, "wr", 2, NULL);
+}
+
+/**
+ * @brief Test timing out on a reader-writer lock
+ *
+ * @details Check that readers and writers time out, and that a writer
+ * which times out waiting for readers lets readers in again and hands the
+ * lock over to a waiting writer.
+ *
+ * @see k_rwlock_read_lock(), k_rwlock_write_lock()
+ */
+void test_rwlock_timeout(void)
+{
+	int64_t start;
+
+	k_rwlock_init(&rwlock);
+	reset_order();
+
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	start = k_uptime_get();
+	spawn(0, twriter_timeout, THREAD_PRIO);
+	zassert_equal(k_thread_join(&tdata[0], K_MSEC(500)), 0, NULL);
+	zassert_true(k_uptime_get() - start >= 50, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+
+	/* a writer gives up waiting for a reader */
+	reset_order();
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	spawn(0, twriter_timeout, THREAD_PRIO);
+	spawn(1, twriter, THREAD_PRIO);
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_MSEC(10)), -EAGAIN, NULL);
+	k_thread_join(&tdata[0], K_FOREVER);
+	zassert_equal(atomic_get(&order_len), 1, NULL);
+
+	/* the next writer still waits for the reader */
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), -EBUSY, NULL);
+	k_rwlock_read_unlock(&rwlock);
+	k_thread_join(&tdata[1], K_FOREVER);
+	zassert_mem_equal(order, "tw", 2, NULL);
+
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	k_rwlock_read_unlock(&rwlock);
+}
+
+static ZTEST_BMEM volatile int stress_readers;
+static ZTEST_BMEM volatile int stress_writers;
+static ZTEST_BMEM atomic_t stress_errors;
+
+static void tstress(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < STRESS_ROUNDS; i++) {
+		if ((i % 8) == 0) {
+			k_rwlock_write_lock(&rwlock, K_FOREVER);
+			stress_writers++;
+			if ((stress_writers != 1) || (stress_readers != 0)) {
+				atomic_inc(&stress_errors);
+			}
+			stress_writers--;
+			k_rwlock_write_unlock(&rwlock);
+		} else {
+			k_rwlock_read_lock(&rwlock, K_FOREVER);
+			if (stress_writers != 0) {
+				atomic_inc(&stress_errors);
+			}
+			k_rwlock_read_unlock(&rwlock);
+		}
+		if ((i % 16) == 0) {
+			k_yield();
+		}
+	}
+}
+
+/**
+ * @brief Test concurrent readers and writers
+ *
+ * @details Have several threads lock for reading and writing, and check
+ * no reader ever sees a writer and no writer sees anyone else. On SMP
+ * the threads run on different CPUs.
+ *
+ * @see k_rwlock_read_lock(), k_rwlock_write_lock()
+ */
+void test_rwlock_concurrent(void)
+{
+	k_rwlock_init(&rwlock);
+
+	for (int i = 0; i < N_THREADS; i++) {
+		spawn(i, tstress, STRESS_PRIO);
+	}
+	tstress(NULL, NULL, NULL);
+	join_all(N_THREADS);
+
+	zassert_equal(atomic_get(&stress_errors), 0, NULL);
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_rwlock_write_unlock(&rwlock), 0, NULL);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	k_thread_access_grant(k_current_get(), &krwlock);
+
+	ztest_test_suite(rwlock,
+			 ztest_user_unit_test(test_rwlock_no_wait),
+			 ztest_1cpu_unit_test(test_rwlock_writer_preference),
+			 ztest_1cpu_unit_test(test_rwlock_timeout),
+			 ztest_unit_test(test_rwlock_concurrent));
+	ztest_run_test_suite(rwlock);
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define HOG_PRIO K_PRIO_PREEMPT(1)
+#define HOG_MS 500
+
+static K_THREAD_STACK_DEFINE(hog_stack, STACK_SIZE);
+static struct k_thread hog_thread;
+
+/* at least 90 % of the cycles in that many microseconds */
+static uint64_t min_cycles(uint32_t us)
+{
+	return k_us_to_cyc_floor64(us) * 9U / 10U;
+}
+
+/* the CPU the test runs on, which nothing else is scheduled on */
+static int curr_cpu(void)
+{
+	unsigned int k = arch_irq_lock();
+	int ret = arch_curr_cpu()->id;
+
+	arch_irq_unlock(k);
+	return ret;
+}
+
+/* the busy load of all the CPUs together */
+static uint32_t busy_load(int window)
+{
+	struct k_cpu_load cpu_load;
+	uint32_t sum = 0U;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		zassert_equal(k_cpu_load_get(i, &cpu_load), 0, NULL);
+		sum += cpu_load.busy.avg[window];
+	}
+
+	return sum;
+}
+
+/**
+ * @brief Test the runtime statistics of a CPU
+ *
+ * @ingroup kernel_thread_tests
+ *
+ * @details Check the time spent busy waiting in a thread is accounted as
+ * busy, and the time spent sleeping as idle.
+ *
+ * @see k_cpu_runtime_stats_get()
+ */
+void test_cpu_runtime_stats(void)
+{
+	struct k_cpu_runtime_stats before, after;
+	int cpu = curr_cpu();
+
+	zassert_equal(k_cpu_runtime_stats_get(-1, &before), -EINVAL, NULL);
+	zassert_equal(k_cpu_runtime_stats_get(CONFIG_MP_NUM_CPUS, &before),
+		      -EINVAL, NULL);
+
+	zassert_equal(k_cpu_runtime_stats_get(cpu, &before), 0, NULL);
+	k_busy_wait(10000);
+	zassert_equal(k_cpu_runtime_stats_get(cpu, &after), 0, NULL);
+	zassert_true(after.busy_cycles - before.busy_cycles >=
+		     min_cycles(10000), NULL);
+	zassert_true(after.idle_cycles - before.idle_cycles <
+		     min_cycles(1000), NULL);
+
+	/* that CPU idles while the test sleeps, wherever it wakes up */
+	before = after;
+	k_sleep(K_MSEC(10));
+	zassert_equal(k_cpu_runtime_stats_get(cpu, &after), 0, NULL);
+	zassert_true(after.idle_cycles - before.idle_cycles >=
+		     min_cycles(10000), NULL);
+	zassert_true(after.busy_cycles - before.busy_cycles <
+		     min_cycles(1000), NULL);
+}
+
+static void offload_busy(const void *param)
+{
+	k_busy_wait(POINTER_TO_UINT(param));
+}
+
+/**
+ * @brief Test the time spent in ISRs
+ *
+ * @ingroup kernel_thread_tests
+ *
+ * @details Busy wait in an ISR, and check the time is accounted to ISRs,
+ * not to the interrupted thread.
+ *
+ * @see k_cpu_runtime_stats_get(), k_thread_runtime_stats_get()
+ */
+void test_isr_stats(void)
+{
+	struct k_cpu_runtime_stats before, after;
+	k_thread_runtime_stats_t tbefore, tafter;
+	int cpu;
+
+	if (!IS_ENABLED(CONFIG_CPU_LOAD_ISR)) {
+		ztest_test_skip();
+	}
+
+	cpu = curr_cpu();
+	zassert_equal(k_cpu_runtime_stats_get(cpu, &before), 0, NULL);
+	zassert_equal(k_thread_runtime_stats_get(k_current_get(), &tbefore), 0,
+		      NULL);
+	irq_offload(offload_busy, UINT_TO_POINTER(10000));
+	zassert_equal(k_cpu_runtime_stats_get(cpu, &after), 0, NULL);
+	zassert_equal(k_thread_runtime_stats_get(k_current_get(), &tafter), 0,
+		      NULL);
+
+	zassert_true(after.isr_cycles - before.isr_cycles >=
+		     min_cycles(10000), NULL);
+	zassert_true(tafter.execution_cycles - tbefore.execution_cycles <
+		     min_cycles(1000), NULL);
+}
+
+static void hog(void *p1, void *p2, void *p3)
+{
+	k_busy_wait(HOG_MS * USEC_PER_MSEC);
+}
+
+/**
+ * @brief Test load averages
+ *
+ * @ingroup kernel_thread_tests
+ *
+ * @details Have a thread busy wait for half the medium window, and check
+ * its load and the load of the CPUs over each window, then that the short
+ * window load drops once it exited.
+ *
+ * @see k_cpu_load_get(), k_thread_load_get()
+ */
+void test_load_avg(void)
+{
+	struct k_cpu_load cpu_load;
+	struct k_load_avg load;
+
+	zassert_equal(k_cpu_load_get(CONFIG_MP_NUM_CPUS, &cpu_load), -EINVAL,
+		      NULL);
+	zassert_equal(k_thread_load_get(NULL, &load), -EINVAL, NULL);
+
+	/* let the loads of the previous tests decay */
+	k_sleep(K_MSEC(CONFIG_CPU_LOAD_WINDOW_MEDIUM * 3));
+
+	k_thread_create(&hog_thread, hog_stack, STACK_SIZE, hog,
+			NULL, NULL, NULL, HOG_PRIO, 0, K_NO_WAIT);
+	k_sleep(K_MSEC(HOG_MS - 50));
+
+	zassert_equal(k_thread_load_get(&hog_thread, &load), 0, NULL);
+	zassert_true(load.avg[K_LOAD_WINDOW_SHORT] >= 900U, "%u",
+		     load.avg[K_LOAD_WINDOW_SHORT]);
+	zassert_true(load.avg[K_LOAD_WINDOW_MEDIUM] >= 250U &&
+		     load.avg[K_LOAD_WINDOW_MEDIUM] <= 600U, "%u",
+		     load.avg[K_LOAD_WINDOW_MEDIUM]);
+	zassert_true(load.avg[K_LOAD_WINDOW_LONG] >= 20U &&
+		     load.avg[K_LOAD_WINDOW_LONG] <= 150U, "%u",
+		     load.avg[K_LOAD_WINDOW_LONG]);
+
+	zassert_true(busy_load(K_LOAD_WINDOW_SHORT) >= 900U, "%u",
+		     busy_load(K_LOAD_WINDOW_SHORT));
+	zassert_true(busy_load(K_LOAD_WINDOW_MEDIUM) >=
+		     load.avg[K_LOAD_WINDOW_MEDIUM], NULL);
+
+	k_thread_join(&hog_thread, K_FOREVER);
+	k_sleep(K_MSEC(CONFIG_CPU_LOAD_WINDOW_SHORT * 3));
+
+	zassert_true(busy_load(K_LOAD_WINDOW_SHORT) <= 100U, "%u",
+		     busy_load(K_LOAD_WINDOW_SHORT));
+	zassert_true(busy_load(K_LOAD_WINDOW_MEDIUM) > 100U, "%u",
+		     busy_load(K_LOAD_WINDOW_MEDIUM));
+}
+
+static void thread_load(const struct k_thread *cthread, void *user_data)
+{
+	struct k_load_avg load;
+
+	/* the thread list is locked, assert once it is released */
+	if (k_thread_load_get((k_tid_t)cthread, &load) != 0) {
+		(*(uint32_t *)user_data)++;
+	}
+}
+
+/**
+ * @brief Test reading thread loads while walking the threads
+ *
+ * @ingroup kernel_thread_tests
+ *
+ * @details Get the load of every thread from k_thread_foreach(), as the
+ * kernel shell does, over several sampling periods.  On SMP the sampling
+ * timer then walks the threads on another CPU at the same time.
+ *
+ * @see k_thread_load_get(), k_thread_foreach()
+ */
+void test_load_foreach(void)
+{
+	int64_t end = k_uptime_get() + CONFIG_CPU_LOAD_SAMPLE_PERIOD * 3;
+	uint32_t failed = 0U;
+
+	while (k_uptime_get() < end) {
+		k_thread_foreach(thread_load, &failed);
+	}
+
+	zassert_equal(failed, 0U, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(cpu_load,
+			 ztest_unit_test(test_cpu_runtime_stats),
+			 ztest_unit_test(test_isr_stats),
+			 ztest_unit_test(test_load_avg),
+			 ztest_unit_test(test_load_foreach));
+	ztest_run_test_suite(cpu_load);
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define NUM_WORKERS 3
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WORKER_PRIO K_PRIO_PREEMPT(1)
+#define NUM_RUNS 20
+
+static K_KERNEL_STACK_ARRAY_DEFINE(pool_stacks, NUM_WORKERS, STACK_SIZE);
+static struct k_work_q_worker pool_workers[NUM_WORKERS];
+static struct k_work_q pool;
+
+static struct k_work blocking_work[NUM_WORKERS + 2];
+static struct k_work quick_work;
+static struct k_work repeat_work;
+static struct k_work current_work;
+static struct k_work sys_current_work;
+
+static K_SEM_DEFINE(blocked, 0, NUM_WORKERS + 2);
+static K_SEM_DEFINE(unblock, 0, NUM_WORKERS + 2);
+static K_SEM_DEFINE(quick_done, 0, 1);
+
+static atomic_t running;
+static atomic_t max_running;
+static atomic_t runs;
+static volatile bool on_pool;
+static volatile bool on_sys_work_q;
+
+static void blocking_handler(struct k_work *work)
+{
+	k_sem_give(&blocked);
+	k_sem_take(&unblock, K_FOREVER);
+}
+
+static void quick_handler(struct k_work *work)
+{
+	k_sem_give(&quick_done);
+}
+
+static void current_handler(struct k_work *work)
+{
+	on_pool = k_work_q_is_current(&pool);
+	on_sys_work_q = k_work_q_is_current(&k_sys_work_q);
+	k_sem_give(&quick_done);
+}
+
+static void repeat_handler(struct k_work *work)
+{
+	atomic_val_t now = atomic_inc(&running) + 1;
+
+	if (now > atomic_get(&max_running)) {
+		atomic_set(&max_running, now);
+	}
+
+	/* let other workers take the resubmitted item meanwhile */
+	k_sleep(K_MSEC(1));
+	atomic_inc(&runs);
+	atomic_dec(&running);
+}
+
+/**
+ * @brief Test that a blocked handler doesn't hold up other work items
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Block one worker of a pool in a handler, and check that a work
+ * item submitted after it is run meanwhile by another worker.
+ *
+ * @see k_work_q_pool_start()
+ */
+void test_pool_blocked_handler(void)
+{
+	k_work_submit_to_queue(&pool, &blocking_work[0]);
+	zassert_equal(k_sem_take(&blocked, K_MSEC(100)), 0, NULL);
+
+	k_work_submit_to_queue(&pool, &quick_work);
+	zassert_equal(k_sem_take(&quick_done, K_MSEC(100)), 0, NULL);
+
+	k_sem_give(&unblock);
+	k_sleep(K_MSEC(10));
+}
+
+/**
+ * @brief Test that a work item doesn't run concurrently with itself
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Resubmit a work item while its handler runs, and check it is
+ * run again afterwards, but never by two workers at once.
+ *
+ * @see k_work_q_pool_start()
+ */
+void test_pool_no_self_concurrency(void)
+{
+	atomic_clear(&running);
+	atomic_clear(&max_running);
+	atomic_clear(&runs);
+
+	for (int i = 0; i < NUM_RUNS; i++) {
+		k_work_submit_to_queue(&pool, &repeat_work);
+		k_sleep(K_USEC(500));
+	}
+
+	k_sleep(K_MSEC(10));
+	zassert_equal(atomic_get(&max_running), 1, NULL);
+	zassert_true(atomic_get(&runs) >= NUM_RUNS / 2, "ran %d times",
+		     (int)atomic_get(&runs));
+	zassert_false(k_work_pending(&repeat_work), NULL);
+}
+
+/**
+ * @brief Test workqueue pool statistics
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Block every worker, queue more work items, and check the depth
+ * and busy workers reported, then the handlers counted once unblocked.
+ *
+ * @see k_work_q_pool_stats_get()
+ */
+void test_pool_stats(void)
+{
+	struct k_work_q_pool_stats before, stats;
+	struct k_work_q other;
+
+	other.workers = NULL;
+	zassert_equal(k_work_q_pool_stats_get(&other, &stats), -EINVAL, NULL);
+
+	zassert_equal(k_work_q_pool_stats_get(&pool, &before), 0, NULL);
+	zassert_equal(before.depth, 0, NULL);
+	zassert_equal(before.busy, 0, NULL);
+
+	for (int i = 0; i < ARRAY_SIZE(blocking_work); i++) {
+		k_work_submit_to_queue(&pool, &blocking_work[i]);
+	}
+
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		zassert_equal(k_sem_take(&blocked, K_MSEC(100)), 0, NULL);
+	}
+
+	zassert_equal(k_work_q_pool_stats_get(&pool, &stats), 0, NULL);
+	zassert_equal(stats.depth, ARRAY_SIZE(blocking_work) - NUM_WORKERS,
+		      NULL);
+	zassert_equal(stats.busy, NUM_WORKERS, NULL);
+
+	/* have the handlers take some time */
+	k_sleep(K_MSEC(1));
+	for (int i = 0; i < ARRAY_SIZE(blocking_work); i++) {
+		k_sem_give(&unblock);
+	}
+	k_sleep(K_MSEC(10));
+	k_sem_reset(&blocked);
+
+	zassert_equal(k_work_q_pool_stats_get(&pool, &stats), 0, NULL);
+	zassert_equal(stats.depth, 0, NULL);
+	zassert_equal(stats.busy, 0, NULL);
+	zassert_equal(stats.handled - before.handled,
+		      ARRAY_SIZE(blocking_work), NULL);
+	zassert_true(stats.handler_cycles > before.handler_cycles, NULL);
+	zassert_true(stats.max_handler_cycles > 0, NULL);
+}
+
+/**
+ * @brief Test telling whether the caller is a workqueue thread
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Check that k_work_q_is_current() recognizes the workers of a
+ * pool and the thread of the system workqueue, and no other thread.
+ *
+ * @see k_work_q_is_current()
+ */
+void test_pool_is_current(void)
+{
+	zassert_false(k_work_q_is_current(&pool), NULL);
+	zassert_false(k_work_q_is_current(&k_sys_work_q), NULL);
+
+	k_work_submit_to_queue(&pool, &current_work);
+	zassert_equal(k_sem_take(&quick_done, K_MSEC(100)), 0, NULL);
+	zassert_true(on_pool, NULL);
+	zassert_false(on_sys_work_q, NULL);
+
+	k_work_submit(&sys_current_work);
+	zassert_equal(k_sem_take(&quick_done, K_MSEC(100)), 0, NULL);
+	zassert_false(on_pool, NULL);
+	zassert_true(on_sys_work_q, NULL);
+}
+
+void test_main(void)
+{
+	k_work_q_pool_start(&pool, pool_workers,
+			    (k_thread_stack_t *)pool_stacks,
+			    STACK_SIZE, NUM_WORKERS, WORKER_PRIO,
+			    K_WORK_Q_POOL_PIN);
+
+	for (int i = 0; i < ARRAY_SIZE(blocking_work); i++) {
+		k_work_init(&blocking_work[i], blocking_handler);
+	}
+	k_work_init(&quick_work, quick_handler);
+	k_work_init(&repeat_work, repeat_handler);
+	k_work_init(&current_work, current_handler);
+	k_work_init(&sys_current_work, current_handler);
+
+	ztest_test_suite(workqueue_pool,
+			 ztest_unit_test(test_pool_blocked_handler),
+			 ztest_unit_test(test_pool_no_self_concurrency),
+			 ztest_unit_test(test_pool_stats),
+			 ztest_unit_test(test_pool_is_current));
+	ztest_run_test_suite(workqueue_pool);
+}
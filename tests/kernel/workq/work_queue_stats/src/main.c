@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+/* lower than the test thread's, so work items queue up until it sleeps */
+#define WORK_Q_PRIO K_PRIO_PREEMPT(1)
+#define NUM_WORK 4
+
+static K_KERNEL_STACK_DEFINE(work_q_stack, STACK_SIZE);
+static struct k_work_q work_q;
+
+static struct k_work work[NUM_WORK];
+static struct k_work other_work;
+static struct k_delayed_work delayed_work;
+
+static K_SEM_DEFINE(unblock, 0, 1);
+static struct k_work blocking_work;
+
+static atomic_t handled;
+
+static void work_handler(struct k_work *item)
+{
+	/* take some time */
+	k_sleep(K_MSEC(1));
+	atomic_inc(&handled);
+}
+
+static void other_handler(struct k_work *item)
+{
+	atomic_inc(&handled);
+}
+
+static void blocking_handler(struct k_work *item)
+{
+	k_sem_take(&unblock, K_FOREVER);
+}
+
+static uint32_t hist_sum(const struct k_work_q_runtime_stats *stats)
+{
+	uint32_t sum = 0U;
+
+	for (int i = 0; i < K_WORK_Q_LATENCY_BUCKETS; i++) {
+		sum += stats->latency_hist[i];
+	}
+
+	return sum;
+}
+
+static void find_work_q(struct k_work_q *found, void *user_data)
+{
+	if (found == &k_sys_work_q) {
+		*(bool *)user_data = true;
+	}
+}
+
+struct handler_counts {
+	uint32_t work;
+	uint32_t other;
+	uint64_t work_cycles;
+};
+
+static void count_handlers(const struct k_work_handler_stats *hs,
+			   void *user_data)
+{
+	struct handler_counts *counts = user_data;
+
+	if (hs->work_q != &work_q) {
+		return;
+	}
+
+	if (hs->handler == work_handler) {
+		counts->work = hs->count;
+		counts->work_cycles = hs->cycles;
+	} else if (hs->handler == other_handler) {
+		counts->other = hs->count;
+	}
+}
+
+/**
+ * @brief Test the depth and latency statistics of a workqueue
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Queue work items while the workqueue can't run, check the depth
+ * reported, then that every work item is accounted for in the latency
+ * histogram once handled, the later ones having waited for the others.
+ *
+ * @see k_work_q_runtime_stats_get()
+ */
+void test_stats_depth_latency(void)
+{
+	struct k_work_q_runtime_stats stats;
+	struct k_work_q other;
+
+	other.stats_enabled = false;
+	zassert_equal(k_work_q_runtime_stats_get(&other, &stats), -EINVAL,
+		      NULL);
+
+	atomic_clear(&handled);
+	for (int i = 0; i < NUM_WORK; i++) {
+		k_work_submit_to_queue(&work_q, &work[i]);
+	}
+
+	zassert_equal(k_work_q_runtime_stats_get(&work_q, &stats), 0, NULL);
+	zassert_equal(stats.submitted, NUM_WORK, NULL);
+	zassert_equal(stats.depth, NUM_WORK, NULL);
+	zassert_equal(stats.max_depth, NUM_WORK, NULL);
+	zassert_equal(stats.handled, 0, NULL);
+
+	k_sleep(K_MSEC(100));
+	zassert_equal(atomic_get(&handled), NUM_WORK, NULL);
+
+	zassert_equal(k_work_q_runtime_stats_get(&work_q, &stats), 0, NULL);
+	zassert_equal(stats.depth, 0, NULL);
+	zassert_equal(stats.max_depth, NUM_WORK, NULL);
+	zassert_equal(stats.handled, NUM_WORK, NULL);
+	zassert_equal(hist_sum(&stats), NUM_WORK, NULL);
+	zassert_true(stats.max_latency_us >= 1000U, "max latency %u us",
+		     stats.max_latency_us);
+	zassert_true(stats.max_handler_cycles > 0, NULL);
+	zassert_true(stats.handler_cycles >= stats.max_handler_cycles, NULL);
+}
+
+/**
+ * @brief Test the statistics of work handlers
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Run two handlers on a workqueue, and check each is counted
+ * separately, then that resetting the statistics of the workqueue clears
+ * them, except the current depth.
+ *
+ * @see k_work_handler_stats_foreach(), k_work_q_runtime_stats_reset()
+ */
+void test_stats_handlers(void)
+{
+	struct handler_counts before = { 0 }, after = { 0 };
+	struct k_work_q_runtime_stats stats;
+
+	k_work_handler_stats_foreach(count_handlers, &before);
+
+	k_work_submit_to_queue(&work_q, &work[0]);
+	k_work_submit_to_queue(&work_q, &other_work);
+	k_sleep(K_MSEC(100));
+
+	k_work_handler_stats_foreach(count_handlers, &after);
+	zassert_equal(after.work - before.work, 1, NULL);
+	zassert_equal(after.other - before.other, 1, NULL);
+	zassert_true(after.work_cycles > before.work_cycles, NULL);
+
+	k_work_submit_to_queue(&work_q, &other_work);
+	k_work_q_runtime_stats_reset(&work_q);
+
+	zassert_equal(k_work_q_runtime_stats_get(&work_q, &stats), 0, NULL);
+	zassert_equal(stats.submitted, 0, NULL);
+	zassert_equal(stats.handled, 0, NULL);
+	zassert_equal(stats.depth, 1, NULL);
+	zassert_equal(stats.max_depth, 1, NULL);
+
+	after = (struct handler_counts){ 0 };
+	k_work_handler_stats_foreach(count_handlers, &after);
+	zassert_equal(after.work, 0, NULL);
+	zassert_equal(after.other, 0, NULL);
+
+	k_sleep(K_MSEC(100));
+	k_work_handler_stats_foreach(count_handlers, &after);
+	zassert_equal(after.other, 1, NULL);
+}
+
+/**
+ * @brief Test the statistics of delayed work items
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @details Check a delayed work item is only counted once its delay
+ * expired, that cancelling it once queued decrements the depth, and that
+ * its latency doesn't include its delay.
+ *
+ * @see k_delayed_work_submit_to_queue(), k_delayed_work_cancel()
+ */
+void test_stats_delayed_work(void)
+{
+	struct k_work_q_runtime_stats stats;
+
+	k_work_q_runtime_stats_reset(&work_q);
+
+	zassert_equal(k_delayed_work_submit_to_queue(&work_q, &delayed_work,
+						     K_MSEC(10)), 0, NULL);
+	zassert_equal(k_work_q_runtime_stats_get(&work_q, &stats), 0, NULL);
+	zassert_equal(stats.submitted, 0, NULL);
+
+	/* have the workqueue busy while the delay expires */
+	k_work_submit_to_queue(&work_q, &blocking_work);
+	k_sleep(K_MSEC(50));
+
+	zassert_equal(k_work_q_runtime_stats_get(&work_q, &stats), 0, NULL);
+	zassert_equal(stats.submitted, 2, NULL);
+	zassert_equal(stats.depth, 1, NULL);
+
+	zassert_equal(k_delayed_work_cancel(&delayed_work), 0, NULL);
+	zassert_equal(k_work_q_runtime_stats_get(&work_q, &stats), 0, NULL);
+	zassert_equal(stats.depth, 0, NULL);
+
+	k_sem_give(&unblock);
+	k_sleep(K_MSEC(20));
+
+	k_work_q_runtime_stats_reset(&work_q);
+	zassert_equal(k_delayed_work_submit_to_queue(&work_q, &delayed_work,
+						     K_MSEC(50)), 0, NULL);
+	k_sleep(K_MSEC(100));
+
+	zassert_equal(k_work_q_runtime_stats_get(&work_q, &stats), 0, NULL);
+	zassert_equal(stats.handled, 1, NULL);
+	zassert_true(stats.max_latency_us < 50000U, "max latency %u us",
+		     stats.max_latency_us);
+}
+
+/**
+ * @brief Test the system workqueue is instrumented
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @see k_work_q_foreach()
+ */
+void test_stats_system_work_q(void)
+{
+	bool found = false;
+
+	k_work_q_foreach(find_work_q, &found);
+	zassert_true(found, NULL);
+}
+
+void test_main(void)
+{
+	k_work_q_start(&work_q, work_q_stack, STACK_SIZE, WORK_Q_PRIO);
+
+	for (int i = 0; i < NUM_WORK; i++) {
+		k_work_init(&work[i], work_handler);
+	}
+	k_work_init(&other_work, other_handler);
+	k_work_init(&blocking_work, blocking_handler);
+	k_delayed_work_init(&delayed_work, other_handler);
+
+	ztest_test_suite(workqueue_stats,
+			 ztest_unit_test(test_stats_depth_latency),
+			 ztest_unit_test(test_stats_handlers),
+			 ztest_unit_test(test_stats_delayed_work),
+			 ztest_unit_test(test_stats_system_work_q));
+	ztest_run_test_suite(workqueue_stats);
+}
@@ -204,12 +204,224 @@ static void test_big_heap(void)
 	log_result(BIG_HEAP_SZ, &result);
 }
 
+/* Checks that small frees are cached and reused, and that the cache
+ * is flushed back into the heap when an allocation would otherwise
+ * fail: the heap is filled with equal small blocks, a run of
+ * adjacent ones is freed into the cache, and a slightly bigger block
+ * (which only fits once those are merged) is then requested.
+ */
+static void test_cache(void)
+{
+#ifdef CONFIG_SYS_HEAP_CACHE
+	struct sys_heap heap;
+	struct sys_heap_cache_stats stats;
+	void **blocks = (void **)scratchmem;
+	size_t nblocks = sizeof(scratchmem) / sizeof(void *);
+	size_t n = 0;
+	void *p;
+
+	sys_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
+
+	while (n < nblocks && (p = sys_heap_alloc(&heap, 16)) != NULL) {
+		blocks[n++] = p;
+	}
+	zassert_true(n > CONFIG_SYS_HEAP_CACHE_DEPTH, "heap too small");
+
+	for (int i = 0; i < CONFIG_SYS_HEAP_CACHE_DEPTH; i++) {
+		sys_heap_free(&heap, blocks[i]);
+	}
+	zassert_true(sys_heap_validate(&heap), "");
+
+	sys_heap_cache_stats_get(&heap, &stats);
+	zassert_true(stats.cached_bytes > 0, "frees were not cached");
+	zassert_equal(stats.flushes, 0, "");
+
+	/* Reuse one cached block */
+	p = sys_heap_alloc(&heap, 16);
+	zassert_equal(p, blocks[CONFIG_SYS_HEAP_CACHE_DEPTH - 1],
+		      "cached block not reused");
+	sys_heap_cache_stats_get(&heap, &stats);
+	zassert_true(stats.hits >= 1, "");
+	sys_heap_free(&heap, p);
+
+	/* Needs the cached chunks to be merged */
+	p = sys_heap_alloc(&heap, 2 * 16);
+	zassert_not_null(p, "cache not flushed under pressure");
+	sys_heap_cache_stats_get(&heap, &stats);
+	zassert_equal(stats.flushes, 1, "");
+	zassert_equal(stats.cached_bytes, 0, "");
+	zassert_true(sys_heap_validate(&heap), "");
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void realloc_fill(uint8_t *p, size_t sz, uint8_t seed)
+{
+	for (size_t i = 0; i < sz; i++) {
+		p[i] = (uint8_t)(seed + i);
+	}
+}
+
+static bool realloc_check(uint8_t *p, size_t sz, uint8_t seed)
+{
+	for (size_t i = 0; i < sz; i++) {
+		if (p[i] != (uint8_t)(seed + i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void test_realloc(void)
+{
+	struct sys_heap heap;
+	uint8_t *p1, *p2, *p3, *p4;
+
+	sys_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
+
+	/* NULL and zero size follow the C library rules */
+	p1 = sys_heap_realloc(&heap, NULL, 64);
+	zassert_not_null(p1, "realloc(NULL) did not allocate");
+	zassert_is_null(sys_heap_realloc(&heap, p1, 0), "");
+	zassert_true(sys_heap_validate(&heap), "");
+
+	/* Shrink in place */
+	p1 = sys_heap_alloc(&heap, 256);
+	p2 = sys_heap_alloc(&heap, 64);
+	realloc_fill(p1, 256, 1);
+	zassert_true(sys_heap_usable_size(&heap, p1) >= 256, "");
+	zassert_equal(sys_heap_realloc(&heap, p1, 100), p1, "shrink moved");
+	zassert_true(realloc_check(p1, 100, 1), "");
+	zassert_true(sys_heap_usable_size(&heap, p1) >= 100 &&
+		     sys_heap_usable_size(&heap, p1) < 256, "");
+	zassert_true(sys_heap_validate(&heap), "");
+
+	/* Grow in place into the space freed by the shrink */
+	zassert_equal(sys_heap_realloc(&heap, p1, 200), p1, "grow moved");
+	zassert_true(realloc_check(p1, 100, 1), "");
+	zassert_true(sys_heap_validate(&heap), "");
+
+	/* Grow in place into a free right neighbor */
+	realloc_fill(p2, 64, 2);
+	p3 = sys_heap_alloc(&heap, 64);
+	p4 = sys_heap_alloc(&heap, 64);
+	sys_heap_free(&heap, p3);
+	zassert_equal(sys_heap_realloc(&heap, p2, 120), p2, "grow moved");
+	zassert_true(realloc_check(p2, 64, 2), "");
+	zassert_true(sys_heap_validate(&heap), "");
+
+	/* Right neighbor used, left one free: moves down in place */
+	sys_heap_free(&heap, p1);
+	realloc_fill(p2, 120, 3);
+	p3 = sys_heap_realloc(&heap, p2, 300);
+	zassert_equal(p3, p1, "did not grow into the left neighbor");
+	zassert_true(realloc_check(p3, 120, 3), "");
+	zassert_true(sys_heap_validate(&heap), "");
+
+	/* No room next to it: falls back to a copy */
+	p2 = sys_heap_alloc(&heap, 16);
+	p1 = sys_heap_realloc(&heap, p3, 600);
+	zassert_not_null(p1, "");
+	zassert_true(p1 > p4, "copy fallback expected");
+	zassert_true(realloc_check(p1, 120, 3), "");
+	zassert_true(sys_heap_validate(&heap), "");
+
+	/* Failure leaves the original block alone */
+	zassert_is_null(sys_heap_realloc(&heap, p1, SMALL_HEAP_SZ), "");
+	zassert_true(realloc_check(p1, 120, 3), "");
+
+	/* Aligned realloc moves misaligned blocks */
+	p3 = sys_heap_aligned_realloc(&heap, p2, 64, 16);
+	zassert_not_null(p3, "");
+	zassert_equal((uintptr_t)p3 & 63, 0, "misaligned");
+	p3 = sys_heap_aligned_realloc(&heap, p3, 64, 48);
+	zassert_equal((uintptr_t)p3 & 63, 0, "misaligned");
+
+	sys_heap_free(&heap, p1);
+	sys_heap_free(&heap, p3);
+	sys_heap_free(&heap, p4);
+	zassert_true(sys_heap_validate(&heap), "");
+}
+
+static void test_runtime_stats(void)
+{
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+	struct sys_heap heap;
+	struct sys_heap_runtime_stats stats, empty;
+	void *p[8];
+
+	sys_heap_init(&heap, heapmem, SMALL_HEAP_SZ);
+
+	zassert_equal(sys_heap_runtime_stats_get(&heap, NULL), -EINVAL, "");
+	zassert_equal(sys_heap_runtime_stats_get(&heap, &empty), 0, "");
+	zassert_equal(empty.allocated_bytes, 0, "");
+	zassert_equal(empty.max_allocated_bytes, 0, "");
+	zassert_equal(empty.fragmentation, 0, "one free chunk expected");
+	zassert_true(empty.largest_free_bytes < empty.free_bytes, "");
+	zassert_true(empty.free_bytes < SMALL_HEAP_SZ, "");
+
+	for (int i = 0; i < ARRAY_SIZE(p); i++) {
+		p[i] = sys_heap_alloc(&heap, 60);
+		zassert_not_null(p[i], "");
+	}
+	zassert_true(sys_heap_validate(&heap), "");
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_true(stats.allocated_bytes >= ARRAY_SIZE(p) * 60, "");
+	zassert_equal(stats.allocated_bytes + stats.free_bytes,
+		      empty.free_bytes, "bytes lost");
+	zassert_equal(stats.max_allocated_bytes, stats.allocated_bytes, "");
+
+	/* Punch holes: free memory is now scattered */
+	for (int i = 0; i < ARRAY_SIZE(p); i += 2) {
+		sys_heap_free(&heap, p[i]);
+	}
+	zassert_true(sys_heap_validate(&heap), "");
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.allocated_bytes + stats.free_bytes,
+		      empty.free_bytes, "bytes lost");
+	zassert_true(stats.max_allocated_bytes > stats.allocated_bytes, "");
+	zassert_true(stats.fragmentation > 0, "holes not accounted");
+
+	/* realloc keeps the books straight too */
+	p[1] = sys_heap_realloc(&heap, p[1], 100);
+	p[3] = sys_heap_realloc(&heap, p[3], 20);
+	zassert_true(sys_heap_validate(&heap), "");
+
+	sys_heap_runtime_stats_reset_max(&heap);
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.max_allocated_bytes, stats.allocated_bytes, "");
+
+	for (int i = 1; i < ARRAY_SIZE(p); i += 2) {
+		sys_heap_free(&heap, p[i]);
+	}
+#ifdef CONFIG_SYS_HEAP_CACHE
+	sys_heap_cache_flush(&heap);
+#endif
+	zassert_true(sys_heap_validate(&heap), "");
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.allocated_bytes, 0, "");
+	zassert_equal(stats.free_bytes, empty.free_bytes, "");
+	zassert_equal(stats.largest_free_bytes, empty.largest_free_bytes,
+		      "not coalesced");
+	zassert_equal(stats.fragmentation, 0, "");
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_heap_test,
 			 ztest_unit_test(test_small_heap),
 			 ztest_unit_test(test_fragmentation),
-			 ztest_unit_test(test_big_heap)
+			 ztest_unit_test(test_big_heap),
+			 ztest_unit_test(test_cache),
+			 ztest_unit_test(test_realloc),
+			 ztest_unit_test(test_runtime_stats)
 			 );
 
 	ztest_run_test_suite(lib_heap_test);
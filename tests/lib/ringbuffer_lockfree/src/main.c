@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/ring_buffer_lockfree.h>
+
+/**
+ * @defgroup lib_ringbuffer_lockfree_tests Lock-free ringbuffer
+ * @ingroup all_tests
+ * @{
+ * @}
+ */
+
+#define SPSC_SIZE 64
+#define SPSC_STRESS_BYTES 16384
+
+#define MPSC_SIZE32 64
+#define MPSC_THREADS 3
+#define MPSC_THREAD_RECORDS 2000
+#define MPSC_ISR_RECORDS 300
+#define MPSC_PRODUCERS (MPSC_THREADS + 1)
+#define MPSC_MAX_PAYLOAD 24
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+RING_BUF_SPSC_DECLARE(spsc, SPSC_SIZE);
+RING_BUF_MPSC_DECLARE(mpsc, MPSC_SIZE32);
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, MPSC_THREADS, STACK_SIZE);
+static struct k_thread threads[MPSC_THREADS];
+
+static uint8_t pattern(uint32_t seq)
+{
+	return (uint8_t)(seq % 251U);
+}
+
+/**
+ * @brief Test single producer, single consumer put and get
+ *
+ * @details Verify claims are limited by the free space and by the end
+ * of the buffer, and that unused parts of claims are given back.
+ */
+void test_spsc_put_get(void)
+{
+	uint8_t in[SPSC_SIZE], out[SPSC_SIZE];
+	uint8_t *data;
+
+	ring_buf_spsc_init(&spsc, SPSC_SIZE, spsc.buf);
+	zassert_true(ring_buf_spsc_is_empty(&spsc), NULL);
+	zassert_equal(ring_buf_spsc_space_get(&spsc), SPSC_SIZE, NULL);
+
+	for (int i = 0; i < sizeof(in); i++) {
+		in[i] = i;
+	}
+
+	zassert_equal(ring_buf_spsc_put(&spsc, in, 40), 40, NULL);
+	zassert_equal(ring_buf_spsc_space_get(&spsc), SPSC_SIZE - 40, NULL);
+	zassert_equal(ring_buf_spsc_get(&spsc, out, 30), 30, NULL);
+	zassert_mem_equal(out, in, 30, NULL);
+
+	/* 54 bytes free, but only 24 before the end of the buffer. */
+	zassert_equal(ring_buf_spsc_put_claim(&spsc, &data, 50), 24, NULL);
+	zassert_equal(ring_buf_spsc_put_claim(&spsc, &data, 50), 30, NULL);
+	zassert_equal(ring_buf_spsc_put_claim(&spsc, &data, 1), 0, NULL);
+	zassert_equal(ring_buf_spsc_put_finish(&spsc, 55), -EINVAL, NULL);
+	zassert_equal(ring_buf_spsc_put_finish(&spsc, 0), 0, NULL);
+	zassert_equal(ring_buf_spsc_space_get(&spsc), 54, NULL);
+
+	/* Wrapping put and get */
+	zassert_equal(ring_buf_spsc_put(&spsc, in, 54), 54, NULL);
+	zassert_equal(ring_buf_spsc_put(&spsc, in, 1), 0, NULL);
+	zassert_equal(ring_buf_spsc_get(&spsc, out, 10), 10, NULL);
+	zassert_mem_equal(out, &in[30], 10, NULL);
+
+	zassert_equal(ring_buf_spsc_get_claim(&spsc, &data, 64), 24, NULL);
+	zassert_equal(ring_buf_spsc_get_finish(&spsc, 25), -EINVAL, NULL);
+	zassert_equal(ring_buf_spsc_get_finish(&spsc, 4), 0, NULL);
+	zassert_equal(ring_buf_spsc_get(&spsc, out, SPSC_SIZE), 50, NULL);
+	zassert_mem_equal(out, &in[4], 50, NULL);
+	zassert_true(ring_buf_spsc_is_empty(&spsc), NULL);
+}
+
+static uint32_t spsc_produced;
+
+static void spsc_producer(struct k_timer *timer)
+{
+	uint32_t len, size = 0;
+	uint8_t *data;
+
+	/* Claim in odd sized chunks to hit every offset of the buffer. */
+	do {
+		len = ring_buf_spsc_put_claim(&spsc, &data,
+					      1 + spsc_produced % 13);
+		for (uint32_t i = 0; i < len; i++) {
+			data[i] = pattern(spsc_produced++);
+		}
+		size += len;
+	} while (len && spsc_produced < SPSC_STRESS_BYTES);
+
+	ring_buf_spsc_put_finish(&spsc, size);
+
+	if (spsc_produced >= SPSC_STRESS_BYTES) {
+		k_timer_stop(timer);
+	}
+}
+
+/**
+ * @brief Test an ISR producer against a thread consumer
+ *
+ * @details A timer ISR fills the buffer while the thread drains it in
+ * small chunks, and the thread checks that every byte arrives in
+ * order.
+ */
+void test_spsc_isr_thread(void)
+{
+	struct k_timer timer;
+	uint32_t consumed = 0;
+	uint32_t len, i;
+	uint8_t *data;
+
+	ring_buf_spsc_init(&spsc, SPSC_SIZE, spsc.buf);
+	spsc_produced = 0;
+
+	k_timer_init(&timer, spsc_producer, NULL);
+	k_timer_start(&timer, K_MSEC(1), K_MSEC(1));
+
+	while (consumed < SPSC_STRESS_BYTES) {
+		len = ring_buf_spsc_get_claim(&spsc, &data, 7);
+		if (len == 0) {
+			k_busy_wait(50);
+			continue;
+		}
+
+		for (i = 0; i < len; i++) {
+			zassert_equal(data[i], pattern(consumed + i),
+				      "byte %u corrupted", consumed + i);
+		}
+
+		zassert_equal(ring_buf_spsc_get_finish(&spsc, len), 0, NULL);
+		consumed += len;
+	}
+
+	k_timer_stop(&timer);
+	zassert_true(ring_buf_spsc_is_empty(&spsc), NULL);
+}
+
+/**
+ * @brief Test multiple producer, single consumer records
+ *
+ * @details Verify records are padded at the end of the buffer, that an
+ * unfinished record holds up the ones reserved after it, and that
+ * claims fail when the buffer is full.
+ */
+void test_mpsc_put_get(void)
+{
+	uint8_t in[MPSC_SIZE32 * sizeof(uint32_t)];
+	uint8_t out[sizeof(in)];
+	uint8_t *data, *first;
+
+	ring_buf_mpsc_init(&mpsc, MPSC_SIZE32, mpsc.buf32);
+
+	for (int i = 0; i < sizeof(in); i++) {
+		in[i] = i;
+	}
+
+	zassert_equal(ring_buf_mpsc_put_claim(&mpsc, &data, 0), 0, NULL);
+	zassert_equal(ring_buf_mpsc_put_claim(&mpsc, &data, sizeof(in)), 0,
+		      NULL);
+	zassert_equal(ring_buf_mpsc_get(&mpsc, out, sizeof(out)), 0, NULL);
+
+	/* 1 + 40 words, then 1 + 3 words */
+	zassert_equal(ring_buf_mpsc_put_claim(&mpsc, &first, 160), 160, NULL);
+	zassert_equal(ring_buf_mpsc_put(&mpsc, in, 9), 9, NULL);
+	zassert_equal(ring_buf_mpsc_get(&mpsc, out, sizeof(out)), 0,
+		      "unfinished record was not skipped");
+
+	memcpy(first, in, 160);
+	ring_buf_mpsc_put_finish(&mpsc, first);
+
+	/* Only 19 words left, all at the end of the buffer */
+	zassert_equal(ring_buf_mpsc_put_claim(&mpsc, &data, 77), 0, NULL);
+
+	zassert_equal(ring_buf_mpsc_get_claim(&mpsc, &data), 160, NULL);
+	zassert_mem_equal(data, in, 160, NULL);
+	ring_buf_mpsc_get_finish(&mpsc);
+
+	/* Padded to the start of the buffer */
+	zassert_equal(ring_buf_mpsc_put(&mpsc, &in[1], 100), 100, NULL);
+	zassert_equal(ring_buf_mpsc_get(&mpsc, out, sizeof(out)), 9, NULL);
+	zassert_mem_equal(out, in, 9, NULL);
+	zassert_equal(ring_buf_mpsc_get_claim(&mpsc, &data), 100, NULL);
+	zassert_equal(data, (uint8_t *)&mpsc.buf32[1],
+		      "record was not moved to the start of the buffer");
+	zassert_mem_equal(data, &in[1], 100, NULL);
+	ring_buf_mpsc_get_finish(&mpsc);
+
+	zassert_equal(ring_buf_mpsc_get_claim(&mpsc, &data), 0, NULL);
+
+	/* Exactly up to the end of the buffer, then the whole buffer */
+	zassert_equal(ring_buf_mpsc_put(&mpsc, in, 148), 148, NULL);
+	zassert_equal(ring_buf_mpsc_get(&mpsc, out, sizeof(out)), 148, NULL);
+	zassert_mem_equal(out, in, 148, NULL);
+	zassert_equal(ring_buf_mpsc_put(&mpsc, in, 252), 252, NULL);
+	zassert_equal(ring_buf_mpsc_put(&mpsc, in, 1), 0, NULL);
+	zassert_equal(ring_buf_mpsc_get(&mpsc, out, 4), 252, NULL);
+	zassert_mem_equal(out, in, 4, NULL);
+}
+
+/**
+ * @brief Test a large MPSC record in a drained buffer
+ *
+ * @details Verify a record longer than half the buffer, which fits on
+ * neither side of the tail of the emptied buffer, is stored at the
+ * start of the buffer once the consumer has skipped its end.
+ */
+void test_mpsc_large_record(void)
+{
+	uint8_t in[MPSC_SIZE32 * sizeof(uint32_t)];
+	uint8_t out[sizeof(in)];
+	uint8_t *data;
+
+	ring_buf_mpsc_init(&mpsc, MPSC_SIZE32, mpsc.buf32);
+
+	for (int i = 0; i < sizeof(in); i++) {
+		in[i] = i;
+	}
+
+	/* Fill and drain up to word 20 */
+	zassert_equal(ring_buf_mpsc_put(&mpsc, in, 76), 76, NULL);
+	zassert_equal(ring_buf_mpsc_get(&mpsc, out, sizeof(out)), 76, NULL);
+
+	/* 1 + 50 words, only 44 left after the tail and 20 before it */
+	zassert_equal(ring_buf_mpsc_put_claim(&mpsc, &data, 200), 0, NULL);
+	zassert_equal(ring_buf_mpsc_get_claim(&mpsc, &data), 0, NULL);
+
+	zassert_equal(ring_buf_mpsc_put_claim(&mpsc, &data, 200), 200,
+		      "large record did not fit in the empty buffer");
+	zassert_equal(data, (uint8_t *)&mpsc.buf32[1], NULL);
+	memcpy(data, in, 200);
+	ring_buf_mpsc_put_finish(&mpsc, data);
+
+	zassert_equal(ring_buf_mpsc_get(&mpsc, out, sizeof(out)), 200, NULL);
+	zassert_mem_equal(out, in, 200, NULL);
+	zassert_equal(ring_buf_mpsc_get_claim(&mpsc, &data), 0, NULL);
+}
+
+struct mpsc_record {
+	uint8_t id;
+	uint8_t len;
+	uint16_t reserved;
+	uint32_t seq;
+	uint8_t payload[MPSC_MAX_PAYLOAD];
+};
+
+static uint32_t mpsc_isr_seq;
+
+/* Claim, fill and finish one record, false if the buffer is full. */
+static bool mpsc_produce(uint8_t id, uint32_t seq, bool slow)
+{
+	uint8_t len = seq % (MPSC_MAX_PAYLOAD + 1);
+	struct mpsc_record *rec;
+	uint32_t size = offsetof(struct mpsc_record, payload) + len;
+
+	if (ring_buf_mpsc_put_claim(&mpsc, (uint8_t **)&rec, size) == 0) {
+		return false;
+	}
+
+	rec->id = id;
+	rec->len = len;
+	rec->seq = seq;
+	for (uint8_t i = 0; i < len; i++) {
+		rec->payload[i] = pattern(seq + i);
+	}
+
+	if (slow) {
+		/* Give the ISR producer a chance to preempt a claim. */
+		k_busy_wait(10);
+	}
+
+	ring_buf_mpsc_put_finish(&mpsc, (uint8_t *)rec);
+
+	return true;
+}
+
+static void mpsc_isr_producer(struct k_timer *timer)
+{
+	for (int i = 0; i < 4 && mpsc_isr_seq < MPSC_ISR_RECORDS; i++) {
+		if (!mpsc_produce(MPSC_THREADS, mpsc_isr_seq, false)) {
+			break;
+		}
+		mpsc_isr_seq++;
+	}
+
+	if (mpsc_isr_seq >= MPSC_ISR_RECORDS) {
+		k_timer_stop(timer);
+	}
+}
+
+static void mpsc_thread_producer(void *p1, void *p2, void *p3)
+{
+	uint8_t id = POINTER_TO_UINT(p1);
+
+	for (uint32_t seq = 0; seq < MPSC_THREAD_RECORDS; seq++) {
+		while (!mpsc_produce(id, seq, (seq % 8) == 0)) {
+			k_yield();
+		}
+	}
+}
+
+/**
+ * @brief Test concurrent thread and ISR producers against one consumer
+ *
+ * @details Several threads and a timer ISR write records of varying
+ * length, the consumer checks that each producer's records all arrive,
+ * in order and intact.  With SMP, producers and consumer run on all
+ * CPUs at once.
+ */
+void test_mpsc_stress(void)
+{
+	uint32_t expected[MPSC_PRODUCERS] = { 0 };
+	uint32_t total = 0;
+	struct mpsc_record rec;
+	struct k_timer timer;
+	uint32_t len;
+	uint8_t *data;
+	int prio = k_thread_priority_get(k_current_get());
+
+	ring_buf_mpsc_init(&mpsc, MPSC_SIZE32, mpsc.buf32);
+	mpsc_isr_seq = 0;
+
+	for (int i = 0; i < MPSC_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				mpsc_thread_producer, UINT_TO_POINTER(i),
+				NULL, NULL, prio, 0, K_NO_WAIT);
+	}
+
+	k_timer_init(&timer, mpsc_isr_producer, NULL);
+	k_timer_start(&timer, K_MSEC(1), K_MSEC(1));
+
+	while (total < MPSC_THREADS * MPSC_THREAD_RECORDS + MPSC_ISR_RECORDS) {
+		len = ring_buf_mpsc_get(&mpsc, (uint8_t *)&rec, sizeof(rec));
+		if (len == 0) {
+			k_yield();
+			k_busy_wait(20);
+			continue;
+		}
+
+		zassert_true(rec.id < MPSC_PRODUCERS, "bad producer %u",
+			     rec.id);
+		zassert_equal(len, offsetof(struct mpsc_record, payload) +
+			      rec.len, "bad record length");
+		zassert_equal(rec.seq, expected[rec.id],
+			      "producer %u: got record %u, expected %u",
+			      rec.id, rec.seq, expected[rec.id]);
+		for (uint8_t i = 0; i < rec.len; i++) {
+			zassert_equal(rec.payload[i], pattern(rec.seq + i),
+				      "record corrupted");
+		}
+
+		expected[rec.id]++;
+		total++;
+	}
+
+	for (int i = 0; i < MPSC_THREADS; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+	}
+	k_timer_stop(&timer);
+
+	zassert_equal(ring_buf_mpsc_get_claim(&mpsc, &data), 0,
+		      "unexpected record");
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_ringbuffer_lockfree,
+			 ztest_unit_test(test_spsc_put_get),
+			 ztest_unit_test(test_spsc_isr_thread),
+			 ztest_unit_test(test_mpsc_put_get),
+			 ztest_unit_test(test_mpsc_large_record),
+			 ztest_unit_test(test_mpsc_stress));
+	ztest_run_test_suite(test_ringbuffer_lockfree);
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+#ifdef CONFIG_EVENTFD
+#include <posix/sys/eventfd.h>
+#endif
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define CLIENT_PORT 9898
+#define SERVER_PORT 4242
+
+/* On QEMU, a wait takes +10ms from the requested time. */
+#define FUZZ 10
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_THREAD_STACK_DEFINE(waiter_stack, STACK_SIZE);
+static struct k_thread waiter_thread;
+static int waiter_epfd;
+static volatile int waiter_res;
+static volatile int waiter_errno;
+
+static int epoll_add(int epfd, int op, int sock, uint32_t events)
+{
+	struct zsock_epoll_event event = {
+		.events = events,
+		.data.fd = sock,
+	};
+
+	return zsock_epoll_ctl(epfd, op, sock, &event);
+}
+
+void test_epoll(void)
+{
+	struct zsock_epoll_event events[3];
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	int c_sock, s_sock, epfd;
+	uint32_t tstamp;
+	char buf[10];
+	ssize_t len;
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	zassert_equal(zsock_epoll_create1(1), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	epfd = zsock_epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_ADD, c_sock,
+				ZSOCK_EPOLLIN), 0, "");
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_ADD, s_sock,
+				ZSOCK_EPOLLIN), 0, "");
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_ADD, s_sock,
+				ZSOCK_EPOLLIN), -1, "");
+	zassert_equal(errno, EEXIST, "");
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_ADD, epfd,
+				ZSOCK_EPOLLIN), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	/* Wait on non-ready sockets, without and with a timeout */
+	tstamp = k_uptime_get_32();
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	tstamp = k_uptime_get_32();
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 0, "");
+
+	/* Send pkt for s_sock and wait for it */
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	tstamp = k_uptime_get_32();
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 100);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, ZSOCK_EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	/* Level-triggered: reported until the data is read */
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Writability is reported at once, and stays reported */
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_MOD, c_sock,
+				ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT), 0, "");
+	for (int i = 0; i < 2; i++) {
+		res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+		zassert_equal(res, 1, "");
+		zassert_equal(events[0].events, ZSOCK_EPOLLOUT, "");
+		zassert_equal(events[0].data.fd, c_sock, "");
+	}
+
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_DEL, c_sock, 0), 0, "");
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_DEL, c_sock, 0), -1, "");
+	zassert_equal(errno, ENOENT, "");
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Closed sockets leave the interest list */
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_DEL, s_sock, 0), -1, "");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+}
+
+static void send_small(int sock)
+{
+	ssize_t len;
+
+	len = send(sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+	/* let the packet reach the other socket */
+	k_sleep(K_MSEC(10));
+}
+
+void test_epoll_edge_triggered(void)
+{
+	struct epoll_event events[2];
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	int c_sock, s_sock, epfd;
+	char buf[10];
+	ssize_t len;
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+
+	zassert_equal(epoll_add(epfd, EPOLL_CTL_ADD, s_sock,
+				EPOLLIN | EPOLLET), 0, "");
+
+	/* Reported once per received packet, not while it is left unread */
+	send_small(c_sock);
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	send_small(c_sock);
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+
+	for (int i = 0; i < 2; i++) {
+		len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+		zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+	}
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* One-shot: reported once, until modified */
+	zassert_equal(epoll_add(epfd, EPOLL_CTL_MOD, s_sock,
+				EPOLLIN | EPOLLONESHOT), 0, "");
+	send_small(c_sock);
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+
+	send_small(c_sock);
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	zassert_equal(epoll_add(epfd, EPOLL_CTL_MOD, s_sock,
+				EPOLLIN | EPOLLONESHOT), 0, "");
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+}
+
+static void epoll_waiter(void *p1, void *p2, void *p3)
+{
+	struct epoll_event event;
+
+	waiter_res = epoll_wait(waiter_epfd, &event, 1, -1);
+	waiter_errno = errno;
+}
+
+void test_epoll_close_while_waiting(void)
+{
+	struct epoll_event event;
+	int res;
+
+	waiter_epfd = epoll_create(1);
+	zassert_true(waiter_epfd >= 0, "epoll_create failed");
+
+	waiter_res = 0;
+	k_thread_create(&waiter_thread, waiter_stack, STACK_SIZE,
+			epoll_waiter, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+
+	/* Closing the instance wakes up the waiter */
+	res = close(waiter_epfd);
+	zassert_equal(res, 0, "close failed");
+	zassert_equal(k_thread_join(&waiter_thread, K_MSEC(1000)), 0,
+		      "waiter not woken up");
+	zassert_equal(waiter_res, -1, "");
+	zassert_equal(waiter_errno, EBADF, "");
+
+	/* and the instance can be used again */
+	res = epoll_create(1);
+	zassert_true(res >= 0, "epoll_create failed");
+	zassert_equal(epoll_wait(res, &event, 1, 0), 0, "");
+	zassert_equal(close(res), 0, "close failed");
+}
+
+void test_epoll_eventfd(void)
+{
+#ifdef CONFIG_EVENTFD
+	struct zsock_epoll_event events[2];
+	eventfd_t value;
+	int efd, epfd;
+	int res;
+
+	efd = eventfd(0, EFD_NONBLOCK);
+	zassert_true(efd >= 0, "eventfd failed");
+
+	epfd = zsock_epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	zassert_equal(epoll_add(epfd, ZSOCK_EPOLL_CTL_ADD, efd,
+				ZSOCK_EPOLLIN), 0, "eventfd not accepted");
+
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Reported once signaled, until it is read */
+	zassert_equal(eventfd_write(efd, 1), 0, "");
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, ZSOCK_EPOLLIN, "");
+	zassert_equal(events[0].data.fd, efd, "");
+
+	zassert_equal(eventfd_read(efd, &value), 0, "");
+	zassert_equal(value, 1, "");
+	res = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	res = close(efd);
+	zassert_equal(res, 0, "close failed");
+
+	res = close(epfd);
+	zassert_equal(res, 0, "close failed");
+#else
+	ztest_test_skip();
+#endif
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll),
+			 ztest_unit_test(test_epoll_edge_triggered),
+			 ztest_unit_test(test_epoll_close_while_waiting),
+			 ztest_unit_test(test_epoll_eventfd));
+
+	ztest_run_test_suite(socket_epoll);
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <tracing_backend.h>
+
+#define RECORDER_SIZE CONFIG_TRACING_BACKEND_RAM_SIZE
+#define RECORDER_MAGIC 0x52465254
+
+#define NUM_GIVES 1000
+
+struct trace_summary {
+	uint32_t bytes;
+	uint32_t events;
+	uint32_t sem_give;
+	/* events since the newest semaphore give */
+	uint32_t since_give;
+};
+
+static struct k_sem sem;
+static uint8_t trace[RECORDER_SIZE];
+
+/* Returns the size of the fields of a CTF event, following its header */
+static int event_size(uint8_t id)
+{
+	switch (id) {
+	case 0x10 ... 0x11:
+	case 0x13 ... 0x18:
+	case 0x1A:
+		return sizeof(uint32_t) + 20;
+	case 0x12:
+		return sizeof(uint32_t) + sizeof(int8_t) + 20;
+	case 0x19:
+		return 3 * sizeof(uint32_t) + 20;
+	case 0x20 ... 0x22:
+	case 0x30:
+		return 0;
+	case 0x41 ... 0x48:
+		return sizeof(uint32_t);
+	case 0x50:
+		return 3 * sizeof(uint32_t);
+	case 0x51:
+		return 2 * sizeof(uint32_t);
+	default:
+		return -1;
+	}
+}
+
+/* Checks the data recorded is a valid CTF stream, in timestamp order */
+static void trace_parse(struct trace_summary *summary)
+{
+	uint32_t len, offset = 0U, tstamp, last_tstamp = 0U;
+	uint8_t id;
+	int size;
+
+	(void)memset(summary, 0, sizeof(*summary));
+
+	len = tracing_backend_ram_copy(trace, sizeof(trace));
+	zassert_true(len > 0U, "nothing recorded");
+
+	while (offset < len) {
+		zassert_true(offset + sizeof(tstamp) + sizeof(id) <= len,
+			     "event truncated at %u", offset);
+		memcpy(&tstamp, &trace[offset], sizeof(tstamp));
+		id = trace[offset + sizeof(tstamp)];
+		size = event_size(id);
+
+		zassert_true(size >= 0, "unknown event 0x%02x at %u",
+			     id, offset);
+		zassert_true((summary->events == 0U) ||
+			     ((int32_t)(tstamp - last_tstamp) >= 0),
+			     "event 0x%02x out of order", id);
+
+		summary->events++;
+		if (id == 0x44) {
+			summary->sem_give++;
+			summary->since_give = 0U;
+		} else {
+			summary->since_give++;
+		}
+
+		last_tstamp = tstamp;
+		offset += sizeof(tstamp) + sizeof(id) + size;
+	}
+
+	zassert_equal(offset, len, "event truncated at the end");
+	summary->bytes = len;
+}
+
+/**
+ * @brief Test the RAM backend keeps the newest events
+ *
+ * @details Trace more events than the recorder holds, and check the data
+ * recorded is a CTF stream ending with the newest of them, with the oldest
+ * ones overwritten whole.
+ *
+ * @ingroup tracing_tests
+ */
+void test_flight_recorder_overwrite(void)
+{
+	struct trace_summary before, after;
+
+	trace_parse(&before);
+
+	for (int i = 0; i < NUM_GIVES; i++) {
+		k_sem_give(&sem);
+	}
+
+	trace_parse(&after);
+	/* the give event may be followed by its end of call */
+	zassert_true(after.since_give <= 1U, "newest events not recorded");
+	zassert_true(after.sem_give > 0U, NULL);
+	zassert_true(after.sem_give < NUM_GIVES, "oldest events not dropped");
+	/* events are stored with their length, less than a packet short of
+	 * filling the recorder
+	 */
+	zassert_true(after.bytes + after.events * sizeof(uint16_t) >
+		     RECORDER_SIZE - CONFIG_TRACING_PACKET_MAX_SIZE -
+		     sizeof(uint16_t), "recorder not filled");
+}
+
+/**
+ * @brief Test the RAM backend region for core dumps
+ *
+ * @details Check the region dumped in core dumps starts with the header
+ * scripts/tracing/trace_flight_recorder.py looks for, and holds the buffer.
+ *
+ * @ingroup tracing_tests
+ */
+void test_flight_recorder_region(void)
+{
+	uintptr_t start, end;
+	uint32_t header[2];
+
+	tracing_backend_ram_region_get(&start, &end);
+	zassert_true(end - start > RECORDER_SIZE, NULL);
+
+	memcpy(header, UINT_TO_POINTER(start), sizeof(header));
+	zassert_equal(header[0], RECORDER_MAGIC, NULL);
+	zassert_equal(header[1], RECORDER_SIZE, NULL);
+}
+
+void test_main(void)
+{
+	k_sem_init(&sem, 0, UINT_MAX);
+
+	ztest_test_suite(tracing_flight_recorder,
+			 ztest_unit_test(test_flight_recorder_overwrite),
+			 ztest_unit_test(test_flight_recorder_region));
+	ztest_run_test_suite(tracing_flight_recorder);
+}
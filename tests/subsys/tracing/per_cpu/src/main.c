@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2020 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <ztest.h>
+#include <irq_offload.h>
+
+/* written by the posix tracing backend */
+#define TRACE_FILE "channel0_0"
+
+#define NUM_GIVES 1000
+
+/* let the tracing thread output the buffers */
+#define EXPORT_WAIT K_MSEC(CONFIG_TRACING_THREAD_WAIT_THRESHOLD * 5)
+
+struct trace_summary {
+	uint32_t events;
+	uint32_t isr_enter;
+	uint32_t isr_exit;
+	uint32_t sem_give;
+};
+
+static struct k_sem sem;
+
+/* Returns the size of the fields of a CTF event, following its header */
+static int event_size(uint8_t id)
+{
+	switch (id) {
+	case 0x10 ... 0x11:
+	case 0x13 ... 0x18:
+	case 0x1A:
+		return sizeof(uint32_t) + 20;
+	case 0x12:
+		return sizeof(uint32_t) + sizeof(int8_t) + 20;
+	case 0x19:
+		return 3 * sizeof(uint32_t) + 20;
+	case 0x20 ... 0x22:
+	case 0x30:
+		return 0;
+	case 0x41 ... 0x48:
+		return sizeof(uint32_t);
+	case 0x50:
+		return 3 * sizeof(uint32_t);
+	case 0x51:
+		return 2 * sizeof(uint32_t);
+	default:
+		return -1;
+	}
+}
+
+/* Checks the trace output is a valid CTF stream, in timestamp order */
+static void trace_parse(struct trace_summary *summary)
+{
+	uint8_t header[sizeof(uint32_t) + sizeof(uint8_t)];
+	uint32_t tstamp, last_tstamp = 0U;
+	FILE *fp;
+	int size;
+
+	(void)memset(summary, 0, sizeof(*summary));
+
+	fp = fopen(TRACE_FILE, "rb");
+	zassert_not_null(fp, "no trace output");
+
+	while (fread(header, sizeof(header), 1, fp) == 1) {
+		memcpy(&tstamp, header, sizeof(tstamp));
+		size = event_size(header[4]);
+
+		zassert_true(size >= 0, "unknown event 0x%02x at %ld",
+			     header[4], ftell(fp));
+		zassert_true((summary->events == 0U) ||
+			     ((int32_t)(tstamp - last_tstamp) >= 0),
+			     "event 0x%02x out of order", header[4]);
+
+		summary->events++;
+		summary->isr_enter += (header[4] == 0x20) ? 1 : 0;
+		summary->isr_exit += (header[4] == 0x21) ? 1 : 0;
+		summary->sem_give += (header[4] == 0x44) ? 1 : 0;
+
+		last_tstamp = tstamp;
+		zassert_equal(fseek(fp, size, SEEK_CUR), 0, NULL);
+	}
+
+	fclose(fp);
+}
+
+static void offload_give(const void *param)
+{
+	k_sem_give(&sem);
+}
+
+/**
+ * @brief Test the merged output of per-CPU tracing
+ *
+ * @details Have a thread and ISRs trace events, and check the output is a
+ * CTF stream with all of them, in timestamp order.
+ *
+ * @ingroup tracing_tests
+ */
+void test_per_cpu_export(void)
+{
+	struct trace_summary before, after;
+
+	k_sleep(EXPORT_WAIT);
+	trace_parse(&before);
+	zassert_true(before.events > 0U, NULL);
+
+	for (int i = 0; i < 10; i++) {
+		irq_offload(offload_give, NULL);
+		k_sem_give(&sem);
+	}
+
+	k_sleep(EXPORT_WAIT);
+	trace_parse(&after);
+	zassert_true(after.isr_enter - before.isr_enter >= 10U, NULL);
+	zassert_equal(after.isr_enter - before.isr_enter,
+		      after.isr_exit - before.isr_exit, NULL);
+	zassert_true(after.sem_give - before.sem_give >= 20U, NULL);
+}
+
+/**
+ * @brief Test per-CPU tracing with its buffer full
+ *
+ * @details Trace more events than the buffer holds before the tracing
+ * thread can run, and check the ones dropped are dropped whole.
+ *
+ * @ingroup tracing_tests
+ */
+void test_per_cpu_full(void)
+{
+	struct trace_summary before, after;
+
+	k_sleep(EXPORT_WAIT);
+	trace_parse(&before);
+
+	k_sched_lock();
+	for (int i = 0; i < NUM_GIVES; i++) {
+		k_sem_give(&sem);
+	}
+	k_sched_unlock();
+
+	k_sleep(EXPORT_WAIT);
+	trace_parse(&after);
+	zassert_true(after.sem_give - before.sem_give > 0U, NULL);
+	zassert_true(after.sem_give - before.sem_give < NUM_GIVES, NULL);
+}
+
+void test_main(void)
+{
+	k_sem_init(&sem, 0, UINT_MAX);
+
+	ztest_test_suite(tracing_per_cpu,
+			 ztest_unit_test(test_per_cpu_export),
+			 ztest_unit_test(test_per_cpu_full));
+	ztest_run_test_suite(tracing_per_cpu);
+}
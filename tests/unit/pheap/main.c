@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2020 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <sys/pheap.h>
+
+#include "../../../lib/os/pheap.c"
+
+#define _CHECK(n) \
+	zassert_true(!!(n), "Heap check failed: [ " #n " ] @%d", __LINE__)
+
+#define MAX_NODES 256
+
+struct item {
+	struct pheap_node node;
+	unsigned int key;
+};
+
+static struct pheap heap;
+
+static struct item items[MAX_NODES];
+
+/* Bit is set if item is in the heap */
+static unsigned int item_mask[(MAX_NODES + 31)/32];
+
+static void set_item_mask(int i, int val)
+{
+	unsigned int *p = &item_mask[i / 32];
+	unsigned int bit = 1u << (i % 32);
+
+	*p &= ~bit;
+	*p |= val ? bit : 0;
+}
+
+static int get_item_mask(int i)
+{
+	return !!(item_mask[i / 32] & (1u << (i % 32)));
+}
+
+static struct item *to_item(struct pheap_node *n)
+{
+	return CONTAINER_OF(n, struct item, node);
+}
+
+static bool item_lessthan(struct pheap_node *a, struct pheap_node *b)
+{
+	return to_item(a)->key < to_item(b)->key;
+}
+
+/* Same LCRNG as the rbtree test, for repeatability across platforms */
+static unsigned int next_rand_mod(unsigned int mod)
+{
+	static unsigned long long state = 123456789; /* seed */
+
+	state = state * 2862933555777941757ul + 3037000493ul;
+
+	return ((unsigned int)(state >> 32)) % mod;
+}
+
+/* Recursively validates heap order and the prev back-links, returns
+ * the number of nodes in the subheap
+ */
+static int check_subheap(struct pheap_node *n)
+{
+	int count = 0;
+	struct pheap_node *prev = n;
+
+	for (struct pheap_node *c = n->child; c != NULL; c = c->next) {
+		_CHECK(c->prev == prev);
+		_CHECK(!item_lessthan(c, n));
+		_CHECK(get_item_mask(to_item(c) - items));
+		count += check_subheap(c);
+		prev = c;
+	}
+
+	return count + 1;
+}
+
+static void check_heap(void)
+{
+	int expected = 0;
+
+	for (int i = 0; i < MAX_NODES; i++) {
+		expected += get_item_mask(i);
+		_CHECK(get_item_mask(i) ==
+		       pheap_node_is_linked(&items[i].node));
+	}
+
+	if (heap.root == NULL) {
+		_CHECK(expected == 0);
+		return;
+	}
+
+	_CHECK(heap.root->prev == heap.root);
+	_CHECK(heap.root->next == NULL);
+	_CHECK(check_subheap(heap.root) == expected);
+}
+
+static void test_heap(int size)
+{
+	int small_heap = size <= 32;
+
+	heap = (struct pheap)PHEAP_STATIC_INIT();
+	(void)memset(items, 0, sizeof(items));
+	(void)memset(item_mask, 0, sizeof(item_mask));
+
+	for (int j = 0; j < 10; j++) {
+		for (int i = 0; i < size; i++) {
+			int n = next_rand_mod(size);
+
+			if (!get_item_mask(n)) {
+				items[n].key = next_rand_mod(size);
+				pheap_insert(&heap, &items[n].node,
+					     item_lessthan);
+				set_item_mask(n, 1);
+			} else {
+				pheap_remove(&heap, &items[n].node,
+					     item_lessthan);
+				set_item_mask(n, 0);
+			}
+
+			if (small_heap) {
+				check_heap();
+			}
+		}
+
+		if (!small_heap) {
+			check_heap();
+		}
+	}
+
+	/* Drain in order, the keys must come out sorted */
+	unsigned int last = 0;
+
+	while (heap.root != NULL) {
+		struct item *it = to_item(pheap_get_min(&heap));
+
+		_CHECK(it->key >= last);
+		last = it->key;
+		pheap_remove(&heap, &it->node, item_lessthan);
+		set_item_mask(it - items, 0);
+	}
+	check_heap();
+}
+
+void test_pheap_spam(void)
+{
+	int size = 1;
+
+	do {
+		size += next_rand_mod(size) + 1;
+
+		if (size > MAX_NODES) {
+			size = MAX_NODES;
+		}
+
+		TC_PRINT("Checking heaps built from %d nodes...\n", size);
+
+		test_heap(size);
+	} while (size < MAX_NODES);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_pheap,
+			 ztest_unit_test(test_pheap_spam));
+	ztest_run_test_suite(test_pheap);
+}